@@ -17,12 +17,14 @@
 #include <thrill/data/block_queue.hpp>
 #include <tlx/cmdline_parser.hpp>
 #include <tlx/thread_pool.hpp>
+#include <tlx/unused.hpp>
 
 #include <algorithm>
 #include <iostream>
 #include <random>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "data_generators.hpp"
@@ -100,6 +102,25 @@ protected:
     std::string type_as_string_;
 };
 
+//! read and discard all items from a Reader
+template <typename Type, typename Reader>
+void ReadAllItems(Reader& reader, bool /* view */, std::false_type) {
+    while (reader.HasNext())
+        reader.template Next<Type>();
+}
+
+//! read and discard all std::string items from a Reader, optionally as
+//! StringViews without allocating strings.
+template <typename Type, typename Reader>
+void ReadAllItems(Reader& reader, bool view, std::true_type) {
+    if (!view)
+        return ReadAllItems<Type>(reader, view, std::false_type());
+    size_t total = 0;
+    while (reader.HasNext())
+        total += reader.template NextView<Type>().size();
+    tlx::unused(total);
+}
+
 /******************************************************************************/
 //! Writes and reads random elements from a file.  Elements are genreated before
 //! the timer startet Number of elements depends on the number of bytes.  one
@@ -122,6 +143,10 @@ public:
         clp.add_unsigned(
             'n', "iterations", iterations_, "Iterations (default: 1)");
 
+        clp.add_bool(
+            'V', "view", view_,
+            "read strings as StringViews with NextView() (default: false)");
+
         clp.add_param_string("reader", reader_type_,
                              "reader type (consume, keep)");
 
@@ -165,8 +190,8 @@ public:
 
             StatsTimerStart read_timer;
             auto reader = file.GetReader(consume);
-            while (reader.HasNext())
-                reader.Next<Type>();
+            ReadAllItems<Type>(
+                reader, view_, std::is_same<Type, std::string>());
             read_timer.Stop();
 
             LOG1 << "RESULT"
@@ -177,6 +202,7 @@ public:
                  << " avg_element_size="
                  << static_cast<double>(min_size_ + max_size_) / 2.0
                  << " reader=" << reader_type_
+                 << " view=" << view_
                  << " write_time=" << write_timer
                  << " read_time=" << read_timer
                  << " write_speed_MiBs=" << CalcMiBs(bytes_, write_timer)
@@ -190,6 +216,9 @@ private:
 
     //! reader type: consume or keep
     std::string reader_type_;
+
+    //! read strings as StringViews
+    bool view_ = false;
 };
 
 /******************************************************************************/
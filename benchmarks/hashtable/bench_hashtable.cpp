@@ -102,7 +102,7 @@ int main(int argc, char* argv[]) {
                    "Load in byte to be inserted");
 
     clp.add_string('h', "hash-table", "H", hashtable,
-                   "Set hashtable: probing or bucket");
+                   "Set hashtable: probing, bucket, or swiss");
 
     clp.add_unsigned('w', "workers", "W", workers,
                      "Open hashtable with W workers, default = 1.");
@@ -127,6 +127,8 @@ int main(int argc, char* argv[]) {
         [&](api::Context& ctx) {
             if (hashtable == "bucket")
                 return RunBenchmark<core::ReduceTableImpl::BUCKET>(ctx, config);
+            else if (hashtable == "swiss")
+                return RunBenchmark<core::ReduceTableImpl::SWISS>(ctx, config);
             else
                 return RunBenchmark<core::ReduceTableImpl::PROBING>(ctx, config);
         });
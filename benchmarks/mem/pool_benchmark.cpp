@@ -10,13 +10,17 @@
 
 #include <thrill/common/logger.hpp>
 #include <thrill/common/stats_timer.hpp>
+#include <thrill/mem/pool.hpp>
 #include <tlx/cmdline_parser.hpp>
 #include <tlx/thread_pool.hpp>
 
 #include <algorithm>
+#include <deque>
 #include <iostream>
 #include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace thrill; // NOLINT
 using common::StatsTimer;
@@ -77,10 +81,91 @@ int BenchmarkOneSize(int argc, char* argv[]) {
 
 /******************************************************************************/
 
+//! Run random allocations and deallocations of small items on an increasing
+//! number of threads, with and without the Pool's thread cache.
+int BenchmarkThreads(int argc, char* argv[]) {
+    tlx::CmdlineParser clp;
+
+    size_t max_size = 256;
+    size_t iterations = 1000000;
+    size_t max_threads = std::thread::hardware_concurrency();
+
+    clp.add_size_t(
+        's', "max_size", max_size, "maximum item size (default: 256)");
+    clp.add_size_t(
+        'n', "iterations", iterations,
+        "Iterations per thread (default: 1000000)");
+    clp.add_size_t(
+        't', "threads", max_threads,
+        "maximum number of threads (default: hardware concurrency)");
+
+    if (!clp.process(argc, argv)) return -1;
+
+    for (bool thread_cache : { false, true }) {
+        for (size_t num_threads = 1; num_threads <= max_threads;
+             num_threads *= 2)
+        {
+            mem::Pool pool(16384, thread_cache);
+
+            StatsTimerStart timer;
+
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < num_threads; ++t) {
+                threads.emplace_back(
+                    [&pool, t, max_size, iterations]() {
+                        std::default_random_engine rng(
+                            static_cast<unsigned>(t));
+                        std::deque<std::pair<void*, size_t> > list;
+
+                        for (size_t i = 0; i < iterations; ++i) {
+                            if (rng() % 2 == 0 || list.empty()) {
+                                size_t size = (rng() % max_size) + 1;
+                                list.emplace_back(pool.allocate(size), size);
+                            }
+                            else {
+                                pool.deallocate(
+                                    list.front().first, list.front().second);
+                                list.pop_front();
+                            }
+                        }
+
+                        while (!list.empty()) {
+                            pool.deallocate(
+                                list.front().first, list.front().second);
+                            list.pop_front();
+                        }
+                    });
+            }
+
+            for (std::thread& t : threads)
+                t.join();
+
+            timer.Stop();
+
+            LOG1 << "RESULT"
+                 << " benchmark=threads"
+                 << " thread_cache=" << thread_cache
+                 << " threads=" << num_threads
+                 << " max_size=" << max_size
+                 << " iterations=" << iterations
+                 << " time=" << timer
+                 << " ops_per_sec="
+                 << static_cast<double>(num_threads * iterations)
+                / timer.SecondsDouble();
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+
 void Usage(const char* argv0) {
     std::cout
         << "Usage: " << argv0 << " <benchmark>" << std::endl
         << std::endl
+        << "    one_size            - allocate items of one size" << std::endl
+        << "    threads             - multi-threaded scaling of small items" << std::endl
         // << "    file                - File and serialization speed" << std::endl
         // << "    blockqueue          - BlockQueue test" << std::endl
         // << "    cat_stream_1factor  - 1-factor bandwidth test using CatStream" << std::endl
@@ -103,6 +188,9 @@ int main(int argc, char* argv[]) {
     if (benchmark == "one_size") {
         return BenchmarkOneSize(argc - 1, argv + 1);
     }
+    else if (benchmark == "threads") {
+        return BenchmarkThreads(argc - 1, argv + 1);
+    }
     else {
         Usage(argv[0]);
         return -1;
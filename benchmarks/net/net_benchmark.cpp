@@ -6,6 +6,7 @@
  * - 1-factor full bandwidth test
  * - fcc Broadcast
  * - fcc PrefixSum
+ * - random and small block transmissions
  *
  * Part of Project Thrill - http://project-thrill.org
  *
@@ -881,6 +882,159 @@ protected:
 
 /******************************************************************************/
 
+class SmallBlocks
+{
+    static constexpr bool debug = false;
+
+public:
+    int Run(int argc, char* argv[]) {
+
+        tlx::CmdlineParser clp;
+
+        clp.add_bytes('b', "block_size", block_size_,
+                      "Size of blocks transmitted, default: 4 KiB");
+
+        clp.add_bytes('H', "header_size", header_size_,
+                      "Size of header sent before each block, default: 24");
+
+        clp.add_unsigned('n', "num_blocks", num_blocks_,
+                         "Number of blocks sent to each other host, "
+                         "default: 10000");
+
+        if (!clp.process(argc, argv)) return -1;
+
+        return api::Run(
+            [=](api::Context& ctx) {
+                // make a copy of this for local workers
+                SmallBlocks local = *this;
+                return local.Test(ctx);
+            });
+    }
+
+    void Test(api::Context& ctx) {
+
+        common::StatsTimerStopped t;
+        size_t sends = 0;
+
+        // only work with first thread on this host.
+        if (ctx.local_worker_id() == 0)
+        {
+            mem::Manager mem_manager(nullptr, "Dispatcher");
+
+            group_ = &ctx.net.group();
+            std::unique_ptr<net::Dispatcher> dispatcher =
+                group_->ConstructDispatcher();
+            dispatcher_ = dispatcher.get();
+
+            size_t sends_begin = CountSends();
+            t.Start();
+
+            // each block is written and read once
+            remaining_ = 2 * num_blocks_ * (group_->num_hosts() - 1);
+
+            for (size_t peer = 0; peer < group_->num_hosts(); ++peer)
+            {
+                if (peer == group_->my_host_rank()) continue;
+                net::Connection& conn = group_->connection(peer);
+
+                // like the multiplexer: a header followed by the block
+                for (size_t i = 0; i < num_blocks_; ++i) {
+                    dispatcher_->AsyncRead(
+                        conn, /* seq */ 0, header_size_,
+                        net::AsyncReadBufferCallback());
+                    dispatcher_->AsyncRead(
+                        conn, /* seq */ 0, block_size_,
+                        [this](net::Connection&, net::Buffer&&) {
+                            OnComplete();
+                        });
+                }
+                for (size_t i = 0; i < num_blocks_; ++i) {
+                    dispatcher_->AsyncWrite(
+                        conn, /* seq */ 0, net::Buffer(header_size_));
+                    dispatcher_->AsyncWrite(
+                        conn, /* seq */ 0, net::Buffer(block_size_),
+                        [this](net::Connection&) { OnComplete(); });
+                }
+            }
+
+            dispatcher_->Loop();
+
+            t.Stop();
+            sends = CountSends() - sends_begin;
+
+            // must clean up dispatcher prior to using group for other things.
+        }
+
+        size_t time = t.Microseconds();
+        // calculate maximum time and total number of send calls.
+        time = ctx.net.AllReduce(time, common::maximum<size_t>());
+        sends = ctx.net.AllReduce(sends);
+
+        if (ctx.my_rank() == 0) {
+            size_t num_hosts = group_->num_hosts();
+            size_t writes = 2 * num_blocks_ * num_hosts * (num_hosts - 1);
+            size_t total_bytes =
+                (header_size_ + block_size_) * writes / 2;
+
+            std::cout
+                << "RESULT"
+                << " operation=" << "sblocks"
+                << " hosts=" << num_hosts
+                << " blocks=" << writes / 2
+                << " block_size=" << block_size_
+                << " header_size=" << header_size_
+                << " time[us]=" << time
+                << " total_bytes=" << total_bytes
+                << " total_bandwidth[MiB/s]="
+                << CalcMiBs(total_bytes, time)
+                << " writes=" << writes
+                << " sends=" << sends
+                << " sends_per_write="
+                << static_cast<double>(sends) / static_cast<double>(writes)
+                << std::endl;
+        }
+    }
+
+    void OnComplete() {
+        if (--remaining_ == 0) {
+            LOG << "terminate";
+            dispatcher_->Terminate();
+        }
+    }
+
+    //! sum of send system calls on all connections of the group, only counted
+    //! by the TCP backend.
+    size_t CountSends() const {
+        size_t sends = 0;
+        for (size_t peer = 0; peer < group_->num_hosts(); ++peer) {
+            if (peer == group_->my_host_rank()) continue;
+            sends += group_->connection(peer).tx_sends_.load();
+        }
+        return sends;
+    }
+
+protected:
+    //! number of blocks sent to each other host
+    unsigned int num_blocks_ = 10000;
+
+    //! size of blocks transmitted
+    uint64_t block_size_ = 4 * 1024;
+
+    //! size of header before each block
+    uint64_t header_size_ = 24;
+
+    //! communication group
+    net::Group* group_;
+
+    //! async dispatcher
+    net::Dispatcher* dispatcher_;
+
+    //! remaining block writes and reads
+    size_t remaining_;
+};
+
+/******************************************************************************/
+
 void Usage(const char* argv0) {
     std::cout
         << "Usage: " << argv0 << " <benchmark>" << std::endl
@@ -892,6 +1046,8 @@ void Usage(const char* argv0) {
         << "    allreduce  - FCC PrefixSum operation" << std::endl
         << "    rblocks    - random block transmissions" << std::endl
         << "    rblocks_series - series of rblocks experiments" << std::endl
+        << "    sblocks    - small blocks with headers, counts send calls"
+        << std::endl
         << std::endl;
 }
 
@@ -925,6 +1081,9 @@ int main(int argc, char** argv) {
     else if (benchmark == "rblocks_series") {
         return RandomBlocksSeries().Run(argc - 1, argv + 1);
     }
+    else if (benchmark == "sblocks") {
+        return SmallBlocks().Run(argc - 1, argv + 1);
+    }
     else {
         Usage(argv[0]);
         return -1;
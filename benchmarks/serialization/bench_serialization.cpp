@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -111,6 +112,62 @@ void GetRandomString(std::vector<char>& s, const int len) {
     }
 }
 
+//! link between two pages with plain fields, serialized raw as a POD
+struct RawLink {
+    size_t src, tgt;
+};
+
+//! link between two pages with fields serialized as Varints
+struct CompactLink {
+    size_t src, tgt;
+
+    static auto thrill_fields() {
+        return data::MakeCompactFields(&CompactLink::src, &CompactLink::tgt);
+    }
+};
+
+//! writes and reads n links with page ids below max_id, prints the time per
+//! iteration and the bytes written.
+template <typename Link>
+void BenchmarkLinks(const std::string& datatype, size_t n, size_t max_id,
+                    int iterations) {
+    std::default_random_engine prng(std::random_device { } ());
+    std::uniform_int_distribution<size_t> dist(0, max_id - 1);
+
+    std::vector<Link> links(n);
+    for (Link& l : links)
+        l.src = dist(prng), l.tgt = dist(prng);
+
+    common::StatsTimerStopped timer;
+    data::BlockPool block_pool;
+    size_t bytes = 0, sum = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        data::File f(block_pool, 0, /* dia_id */ 0);
+        timer.Start();
+        {
+            auto w = f.GetWriter();
+            for (const Link& l : links)
+                w.Put(l);
+        }
+        bytes = f.size_bytes();
+        auto r = f.GetConsumeReader();
+        while (r.HasNext())
+            sum += r.template Next<Link>().tgt;
+        timer.Stop();
+    }
+
+    std::cout << "RESULT"
+              << " datatype=" << datatype
+              << " size=" << n
+              << " max_id=" << max_id
+              << " repeats=" << iterations
+              << " time=" << timer.Microseconds() / iterations
+              << " bytes=" << bytes
+              << " sum=" << sum
+              << std::endl;
+}
+
 //! executes some serializations and times it to use as benchmark
 int main() {
     int iterations = 50;
@@ -151,6 +208,12 @@ int main() {
 
         PrintSQLPlotTool("std::vector<int64_t>", s, iterations, BenchmarkSerialization(x_struct, iterations));
     }
+
+    // serialize page links with raw and Varint fields
+    for (size_t max_id : { size_t(1) << 7, size_t(1) << 20, size_t(1) << 40 }) {
+        BenchmarkLinks<RawLink>("raw_link", 1000000, max_id, iterations);
+        BenchmarkLinks<CompactLink>("compact_link", 1000000, max_id, iterations);
+    }
     return 1;
 }
 
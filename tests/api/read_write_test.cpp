@@ -16,6 +16,7 @@
 #include <thrill/api/read_lines.hpp>
 #include <thrill/api/size.hpp>
 #include <thrill/api/write_binary.hpp>
+#include <thrill/api/write_binary_one.hpp>
 #include <thrill/api/write_lines.hpp>
 #include <thrill/api/write_lines_one.hpp>
 #include <thrill/common/logger.hpp>
@@ -87,6 +88,53 @@ TEST(IO, ReadFolder) {
     api::RunLocalTests(start_func);
 }
 
+TEST(IO, ReadLinesRangedBoundaries) {
+    vfs::TemporaryDirectory tmpdir;
+
+    // small chunks, such that lines and ranges cross many chunk boundaries.
+    size_t old_block_size = data::default_block_size;
+    data::default_block_size = 4096;
+
+    std::mt19937 rng(42);
+    std::vector<std::string> lines;
+    std::vector<std::string> contents(6);
+
+    for (size_t f = 0; f < contents.size(); ++f) {
+        // file 2 is empty, file 4 has a single long line, file 5 has no
+        // trailing newline.
+        size_t num_lines = f == 2 ? 0 : f == 4 ? 1 : 200 + f * 100;
+        for (size_t i = 0; i < num_lines; ++i) {
+            size_t length = f == 4 ? 40000 : rng() % 8 == 0 ? 12000 : rng() % 40;
+            std::string line = std::to_string(f) + ":" + std::to_string(i);
+            line.resize(line.size() + length, 'a' + rng() % 26);
+            // empty lines, except the last, which may lack a newline
+            if (rng() % 16 == 0 && i + 1 != num_lines) line.clear();
+
+            contents[f] += line;
+            if (f != 5 || i + 1 != num_lines) contents[f] += '\n';
+            lines.emplace_back(std::move(line));
+        }
+
+        std::ofstream of(tmpdir.get() + "/lines-" + std::to_string(f));
+        of << contents[f];
+    }
+
+    auto start_func =
+        [&](Context& ctx) {
+            std::vector<std::string> out_vec =
+                ReadLines(ctx, tmpdir.get() + "/lines-*").AllGather();
+
+            ASSERT_EQ(lines.size(), out_vec.size());
+            for (size_t i = 0; i < lines.size(); ++i) {
+                ASSERT_EQ(lines[i], out_vec[i]);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+
+    data::default_block_size = old_block_size;
+}
+
 // need all decompressors in folder
 #if THRILL_HAVE_ZLIB && THRILL_HAVE_BZIP2
 
@@ -211,8 +259,81 @@ TEST(IO, GenerateIntegerWriteReadBinaryCompressed) {
         });
 }
 
+TEST(IO, GenerateLinesWriteOneCompressed) {
+#if defined(_MSC_VER)
+    return;
+#endif
+
+    vfs::TemporaryDirectory tmpdir;
+
+    api::RunLocalTests(
+        [&tmpdir](api::Context& ctx) {
+
+            // wipe directory from last test
+            if (ctx.my_rank() == 0) {
+                tmpdir.wipe();
+            }
+            ctx.net.Barrier();
+
+            // compressed files cannot be written at offsets, hence all lines
+            // are written by worker 0.
+            size_t generate_size = 32000;
+            Generate(ctx, generate_size)
+            .Map([](const size_t& i) { return std::to_string(i); })
+            .WriteLinesOne(tmpdir.get() + "/IntegerLines.gz");
+
+            auto dia = api::ReadLines(ctx, tmpdir.get() + "/IntegerLines.gz");
+
+            std::vector<std::string> vec = dia.AllGather();
+
+            ASSERT_EQ(generate_size, vec.size());
+            for (size_t i = 0; i < vec.size(); ++i) {
+                ASSERT_EQ(std::to_string(i), vec[i]);
+            }
+        });
+}
+
 #endif // THRILL_HAVE_ZLIB
 
+TEST(IO, GenerateIntegerWriteBinaryOne) {
+    vfs::TemporaryDirectory tmpdir;
+
+    api::RunLocalTests(
+        [&tmpdir](api::Context& ctx) {
+
+            // wipe directory from last test
+            if (ctx.my_rank() == 0) {
+                tmpdir.wipe();
+            }
+            ctx.net.Barrier();
+
+            // generate a dia of integers and write them into one file
+            size_t generate_size = 32000;
+            std::string path = tmpdir.get() + "/IntegerBinaryOne";
+            {
+                auto dia = Generate(
+                    ctx, generate_size,
+                    [](const size_t index) { return index + 42; });
+
+                dia.WriteBinaryOne(path);
+            }
+
+            vfs::FileList files = vfs::Glob(path);
+            ASSERT_EQ(1u, files.size());
+            ASSERT_EQ(generate_size * sizeof(size_t), files.total_size);
+
+            // read the integers from disk (collectively) and compare
+            auto dia = api::ReadBinary<size_t>(ctx, path);
+
+            std::vector<size_t> vec = dia.AllGather();
+
+            ASSERT_EQ(generate_size, vec.size());
+            for (size_t i = 0; i < vec.size(); ++i) {
+                ASSERT_EQ(42 + i, vec[i]);
+            }
+        });
+}
+
 // make weird test strings of different lengths
 std::string test_string(size_t index) {
     return std::string((index * index) % 20,
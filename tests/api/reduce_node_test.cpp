@@ -87,6 +87,8 @@ TEST(ReduceNode, ReduceModulo2CorrectResults) {
         TestReduceModulo2CorrectResults<ReduceTableImpl::BUCKET>());
     api::RunLocalTests(
         TestReduceModulo2CorrectResults<ReduceTableImpl::OLD_PROBING>());
+    api::RunLocalTests(
+        TestReduceModulo2CorrectResults<ReduceTableImpl::SWISS>());
 }
 
 //! Test sums of integers 0..n-1 for n=100 in 1000 buckets in the reduce table
@@ -136,6 +138,45 @@ TEST(ReduceNode, ReduceModuloPairsCorrectResults) {
         TestReduceModuloPairsCorrectResults<ReduceTableImpl::BUCKET>());
     api::RunLocalTests(
         TestReduceModuloPairsCorrectResults<ReduceTableImpl::OLD_PROBING>());
+    api::RunLocalTests(
+        TestReduceModuloPairsCorrectResults<ReduceTableImpl::SWISS>());
+}
+
+struct SharedPrePhaseReduceConfig : public api::DefaultReduceConfig {
+    static constexpr bool use_shared_pre_phase_ = true;
+};
+
+TEST(ReduceNode, ReduceSharedPrePhaseCorrectResults) {
+    auto start_func =
+        [](Context& ctx) {
+            static constexpr size_t num_keys = 1000;
+
+            auto pairs = Generate(
+                ctx, 100000,
+                [](const size_t& index) {
+                    return std::make_pair(index % num_keys, size_t(1));
+                });
+
+            auto reduced = pairs.ReduceByKey(
+                [](const std::pair<size_t, size_t>& p) { return p.first; },
+                [](const std::pair<size_t, size_t>& a,
+                   const std::pair<size_t, size_t>& b) {
+                    return std::make_pair(a.first, a.second + b.second);
+                },
+                SharedPrePhaseReduceConfig());
+
+            std::vector<std::pair<size_t, size_t> > out_vec =
+                reduced.AllGather();
+            ASSERT_EQ(num_keys, out_vec.size());
+
+            std::sort(out_vec.begin(), out_vec.end());
+            for (size_t i = 0; i < num_keys; ++i) {
+                ASSERT_EQ(i, out_vec[i].first);
+                ASSERT_EQ(100000 / num_keys, out_vec[i].second);
+            }
+        };
+
+    api::RunLocalTests(start_func);
 }
 
 template <ReduceTableImpl table_impl>
@@ -212,6 +253,10 @@ TEST(ReduceNode, ReduceToIndexCorrectResults) {
         TestReduceToIndexCorrectResults<ReduceTableImpl::BUCKET>());
     api::RunLocalTests(
         TestReduceToIndexCorrectResults<ReduceTableImpl::OLD_PROBING>());
+    api::RunLocalTests(
+        TestReduceToIndexCorrectResults<ReduceTableImpl::SWISS>());
+    api::RunLocalTests(
+        TestReduceToIndexCorrectResults<ReduceTableImpl::DENSE>());
 }
 
 TEST(ReduceToIndexNode, OutputSizeCheck) {
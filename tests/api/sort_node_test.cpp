@@ -9,13 +9,16 @@
  ******************************************************************************/
 
 #include <thrill/api/all_gather.hpp>
+#include <thrill/api/cache.hpp>
 #include <thrill/api/generate.hpp>
 #include <thrill/api/read_binary.hpp>
 #include <thrill/api/sort.hpp>
+#include <thrill/api/zip.hpp>
 
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cstdlib>
 #include <string>
 #include <utility>
 #include <vector>
@@ -52,6 +55,49 @@ TEST(Sort, SortKnownIntegers) {
     api::RunLocalMock(mem_config, 2, 1, start_func);
 }
 
+TEST(Sort, ParallelMergeIntoCacheAndZip) {
+
+    static constexpr size_t test_size = 6000000u;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            auto integers = Generate(
+                ctx, test_size,
+                [](const size_t& index) -> size_t {
+                    return test_size - index - 1;
+                });
+
+            // both children take the merged output as one File
+            auto sorted = integers.Sort().Keep();
+            auto cached = sorted.Cache();
+            auto zipped = Zip(
+                [](const size_t& a, const size_t& b) { return a + b; },
+                sorted, Generate(ctx, test_size));
+
+            std::vector<size_t> out_vec = cached.AllGather();
+            ASSERT_EQ(test_size, out_vec.size());
+            for (size_t i = 0; i < out_vec.size(); i++) {
+                ASSERT_EQ(i, out_vec[i]);
+            }
+
+            out_vec = zipped.AllGather();
+            ASSERT_EQ(test_size, out_vec.size());
+            for (size_t i = 0; i < out_vec.size(); i++) {
+                ASSERT_EQ(2 * i, out_vec[i]);
+            }
+        };
+
+    // set fixed amount of RAM for testing, such that multiple runs are merged,
+    // and merge them with two threads regardless of the cores.
+    api::MemoryConfig mem_config;
+    mem_config.setup(128 * 1024 * 1024llu);
+
+    setenv("THRILL_SORT_MERGE_THREADS", "2", 1);
+    api::RunLocalMock(mem_config, 2, 1, start_func);
+    unsetenv("THRILL_SORT_MERGE_THREADS");
+}
+
 TEST(Sort, SortRandomIntegers) {
 
     auto start_func =
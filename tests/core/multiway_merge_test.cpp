@@ -12,6 +12,7 @@
 
 #include <thrill/common/function_traits.hpp>
 #include <thrill/core/multiway_merge.hpp>
+#include <thrill/core/parallel_multiway_merge.hpp>
 #include <thrill/data/file.hpp>
 
 #include <thrill/common/logger.hpp>
@@ -19,6 +20,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <functional>
+#include <numeric>
 #include <random>
 #include <string>
 #include <utility>
@@ -87,4 +89,134 @@ TEST_F(MultiwayMerge, GetMultiwayMergePuller) {
     ASSERT_FALSE(puller.HasNext());
 }
 
+template <bool Stable>
+void TestStringMerge(data::BlockPool& block_pool) {
+    std::mt19937 gen(0);
+    size_t num_files = 13;
+
+    // strings with long common prefixes and duplicates, some with non-ASCII
+    // characters to check the unsigned character order.
+    std::vector<std::vector<std::string> > runs(num_files);
+    std::vector<std::pair<std::string, size_t> > ref;
+    for (size_t i = 0; i < num_files; ++i) {
+        size_t size = gen() % 200;
+        for (size_t j = 0; j < size; ++j) {
+            std::string s(20 + gen() % 3, 'p');
+            for (size_t l = gen() % 4; l > 0; --l)
+                s += static_cast<char>('a' + gen() % 3);
+            if (gen() % 5 == 0) s += static_cast<char>(0x80 + gen() % 2);
+            runs[i].emplace_back(s);
+        }
+        std::sort(runs[i].begin(), runs[i].end());
+        for (const std::string& s : runs[i])
+            ref.emplace_back(s, i);
+    }
+    std::stable_sort(
+        ref.begin(), ref.end(),
+        [](const std::pair<std::string, size_t>& a,
+           const std::pair<std::string, size_t>& b) {
+            return a.first < b.first;
+        });
+
+    std::vector<data::File> files;
+    for (size_t i = 0; i < num_files; ++i) {
+        files.emplace_back(block_pool, 0, /* dia_id */ 0);
+        auto w = files.back().GetWriter();
+        for (const std::string& s : runs[i])
+            w.Put(s);
+    }
+
+    std::vector<data::File::ConsumeReader> seq;
+    for (size_t i = 0; i < num_files; ++i)
+        seq.emplace_back(files[i].GetConsumeReader());
+
+    using MergeTree = core::MultiwayMergeTree<
+        std::string, std::vector<data::File::ConsumeReader>::iterator,
+        std::less<std::string>, Stable>;
+    static_assert(MergeTree::use_lcp, "string merge must use LCPs");
+
+    MergeTree puller(seq.begin(), seq.end(), std::less<std::string>());
+
+    for (size_t i = 0; i < ref.size(); ++i) {
+        ASSERT_TRUE(puller.HasNext());
+        std::pair<std::string, unsigned> e = puller.NextWithSource();
+        ASSERT_EQ(ref[i].first, e.first);
+        if (Stable) ASSERT_EQ(ref[i].second, e.second);
+    }
+    ASSERT_FALSE(puller.HasNext());
+}
+
+TEST_F(MultiwayMerge, LcpStringMerge) {
+    TestStringMerge<false>(block_pool_);
+}
+
+TEST_F(MultiwayMerge, LcpStableStringMerge) {
+    TestStringMerge<true>(block_pool_);
+}
+
+TEST_F(MultiwayMerge, ParallelStableMerge) {
+    std::mt19937 gen(0);
+    size_t num_files = 7;
+
+    // items with many equal keys, the second component identifies the input
+    // position, which must be retained by the stable parallel merge.
+    using Item = std::pair<size_t, size_t>;
+    auto less = [](const Item& a, const Item& b) { return a.first < b.first; };
+
+    std::vector<data::File> files;
+    std::vector<Item> ref;
+    for (size_t i = 0; i < num_files; ++i) {
+        std::vector<Item> run;
+        size_t size = i == 3 ? 0 : gen() % 1000;
+        for (size_t j = 0; j < size; ++j)
+            run.emplace_back(gen() % 50, 0);
+        std::sort(run.begin(), run.end(), less);
+
+        files.emplace_back(block_pool_, 0, /* dia_id */ 0);
+        auto w = files.back().GetWriter();
+        for (size_t j = 0; j < run.size(); ++j) {
+            run[j].second = i * 1000 + j;
+            w.Put(run[j]);
+            ref.push_back(run[j]);
+        }
+    }
+    std::stable_sort(ref.begin(), ref.end(), less);
+
+    // check the split positions against the reference
+    for (size_t rank = 0; rank <= ref.size(); rank += ref.size() / 10) {
+        std::vector<size_t> pos =
+            core::MultisequenceSelect<Item>(files, rank, less);
+        ASSERT_EQ(rank, std::accumulate(pos.begin(), pos.end(), size_t(0)));
+        for (size_t r = 0; r < ref.size(); ++r) {
+            size_t i = ref[r].second / 1000, j = ref[r].second % 1000;
+            ASSERT_EQ(r < rank, j < pos[i]);
+        }
+    }
+
+    for (bool consume : { false, true }) {
+        for (size_t num_threads : { 1, 2, 3, 8 }) {
+            // consuming merges empty the input, hence merge copies
+            std::vector<data::File> input;
+            for (const data::File& f : files)
+                input.emplace_back(f.Copy());
+
+            data::File merged(block_pool_, 0, /* dia_id */ 0);
+            core::ParallelMultiwayMerge<Item, /* Stable */ true>(
+                input, consume, num_threads, /* prefetch */ 0, less,
+                [this]() { return data::File(block_pool_, 0, /* dia_id */ 0); },
+                merged);
+
+            std::vector<Item> output;
+            auto r = merged.GetConsumeReader();
+            while (r.HasNext()) output.push_back(r.Next<Item>());
+
+            ASSERT_EQ(ref, output);
+            for (size_t i = 0; i < files.size(); ++i) {
+                ASSERT_EQ(consume ? 0 : files[i].num_items(),
+                          input[i].num_items());
+            }
+        }
+    }
+}
+
 /******************************************************************************/
@@ -12,6 +12,7 @@
 #include <thrill/core/reduce_bucket_hash_table.hpp>
 #include <thrill/core/reduce_old_probing_hash_table.hpp>
 #include <thrill/core/reduce_probing_hash_table.hpp>
+#include <thrill/core/reduce_swiss_hash_table.hpp>
 
 #include <thrill/core/reduce_pre_phase.hpp>
 
@@ -136,6 +137,13 @@ TEST(ReduceHashTable, ProbingAddIntegers) {
         });
 }
 
+TEST(ReduceHashTable, SwissAddIntegers) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructModulo<core::ReduceSwissHashTable>(ctx);
+        });
+}
+
 TEST(ReduceHashTable, OldProbingAddIntegers) {
     api::RunLocalSameThread(
         [](Context& ctx) {
@@ -111,6 +111,13 @@ TEST(ReduceHashPhase, ProbingAddMyStructByHash) {
         });
 }
 
+TEST(ReduceHashPhase, SwissAddMyStructByHash) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByHash<core::ReduceTableImpl::SWISS>(ctx);
+        });
+}
+
 /******************************************************************************/
 
 TEST(ReduceHashPhase, PostReduceByIndex) {
@@ -223,6 +230,13 @@ TEST(ReduceHashPhase, ProbingAddMyStructByIndex) {
         });
 }
 
+TEST(ReduceHashPhase, SwissAddMyStructByIndex) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByIndex<core::ReduceTableImpl::SWISS>(ctx);
+        });
+}
+
 /******************************************************************************/
 
 template <core::ReduceTableImpl table_impl>
@@ -306,4 +320,11 @@ TEST(ReduceHashPhase, ProbingAddMyStructByIndexWithHoles) {
         });
 }
 
+TEST(ReduceHashPhase, SwissAddMyStructByIndexWithHoles) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByIndexWithHoles<core::ReduceTableImpl::SWISS>(ctx);
+        });
+}
+
 /******************************************************************************/
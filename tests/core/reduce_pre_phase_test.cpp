@@ -126,6 +126,81 @@ TEST(ReducePrePhase, ProbingAddMyStructByHash) {
         });
 }
 
+TEST(ReducePrePhase, SwissAddMyStructByHash) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByHash<core::ReduceTableImpl::SWISS>(ctx);
+        });
+}
+
+/******************************************************************************/
+
+//! inserts mostly unique keys, such that the table is bypassed after the first
+//! sample, and checks that the emitted items still reduce to the right result.
+TEST(ReducePrePhase, AdaptiveSkipUniqueKeys) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            static constexpr size_t mod_size = 200000;
+            static constexpr size_t test_size = 3 * mod_size;
+
+            auto key_ex = [](const MyStruct& in) { return in.key; };
+
+            auto red_fn = [](const MyStruct& in1, const MyStruct& in2) {
+                              return MyStruct {
+                                  in1.key, in1.value + in2.value
+                              };
+                          };
+
+            const size_t num_partitions = 4;
+
+            std::vector<data::File> files;
+            for (size_t i = 0; i < num_partitions; ++i)
+                files.emplace_back(ctx.GetFile(nullptr));
+
+            std::vector<data::File::Writer> emitters;
+            for (size_t i = 0; i < num_partitions; ++i)
+                emitters.emplace_back(files[i].GetWriter());
+
+            using Phase = core::ReducePrePhase<
+                MyStruct, size_t, MyStruct,
+                decltype(key_ex), decltype(red_fn),
+                /* VolatileKey */ false, data::File::Writer,
+                MyReduceConfig<core::ReduceTableImpl::PROBING> >;
+
+            Phase phase(ctx, 0, num_partitions, key_ex, red_fn, emitters);
+
+            phase.Initialize(/* limit_memory_bytes */ 64 * 1024 * 1024);
+
+            for (size_t i = 0; i < test_size; ++i) {
+                phase.Insert(MyStruct { i % mod_size, 1 });
+            }
+
+            phase.FlushAll();
+            phase.CloseAll();
+
+            // reduce emitted items, which may contain duplicate keys
+            std::vector<size_t> count(mod_size, 0);
+            size_t num_items = 0;
+
+            for (size_t i = 0; i < num_partitions; ++i) {
+                data::File::Reader r = files[i].GetReader(/* consume */ true);
+                while (r.HasNext()) {
+                    MyStruct m = r.Next<MyStruct>();
+                    ASSERT_LT(m.key, mod_size);
+                    count[m.key] += m.value;
+                    ++num_items;
+                }
+            }
+
+            // not all items were reduced in the table.
+            ASSERT_GT(num_items, mod_size);
+
+            for (size_t i = 0; i < mod_size; ++i) {
+                ASSERT_EQ(test_size / mod_size, count[i]);
+            }
+        });
+}
+
 /******************************************************************************/
 
 template <core::ReduceTableImpl table_impl>
@@ -217,4 +292,86 @@ TEST(ReducePrePhase, ProbingAddMyStructByIndex) {
         });
 }
 
+TEST(ReducePrePhase, SwissAddMyStructByIndex) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByIndex<core::ReduceTableImpl::SWISS>(ctx);
+        });
+}
+
+TEST(ReducePrePhase, DenseAddMyStructByIndex) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByIndex<core::ReduceTableImpl::DENSE>(ctx);
+        });
+}
+
+//! with a memory limit smaller than the index range, the dense table evicts
+//! items of keys sharing a slot, which must still sum up correctly.
+TEST(ReducePrePhase, DenseEvictMyStructByIndex) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            static constexpr size_t mod_size = 601;
+            static constexpr size_t test_size = mod_size * 100;
+
+            auto key_ex = [](const MyStruct& in) {
+                              return in.key % mod_size;
+                          };
+
+            auto red_fn = [](const MyStruct& in1, const MyStruct& in2) {
+                              return MyStruct {
+                                  in1.key, in1.value + in2.value
+                              };
+                          };
+
+            const size_t num_partitions = 13;
+
+            std::vector<data::File> files;
+            for (size_t i = 0; i < num_partitions; ++i)
+                files.emplace_back(ctx.GetFile(nullptr));
+
+            std::vector<data::File::Writer> emitters;
+            for (size_t i = 0; i < num_partitions; ++i)
+                emitters.emplace_back(files[i].GetWriter());
+
+            using Phase = core::ReducePrePhase<
+                MyStruct, size_t, MyStruct,
+                decltype(key_ex), decltype(red_fn),
+                /* VolatileKey */ false,
+                data::File::Writer,
+                MyReduceConfig<core::ReduceTableImpl::DENSE>,
+                core::ReduceByIndex<size_t> >;
+
+            Phase phase(ctx, 0,
+                        num_partitions,
+                        key_ex, red_fn, emitters,
+                        typename Phase::ReduceConfig(),
+                        core::ReduceByIndex<size_t>(0, mod_size));
+
+            // eight slots per partition
+            phase.Initialize(num_partitions * 8 * sizeof(MyStruct));
+
+            for (size_t i = 0; i < test_size; ++i) {
+                phase.Insert(MyStruct { i, 1 });
+            }
+
+            phase.FlushAll();
+            phase.CloseAll();
+
+            std::vector<size_t> count(mod_size, 0);
+
+            for (size_t i = 0; i < num_partitions; ++i) {
+                data::File::Reader r = files[i].GetReader(/* consume */ true);
+                while (r.HasNext()) {
+                    MyStruct m = r.Next<MyStruct>();
+                    count[m.key % mod_size] += m.value;
+                }
+            }
+
+            for (size_t i = 0; i < mod_size; ++i) {
+                ASSERT_EQ(test_size / mod_size, count[i]);
+            }
+        });
+}
+
 /******************************************************************************/
@@ -13,6 +13,7 @@
 #include <thrill/data/block_pool.hpp>
 
 #include <string>
+#include <vector>
 
 using namespace thrill;
 
@@ -109,4 +110,101 @@ TEST_F(BlockPoolTest, EvictBlock) {
     ASSERT_EQ(0u, block_pool_.writing_blocks() + block_pool_.swapped_blocks());
 }
 
+TEST_F(BlockPoolTest, EvictByAccessHint) {
+    // allocate four unpinned Blocks
+    std::vector<data::Block> blocks;
+    for (size_t i = 0; i < 4; ++i) {
+        data::PinnedByteBlockPtr block = block_pool_.AllocateByteBlock(4096, 0);
+        data::PinnedBlock pinned_block(std::move(block), 0, 4096, 0, 0, false);
+        blocks.emplace_back(pinned_block.ToBlock());
+    }
+    ASSERT_EQ(4u, block_pool_.unpinned_blocks());
+
+    // Block 1 is read by a scan, Block 3 is needed soon, Block 0 is the least
+    // recently used Normal Block.
+    blocks[1].PinWait(0, data::AccessHint::Scanned);
+    blocks[3].AdviseAccess(data::AccessHint::WillNeed);
+    ASSERT_EQ(data::AccessHint::Scanned, blocks[1].byte_block()->access_hint());
+    ASSERT_EQ(4u, block_pool_.unpinned_blocks());
+
+    // evict in order: scanned, least recently used, most recently used, will
+    // need.
+    std::vector<bool> evicted(blocks.size());
+    for (size_t expect : { 1, 0, 2, 3 }) {
+        foxxll::request_ptr req = block_pool_.EvictBlockLRU();
+        ASSERT_TRUE(req);
+        req->wait();
+        evicted[expect] = true;
+        for (size_t i = 0; i < blocks.size(); ++i)
+            ASSERT_EQ(!evicted[i], blocks[i].byte_block()->in_memory());
+    }
+    ASSERT_EQ(0u, block_pool_.unpinned_blocks());
+}
+
+TEST_F(BlockPoolTest, RecycleByteBlockMemory) {
+    data::ByteBlockRecyclerPtr recycler =
+        tlx::make_counting<data::ByteBlockRecycler>(block_pool_, 1);
+
+    data::Byte* data;
+    {
+        data::PinnedByteBlockPtr block =
+            block_pool_.AllocateByteBlock(64, 0, recycler);
+        data = block->data();
+    }
+    ASSERT_EQ(0u, block_pool_.total_blocks());
+    ASSERT_EQ(1u, recycler->recycled());
+
+    // same size reuses the memory, another size does not.
+    data::PinnedByteBlockPtr block1 =
+        block_pool_.AllocateByteBlock(32, 0, recycler);
+    data::PinnedByteBlockPtr block2 =
+        block_pool_.AllocateByteBlock(64, 0, recycler);
+    ASSERT_EQ(data, block2->data());
+    ASSERT_EQ(1u, recycler->hits());
+    ASSERT_EQ(2u, recycler->misses());
+
+    // only one is kept, the other is deallocated.
+    block1 = data::PinnedByteBlockPtr();
+    block2 = data::PinnedByteBlockPtr();
+    ASSERT_EQ(2u, recycler->recycled());
+
+    // blocks destroyed after closing are deallocated.
+    data::PinnedByteBlockPtr block3 =
+        block_pool_.AllocateByteBlock(64, 0, recycler);
+    recycler->Close();
+    block3 = data::PinnedByteBlockPtr();
+    ASSERT_EQ(2u, recycler->recycled());
+}
+
+TEST_F(BlockPoolTest, RecycledMemoryIsCountedAndDrained) {
+    const size_t size = 64 * 1024;
+    data::BlockPool block_pool(4 * size, 8 * size, nullptr, nullptr, 1);
+    data::ByteBlockRecyclerPtr recycler =
+        tlx::make_counting<data::ByteBlockRecycler>(block_pool, 2);
+
+    {
+        data::PinnedByteBlockPtr block1 =
+            block_pool.AllocateByteBlock(size, 0, recycler);
+        data::PinnedByteBlockPtr block2 =
+            block_pool.AllocateByteBlock(size, 0, recycler);
+    }
+    ASSERT_EQ(2 * size, recycler->cached_bytes());
+
+    {
+        data::PinnedByteBlockPtr block =
+            block_pool.AllocateByteBlock(size, 0, recycler);
+        ASSERT_EQ(1u, recycler->hits());
+        ASSERT_EQ(size, recycler->cached_bytes());
+    }
+    ASSERT_EQ(2 * size, recycler->cached_bytes());
+
+    // the cached memory counts as used RAM, which exceeds the soft limit,
+    // hence the recycler is drained.
+    block_pool.RequestInternalMemory(3 * size);
+    ASSERT_EQ(0u, recycler->cached_bytes());
+    block_pool.ReleaseInternalMemory(3 * size);
+
+    recycler->Close();
+}
+
 /******************************************************************************/
@@ -10,6 +10,7 @@
 
 #include <gtest/gtest.h>
 #include <thrill/common/string.hpp>
+#include <thrill/common/string_view.hpp>
 #include <thrill/data/block_queue.hpp>
 #include <thrill/data/file.hpp>
 
@@ -17,6 +18,8 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,6 +30,39 @@ struct File : public ::testing::Test {
     data::BlockPool block_pool_;
 };
 
+TEST_F(File, BlockSizePolicyGrowth) {
+
+    data::File file(block_pool_, 0, /* dia_id */ 0);
+    file.set_block_size_policy(data::BlockSizePolicy(16, 64));
+
+    {
+        data::File::Writer fw = file.GetWriter();
+        ASSERT_EQ(fw.block_size(), 16u);
+        fw.MarkItem();
+        fw.Append(std::string(200, 'x'));
+    }
+
+    // blocks grow from 16 to 64 bytes, then stay at 64.
+    ASSERT_EQ(file.num_blocks(), 5u);
+    ASSERT_EQ(file.block(0).size(), 16u);
+    ASSERT_EQ(file.block(1).size(), 32u);
+    ASSERT_EQ(file.block(2).size(), 64u);
+    ASSERT_EQ(file.block(3).size(), 64u);
+    ASSERT_EQ(file.block(4).size(), 24u);
+    ASSERT_EQ(file.size_bytes(), 200u);
+
+    // capped writer and Copy() keep the File's policy
+    data::File copy = file.Copy();
+    ASSERT_EQ(copy.block_size_policy().max_size(), 64u);
+    ASSERT_EQ(copy.GetWriter(32).block_size_policy().max_size(), 32u);
+
+    // constant block size policy
+    data::BlockSizePolicy fixed(48, 48, 1);
+    ASSERT_EQ(fixed.next(48), 48u);
+    ASSERT_EQ(data::BlockSizePolicy::Throughput().start_size(),
+              data::default_block_size);
+}
+
 TEST_F(File, PutSomeItemsGetItems) {
 
     // construct File with very small blocks for testing
@@ -254,6 +290,115 @@ TEST_F(File, SerializeSomeItemsConsumeReader) {
     ASSERT_EQ(0u, file.num_items());
 }
 
+TEST_F(File, ReadStringViews) {
+    // strings of growing length, some of which straddle the small blocks.
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < 200; ++i)
+        strings.emplace_back(i % 97, static_cast<char>('a' + i % 26));
+
+    data::File file(block_pool_, 0, /* dia_id */ 0);
+    {
+        data::File::Writer fw = file.GetWriter(53);
+        for (const std::string& s : strings)
+            fw.Put(s);
+    }
+
+    // read views with a KeepReader, the view must be used before the next
+    // reading call.
+    {
+        data::File::KeepReader fr = file.GetKeepReader();
+        for (const std::string& s : strings) {
+            ASSERT_TRUE(fr.HasNext());
+            common::StringView sv = fr.NextView<std::string>();
+            ASSERT_EQ(s, sv);
+        }
+        ASSERT_TRUE(!fr.HasNext());
+    }
+
+    // mix Next() and NextView() on a consuming reader.
+    {
+        data::File::Reader fr = file.GetReader(true);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            ASSERT_TRUE(fr.HasNext());
+            if (i % 2 == 0)
+                ASSERT_EQ(strings[i], fr.NextView<std::string>());
+            else
+                ASSERT_EQ(strings[i], fr.Next<std::string>());
+        }
+        ASSERT_TRUE(!fr.HasNext());
+    }
+    ASSERT_TRUE(file.empty());
+
+    // StringViews order like std::string, including non-ASCII bytes.
+    ASSERT_LT(common::StringView("ab", 2), common::StringView("abc", 3));
+    ASSERT_LT(common::StringView("a\x7f", 2), common::StringView("a\x80", 2));
+    ASSERT_EQ(std::string("a\x7f").compare("a\x80") < 0,
+              common::StringView("a\x7f", 2) < common::StringView("a\x80", 2));
+}
+
+TEST_F(File, PutManyReadMany) {
+    // items straddle the small blocks, and runs are mixed with single Put()s.
+    std::vector<size_t> items(1000);
+    std::iota(items.begin(), items.end(), 42);
+
+    data::File file(block_pool_, 0, /* dia_id */ 0);
+    {
+        data::File::Writer fw = file.GetWriter(53);
+        ASSERT_EQ(300u, fw.PutMany(items.data(), 300));
+        fw.Put(items[300]);
+        ASSERT_EQ(699u, fw.PutMany(items.data() + 301, 699));
+    }
+    ASSERT_EQ(items.size(), file.num_items());
+
+    // read all items with ReadComplete()
+    {
+        data::File::KeepReader fr = file.GetKeepReader();
+        ASSERT_EQ(items, fr.ReadComplete<size_t>());
+    }
+
+    // mix ReadMany() and Next()
+    {
+        data::File::KeepReader fr = file.GetKeepReader();
+        std::vector<size_t> out;
+        ASSERT_EQ(1u, fr.ReadMany(out, 1));
+        out.push_back(fr.Next<size_t>());
+        ASSERT_EQ(500u, fr.ReadMany(out, 500));
+        ASSERT_EQ(498u, fr.ReadMany(out, 1000));
+        ASSERT_EQ(0u, fr.ReadMany(out, 1000));
+        ASSERT_EQ(items, out);
+    }
+
+    // read items one at a time via a BatchItemReader
+    {
+        data::File::Reader fr = file.GetReader(/* consume */ true);
+        data::BatchItemReader<size_t, data::File::Reader> br(fr);
+        for (const size_t& i : items) {
+            ASSERT_TRUE(br.HasNext());
+            ASSERT_EQ(i, br.Next());
+        }
+        ASSERT_TRUE(!br.HasNext());
+    }
+    ASSERT_TRUE(file.empty());
+
+    // items which are not raw bytes take the individual path.
+    std::vector<std::pair<std::string, size_t> > pairs;
+    for (size_t i = 0; i < 100; ++i)
+        pairs.emplace_back(std::string(i % 13, 'x'), i);
+
+    data::File file2(block_pool_, 0, /* dia_id */ 0);
+    {
+        data::File::Writer fw = file2.GetWriter(53);
+        ASSERT_EQ(pairs.size(), fw.PutMany(pairs));
+    }
+    {
+        data::File::KeepReader fr = file2.GetKeepReader();
+        std::vector<std::pair<std::string, size_t> > out;
+        ASSERT_EQ(pairs.size(),
+                  fr.ReadMany(out, std::numeric_limits<size_t>::max()));
+        ASSERT_EQ(pairs, out);
+    }
+}
+
 TEST_F(File, RandomGetIndexOf) {
     static constexpr size_t size = 500;
 
@@ -451,6 +596,100 @@ TEST_F(File, SeekReadSlicesOfFiles) {
     check_range(1000, 1000, true);
 }
 
+TEST_F(File, SplitSharesBlocks) {
+    // strings of varying size in small blocks, such that items span blocks.
+    data::File file(block_pool_, 0, /* dia_id */ 0);
+    std::vector<std::string> items;
+    {
+        data::File::Writer fw = file.GetWriter(53);
+        for (size_t i = 0; i < 200; ++i) {
+            items.emplace_back(std::to_string(i) + std::string(i % 37, 'x'));
+            fw.Put(items.back());
+        }
+    }
+    size_t num_blocks = file.num_blocks();
+
+    std::vector<size_t> positions = { 0, 1, 1, 57, 58, 120, 199, 200 };
+    std::vector<data::File> parts = file.Split<std::string>(positions);
+    ASSERT_EQ(positions.size() + 1, parts.size());
+
+    // the File is unchanged, the parts only reference its ByteBlocks
+    ASSERT_EQ(items.size(), file.num_items());
+    ASSERT_EQ(num_blocks, file.num_blocks());
+
+    size_t begin = 0;
+    for (size_t p = 0; p < parts.size(); ++p) {
+        size_t end = p < positions.size() ? positions[p] : items.size();
+        ASSERT_EQ(end - begin, parts[p].num_items());
+
+        data::File::ConsumeReader fr = parts[p].GetConsumeReader();
+        for (size_t i = begin; i < end; ++i) {
+            ASSERT_TRUE(fr.HasNext());
+            ASSERT_EQ(items[i], fr.Next<std::string>());
+        }
+        ASSERT_FALSE(fr.HasNext());
+        begin = end;
+    }
+}
+
+TEST_F(File, PrefetchGroupStaysInBudget) {
+    const size_t block = 1024;
+    data::PrefetchGroup group(8 * block, 4, block);
+
+    std::vector<data::PrefetchGroup::Share> shares(4);
+    for (data::PrefetchGroup::Share& s : shares)
+        group.Join(s);
+    ASSERT_EQ(8 * block, group.assigned_size());
+
+    // reader 0 is consumed most, but the others only shrink slowly.
+    for (size_t i = 0; i < 100; ++i) {
+        size_t size = group.Deliver(shares[i % 5 == 4 ? 1 + i % 3 : 0]);
+        ASSERT_GE(size, block);
+        ASSERT_LE(size, 4 * block);
+        ASSERT_LE(group.assigned_size(), 8 * block);
+    }
+    ASSERT_GT(shares[0].size, shares[1].size);
+
+    for (data::PrefetchGroup::Share& s : shares)
+        group.Leave(s);
+    ASSERT_EQ(0u, group.assigned_size());
+}
+
+TEST_F(File, AbandonedReaderClearsWillNeed) {
+    data::File file(block_pool_, 0, /* dia_id */ 0);
+    {
+        data::File::Writer fw = file.GetWriter(64);
+        for (size_t i = 0; i < 100; ++i)
+            fw.Put<size_t>(i);
+    }
+    ASSERT_LT(4u, file.num_blocks());
+
+    auto count_will_need = [&]() {
+                               size_t n = 0;
+                               for (size_t i = 0; i < file.num_blocks(); ++i) {
+                                   if (file.block(i).byte_block()->access_hint()
+                                       == data::AccessHint::WillNeed)
+                                       ++n;
+                               }
+                               return n;
+                           };
+
+    {
+        data::File::KeepReader fr = file.GetKeepReader(128);
+        ASSERT_EQ(0u, fr.Next<size_t>());
+        ASSERT_EQ(1u, count_will_need());
+    }
+    ASSERT_EQ(0u, count_will_need());
+
+    // a fully read File leaves no hint either
+    {
+        data::File::KeepReader fr = file.GetKeepReader(128);
+        for (size_t i = 0; i < 100; ++i)
+            ASSERT_EQ(i, fr.Next<size_t>());
+    }
+    ASSERT_EQ(0u, count_will_need());
+}
+
 #if 0
 //! A derivative of File which only contains a limited amount of Blocks
 #if defined(_MSC_VER)
@@ -496,6 +735,25 @@ TEST_F(File, BoundedFilePutIntegerUntilFull) {
                  + (data::BlockWriter<BoundedFile>::self_verify ? sizeof(size_t) : 0)),
               file.num_items());
 }
+
+TEST_F(File, BoundedFilePutManyUntilFull) {
+
+    // construct Partition with very small blocks for testing
+    BoundedFile file(block_pool_, 0, /* dia_id */ 0, 32 * 64);
+
+    std::vector<size_t> items(1000);
+    std::iota(items.begin(), items.end(), 123456u);
+
+    data::BlockWriter<BoundedFile> bw(&file, 64);
+    size_t n = bw.PutMany(items);
+
+    ASSERT_EQ(file.max_size()
+              / (sizeof(size_t)
+                 + (data::BlockWriter<BoundedFile>::self_verify ? sizeof(size_t) : 0)),
+              n);
+    ASSERT_EQ(n, file.num_items());
+    ASSERT_EQ(0u, bw.PutMany(items.data() + n, items.size() - n));
+}
 #endif
 
 // forced instantiation
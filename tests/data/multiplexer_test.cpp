@@ -19,7 +19,10 @@
 #include <thrill/net/mock/group.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace thrill;
@@ -170,8 +173,12 @@ struct Multiplexer : public ::testing::Test {
 };
 
 // open a Stream via data::Multiplexer, and send a short message to all workers,
-// receive and check the message.
-void TalkAllToAllViaCatStream(net::Group* net) {
+// receive and check the message. The Multiplexer stripes Blocks across the
+// connections of all groups, each with its own DispatcherThread, or if
+// num_dispatchers != 0, the connections are sharded across that many threads.
+void TalkAllToAllViaCatStreamStriped(const std::vector<net::Group*>& groups,
+                                     size_t num_dispatchers = 0) {
+    net::Group* net = groups[0];
     common::NameThisThread("chmp" + std::to_string(net->my_host_rank()));
 
     unsigned char send_buffer[123];
@@ -187,9 +194,30 @@ void TalkAllToAllViaCatStream(net::Group* net) {
 
     mem::Manager mem_manager(nullptr, "Benchmark");
     data::BlockPool block_pool(num_workers_per_host);
-    net::DispatcherThread disp(net->ConstructDispatcher(), 0);
+
+    std::vector<std::unique_ptr<net::DispatcherThread> > disp;
+    std::vector<net::DispatcherThread*> disp_ptr;
+    if (num_dispatchers == 0) {
+        for (net::Group* g : groups) {
+            disp.emplace_back(
+                std::make_unique<net::DispatcherThread>(
+                    g->ConstructDispatcher(), 0));
+            disp_ptr.push_back(disp.back().get());
+        }
+    }
+    else {
+        for (size_t i = 0; i < num_dispatchers; ++i) {
+            disp.emplace_back(
+                std::make_unique<net::DispatcherThread>(
+                    net->ConstructDispatcher(), 0, i));
+        }
+        // one dispatcher per connection
+        for (size_t c = 0; c < groups.size() * num_hosts; ++c)
+            disp_ptr.push_back(disp[c % num_dispatchers].get());
+    }
+
     data::Multiplexer multiplexer(
-        mem_manager, block_pool, disp, *net, num_workers_per_host);
+        mem_manager, block_pool, disp_ptr, groups, num_workers_per_host);
 
     auto thread_func =
         [&](size_t my_local_worker_id) {
@@ -289,8 +317,13 @@ void TalkAllToAllViaCatStream(net::Group* net) {
     std::thread t1 = std::thread(thread_func, 1);
     t0.join(), t1.join();
 
-    // stop DispatcherThread before Multiplexer
-    disp.Terminate();
+    // stop DispatcherThreads before Multiplexer
+    for (auto& d : disp)
+        d->Terminate();
+}
+
+void TalkAllToAllViaCatStream(net::Group* net) {
+    TalkAllToAllViaCatStreamStriped(std::vector<net::Group*>({ net }));
 }
 
 TEST_F(Multiplexer, TalkAllToAllViaCatStreamForManyNetSizes) {
@@ -301,6 +334,50 @@ TEST_F(Multiplexer, TalkAllToAllViaCatStreamForManyNetSizes) {
     net::RunLoopbackGroupTest(9, TalkAllToAllViaCatStream);
 }
 
+TEST_F(Multiplexer, TalkAllToAllViaCatStreamStriped) {
+    static constexpr size_t num_hosts = 3, num_stripes = 3;
+
+    // construct one mock mesh per stripe
+    std::vector<std::vector<std::unique_ptr<net::mock::Group> > > meshes;
+    for (size_t s = 0; s < num_stripes; ++s)
+        meshes.emplace_back(net::mock::Group::ConstructLoopbackMesh(num_hosts));
+
+    std::vector<std::thread> threads;
+    for (size_t h = 0; h < num_hosts; ++h) {
+        threads.emplace_back(
+            [&meshes, h]() {
+                std::vector<net::Group*> groups;
+                for (size_t s = 0; s < num_stripes; ++s)
+                    groups.push_back(meshes[s][h].get());
+                TalkAllToAllViaCatStreamStriped(groups);
+            });
+    }
+    for (std::thread& t : threads)
+        t.join();
+}
+
+TEST_F(Multiplexer, TalkAllToAllViaCatStreamSharded) {
+    static constexpr size_t num_hosts = 5, num_stripes = 2;
+
+    // construct one mock mesh per stripe
+    std::vector<std::vector<std::unique_ptr<net::mock::Group> > > meshes;
+    for (size_t s = 0; s < num_stripes; ++s)
+        meshes.emplace_back(net::mock::Group::ConstructLoopbackMesh(num_hosts));
+
+    std::vector<std::thread> threads;
+    for (size_t h = 0; h < num_hosts; ++h) {
+        threads.emplace_back(
+            [&meshes, h]() {
+                std::vector<net::Group*> groups;
+                for (size_t s = 0; s < num_stripes; ++s)
+                    groups.push_back(meshes[s][h].get());
+                TalkAllToAllViaCatStreamStriped(groups, /* num_dispatchers */ 3);
+            });
+    }
+    for (std::thread& t : threads)
+        t.join();
+}
+
 TEST_F(Multiplexer, ReadCompleteCatStream) {
     data::default_block_size = test_block_size;
     auto w0 =
@@ -414,6 +491,64 @@ TEST_F(Multiplexer, ReadCompleteCatStreamManyTimes) {
     Execute(w0, w1, w2);
 }
 
+TEST_F(Multiplexer, CatStreamFlowControlSlowReader) {
+    data::default_block_size = test_block_size;
+    static constexpr size_t num_items = 4096;
+    auto writer =
+        [](data::Multiplexer& multiplexer) {
+            auto c = multiplexer.GetNewCatStream(0, /* dia_id */ 0);
+            auto writers = c->GetWriters();
+            for (size_t i = 0; i < num_items; ++i)
+                writers[2].Put(i);
+            writers.Close();
+            // the reader waits, hence it cannot have granted credit for all
+            // Blocks, which were held back.
+            ASSERT_GT(c->tx_net_deferred(), 0u);
+            c->Close();
+        };
+    auto w2 =
+        [](data::Multiplexer& multiplexer) {
+            auto c = multiplexer.GetNewCatStream(0, /* dia_id */ 0);
+            auto writers = c->GetWriters();
+            writers.Close();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            auto reader = c->GetCatReader(true);
+            for (size_t w = 0; w < 2; ++w) {
+                for (size_t i = 0; i < num_items; ++i)
+                    ASSERT_EQ(i, reader.Next<size_t>());
+            }
+            ASSERT_FALSE(reader.HasNext());
+            c->Close();
+        };
+    Execute(writer, writer, w2);
+}
+
+TEST_F(Multiplexer, CatStreamFlowControlCloseWithoutReading) {
+    data::default_block_size = test_block_size;
+    static constexpr size_t num_items = 4096;
+    auto writer =
+        [](data::Multiplexer& multiplexer) {
+            auto c = multiplexer.GetNewCatStream(0, /* dia_id */ 0);
+            auto writers = c->GetWriters();
+            for (size_t i = 0; i < num_items; ++i)
+                writers[2].Put(i);
+            writers.Close();
+            c->Close();
+        };
+    auto w2 =
+        [](data::Multiplexer& multiplexer) {
+            auto c = multiplexer.GetNewCatStream(0, /* dia_id */ 0);
+            auto writers = c->GetWriters();
+            writers.Close();
+            // all Blocks must arrive although nothing is consumed.
+            c->Close();
+            ASSERT_EQ(2 * num_items, c->rx_net_items());
+        };
+    Execute(writer, writer, w2);
+}
+
 /******************************************************************************/
 // MixStream Tests
 
@@ -637,6 +772,29 @@ TEST_F(Multiplexer, TalkAllToAllViaMixStreamForManyNetSizes) {
     net::RunLoopbackGroupTest(9, TalkAllToAllViaMixStream);
 }
 
+TEST_F(Multiplexer, MixStreamFlowControlCloseWithoutReading) {
+    data::default_block_size = test_block_size;
+    static constexpr size_t num_items = 4096;
+    auto worker =
+        [](data::Multiplexer& multiplexer) {
+            auto c = multiplexer.GetNewMixStream(0, /* dia_id */ 0);
+            auto writers = c->GetWriters();
+            for (size_t tgt = 0; tgt < writers.size(); ++tgt) {
+                for (size_t i = 0; i < num_items; ++i)
+                    writers[tgt].Put(i);
+            }
+            writers.Close();
+            // read only a part of the Blocks
+            auto reader = c->GetMixReader(true);
+            for (size_t i = 0; i < 16; ++i) {
+                ASSERT_TRUE(reader.HasNext());
+                reader.Next<size_t>();
+            }
+            c->Close();
+        };
+    Execute(worker, worker, worker);
+}
+
 /******************************************************************************/
 // Scatter Tests
 
@@ -13,6 +13,7 @@
 #include <thrill/data/file.hpp>
 #include <thrill/data/serialization.hpp>
 
+#include <limits>
 #include <string>
 #include <tuple>
 #include <typeinfo>
@@ -236,4 +237,147 @@ TEST_F(Serialization, MethodStruct) {
         "Serialization::is_fixed_size is wrong");
 }
 
+struct MyFieldStruct {
+    int    i1;
+    double d2;
+    std::string s3;
+
+    static auto thrill_fields() {
+        return data::MakeFields(data::Field(&MyFieldStruct::i1),
+                                data::Field(&MyFieldStruct::d2),
+                                data::Field(&MyFieldStruct::s3));
+    }
+};
+
+struct MyFixedFieldStruct {
+    int    i1;
+    double d2;
+
+    static auto thrill_fields() {
+        return data::MakeFields(data::Field(&MyFixedFieldStruct::i1),
+                                data::Field(&MyFixedFieldStruct::d2));
+    }
+};
+
+TEST_F(Serialization, FieldStruct) {
+    MyFieldStruct foo { 6 * 9, 42, "abc" };
+    data::File f(block_pool_, 0, /* dia_id */ 0);
+    {
+        auto w = f.GetWriter();
+        w.Put(foo);
+    }
+    auto r = f.GetKeepReader();
+    auto fooserial = r.Next<MyFieldStruct>();
+    ASSERT_EQ(foo.i1, fooserial.i1);
+    ASSERT_DOUBLE_EQ(foo.d2, fooserial.d2);
+    ASSERT_EQ(foo.s3, fooserial.s3);
+    static_assert(
+        !data::Serialization<data::File::Writer, MyFieldStruct>::is_fixed_size,
+        "Serialization::is_fixed_size is wrong");
+    static_assert(
+        data::Serialization<data::File::Writer, MyFixedFieldStruct>
+        ::is_fixed_size, "Serialization::is_fixed_size is wrong");
+    static_assert(
+        data::Serialization<data::File::Writer, MyFixedFieldStruct>
+        ::fixed_size == sizeof(int) + sizeof(double),
+        "Serialization::fixed_size is wrong");
+}
+
+struct MyCompactLink {
+    size_t  src, tgt;
+    int64_t weight;
+
+    static auto thrill_fields() {
+        return data::MakeCompactFields(
+            &MyCompactLink::src, &MyCompactLink::tgt, &MyCompactLink::weight);
+    }
+};
+
+//! MyCompactLink without weight, as written by an older program.
+struct MyCompactLinkOld {
+    size_t src, tgt;
+
+    static auto thrill_fields() {
+        return data::MakeCompactFields(
+            &MyCompactLinkOld::src, &MyCompactLinkOld::tgt);
+    }
+};
+
+TEST_F(Serialization, CompactFieldStruct) {
+    std::vector<MyCompactLink> links = {
+        { 0, 1, -1 }, { 127, 128, 64 }, { 1000000, 3, -1000000 },
+        { size_t(-1), 0, std::numeric_limits<int64_t>::min() }
+    };
+
+    data::File f(block_pool_, 0, /* dia_id */ 0);
+    {
+        auto w = f.GetWriter();
+        for (const MyCompactLink& l : links) w.Put(l);
+    }
+    // field count, src, tgt, and weight are each one byte for the first item.
+    ASSERT_EQ(4u + 6u + 8u + 22u
+              + (data::File::Writer::self_verify ? 4 * sizeof(size_t) : 0),
+              f.size_bytes());
+
+    auto r = f.GetKeepReader();
+    for (const MyCompactLink& l : links) {
+        ASSERT_TRUE(r.HasNext());
+        MyCompactLink x = r.Next<MyCompactLink>();
+        ASSERT_EQ(l.src, x.src);
+        ASSERT_EQ(l.tgt, x.tgt);
+        ASSERT_EQ(l.weight, x.weight);
+    }
+    ASSERT_FALSE(r.HasNext());
+
+    static_assert(!data::is_raw_serializable<MyCompactLink>::value,
+                  "compact POD must not be copied raw");
+}
+
+TEST_F(Serialization, CompactFieldStructAppendedField) {
+    data::File f(block_pool_, 0, /* dia_id */ 0);
+    {
+        auto w = f.GetWriter();
+        w.PutNoSelfVerify(MyCompactLinkOld { 5, 300 });
+    }
+    // items written without the appended field read it value-initialized.
+    auto r = f.GetKeepReader();
+    MyCompactLink x = data::Serialization<data::File::KeepReader, MyCompactLink>
+                      ::Deserialize(r);
+    ASSERT_EQ(5u, x.src);
+    ASSERT_EQ(300u, x.tgt);
+    ASSERT_EQ(0, x.weight);
+}
+
+using MyCompactTuple = std::tuple<uint32_t, int64_t, std::string>;
+
+namespace thrill {
+namespace data {
+
+template <>
+struct is_compact_tuple<MyCompactTuple>: public std::true_type { };
+
+} // namespace data
+} // namespace thrill
+
+TEST_F(Serialization, CompactTuple) {
+    MyCompactTuple foo(3, -2, "abc");
+    data::File f(block_pool_, 0, /* dia_id */ 0);
+    {
+        auto w = f.GetWriter();
+        w.Put(foo);
+    }
+    ASSERT_EQ(1u + 1u + 1u + 4u
+              + (data::File::Writer::self_verify ? sizeof(size_t) : 0),
+              f.size_bytes());
+    auto r = f.GetKeepReader();
+    ASSERT_EQ(foo, r.Next<MyCompactTuple>());
+
+    ASSERT_EQ(0u, data::ZigzagEncode(0));
+    ASSERT_EQ(1u, data::ZigzagEncode(-1));
+    ASSERT_EQ(2u, data::ZigzagEncode(1));
+    ASSERT_EQ(std::numeric_limits<int64_t>::min(),
+              data::ZigzagDecode(data::ZigzagEncode(
+                                     std::numeric_limits<int64_t>::min())));
+}
+
 /******************************************************************************/
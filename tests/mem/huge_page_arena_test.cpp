@@ -0,0 +1,179 @@
+/*******************************************************************************
+ * tests/mem/huge_page_arena_test.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/mem/huge_page_arena.hpp>
+
+#include <gtest/gtest.h>
+#include <tlx/die.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace thrill;
+
+TEST(HugePageArena, AllocateDeallocate) {
+    static constexpr size_t slot_size = 64 * 1024;
+    mem::HugePageArena arena(slot_size, 4 * 1024 * 1024, 4);
+
+    std::vector<void*> slots;
+    for (size_t i = 0; i < 100; ++i) {
+        void* ptr = arena.allocate();
+        if (!ptr) return; // no mmap() support on this platform.
+
+        ASSERT_TRUE(arena.contains(ptr));
+        ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(ptr) % 4096);
+        memset(ptr, static_cast<int>(i), slot_size);
+        slots.push_back(ptr);
+    }
+
+    ASSERT_EQ(100u, arena.used_slots());
+    ASSERT_EQ(100u, std::set<void*>(slots.begin(), slots.end()).size());
+
+    // check that slots are not overlapping
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const uint8_t* p = static_cast<const uint8_t*>(slots[i]);
+        ASSERT_EQ(static_cast<uint8_t>(i), p[0]);
+        ASSERT_EQ(static_cast<uint8_t>(i), p[slot_size - 1]);
+    }
+
+    int local = 0;
+    ASSERT_FALSE(arena.contains(&local));
+
+    // free half of the slots and reallocate them
+    for (size_t i = 0; i < 50; ++i)
+        arena.deallocate(slots[i]);
+    ASSERT_EQ(50u, arena.used_slots());
+
+    size_t regions = arena.num_regions();
+    for (size_t i = 0; i < 50; ++i)
+        slots[i] = arena.allocate();
+    ASSERT_EQ(regions, arena.num_regions());
+
+    for (void* ptr : slots)
+        arena.deallocate(ptr);
+    ASSERT_EQ(0u, arena.used_slots());
+}
+
+TEST(HugePageArena, Exhausted) {
+    static constexpr size_t slot_size = 1024 * 1024;
+    mem::HugePageArena arena(slot_size, 2 * slot_size, 2);
+
+    std::vector<void*> slots;
+    for (size_t i = 0; i < 4; ++i) {
+        void* ptr = arena.allocate();
+        if (!ptr) return; // no mmap() support on this platform.
+        slots.push_back(ptr);
+    }
+
+    // arena is full, allocation must fail, also without retrying
+    ASSERT_EQ(nullptr, arena.allocate());
+    ASSERT_TRUE(arena.exhausted());
+    ASSERT_EQ(nullptr, arena.allocate());
+
+    // but freed slots are reused
+    arena.deallocate(slots.back());
+    slots.back() = arena.allocate();
+    ASSERT_NE(nullptr, slots.back());
+
+    for (void* ptr : slots)
+        arena.deallocate(ptr);
+}
+
+TEST(HugePageArena, TrimResident) {
+    static constexpr size_t slot_size = 64 * 1024;
+    mem::HugePageArena arena(slot_size, 4 * 1024 * 1024, 4);
+
+    std::vector<void*> slots;
+    for (size_t i = 0; i < 10; ++i) {
+        void* ptr = arena.allocate();
+        if (!ptr) return; // no mmap() support on this platform.
+        memset(ptr, 1, slot_size);
+        slots.push_back(ptr);
+    }
+
+    // explicit huge page regions are committed in full
+    size_t committed = arena.hugetlb_regions() * arena.region_size();
+    if (committed == 0)
+        ASSERT_EQ(10 * slot_size, arena.resident_bytes());
+    else
+        ASSERT_EQ(committed, arena.resident_bytes());
+    ASSERT_EQ(arena.resident_bytes() - 10 * slot_size, arena.idle_bytes());
+
+    // freed slots stay resident and count as idle until trimmed
+    for (void* ptr : slots)
+        arena.deallocate(ptr);
+    ASSERT_EQ(arena.resident_bytes(), arena.idle_bytes());
+    ASSERT_TRUE(arena.has_resident_free());
+
+    size_t released = arena.Trim();
+    ASSERT_FALSE(arena.has_resident_free() && committed == 0);
+    ASSERT_EQ(0u, arena.releasable_bytes());
+    if (committed != 0) return;
+
+    ASSERT_EQ(10 * slot_size, released);
+    ASSERT_EQ(0u, arena.resident_bytes());
+    ASSERT_EQ(0u, arena.idle_bytes());
+
+    // released slots are reused and zeroed by the kernel
+    size_t regions = arena.num_regions();
+    for (size_t i = 0; i < 10; ++i) {
+        slots[i] = arena.allocate();
+        ASSERT_EQ(0u, static_cast<uint8_t*>(slots[i])[0]);
+    }
+    ASSERT_EQ(regions, arena.num_regions());
+    ASSERT_EQ(10 * slot_size, arena.resident_bytes());
+
+    for (void* ptr : slots)
+        arena.deallocate(ptr);
+}
+
+TEST(HugePageArena, Concurrent) {
+    static constexpr size_t slot_size = 4096;
+    static constexpr size_t num_threads = 8;
+    mem::HugePageArena arena(slot_size, 1024 * slot_size);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back(
+            [&arena, t]() {
+                std::default_random_engine rng(static_cast<unsigned>(t));
+                std::vector<uint64_t*> list;
+                for (size_t i = 0; i < 20000; ++i) {
+                    if (rng() % 2 == 0 || list.empty()) {
+                        uint64_t* ptr = static_cast<uint64_t*>(arena.allocate());
+                        if (!ptr) return;
+                        // mark slot with owner thread and check later
+                        *ptr = t;
+                        list.push_back(ptr);
+                    }
+                    else {
+                        size_t j = rng() % list.size();
+                        die_unequal(*list[j], t);
+                        arena.deallocate(list[j]);
+                        list[j] = list.back();
+                        list.pop_back();
+                    }
+                }
+                for (uint64_t* ptr : list) {
+                    die_unequal(*ptr, t);
+                    arena.deallocate(ptr);
+                }
+            });
+    }
+
+    for (std::thread& t : threads)
+        t.join();
+
+    ASSERT_EQ(0u, arena.used_slots());
+}
+
+/******************************************************************************/
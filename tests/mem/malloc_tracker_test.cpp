@@ -11,6 +11,8 @@
 #include <gtest/gtest.h>
 #include <thrill/mem/malloc_tracker.hpp>
 
+#include <vector>
+
 using namespace thrill;
 
 TEST(MallocTracker, Test1) {
@@ -35,4 +37,35 @@ TEST(MallocTracker, Test1) {
     ASSERT_LE(curr, curr2);
 }
 
+TEST(MallocTracker, ManySmallAllocations) {
+    // in sampling mode (THRILL_MALLOC_SAMPLE) the counters are estimates, hence
+    // only check that a large fraction of the allocated memory is counted.
+    static constexpr size_t num = 1024 * 1024;
+    static constexpr size_t size = 64;
+
+    std::vector<char*> list;
+    list.reserve(num);
+
+    mem::flush_memory_statistics();
+    ssize_t curr = mem::malloc_tracker_current();
+
+    for (size_t i = 0; i < num; ++i) {
+        list.push_back(reinterpret_cast<char*>(malloc(size)));
+        list.back()[0] = 0;
+    }
+
+    mem::flush_memory_statistics();
+    ssize_t curr2 = mem::malloc_tracker_current();
+    ASSERT_GE(curr2 - curr, static_cast<ssize_t>(num * size / 2));
+
+    mem::malloc_tracker_print_sampled_sites(4);
+
+    for (char* a : list)
+        free(a);
+
+    mem::flush_memory_statistics();
+    ASSERT_LT(mem::malloc_tracker_current() - curr,
+              static_cast<ssize_t>(num * size / 2));
+}
+
 /******************************************************************************/
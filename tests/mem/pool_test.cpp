@@ -12,6 +12,7 @@
 
 #include <gtest/gtest.h>
 #include <thrill/common/logger.hpp>
+#include <tlx/die.hpp>
 
 #include <algorithm>
 #include <deque>
@@ -19,6 +20,7 @@
 #include <random>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -186,6 +188,49 @@ TEST(MemPool, UnorderedMap) {
     }
 }
 
+TEST(MemPool, ThreadCache) {
+    static constexpr size_t num_threads = 8;
+    mem::Pool pool(16384, /* thread_cache */ true);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back(
+            [&pool, t]() {
+                std::default_random_engine rng(static_cast<unsigned>(t));
+                std::vector<std::pair<size_t*, size_t> > list;
+                for (size_t i = 0; i < 100000; ++i) {
+                    if (rng() % 2 == 0 || list.empty()) {
+                        size_t size = (rng() % 512) + sizeof(size_t);
+                        size_t* ptr = static_cast<size_t*>(pool.allocate(size));
+                        // mark item with owner thread and check later
+                        *ptr = t;
+                        list.emplace_back(ptr, size);
+                    }
+                    else {
+                        size_t j = rng() % list.size();
+                        die_unequal(*list[j].first, t);
+                        pool.deallocate(list[j].first, list[j].second);
+                        list[j] = list.back();
+                        list.pop_back();
+                    }
+                }
+                for (const std::pair<size_t*, size_t>& p : list) {
+                    die_unequal(*p.first, t);
+                    pool.deallocate(p.first, p.second);
+                }
+            });
+    }
+
+    for (std::thread& t : threads)
+        t.join();
+
+    // items cached by the main thread are returned by the destructor
+    void* ptr = pool.allocate(16);
+    pool.deallocate(ptr, 16);
+
+    pool.self_verify();
+}
+
 namespace thrill {
 namespace mem {
 
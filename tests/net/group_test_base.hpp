@@ -249,6 +249,51 @@ static void TestDispatcherSyncSendAsyncRead(net::Group* net) {
     }
 }
 
+//! send many small messages asynchronously to all other clients, which
+//! dispatchers may coalesce into few send calls, and check their order.
+static void TestDispatcherAsyncWriteMany(net::Group* net) {
+    static constexpr size_t num_messages = 1000;
+
+    size_t received = 0, written = 0;
+    std::unique_ptr<net::Dispatcher> dispatcher = net->ConstructDispatcher();
+
+    for (size_t i = 0; i != net->num_hosts(); ++i)
+    {
+        if (i == net->my_host_rank()) continue;
+
+        for (size_t m = 0; m < num_messages; ++m) {
+            // messages alternate between a header and a payload of size m
+            size_t header[2] = { i, m };
+            dispatcher->AsyncWriteCopy(
+                net->connection(i), /* seq */ 0, header, sizeof(header));
+            dispatcher->AsyncWriteCopy(
+                net->connection(i), /* seq */ 0, std::string(m, char(m)),
+                [&written](net::Connection&) { ++written; });
+
+            dispatcher->AsyncRead(
+                net->connection(i), /* seq */ 0, sizeof(header),
+                [net, m](net::Connection&, net::Buffer&& buffer) {
+                    const size_t* h =
+                        reinterpret_cast<const size_t*>(buffer.data());
+                    ASSERT_EQ(net->my_host_rank(), h[0]);
+                    ASSERT_EQ(m, h[1]);
+                });
+            dispatcher->AsyncRead(
+                net->connection(i), /* seq */ 0, m,
+                [m, &received](net::Connection&, net::Buffer&& buffer) {
+                    ASSERT_EQ(std::string(m, char(m)), buffer.ToString());
+                    ++received;
+                });
+        }
+    }
+
+    size_t expected = (net->num_hosts() - 1) * num_messages;
+    while (received < expected || dispatcher->HasAsyncWrites()) {
+        dispatcher->Dispatch();
+    }
+    ASSERT_EQ(expected, written);
+}
+
 /******************************************************************************/
 // DispatcherThread tests
 
@@ -97,6 +97,9 @@ TEST(MockGroup, AllReduceEliminationString) {
 TEST(MockGroup, DispatcherSyncSendAsyncRead) {
     MockTest(TestDispatcherSyncSendAsyncRead);
 }
+TEST(MockGroup, DispatcherAsyncWriteMany) {
+    MockTest(TestDispatcherAsyncWriteMany);
+}
 TEST(MockGroup, DispatcherLaunchAndTerminate) {
     MockTest(TestDispatcherLaunchAndTerminate);
 }
@@ -87,6 +87,9 @@ TEST(MpiGroup, AllReduceEliminationString) {
 TEST(MpiGroup, DispatcherSyncSendAsyncRead) {
     MpiTest(TestDispatcherSyncSendAsyncRead);
 }
+TEST(MpiGroup, DispatcherAsyncWriteMany) {
+    MpiTest(TestDispatcherAsyncWriteMany);
+}
 TEST(MpiGroup, DispatcherLaunchAndTerminate) {
     MpiTest(TestDispatcherLaunchAndTerminate);
 }
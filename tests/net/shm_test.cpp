@@ -0,0 +1,340 @@
+/*******************************************************************************
+ * tests/net/shm_test.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <thrill/net/dispatcher_thread.hpp>
+#include <thrill/net/shm/dispatcher.hpp>
+#include <thrill/net/shm/group.hpp>
+#include <thrill/net/tcp/group.hpp>
+#include <tlx/die.hpp>
+
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "flow_control_test_base.hpp"
+#include "group_test_base.hpp"
+
+using namespace thrill;      // NOLINT
+
+TEST(ShmRing, WriteReadWrapAround) {
+    const size_t capacity = 4096;
+    std::string name = "/thrill-shm-test-" + std::to_string(::getpid());
+
+    net::shm::Ring reader(
+        net::shm::Segment::Create(
+            name, net::shm::Ring::SegmentSize(capacity)), true);
+    net::shm::Ring writer(net::shm::Segment::Open(name), false);
+    net::shm::Segment::Unlink(name);
+
+    ASSERT_EQ(capacity, writer.writable());
+    ASSERT_EQ(0u, reader.readable());
+
+    // push chunks of odd size through the ring, wrapping around many times.
+    std::vector<uint8_t> in(1000), out(1000);
+    size_t total_in = 0, total_out = 0;
+    for (size_t round = 0; round < 100; ++round) {
+        std::iota(in.begin(), in.end(), static_cast<uint8_t>(round));
+        ASSERT_EQ(in.size(), writer.Write(in.data(), in.size()));
+        total_in += in.size();
+
+        ASSERT_EQ(in.size(), reader.readable());
+        ASSERT_EQ(out.size(), reader.Read(out.data(), out.size()));
+        total_out += out.size();
+        ASSERT_EQ(in, out);
+    }
+    ASSERT_EQ(total_in, total_out);
+
+    // a full ring accepts no more data
+    std::vector<uint8_t> big(2 * capacity, 42);
+    ASSERT_EQ(capacity, writer.Write(big.data(), big.size()));
+    ASSERT_EQ(0u, writer.Write(big.data(), big.size()));
+    ASSERT_EQ(0u, writer.writable());
+
+    ASSERT_EQ(capacity, reader.Read(big.data(), big.size()));
+    ASSERT_EQ(0u, reader.Read(big.data(), big.size()));
+
+    ASSERT_FALSE(reader.closed());
+    writer.Close();
+    ASSERT_TRUE(reader.closed());
+}
+
+TEST(ShmGroup, LargeSyncSendRecvExchange) {
+    // exchange more data than fits into the rings in both directions at once.
+    std::vector<std::unique_ptr<net::shm::Group> > groups =
+        net::shm::Group::ConstructLoopbackMesh(2);
+
+    const size_t size = 4 * net::shm::ring_size + 12345;
+
+    std::function<void(net::shm::Group*)> thread_function =
+        [size](net::shm::Group* net) {
+            size_t peer = 1 - net->my_host_rank();
+            ASSERT_TRUE(net->is_shm(peer));
+
+            std::vector<uint8_t> send(size), recv(size);
+            std::iota(send.begin(), send.end(),
+                      static_cast<uint8_t>(net->my_host_rank()));
+
+            net->connection(peer).SyncSendRecv(
+                send.data(), send.size(), recv.data(), recv.size());
+
+            for (size_t i = 0; i < size; ++i) {
+                ASSERT_EQ(static_cast<uint8_t>(peer + i), recv[i]);
+            }
+        };
+
+    net::ExecuteGroupThreads(groups, thread_function);
+}
+
+static void ShmGroupTest(
+    const std::function<void(net::Group*)>& thread_function) {
+    // execute tests with all peers connected via shared memory
+    net::ExecuteGroupThreads(
+        net::shm::Group::ConstructLoopbackMesh(6),
+        thread_function);
+}
+
+static void HybridGroupTest(
+    const std::function<void(net::Group*)>& thread_function) {
+    // execute tests with two nodes of three peers each
+    net::ExecuteGroupThreads(
+        net::shm::Group::ConstructLoopbackMesh(6, 3),
+        thread_function);
+}
+
+static void RealGroupTest(
+    const std::function<void(net::Group*)>& thread_function) {
+    // upgrade a real TCP mesh: hosts 2i and 2i+1 claim the same host name.
+    const size_t num_hosts = 6;
+    std::vector<std::unique_ptr<net::tcp::Group> > tcp_groups =
+        net::tcp::Group::ConstructLocalRealTCPMesh(num_hosts);
+
+    std::vector<std::unique_ptr<net::shm::Group> > groups(num_hosts);
+    std::vector<std::thread> threads(num_hosts);
+
+    for (size_t i = 0; i < num_hosts; ++i) {
+        threads[i] = std::thread(
+            [i, &tcp_groups, &groups]() {
+                std::vector<std::unique_ptr<net::tcp::Group> > tg;
+                tg.emplace_back(std::move(tcp_groups[i]));
+                groups[i] = std::move(
+                    net::shm::Group::Construct(
+                        std::move(tg), "node" + std::to_string(i / 2))[0]);
+                die_unless(groups[i]->num_shm_peers() == 1);
+            });
+    }
+    for (size_t i = 0; i < num_hosts; ++i)
+        threads[i].join();
+
+    net::ExecuteGroupThreads(groups, thread_function);
+}
+
+/*[[[perl
+  require("tests/net/test_gen.pm");
+  generate_group_tests("ShmGroup", "ShmGroupTest");
+  generate_flow_control_tests("ShmGroup", "ShmGroupTest");
+
+  generate_group_tests("HybridShmGroup", "HybridGroupTest");
+
+  generate_group_tests("RealShmGroup", "RealGroupTest");
+  ]]]*/
+TEST(ShmGroup, NoOperation) {
+    ShmGroupTest(TestNoOperation);
+}
+TEST(ShmGroup, SendRecvCyclic) {
+    ShmGroupTest(TestSendRecvCyclic);
+}
+TEST(ShmGroup, BroadcastIntegral) {
+    ShmGroupTest(TestBroadcastIntegral);
+}
+TEST(ShmGroup, SendReceiveAll2All) {
+    ShmGroupTest(TestSendReceiveAll2All);
+}
+TEST(ShmGroup, PrefixSumHypercube) {
+    ShmGroupTest(TestPrefixSumHypercube);
+}
+TEST(ShmGroup, PrefixSumHypercubeString) {
+    ShmGroupTest(TestPrefixSumHypercubeString);
+}
+TEST(ShmGroup, PrefixSum) {
+    ShmGroupTest(TestPrefixSum);
+}
+TEST(ShmGroup, Broadcast) {
+    ShmGroupTest(TestBroadcast);
+}
+TEST(ShmGroup, Reduce) {
+    ShmGroupTest(TestReduce);
+}
+TEST(ShmGroup, ReduceString) {
+    ShmGroupTest(TestReduceString);
+}
+TEST(ShmGroup, AllReduceString) {
+    ShmGroupTest(TestAllReduceString);
+}
+TEST(ShmGroup, AllReduceHypercubeString) {
+    ShmGroupTest(TestAllReduceHypercubeString);
+}
+TEST(ShmGroup, AllReduceEliminationString) {
+    ShmGroupTest(TestAllReduceEliminationString);
+}
+TEST(ShmGroup, DispatcherSyncSendAsyncRead) {
+    ShmGroupTest(TestDispatcherSyncSendAsyncRead);
+}
+TEST(ShmGroup, DispatcherAsyncWriteMany) {
+    ShmGroupTest(TestDispatcherAsyncWriteMany);
+}
+TEST(ShmGroup, DispatcherLaunchAndTerminate) {
+    ShmGroupTest(TestDispatcherLaunchAndTerminate);
+}
+TEST(ShmGroup, SingleThreadPrefixSum) {
+    ShmGroupTest(TestSingleThreadPrefixSum);
+}
+TEST(ShmGroup, SingleThreadVectorPrefixSum) {
+    ShmGroupTest(TestSingleThreadVectorPrefixSum);
+}
+TEST(ShmGroup, SingleThreadBroadcast) {
+    ShmGroupTest(TestSingleThreadBroadcast);
+}
+TEST(ShmGroup, MultiThreadBroadcast) {
+    ShmGroupTest(TestMultiThreadBroadcast);
+}
+TEST(ShmGroup, MultiThreadReduce) {
+    ShmGroupTest(TestMultiThreadReduce);
+}
+TEST(ShmGroup, SingleThreadAllReduce) {
+    ShmGroupTest(TestSingleThreadAllReduce);
+}
+TEST(ShmGroup, MultiThreadAllReduce) {
+    ShmGroupTest(TestMultiThreadAllReduce);
+}
+TEST(ShmGroup, MultiThreadPrefixSum) {
+    ShmGroupTest(TestMultiThreadPrefixSum);
+}
+TEST(ShmGroup, PredecessorManyItems) {
+    ShmGroupTest(TestPredecessorManyItems);
+}
+TEST(ShmGroup, PredecessorFewItems) {
+    ShmGroupTest(TestPredecessorFewItems);
+}
+TEST(ShmGroup, PredecessorOneItem) {
+    ShmGroupTest(TestPredecessorOneItem);
+}
+TEST(ShmGroup, HardcoreRaceConditionTest) {
+    ShmGroupTest(TestHardcoreRaceConditionTest);
+}
+TEST(ShmGroup, AllGather) {
+    ShmGroupTest(TestAllGather);
+}
+TEST(ShmGroup, AllGatherMultiThreaded) {
+    ShmGroupTest(TestAllGatherMultiThreaded);
+}
+TEST(ShmGroup, AllGatherString) {
+    ShmGroupTest(TestAllGatherString);
+}
+TEST(HybridShmGroup, NoOperation) {
+    HybridGroupTest(TestNoOperation);
+}
+TEST(HybridShmGroup, SendRecvCyclic) {
+    HybridGroupTest(TestSendRecvCyclic);
+}
+TEST(HybridShmGroup, BroadcastIntegral) {
+    HybridGroupTest(TestBroadcastIntegral);
+}
+TEST(HybridShmGroup, SendReceiveAll2All) {
+    HybridGroupTest(TestSendReceiveAll2All);
+}
+TEST(HybridShmGroup, PrefixSumHypercube) {
+    HybridGroupTest(TestPrefixSumHypercube);
+}
+TEST(HybridShmGroup, PrefixSumHypercubeString) {
+    HybridGroupTest(TestPrefixSumHypercubeString);
+}
+TEST(HybridShmGroup, PrefixSum) {
+    HybridGroupTest(TestPrefixSum);
+}
+TEST(HybridShmGroup, Broadcast) {
+    HybridGroupTest(TestBroadcast);
+}
+TEST(HybridShmGroup, Reduce) {
+    HybridGroupTest(TestReduce);
+}
+TEST(HybridShmGroup, ReduceString) {
+    HybridGroupTest(TestReduceString);
+}
+TEST(HybridShmGroup, AllReduceString) {
+    HybridGroupTest(TestAllReduceString);
+}
+TEST(HybridShmGroup, AllReduceHypercubeString) {
+    HybridGroupTest(TestAllReduceHypercubeString);
+}
+TEST(HybridShmGroup, AllReduceEliminationString) {
+    HybridGroupTest(TestAllReduceEliminationString);
+}
+TEST(HybridShmGroup, DispatcherSyncSendAsyncRead) {
+    HybridGroupTest(TestDispatcherSyncSendAsyncRead);
+}
+TEST(HybridShmGroup, DispatcherAsyncWriteMany) {
+    HybridGroupTest(TestDispatcherAsyncWriteMany);
+}
+TEST(HybridShmGroup, DispatcherLaunchAndTerminate) {
+    HybridGroupTest(TestDispatcherLaunchAndTerminate);
+}
+TEST(RealShmGroup, NoOperation) {
+    RealGroupTest(TestNoOperation);
+}
+TEST(RealShmGroup, SendRecvCyclic) {
+    RealGroupTest(TestSendRecvCyclic);
+}
+TEST(RealShmGroup, BroadcastIntegral) {
+    RealGroupTest(TestBroadcastIntegral);
+}
+TEST(RealShmGroup, SendReceiveAll2All) {
+    RealGroupTest(TestSendReceiveAll2All);
+}
+TEST(RealShmGroup, PrefixSumHypercube) {
+    RealGroupTest(TestPrefixSumHypercube);
+}
+TEST(RealShmGroup, PrefixSumHypercubeString) {
+    RealGroupTest(TestPrefixSumHypercubeString);
+}
+TEST(RealShmGroup, PrefixSum) {
+    RealGroupTest(TestPrefixSum);
+}
+TEST(RealShmGroup, Broadcast) {
+    RealGroupTest(TestBroadcast);
+}
+TEST(RealShmGroup, Reduce) {
+    RealGroupTest(TestReduce);
+}
+TEST(RealShmGroup, ReduceString) {
+    RealGroupTest(TestReduceString);
+}
+TEST(RealShmGroup, AllReduceString) {
+    RealGroupTest(TestAllReduceString);
+}
+TEST(RealShmGroup, AllReduceHypercubeString) {
+    RealGroupTest(TestAllReduceHypercubeString);
+}
+TEST(RealShmGroup, AllReduceEliminationString) {
+    RealGroupTest(TestAllReduceEliminationString);
+}
+TEST(RealShmGroup, DispatcherSyncSendAsyncRead) {
+    RealGroupTest(TestDispatcherSyncSendAsyncRead);
+}
+TEST(RealShmGroup, DispatcherAsyncWriteMany) {
+    RealGroupTest(TestDispatcherAsyncWriteMany);
+}
+TEST(RealShmGroup, DispatcherLaunchAndTerminate) {
+    RealGroupTest(TestDispatcherLaunchAndTerminate);
+}
+// [[[end]]]
+
+/******************************************************************************/
@@ -14,6 +14,7 @@
 #include <thrill/net/tcp/group.hpp>
 #include <thrill/net/tcp/select_dispatcher.hpp>
 
+#include <memory>
 #include <random>
 #include <string>
 #include <thread>
@@ -89,6 +90,9 @@ TEST(RealTcpGroup, AllReduceEliminationString) {
 TEST(RealTcpGroup, DispatcherSyncSendAsyncRead) {
     RealGroupTest(TestDispatcherSyncSendAsyncRead);
 }
+TEST(RealTcpGroup, DispatcherAsyncWriteMany) {
+    RealGroupTest(TestDispatcherAsyncWriteMany);
+}
 TEST(RealTcpGroup, DispatcherLaunchAndTerminate) {
     RealGroupTest(TestDispatcherLaunchAndTerminate);
 }
@@ -134,6 +138,9 @@ TEST(LocalTcpGroup, AllReduceEliminationString) {
 TEST(LocalTcpGroup, DispatcherSyncSendAsyncRead) {
     LocalGroupTest(TestDispatcherSyncSendAsyncRead);
 }
+TEST(LocalTcpGroup, DispatcherAsyncWriteMany) {
+    LocalGroupTest(TestDispatcherAsyncWriteMany);
+}
 TEST(LocalTcpGroup, DispatcherLaunchAndTerminate) {
     LocalGroupTest(TestDispatcherLaunchAndTerminate);
 }
@@ -184,4 +191,53 @@ TEST(LocalTcpGroup, AllGatherString) {
 }
 // [[[end]]]
 
+TEST(SelectDispatcher, WriteQueueOfReusedFd) {
+    using net::tcp::Connection;
+    using net::tcp::Socket;
+
+    net::tcp::SelectDispatcher dispatcher;
+
+    // write to c and wait for completion, then read from the peer
+    auto write_read = [&](Connection& c, Connection& peer,
+                          const std::string& msg) {
+                          bool done = false;
+                          dispatcher.AsyncWrite(
+                              c, 0, net::Buffer(msg.data(), msg.size()),
+                              [&](net::Connection&) { done = true; });
+                          while (!done)
+                              dispatcher.DispatchOne(std::chrono::milliseconds(100));
+
+                          std::string out(msg.size(), 0);
+                          peer.SyncRecv(&out[0], out.size());
+                          ASSERT_EQ(msg, out);
+                      };
+
+    auto pair1 = Socket::CreatePair();
+    auto c1 = std::make_unique<Connection>(std::move(pair1.first));
+    Connection peer1(std::move(pair1.second));
+    int fd = c1->GetSocket().fd();
+
+    // a pending write is dropped by Cancel(), then the Connection closes
+    dispatcher.AsyncWrite(*c1, 0, net::Buffer("dropped", 7));
+    dispatcher.Cancel(*c1);
+    c1.reset();
+
+    // the next socket gets the same fd, its writes use the Connection
+    auto pair2 = Socket::CreatePair();
+    auto c2 = std::make_unique<Connection>(std::move(pair2.first));
+    Connection peer2(std::move(pair2.second));
+    ASSERT_EQ(fd, c2->GetSocket().fd());
+    write_read(*c2, peer2, "after cancel");
+
+    // the same without Cancel()
+    c2.reset();
+    auto pair3 = Socket::CreatePair();
+    Connection c3(std::move(pair3.first));
+    Connection peer3(std::move(pair3.second));
+    ASSERT_EQ(fd, c3.GetSocket().fd());
+    write_read(c3, peer3, "after close");
+
+    ASSERT_FALSE(dispatcher.HasAsyncWrites());
+}
+
 /******************************************************************************/
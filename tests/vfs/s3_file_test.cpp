@@ -0,0 +1,533 @@
+/*******************************************************************************
+ * tests/vfs/s3_file_test.cpp
+ *
+ * Tests of s3:// streams against a local S3-compatible stand-in server.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <thrill/common/logger.hpp>
+#include <thrill/common/stats_timer.hpp>
+#include <thrill/net/tcp/socket.hpp>
+#include <thrill/vfs/file_io.hpp>
+
+#include <tlx/die.hpp>
+#include <tlx/string/starts_with.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+
+using namespace thrill;
+
+static constexpr bool debug = false;
+
+/*!
+ * Minimal in-memory S3 stand-in speaking HTTP/1.1 with path-style URIs. It
+ * supports the requests issued by vfs: bucket listing, HEAD, ranged GET and
+ * multipart uploads. Signatures are not checked. Each GET and part upload is
+ * delayed slightly, such that concurrent requests overlap measurably. With a
+ * GET barrier set, GETs are held until that many were served at once.
+ */
+class S3StandIn
+{
+public:
+    explicit S3StandIn(std::chrono::milliseconds delay)
+        : delay_(delay) {
+        listener_ = net::tcp::Socket::Create();
+        die_unless(listener_.bind(net::tcp::SocketAddress("127.0.0.1:0")));
+        die_unless(listener_.listen());
+        thread_ = std::thread([this]() { Accept(); });
+    }
+
+    ~S3StandIn() {
+        ::shutdown(listener_.fd(), SHUT_RDWR);
+        thread_.join();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (net::tcp::Socket* s : sockets_)
+                ::shutdown(s->fd(), SHUT_RDWR);
+        }
+        for (std::thread& t : connections_) t.join();
+    }
+
+    //! host:port for THRILL_S3_HOST
+    std::string host() const {
+        return "127.0.0.1:" + std::to_string(
+            listener_.GetLocalAddress().GetPort());
+    }
+
+    //! contents of a stored object
+    std::string object(const std::string& path) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return objects_[path];
+    }
+
+    //! store an object directly
+    void set_object(const std::string& path, const std::string& data) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        objects_[path] = data;
+    }
+
+    //! hold GETs until num GETs were served concurrently, or a timeout passed.
+    //! Zero disables the barrier.
+    void set_get_barrier(size_t num) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        get_barrier_ = num;
+        cv_.notify_all();
+    }
+
+    //! maximum number of GETs served at the same time
+    size_t max_gets() const { return max_gets_; }
+    //! number of ranged GETs
+    size_t num_gets() const { return num_gets_; }
+    //! maximum number of part uploads served at the same time
+    size_t max_uploads() const { return max_uploads_; }
+    //! number of part uploads
+    size_t num_uploads() const { return num_uploads_; }
+
+private:
+    struct Request {
+        std::string method, path, query, body;
+        std::map<std::string, std::string> headers;
+    };
+
+    std::chrono::milliseconds delay_;
+    net::tcp::Socket listener_;
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    //! number of concurrent GETs to wait for, see set_get_barrier()
+    size_t get_barrier_ = 0;
+    //! objects by /bucket/key
+    std::map<std::string, std::string> objects_;
+    //! multipart uploads: parts by number
+    std::map<std::string, std::map<size_t, std::string> > uploads_;
+    size_t upload_counter_ = 0;
+
+    std::vector<std::thread> connections_;
+    std::vector<net::tcp::Socket*> sockets_;
+
+    std::atomic<size_t> active_gets_ { 0 }, max_gets_ { 0 }, num_gets_ { 0 };
+    std::atomic<size_t> active_uploads_ { 0 }, max_uploads_ { 0 },
+        num_uploads_ { 0 };
+
+    void Accept() {
+        while (true) {
+            net::tcp::Socket s = listener_.accept();
+            if (!s.IsValid()) return;
+            std::unique_lock<std::mutex> lock(mutex_);
+            connections_.emplace_back(
+                [this](net::tcp::Socket s) { Serve(std::move(s)); },
+                std::move(s));
+        }
+    }
+
+    void Serve(net::tcp::Socket s) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            sockets_.push_back(&s);
+        }
+        std::string buffer;
+        Request req;
+        while (ReadRequest(s, buffer, &req))
+            Handle(s, req);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            sockets_.erase(std::find(sockets_.begin(), sockets_.end(), &s));
+        }
+    }
+
+    static std::string Lower(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+        return s;
+    }
+
+    static std::string UrlDecode(const std::string& s) {
+        std::string out;
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '%' && i + 2 < s.size()) {
+                out += static_cast<char>(
+                    std::stoi(s.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            }
+            else {
+                out += s[i];
+            }
+        }
+        return out;
+    }
+
+    //! value of a query parameter, or "" if missing
+    static std::string Query(const Request& req, const std::string& name) {
+        size_t pos = 0;
+        while (pos <= req.query.size()) {
+            size_t end = req.query.find('&', pos);
+            if (end == std::string::npos) end = req.query.size();
+            std::string param = req.query.substr(pos, end - pos);
+            size_t eq = param.find('=');
+            if (param.substr(0, eq) == name)
+                return eq == std::string::npos ? "" :
+                       UrlDecode(param.substr(eq + 1));
+            pos = end + 1;
+        }
+        return std::string();
+    }
+
+    static bool HasQuery(const Request& req, const std::string& name) {
+        return ("&" + req.query + "&").find("&" + name) != std::string::npos;
+    }
+
+    bool ReadRequest(net::tcp::Socket& s, std::string& buffer, Request* req) {
+        char tmp[64 * 1024];
+        size_t header_end;
+        while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t r = s.recv_one(tmp, sizeof(tmp));
+            if (r <= 0) return false;
+            buffer.append(tmp, r);
+        }
+
+        std::string header = buffer.substr(0, header_end);
+        buffer.erase(0, header_end + 4);
+
+        *req = Request();
+        size_t line_end = header.find("\r\n");
+        std::string line = header.substr(0, line_end);
+        size_t sp1 = line.find(' '), sp2 = line.rfind(' ');
+        req->method = line.substr(0, sp1);
+        std::string uri = line.substr(sp1 + 1, sp2 - sp1 - 1);
+        size_t qm = uri.find('?');
+        req->path = UrlDecode(uri.substr(0, qm));
+        if (qm != std::string::npos) req->query = uri.substr(qm + 1);
+
+        while (line_end != std::string::npos) {
+            size_t next = header.find("\r\n", line_end + 2);
+            line = header.substr(line_end + 2, next - line_end - 2);
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                size_t v = line.find_first_not_of(' ', colon + 1);
+                req->headers[Lower(line.substr(0, colon))] =
+                    v == std::string::npos ? "" : line.substr(v);
+            }
+            line_end = next;
+        }
+
+        if (Lower(req->headers["expect"]) == "100-continue")
+            Send(s, "HTTP/1.1 100 Continue\r\n\r\n");
+
+        size_t length = req->headers.count("content-length")
+                        ? std::stoul(req->headers["content-length"]) : 0;
+        while (buffer.size() < length) {
+            ssize_t r = s.recv_one(tmp, sizeof(tmp));
+            if (r <= 0) return false;
+            buffer.append(tmp, r);
+        }
+        req->body = buffer.substr(0, length);
+        buffer.erase(0, length);
+        return true;
+    }
+
+    static void Send(net::tcp::Socket& s, const std::string& data) {
+        s.send(data.data(), data.size(), MSG_NOSIGNAL);
+    }
+
+    static void Respond(net::tcp::Socket& s, const std::string& status,
+                        const std::string& body,
+                        const std::string& headers = std::string(),
+                        bool send_body = true) {
+        Send(s, "HTTP/1.1 " + status + "\r\n"
+             "Content-Length: " + std::to_string(body.size()) + "\r\n"
+             + headers + "\r\n" + (send_body ? body : std::string()));
+    }
+
+    static std::string ETag(const std::string& data) {
+        return "\"" + std::to_string(std::hash<std::string>()(data)) + "\"";
+    }
+
+    static void Count(std::atomic<size_t>& active, std::atomic<size_t>& max) {
+        size_t a = ++active, m = max;
+        while (a > m && !max.compare_exchange_weak(m, a)) { }
+    }
+
+    void Handle(net::tcp::Socket& s, const Request& req) {
+        // path is /bucket or /bucket/key
+        size_t slash = req.path.find('/', 1);
+        std::string bucket = req.path.substr(1, slash - 1);
+        std::string key =
+            slash == std::string::npos ? "" : req.path.substr(slash + 1);
+        std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (req.method == "GET" && key.empty()) {
+            // list bucket
+            std::string prefix = Query(req, "prefix");
+            std::string delimiter = Query(req, "delimiter");
+            std::string contents, common;
+            std::string last_common;
+            for (const auto& obj : objects_) {
+                if (!tlx::starts_with(obj.first, "/" + bucket + "/")) continue;
+                std::string k = obj.first.substr(bucket.size() + 2);
+                if (!tlx::starts_with(k, prefix)) continue;
+                size_t d = delimiter.empty() ? std::string::npos
+                           : k.find(delimiter, prefix.size());
+                if (d != std::string::npos) {
+                    std::string cp = k.substr(0, d + delimiter.size());
+                    if (cp != last_common)
+                        common += "<CommonPrefixes><Prefix>" + cp +
+                                  "</Prefix></CommonPrefixes>";
+                    last_common = cp;
+                    continue;
+                }
+                contents += "<Contents><Key>" + k + "</Key>"
+                            "<LastModified>2017-01-01T00:00:00.000Z"
+                            "</LastModified><ETag>" + ETag(obj.second) +
+                            "</ETag><Size>" + std::to_string(obj.second.size())
+                            + "</Size><StorageClass>STANDARD</StorageClass>"
+                            "</Contents>";
+            }
+            Respond(s, "200 OK",
+                    xml + "<ListBucketResult><Name>" + bucket + "</Name>"
+                    "<Prefix>" + prefix + "</Prefix><IsTruncated>false"
+                    "</IsTruncated>" + contents + common +
+                    "</ListBucketResult>",
+                    "Content-Type: application/xml\r\n");
+        }
+        else if (req.method == "HEAD" || req.method == "GET") {
+            auto it = objects_.find(req.path);
+            if (it == objects_.end()) {
+                Respond(s, "404 Not Found",
+                        xml + "<Error><Code>NoSuchKey</Code></Error>",
+                        "Content-Type: application/xml\r\n",
+                        req.method == "GET");
+                return;
+            }
+            std::string data = it->second;
+            lock.unlock();
+
+            std::string headers = "ETag: " + ETag(data) + "\r\n";
+            if (req.method == "HEAD") {
+                Respond(s, "200 OK", data, headers, false);
+                return;
+            }
+
+            Count(active_gets_, max_gets_);
+            ++num_gets_;
+            lock.lock();
+            cv_.notify_all();
+            cv_.wait_for(lock, std::chrono::seconds(10),
+                         [this]() { return max_gets_ >= get_barrier_; });
+            lock.unlock();
+            std::this_thread::sleep_for(delay_);
+
+            auto range = req.headers.find("range");
+            if (range != req.headers.end()) {
+                // bytes=begin-end, both inclusive
+                std::string r = range->second.substr(6);
+                size_t dash = r.find('-');
+                uint64_t begin = std::stoull(r.substr(0, dash));
+                uint64_t end = dash + 1 < r.size()
+                               ? std::stoull(r.substr(dash + 1)) + 1
+                               : data.size();
+                end = std::min<uint64_t>(end, data.size());
+                headers += "Content-Range: bytes " + std::to_string(begin) +
+                           "-" + std::to_string(end - 1) + "/" +
+                           std::to_string(data.size()) + "\r\n";
+                Respond(s, "206 Partial Content",
+                        data.substr(begin, end - begin), headers);
+            }
+            else {
+                Respond(s, "200 OK", data, headers);
+            }
+            --active_gets_;
+        }
+        else if (req.method == "POST" && HasQuery(req, "uploads")) {
+            std::string upload_id =
+                "upload" + std::to_string(++upload_counter_);
+            uploads_[upload_id];
+            Respond(s, "200 OK",
+                    xml + "<InitiateMultipartUploadResult><Bucket>" + bucket +
+                    "</Bucket><Key>" + key + "</Key><UploadId>" + upload_id +
+                    "</UploadId></InitiateMultipartUploadResult>",
+                    "Content-Type: application/xml\r\n");
+        }
+        else if (req.method == "PUT" && HasQuery(req, "partNumber")) {
+            size_t part = std::stoul(Query(req, "partNumber"));
+            std::string upload_id = Query(req, "uploadId");
+            lock.unlock();
+
+            Count(active_uploads_, max_uploads_);
+            ++num_uploads_;
+            std::this_thread::sleep_for(delay_);
+            --active_uploads_;
+
+            lock.lock();
+            uploads_[upload_id][part] = req.body;
+            Respond(s, "200 OK", "", "ETag: " + ETag(req.body) + "\r\n");
+        }
+        else if (req.method == "POST" && HasQuery(req, "uploadId")) {
+            // assemble the parts listed in the commit message
+            std::map<size_t, std::string>& parts =
+                uploads_[Query(req, "uploadId")];
+            std::string data;
+            size_t pos = 0;
+            while ((pos = req.body.find("<PartNumber>", pos))
+                   != std::string::npos) {
+                size_t part = std::stoul(req.body.substr(pos + 12));
+                size_t etag = req.body.find("<ETag>", pos) + 6;
+                std::string tag = req.body.substr(
+                    etag, req.body.find("</ETag>", etag) - etag);
+                if (!parts.count(part) || ETag(parts[part]) != tag) {
+                    Respond(s, "400 Bad Request",
+                            xml + "<Error><Code>InvalidPart</Code></Error>",
+                            "Content-Type: application/xml\r\n");
+                    return;
+                }
+                data += parts[part];
+                pos = etag;
+            }
+            objects_[req.path] = data;
+            Respond(s, "200 OK",
+                    xml + "<CompleteMultipartUploadResult><Location>" +
+                    req.path + "</Location><Bucket>" + bucket + "</Bucket>"
+                    "<Key>" + key + "</Key><ETag>" + ETag(data) + "</ETag>"
+                    "</CompleteMultipartUploadResult>",
+                    "Content-Type: application/xml\r\n");
+        }
+        else if (req.method == "PUT") {
+            objects_[req.path] = req.body;
+            Respond(s, "200 OK", "", "ETag: " + ETag(req.body) + "\r\n");
+        }
+        else {
+            Respond(s, "400 Bad Request",
+                    xml + "<Error><Code>InvalidRequest</Code></Error>",
+                    "Content-Type: application/xml\r\n");
+        }
+    }
+};
+
+struct S3FileTest : public ::testing::Test {
+    S3FileTest() {
+        setenv("THRILL_S3_HOST", server_.host().c_str(), 1);
+        setenv("THRILL_S3_PROTOCOL", "http", 1);
+        setenv("THRILL_S3_URI_STYLE", "path", 1);
+        setenv("THRILL_S3_KEY", "key", 1);
+        setenv("THRILL_S3_SECRET", "secret", 1);
+        setenv("THRILL_S3_PART_SIZE", "64Ki", 1);
+        setenv("THRILL_S3_CONCURRENCY", "4", 1);
+        vfs::Initialize();
+    }
+
+    ~S3FileTest() {
+        vfs::Deinitialize();
+    }
+
+    S3StandIn server_ { std::chrono::milliseconds(20) };
+
+    static std::string RandomData(size_t size) {
+        std::mt19937 rng(size);
+        std::string data(size, 0);
+        for (char& c : data) c = static_cast<char>(rng());
+        return data;
+    }
+};
+
+TEST_F(S3FileTest, MultipartUpload) {
+    std::string data = RandomData(1024 * 1024 + 12345);
+
+    vfs::WriteStreamPtr ws = vfs::OpenWriteStream("s3://bucket/upload.bin");
+    // write in irregular pieces crossing the part boundaries
+    for (size_t pos = 0, i = 0; pos < data.size(); ++i) {
+        size_t size = std::min((i * 7919) % 50000 + 1, data.size() - pos);
+        ws->write(data.data() + pos, size);
+        pos += size;
+    }
+    ws->close();
+
+    ASSERT_EQ(data, server_.object("/bucket/upload.bin"));
+    ASSERT_EQ((data.size() + 65535) / 65536, server_.num_uploads());
+    ASSERT_LE(server_.max_uploads(), 4u);
+
+    // empty object
+    ws = vfs::OpenWriteStream("s3://bucket/empty.bin");
+    ws->close();
+    ASSERT_EQ("", server_.object("/bucket/empty.bin"));
+}
+
+TEST_F(S3FileTest, RangedParallelRead) {
+    std::string data = RandomData(2 * 1024 * 1024 + 4321);
+    server_.set_object("/bucket/object.bin", data);
+
+    // whole object, GETs are held until two of them are in flight
+    {
+        server_.set_get_barrier(2);
+        common::StatsTimerStart timer;
+        vfs::ReadStreamPtr rs = vfs::OpenReadStream("s3://bucket/object.bin");
+        std::string out;
+        char buffer[10000];
+        ssize_t rb;
+        while ((rb = rs->read(buffer, sizeof(buffer))) > 0)
+            out.append(buffer, rb);
+        rs->close();
+        timer.Stop();
+        server_.set_get_barrier(0);
+
+        ASSERT_EQ(data, out);
+        ASSERT_EQ((data.size() + 65535) / 65536, server_.num_gets());
+        // parts were requested concurrently, otherwise the barrier timed out
+        ASSERT_GT(server_.max_gets(), 1u);
+        ASSERT_LE(server_.max_gets(), 4u);
+
+        sLOG << "S3FileTest: read" << data.size() << "bytes at"
+             << data.size() / timer.SecondsDouble() / 1024 / 1024 << "MiB/s";
+    }
+
+    // ranges inside and across parts
+    std::vector<std::pair<size_t, size_t> > ranges = {
+        { 0, 1 }, { 100, 65536 }, { 65535, 65537 }, { 70000, 500000 },
+        { data.size() - 10, data.size() }
+    };
+    for (const std::pair<size_t, size_t>& r : ranges) {
+        vfs::ReadStreamPtr rs = vfs::OpenReadStream(
+            "s3://bucket/object.bin", common::Range(r.first, r.second));
+        std::string out(r.second - r.first + 1, 0);
+        size_t pos = 0;
+        ssize_t rb;
+        while ((rb = rs->read(&out[pos], std::min<size_t>(
+                                  4096, out.size() - pos))) > 0)
+            pos += rb;
+        ASSERT_EQ(r.second - r.first, pos);
+        out.resize(pos);
+        ASSERT_EQ(data.substr(r.first, r.second - r.first), out);
+    }
+}
+
+TEST_F(S3FileTest, Glob) {
+    server_.set_object("/bucket/dir/a", "aaa");
+    server_.set_object("/bucket/dir/b", "bbbbb");
+    server_.set_object("/bucket/other", "c");
+
+    vfs::FileList fl = vfs::Glob("s3://bucket/dir/", vfs::GlobType::File);
+    ASSERT_EQ(2u, fl.size());
+    ASSERT_EQ("s3://bucket/dir/a", fl[0].path);
+    ASSERT_EQ(3u, fl[0].size);
+    ASSERT_EQ("s3://bucket/dir/b", fl[1].path);
+    ASSERT_EQ(8u, fl.total_size);
+}
+
+/******************************************************************************/
@@ -11,9 +11,12 @@
 #include <thrill/vfs/sys_file.hpp>
 
 #include <gtest/gtest.h>
+#include <thrill/vfs/io_uring.hpp>
 #include <thrill/vfs/temporary_directory.hpp>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 using namespace thrill;
 
@@ -63,4 +66,116 @@ TEST(SysFileTest, WriteReadSingleFile) {
     }
 }
 
+TEST(SysFileTest, WriteAtSingleFile) {
+    vfs::TemporaryDirectory tmpdir;
+    std::string path = tmpdir.get() + "/test.dat";
+
+    ASSERT_TRUE(vfs::SysIsWriteAtSupported(path));
+
+    // create pre-sized file and write two ranges in reverse order
+    {
+        vfs::WriteAtStreamPtr ws = vfs::SysOpenWriteAtStream(
+            path, /* create */ true, 20);
+        ws->write_at("klmnopqrst", 10, 10);
+        ws->close();
+    }
+    {
+        vfs::WriteAtStreamPtr ws = vfs::SysOpenWriteAtStream(
+            path, /* create */ false, 0);
+        ws->write_at("abcdefghij", 10, 0);
+    }
+    ASSERT_TRUE(vfs::SysIsWriteAtSupported(path));
+    {
+        vfs::ReadStreamPtr rs = vfs::SysOpenReadStream(path);
+
+        char buffer[21];
+        ASSERT_EQ(20, rs->read(buffer, 21));
+        buffer[20] = 0;
+        ASSERT_EQ(std::string(buffer), "abcdefghijklmnopqrst");
+    }
+
+    // directories cannot be written at offsets
+    ASSERT_FALSE(vfs::SysIsWriteAtSupported(tmpdir.get()));
+}
+
+TEST(SysFileTest, WriteReadIoUring) {
+#if THRILL_HAVE_IO_URING
+    if (!vfs::IoUring::IsSupported()) return;
+
+    vfs::TemporaryDirectory tmpdir;
+    std::string path = tmpdir.get() + "/test.dat";
+
+    bool use_io_uring = vfs::use_io_uring;
+    vfs::use_io_uring = true;
+
+    // a pattern spanning more buffers than are in flight, with a partial tail
+    std::vector<uint32_t> data(3 * 1024 * 1024 + 12345);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<uint32_t>(i * 2654435761u);
+    const char* bytes = reinterpret_cast<const char*>(data.data());
+    size_t size = data.size() * sizeof(uint32_t);
+
+    {
+        // write in pieces of varying size, some larger than a buffer
+        vfs::WriteStreamPtr ws = vfs::SysOpenWriteStream(path);
+        for (size_t pos = 0, step = 1; pos < size; step = step * 7 + 3) {
+            size_t wb = std::min(step % (3 * 1024 * 1024), size - pos);
+            ASSERT_EQ(static_cast<ssize_t>(wb), ws->write(bytes + pos, wb));
+            pos += wb;
+        }
+        ws->close();
+    }
+    {
+        // read everything in pieces of varying size
+        vfs::ReadStreamPtr rs = vfs::SysOpenReadStream(path);
+        std::vector<char> out(size + 100);
+        size_t pos = 0;
+        for (size_t step = 5; ; step = step * 3 + 1) {
+            ssize_t rb = rs->read(
+                out.data() + pos, std::min<size_t>(
+                    step % (5 * 1024 * 1024), out.size() - pos));
+            ASSERT_GE(rb, 0);
+            if (rb == 0) break;
+            pos += rb;
+        }
+        ASSERT_EQ(size, pos);
+        ASSERT_TRUE(std::equal(bytes, bytes + size, out.begin()));
+    }
+    {
+        // read from an offset into a buffer larger than the remaining file
+        size_t offset = 1024 * 1024 + 17;
+        vfs::ReadStreamPtr rs = vfs::SysOpenReadStream(
+            path, common::Range(offset, 0));
+        std::vector<char> out(size);
+        ASSERT_EQ(static_cast<ssize_t>(size - offset),
+                  rs->read(out.data(), out.size()));
+        ASSERT_TRUE(std::equal(bytes + offset, bytes + size, out.begin()));
+        ASSERT_EQ(0, rs->read(out.data(), out.size()));
+    }
+    {
+        // read a range which ends inside a buffer, it stops at the range end
+        size_t begin = 12345, end = 2 * 1024 * 1024 + 777;
+        vfs::ReadStreamPtr rs = vfs::SysOpenReadStream(
+            path, common::Range(begin, end));
+        std::vector<char> out(size);
+        ASSERT_EQ(static_cast<ssize_t>(end - begin),
+                  rs->read(out.data(), out.size()));
+        ASSERT_TRUE(std::equal(bytes + begin, bytes + end, out.begin()));
+        ASSERT_EQ(0, rs->read(out.data(), out.size()));
+    }
+    {
+        // empty files and reading past the end
+        vfs::SysOpenWriteStream(tmpdir.get() + "/empty.dat")->close();
+        vfs::ReadStreamPtr rs = vfs::SysOpenReadStream(
+            tmpdir.get() + "/empty.dat");
+        char c;
+        ASSERT_EQ(0, rs->read(&c, 1));
+        rs = vfs::SysOpenReadStream(path, common::Range(size + 10, 0));
+        ASSERT_EQ(0, rs->read(&c, 1));
+    }
+
+    vfs::use_io_uring = use_io_uring;
+#endif
+}
+
 /******************************************************************************/
@@ -20,6 +20,7 @@
 #include <thrill/common/string.hpp>
 #include <thrill/common/system_exception.hpp>
 #include <thrill/vfs/file_io.hpp>
+#include <thrill/vfs/sys_file.hpp>
 
 #include <foxxll/io/iostats.hpp>
 #include <tlx/math/abs_diff.hpp>
@@ -36,6 +37,11 @@
 #include <thrill/net/tcp/select_dispatcher.hpp>
 #endif
 
+#if THRILL_HAVE_NET_SHM
+#include <thrill/net/shm/dispatcher.hpp>
+#include <thrill/net/shm/group.hpp>
+#endif
+
 #if THRILL_HAVE_NET_MPI
 #include <thrill/net/mpi/dispatcher.hpp>
 #include <thrill/net/mpi/group.hpp>
@@ -74,6 +80,7 @@
 #include <algorithm>
 #include <csignal>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <thread>
@@ -87,6 +94,70 @@ namespace api {
 /******************************************************************************/
 // Generic Network Construction
 
+//! Determine the number of parallel data connections to each host from
+//! THRILL_NET_STRIPES, returns 0 on errors.
+static inline size_t FindNetStripes() {
+
+    const char* env_stripes = getenv("THRILL_NET_STRIPES");
+    if (env_stripes == nullptr || *env_stripes == 0) return 1;
+
+    char* endptr;
+    size_t stripes = std::strtoul(env_stripes, &endptr, 10);
+
+    if (!endptr || *endptr != 0 || stripes == 0) {
+        std::cerr << "Thrill: environment variable"
+                  << " THRILL_NET_STRIPES=" << env_stripes
+                  << " is not a valid number of data connections."
+                  << std::endl;
+        return 0;
+    }
+
+    return stripes;
+}
+
+//! Determine from THRILL_NET_STRIPE_THREADS whether each additional data
+//! connection is served by its own dispatcher thread (default: yes).
+static inline bool FindNetStripeThreads() {
+
+    const char* env_threads = getenv("THRILL_NET_STRIPE_THREADS");
+    if (env_threads == nullptr || *env_threads == 0) return true;
+
+    return *env_threads != '0';
+}
+
+//! Determine the number of dispatcher threads of each host from
+//! THRILL_NET_DISPATCHERS, returns 0 on errors. The default is one thread per
+//! data stripe if THRILL_NET_STRIPE_THREADS is set, otherwise one.
+static inline size_t FindNetDispatchers(size_t stripes) {
+
+    const char* env_dispatchers = getenv("THRILL_NET_DISPATCHERS");
+    if (env_dispatchers == nullptr || *env_dispatchers == 0)
+        return FindNetStripeThreads() ? stripes : 1;
+
+    char* endptr;
+    size_t dispatchers = std::strtoul(env_dispatchers, &endptr, 10);
+
+    if (!endptr || *endptr != 0 || dispatchers == 0) {
+        std::cerr << "Thrill: environment variable"
+                  << " THRILL_NET_DISPATCHERS=" << env_dispatchers
+                  << " is not a valid number of dispatcher threads."
+                  << std::endl;
+        return 0;
+    }
+
+    return dispatchers;
+}
+
+//! Determine from THRILL_NET_SHM whether connections to hosts on the same
+//! machine use shared memory (default: no).
+static inline bool FindNetShm() {
+
+    const char* env_shm = getenv("THRILL_NET_SHM");
+    if (env_shm == nullptr || *env_shm == 0) return false;
+
+    return *env_shm != '0';
+}
+
 //! Generic network constructor for net backends supporting loopback tests.
 template <typename NetGroup>
 static inline
@@ -97,10 +168,17 @@ ConstructLoopbackHostContexts(
 
     static constexpr size_t kGroupCount = net::Manager::kGroupCount;
 
-    // construct three full mesh loopback cliques, deliver net::Groups.
-    std::array<std::vector<std::unique_ptr<NetGroup> >, kGroupCount> group;
+    size_t stripes = FindNetStripes();
+    die_unless(stripes != 0);
+    size_t dispatchers = FindNetDispatchers(stripes);
+    die_unless(dispatchers != 0);
 
-    for (size_t g = 0; g < kGroupCount; ++g) {
+    // construct full mesh loopback cliques for the groups and additional data
+    // stripes, deliver net::Groups.
+    std::vector<std::vector<std::unique_ptr<NetGroup> > > group(
+        kGroupCount + stripes - 1);
+
+    for (size_t g = 0; g < group.size(); ++g) {
         group[g] = NetGroup::ConstructLoopbackMesh(num_hosts);
     }
 
@@ -116,14 +194,22 @@ ConstructLoopbackHostContexts(
     std::vector<std::unique_ptr<HostContext> > host_context;
 
     for (size_t h = 0; h < num_hosts; h++) {
-        std::array<net::GroupPtr, kGroupCount> host_group = {
-            { std::move(group[0][h]), std::move(group[1][h]) }
-        };
+        std::vector<net::GroupPtr> host_group;
+        for (size_t g = 0; g < group.size(); ++g)
+            host_group.emplace_back(std::move(group[g][h]));
+
+        std::vector<std::unique_ptr<net::DispatcherThread> > io_dispatcher;
+        for (size_t i = 1; i < dispatchers; ++i) {
+            io_dispatcher.emplace_back(
+                std::make_unique<net::DispatcherThread>(
+                    std::make_unique<typename NetGroup::Dispatcher>(), h, i));
+        }
 
         host_context.emplace_back(
             std::make_unique<HostContext>(
                 h, mem_config, std::move(dispatcher[h]),
-                std::move(host_group), workers_per_host));
+                std::move(host_group), workers_per_host,
+                std::move(io_dispatcher)));
     }
 
     return host_context;
@@ -200,6 +286,96 @@ static inline bool SetupBlockSize() {
     return true;
 }
 
+static inline bool SetupBlockArena() {
+
+    const char* env_huge_pages = getenv("THRILL_HUGE_PAGES");
+    if (env_huge_pages == nullptr || *env_huge_pages == 0) return true;
+
+    if (strcmp(env_huge_pages, "0") == 0 ||
+        strcmp(env_huge_pages, "off") == 0) {
+        data::use_block_arena = false;
+    }
+    else if (strcmp(env_huge_pages, "1") == 0 ||
+             strcmp(env_huge_pages, "on") == 0) {
+        data::use_block_arena = true;
+    }
+    else {
+        std::cerr << "Thrill: environment variable"
+                  << " THRILL_HUGE_PAGES=" << env_huge_pages
+                  << " is not a valid switch, use 0/1 or off/on."
+                  << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+static inline bool SetupNetZeroCopy() {
+
+    const char* env_zerocopy = getenv("THRILL_NET_ZEROCOPY");
+    if (env_zerocopy == nullptr || *env_zerocopy == 0) return true;
+
+#if THRILL_HAVE_NET_TCP
+    uint64_t threshold;
+    if (!tlx::parse_si_iec_units(env_zerocopy, &threshold)) {
+        std::cerr << "Thrill: environment variable"
+                  << " THRILL_NET_ZEROCOPY=" << env_zerocopy
+                  << " is not a valid size, use 0 to disable."
+                  << std::endl;
+        return false;
+    }
+
+    net::tcp::zerocopy_threshold = threshold;
+#endif
+
+    return true;
+}
+
+static inline bool SetupNetShmSize() {
+
+    const char* env_size = getenv("THRILL_NET_SHM_SIZE");
+    if (env_size == nullptr || *env_size == 0) return true;
+
+#if THRILL_HAVE_NET_SHM
+    uint64_t size;
+    if (!tlx::parse_si_iec_units(env_size, &size) || size == 0) {
+        std::cerr << "Thrill: environment variable"
+                  << " THRILL_NET_SHM_SIZE=" << env_size
+                  << " is not a valid size."
+                  << std::endl;
+        return false;
+    }
+
+    net::shm::ring_size = size;
+#endif
+
+    return true;
+}
+
+static inline bool SetupIoUring() {
+
+    const char* env_io_uring = getenv("THRILL_IO_URING");
+    if (env_io_uring == nullptr || *env_io_uring == 0) return true;
+
+    if (strcmp(env_io_uring, "0") == 0 ||
+        strcmp(env_io_uring, "off") == 0) {
+        vfs::use_io_uring = false;
+    }
+    else if (strcmp(env_io_uring, "1") == 0 ||
+             strcmp(env_io_uring, "on") == 0) {
+        vfs::use_io_uring = true;
+    }
+    else {
+        std::cerr << "Thrill: environment variable"
+                  << " THRILL_IO_URING=" << env_io_uring
+                  << " is not a valid switch, use 0/1 or off/on."
+                  << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 static inline size_t FindWorkersPerHost(
     const char*& str_workers_per_host, const char*& env_workers_per_host) {
 
@@ -273,6 +449,10 @@ static inline size_t FindWorkersPerHost(
 static inline bool Initialize() {
 
     if (!SetupBlockSize()) return false;
+    if (!SetupBlockArena()) return false;
+    if (!SetupNetZeroCopy()) return false;
+    if (!SetupNetShmSize()) return false;
+    if (!SetupIoUring()) return false;
 
     vfs::Initialize();
 
@@ -576,6 +756,25 @@ int RunBackendTcp(const std::function<void(Context&)>& job_startpoint) {
     if (workers_per_host == 0)
         return -1;
 
+    // determine number of parallel data connections to each host
+
+    size_t stripes = FindNetStripes();
+    if (stripes == 0)
+        return -1;
+
+    size_t dispatchers = FindNetDispatchers(stripes);
+    if (dispatchers == 0)
+        return -1;
+
+    bool use_shm = FindNetShm();
+#if !THRILL_HAVE_NET_SHM
+    if (use_shm) {
+        std::cerr << "Thrill: THRILL_NET_SHM is not supported by this binary,"
+                  << " using tcp connections to local hosts." << std::endl;
+        use_shm = false;
+    }
+#endif
+
     // detect memory config
 
     MemoryConfig mem_config;
@@ -592,30 +791,70 @@ int RunBackendTcp(const std::function<void(Context&)>& job_startpoint) {
         std::cerr << ' ' << ep;
     std::cerr << std::endl;
 
+    if (stripes > 1) {
+        std::cerr << "Thrill: using " << stripes
+                  << " data connections to each host" << std::endl;
+    }
+    if (dispatchers > 1) {
+        std::cerr << "Thrill: sharding data connections across "
+                  << dispatchers << " dispatcher threads" << std::endl;
+    }
+
     if (!Initialize()) return -1;
 
     static constexpr size_t kGroupCount = net::Manager::kGroupCount;
 
-    // construct three TCP network groups
+    // construct TCP network groups, additional ones are data stripes
     auto select_dispatcher = std::make_unique<net::tcp::SelectDispatcher>();
 
-    std::array<std::unique_ptr<net::tcp::Group>, kGroupCount> groups;
+    std::vector<std::unique_ptr<net::tcp::Group> > groups(
+        kGroupCount + stripes - 1);
     net::tcp::Construct(
         *select_dispatcher, my_host_rank, hostlist,
-        groups.data(), net::Manager::kGroupCount);
+        groups.data(), groups.size());
 
-    std::array<net::GroupPtr, kGroupCount> host_groups = {
-        { std::move(groups[0]), std::move(groups[1]) }
-    };
+    std::vector<net::GroupPtr> host_groups;
+    std::unique_ptr<net::Dispatcher> main_dispatcher;
+
+#if THRILL_HAVE_NET_SHM
+    if (use_shm) {
+        // replace connections to hosts on this machine by shared memory
+        std::vector<std::unique_ptr<net::shm::Group> > shm_groups =
+            net::shm::Group::Construct(
+                std::move(groups), common::GetHostname());
+
+        std::cerr << "Thrill: using shared memory to "
+                  << shm_groups[0]->num_shm_peers() << " local hosts"
+                  << std::endl;
+
+        host_groups.assign(std::make_move_iterator(shm_groups.begin()),
+                           std::make_move_iterator(shm_groups.end()));
+        main_dispatcher = std::make_unique<net::shm::Dispatcher>(
+            std::move(select_dispatcher));
+    }
+#endif
+    if (!use_shm) {
+        host_groups.assign(std::make_move_iterator(groups.begin()),
+                           std::make_move_iterator(groups.end()));
+        main_dispatcher = std::move(select_dispatcher);
+    }
 
     // construct HostContext
 
     auto dispatcher = std::make_unique<net::DispatcherThread>(
-        std::move(select_dispatcher), my_host_rank);
+        std::move(main_dispatcher), my_host_rank);
+
+    std::vector<std::unique_ptr<net::DispatcherThread> > io_dispatchers;
+    for (size_t i = 1; i < dispatchers; ++i) {
+        io_dispatchers.emplace_back(
+            std::make_unique<net::DispatcherThread>(
+                host_groups[0]->ConstructDispatcher(), my_host_rank, i));
+    }
 
     HostContext host_context(
         0, mem_config,
-        std::move(dispatcher), std::move(host_groups), workers_per_host);
+        std::move(dispatcher), std::move(host_groups), workers_per_host,
+        std::move(io_dispatchers));
 
     std::vector<std::thread> threads(workers_per_host);
 
@@ -918,6 +1157,15 @@ int Run(const std::function<void(Context&)>& job_startpoint) {
 #endif
     }
 
+    if (strcmp(env_net, "shm") == 0) {
+#if THRILL_HAVE_NET_SHM
+        // shared memory loopback network backend
+        return RunBackendLoopback<net::shm::Group>("shm", job_startpoint);
+#else
+        return RunNotSupported(env_net);
+#endif
+    }
+
     if (strcmp(env_net, "tcp") == 0) {
 #if THRILL_HAVE_NET_TCP
         // real tcp network backend
@@ -1064,6 +1312,19 @@ HostContext::HostContext(
     std::unique_ptr<net::DispatcherThread> dispatcher,
     std::array<net::GroupPtr, net::Manager::kGroupCount>&& groups,
     size_t workers_per_host)
+    : HostContext(local_host_id, mem_config, std::move(dispatcher),
+                  std::vector<net::GroupPtr>(
+                      std::make_move_iterator(groups.begin()),
+                      std::make_move_iterator(groups.end())),
+                  workers_per_host) { }
+
+HostContext::HostContext(
+    size_t local_host_id,
+    const MemoryConfig& mem_config,
+    std::unique_ptr<net::DispatcherThread> dispatcher,
+    std::vector<net::GroupPtr>&& groups,
+    size_t workers_per_host,
+    std::vector<std::unique_ptr<net::DispatcherThread> > io_dispatchers)
     : mem_config_(mem_config),
       base_logger_(MakeHostLogPath(groups[0]->my_host_rank())),
       logger_(&base_logger_, "host_rank", groups[0]->my_host_rank()),
@@ -1071,6 +1332,7 @@ HostContext::HostContext(
       local_host_id_(local_host_id),
       workers_per_host_(workers_per_host),
       dispatcher_(std::move(dispatcher)),
+      io_dispatchers_(std::move(io_dispatchers)),
       net_manager_(std::move(groups), logger_) {
 
     // write command line parameters to json log
@@ -1085,8 +1347,38 @@ HostContext::HostContext(
 }
 
 HostContext::~HostContext() {
-    // stop dispatcher _before_ stopping multiplexer
+    // stop dispatchers _before_ stopping multiplexer
     dispatcher_->Terminate();
+    for (auto& d : io_dispatchers_)
+        d->Terminate();
+}
+
+std::vector<net::Group*> HostContext::data_groups() {
+    std::vector<net::Group*> groups;
+    for (size_t i = 0; i < net_manager_.num_data_groups(); ++i)
+        groups.push_back(&net_manager_.GetDataGroup(i));
+    return groups;
+}
+
+std::vector<net::DispatcherThread*> HostContext::data_dispatchers() {
+    size_t num_groups = net_manager_.num_data_groups();
+    size_t num_hosts = net_manager_.num_hosts();
+    size_t my_rank = net_manager_.my_host_rank();
+    size_t num_threads = 1 + io_dispatchers_.size();
+
+    // shard connections round-robin: first the stripes of a peer, then the
+    // peers, skipping ourself. If there is one thread per stripe, each stripe
+    // is served by its own thread.
+    std::vector<net::DispatcherThread*> dispatchers;
+    for (size_t g = 0; g < num_groups; ++g) {
+        for (size_t p = 0; p < num_hosts; ++p) {
+            size_t remote = p < my_rank ? p : p == my_rank ? 0 : p - 1;
+            size_t t = (g + remote * num_groups) % num_threads;
+            dispatchers.push_back(
+                t == 0 ? dispatcher_.get() : io_dispatchers_[t - 1].get());
+        }
+    }
+    return dispatchers;
 }
 
 std::string HostContext::MakeHostLogPath(size_t host_rank) {
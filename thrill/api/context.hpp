@@ -97,6 +97,18 @@ public:
                 std::array<net::GroupPtr, net::Manager::kGroupCount>&& groups,
                 size_t workers_per_host);
 
+    //! constructor from existing net Groups, the Groups beyond kGroupCount are
+    //! additional data Groups striped by the data Multiplexer. The connections
+    //! of all data Groups are sharded across the main dispatcher and the
+    //! io_dispatchers, if given.
+    HostContext(size_t local_host_id, const MemoryConfig& mem_config,
+                std::unique_ptr<net::DispatcherThread> dispatcher,
+                std::vector<net::GroupPtr>&& groups,
+                size_t workers_per_host,
+                std::vector<std::unique_ptr<net::DispatcherThread> >
+                io_dispatchers =
+                    std::vector<std::unique_ptr<net::DispatcherThread> >());
+
     //! destructor
     ~HostContext();
 
@@ -175,9 +187,20 @@ private:
     //! main host network dispatcher thread backend
     std::unique_ptr<net::DispatcherThread> dispatcher_;
 
+    //! additional dispatcher threads, the data connections are sharded across
+    //! them and dispatcher_.
+    std::vector<std::unique_ptr<net::DispatcherThread> > io_dispatchers_;
+
     //! net manager constructs communication groups to other hosts.
     net::Manager net_manager_;
 
+    //! the data Groups of net_manager_, for the data multiplexer
+    std::vector<net::Group*> data_groups();
+
+    //! the dispatcher thread serving each connection of the data Groups,
+    //! indexed by group * num_hosts + peer.
+    std::vector<net::DispatcherThread*> data_dispatchers();
+
 #if !THRILL_HAVE_THREAD_SANITIZER
     //! register net_manager_'s profiling method
     common::ProfileTaskRegistration net_manager_profiler_ {
@@ -206,7 +229,7 @@ private:
     //! data multiplexer transmits large amounts of data asynchronously.
     data::Multiplexer data_multiplexer_ {
         mem_manager_, block_pool_,
-        *dispatcher_, net_manager_.GetDataGroup(), workers_per_host_
+        data_dispatchers(), data_groups(), workers_per_host_
     };
 };
 
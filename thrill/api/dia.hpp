@@ -670,7 +670,8 @@ public:
 
     /*!
      * WriteLinesOne is an Action, which writes std::strings to a single output
-     * file.
+     * file. Each worker writes its lines directly at its offset in the file, if
+     * the target supports it, otherwise all lines are written by worker 0.
      *
      * \param filepath Destination of the output file.
      *
@@ -763,6 +764,30 @@ public:
         const std::string& filepath,
         size_t max_file_size = 128* 1024* 1024) const;
 
+    /*!
+     * WriteBinaryOne is an Action, which writes a DIA to a single output file
+     * in the format of WriteBinary. Each worker writes its items directly at
+     * its offset in the file, if the target supports it, otherwise all items
+     * are written by worker 0. The DIA can be recreated with ReadBinary.
+     *
+     * \param filepath Destination of the output file.
+     *
+     * \ingroup dia_actions
+     */
+    void WriteBinaryOne(const std::string& filepath) const;
+
+    /*!
+     * WriteBinaryOne is an ActionFuture, which writes a DIA to a single output
+     * file in the format of WriteBinary. Each worker writes its items directly
+     * at its offset in the file, if the target supports it, otherwise all items
+     * are written by worker 0. The DIA can be recreated with ReadBinary.
+     *
+     * \param filepath Destination of the output file.
+     *
+     * \ingroup dia_actions
+     */
+    Future<void> WriteBinaryOneFuture(const std::string& filepath) const;
+
     //! \}
 
     //! \name Distributed Operations (DOps)
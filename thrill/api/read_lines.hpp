@@ -17,6 +17,7 @@
 #include <thrill/api/dia.hpp>
 #include <thrill/api/source_node.hpp>
 #include <thrill/common/defines.hpp>
+#include <thrill/common/functional.hpp>
 #include <thrill/common/logger.hpp>
 #include <thrill/common/string.hpp>
 #include <thrill/common/system_exception.hpp>
@@ -25,6 +26,8 @@
 
 #include <tlx/string/join.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
@@ -57,6 +60,12 @@ public:
         if (filelist_.size() == 0)
             die("ReadLines: no files found in globs: " + tlx::join(' ', globlist));
 
+        // local uncompressed files are read in ranges at offsets
+        ranged_ = !filelist_.contains_compressed &&
+                  !filelist_.contains_remote_uri;
+        for (const vfs::FileInfo& fi : filelist_)
+            ranged_ = ranged_ && vfs::IsReadAtSupported(fi.path);
+
         sLOG << "ReadLines: creating for" << globlist.size() << "globs"
              << "matching" << filelist_.size() << "files";
     }
@@ -67,12 +76,26 @@ public:
     { }
 
     DIAMemUse PushDataMemUse() final {
-        // InputLineIterators read files block-wise
-        return data::default_block_size;
+        // InputLineIterators read files block-wise, or in chunks of two blocks
+        return (ranged_ ? 2 : 1) * data::default_block_size;
     }
 
     void PushData(bool /* consume */) final {
-        if (filelist_.contains_compressed) {
+        // all workers must agree to read ranges, since they exchange the lines
+        // crossing the range boundaries.
+        bool ranged = context_.net.AllReduce(
+            static_cast<size_t>(ranged_), common::minimum<size_t>()) != 0;
+
+        if (ranged) {
+            InputLineIteratorRanged it(
+                filelist_, *this, local_storage_);
+
+            // Hook Read
+            while (it.HasNext()) {
+                this->PushItem(it.Next());
+            }
+        }
+        else if (filelist_.contains_compressed) {
             InputLineIteratorCompressed it(
                 filelist_, *this, local_storage_);
 
@@ -99,6 +122,10 @@ private:
     //! system.
     bool local_storage_;
 
+    //! true, if all files can be read at offsets with
+    //! InputLineIteratorRanged.
+    bool ranged_;
+
     class InputLineIterator
     {
     public:
@@ -157,13 +184,16 @@ private:
         }
 
         ~InputLineIterator() {
+            double read_secs = read_timer.SecondsDouble();
             node_.logger_
                 << "class" << "ReadLinesNode"
                 << "event" << "done"
                 << "total_bytes" << total_bytes_
                 << "total_reads" << total_reads_
                 << "total_lines" << total_elements_
-                << "read_time" << read_timer;
+                << "read_time" << read_timer
+                << "read_throughput"
+                << (read_secs == 0 ? 0.0 : total_bytes_ / read_secs);
         }
     };
 
@@ -292,6 +322,238 @@ private:
         vfs::ReadStreamPtr stream_;
     };
 
+    /*!
+     * InputLineIterator which reads exactly the local byte range of local
+     * uncompressed files, using large aligned read_at() calls.
+     *
+     * Instead of reading past the end of its range to complete the last line,
+     * each worker scans its range backwards for the last line end, and the
+     * trailing partial lines are passed to the succeeding workers via a prefix
+     * sum. A worker's first line is then the received partial line plus the
+     * bytes up to its first line end. A file end terminates a line as well.
+     */
+    class InputLineIteratorRanged : public InputLineIterator
+    {
+    public:
+        //! partial line at the end of a range, and whether the range contains
+        //! a line end.
+        using Carry = std::pair<bool, std::string>;
+
+        //! Creates an instance of iterator that reads file line based
+        InputLineIteratorRanged(const vfs::FileList& files,
+                                ReadLinesNode& node, bool local_storage)
+            : InputLineIterator(files, node) {
+
+            if (local_storage) {
+                my_range_ = node_.context_.CalculateLocalRangeOnHost(
+                    files.total_size);
+            }
+            else {
+                my_range_ = node_.context_.CalculateLocalRange(
+                    files.total_size);
+            }
+
+            assert(my_range_.begin <= my_range_.end);
+
+            Carry tail;
+            if (my_range_.begin < my_range_.end) {
+                file_nr_ = 0;
+                while (files_[file_nr_].size_inc_psum() <= my_range_.begin)
+                    ++file_nr_;
+
+                tail = ReadTail();
+            }
+            else {
+                file_nr_ = files_.size();
+                end_ = my_range_.begin;
+            }
+
+            // collective: receive the partial line of the preceding workers.
+            Carry carry = node_.context_.net.ExPrefixSum(
+                tail, [](const Carry& a, const Carry& b) {
+                    return b.first ? b : Carry(a.first, a.second + b.second);
+                });
+
+            sLOG << "ReadLines: ranged my_range_" << my_range_
+                 << "end_" << end_ << "tail" << tail.second.size()
+                 << "carry" << carry.second.size();
+
+            data_ = std::move(carry.second);
+            chunk_end_ = my_range_.begin;
+            buffer_.Reserve(chunk_size_);
+            current_ = buffer_.begin();
+        }
+
+        //! returns the next element if one exists
+        //!
+        //! does no checks whether a next element exists!
+        const std::string& Next() {
+            total_elements_++;
+            // the first line starts with the carry of preceding workers
+            if (!first_) data_.clear();
+            first_ = false;
+
+            while (true) {
+                unsigned char* end = buffer_.end();
+                if (current_ < end) {
+                    unsigned char* nl = reinterpret_cast<unsigned char*>(
+                        memchr(current_, '\n', end - current_));
+                    if (nl) {
+                        data_.append(reinterpret_cast<char*>(current_),
+                                     reinterpret_cast<char*>(nl));
+                        current_ = nl + 1;
+                        return data_;
+                    }
+                    data_.append(reinterpret_cast<char*>(current_),
+                                 reinterpret_cast<char*>(end));
+                    current_ = end;
+                }
+
+                if (ReadChunk()) continue;
+
+                // end of file: terminates a line without newline
+                LOG << "ReadLines: opening next file";
+                assert(file_nr_ < files_.size());
+                if (reader_) {
+                    reader_->close();
+                    reader_.reset();
+                }
+                ++file_nr_;
+
+                if (!data_.empty()) return data_;
+            }
+        }
+
+        //! returns true, if an element is available in local part
+        bool HasNext() {
+            return chunk_end_ - (buffer_.end() - current_) < end_;
+        }
+
+    private:
+        //! size of the aligned chunks to read
+        const size_t chunk_size_ = 2 * data::default_block_size;
+        //! File handle to files_[file_nr_]
+        vfs::ReadAtStreamPtr reader_;
+        //! global offset after the data in buffer_
+        uint64_t chunk_end_ = 0;
+        //! global offset after the last line end in the local range
+        uint64_t end_ = 0;
+        //! bytes [stash_begin_,end_) which were read by ReadTail()
+        std::string stash_;
+        //! global offset of stash_
+        uint64_t stash_begin_ = 0;
+        //! whether Next() returns the first line
+        bool first_ = true;
+
+        //! read bytes of files_[nr] at offset in the file
+        void ReadAt(size_t nr, void* data, size_t size, uint64_t offset) {
+            if (!reader_)
+                reader_ = vfs::OpenReadAtStream(files_[nr].path);
+            read_timer.Start();
+            size_t rb = reader_->read_at(data, size, offset);
+            read_timer.Stop();
+            if (rb != size) {
+                throw common::SystemException(
+                          "ReadLines: file shrunk while reading "
+                          + files_[nr].path);
+            }
+            total_bytes_ += size;
+            total_reads_++;
+        }
+
+        //! Determine end_ by scanning the local range backwards from its end,
+        //! and return the partial line after it. Bytes before the line end
+        //! in the last read chunk are kept in stash_.
+        Carry ReadTail() {
+            uint64_t b = my_range_.begin, e = my_range_.end;
+
+            // file containing the last byte of the range
+            size_t f = file_nr_;
+            while (files_[f].size_inc_psum() < e) ++f;
+            uint64_t fb = files_[f].size_ex_psum;
+
+            if (files_[f].size_inc_psum() == e) {
+                // the end of the file is a line end
+                end_ = e;
+                return Carry(true, std::string());
+            }
+
+            std::vector<std::string> pieces;
+            uint64_t lo = std::max(b, fb), pos = e;
+            bool found = false;
+
+            while (pos > lo && !found) {
+                // read chunks aligned within the file
+                uint64_t size = (pos - fb - 1) % chunk_size_ + 1;
+                size = std::min(size, pos - lo);
+                pos -= size;
+
+                std::string piece(size, 0);
+                ReadAt(f, &piece[0], size, pos - fb);
+
+                size_t nl = piece.rfind('\n');
+                if (nl != std::string::npos) {
+                    end_ = pos + nl + 1;
+                    stash_begin_ = pos;
+                    stash_ = piece.substr(0, nl + 1);
+                    piece.erase(0, nl + 1);
+                    found = true;
+                }
+                pieces.emplace_back(std::move(piece));
+            }
+
+            if (f != file_nr_) {
+                // the reader is reopened for the first file.
+                reader_->close();
+                reader_.reset();
+            }
+
+            if (!found) {
+                // the end of the preceding file is a line end, if it is in
+                // the range.
+                end_ = fb > b ? fb : b;
+                stash_begin_ = end_;
+                found = (fb > b);
+            }
+
+            Carry tail(found, std::string());
+            for (size_t i = pieces.size(); i != 0; --i)
+                tail.second += pieces[i - 1];
+            return tail;
+        }
+
+        //! read the next aligned chunk of the current file up to end_.
+        //! Returns false at the end of the file.
+        bool ReadChunk() {
+            uint64_t fb = files_.size_ex_psum(file_nr_);
+            uint64_t fe = std::min(files_.size_inc_psum(file_nr_), end_);
+            if (chunk_end_ >= fe) return false;
+
+            if (chunk_end_ == stash_begin_ && !stash_.empty()) {
+                // bytes already read backwards by ReadTail()
+                std::copy(stash_.begin(), stash_.end(), buffer_.data());
+                buffer_.set_size(stash_.size());
+                chunk_end_ += stash_.size();
+                stash_.clear();
+            }
+            else {
+                uint64_t size = chunk_size_ - (chunk_end_ - fb) % chunk_size_;
+                size = std::min(size, fe - chunk_end_);
+                if (!stash_.empty())
+                    size = std::min(size, stash_begin_ - chunk_end_);
+
+                ReadAt(file_nr_, buffer_.data(), size, chunk_end_ - fb);
+                buffer_.set_size(size);
+                chunk_end_ += size;
+            }
+
+            current_ = buffer_.begin();
+            LOG << "ReadLines: read chunk containing " << buffer_.size()
+                << " bytes.";
+            return true;
+        }
+    };
+
     //! InputLineIterator gives you access to lines of a file
     class InputLineIteratorCompressed : public InputLineIterator
     {
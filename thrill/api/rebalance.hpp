@@ -98,8 +98,9 @@ public:
 
     void PushData(bool consume) final {
         auto reader = stream_->GetCatReader(consume);
-        while (reader.HasNext()) {
-            this->PushItem(reader.template Next<ValueType>());
+        data::BatchItemReader<ValueType, decltype(reader)> batch(reader);
+        while (batch.HasNext()) {
+            this->PushItem(batch.Next());
         }
     }
 
@@ -23,6 +23,7 @@
 #include <thrill/common/porting.hpp>
 #include <thrill/core/reduce_by_hash_post_phase.hpp>
 #include <thrill/core/reduce_pre_phase.hpp>
+#include <thrill/core/reduce_shared_pre_phase.hpp>
 #include <tlx/meta/is_std_pair.hpp>
 
 #include <functional>
@@ -80,6 +81,22 @@ private:
     static constexpr bool use_mix_stream_ = ReduceConfig::use_mix_stream_;
     static constexpr bool use_post_thread_ = ReduceConfig::use_post_thread_;
 
+    //! duplicate detection requires the per-worker table.
+    static constexpr bool use_shared_pre_phase_ =
+        ReduceConfig::use_shared_pre_phase_ && !UseDuplicateDetection;
+
+    using PrePhase = typename std::conditional<
+        use_shared_pre_phase_,
+        core::ReduceSharedPrePhase<
+            TableItem, Key, ValueType, KeyExtractor,
+            ReduceFunction, VolatileKey, data::Stream::Writer, ReduceConfig,
+            HashIndexFunction, KeyEqualFunction>,
+        core::ReducePrePhase<
+            TableItem, Key, ValueType, KeyExtractor,
+            ReduceFunction, VolatileKey, data::Stream::Writer, ReduceConfig,
+            HashIndexFunction, KeyEqualFunction, KeyHashFunction,
+            UseDuplicateDetection> >::type;
+
     //! Emitter for PostPhase to push elements to next DIA object.
     class Emitter
     {
@@ -224,11 +241,7 @@ private:
     //! handle to additional thread for post phase
     std::thread thread_;
 
-    core::ReducePrePhase<
-        TableItem, Key, ValueType, KeyExtractor,
-        ReduceFunction, VolatileKey, data::Stream::Writer, ReduceConfig,
-        HashIndexFunction, KeyEqualFunction, KeyHashFunction,
-        UseDuplicateDetection> pre_phase_;
+    PrePhase pre_phase_;
 
     core::ReduceByHashPostPhase<
         TableItem, Key, ValueType, KeyExtractor, ReduceFunction, Emitter,
@@ -23,6 +23,7 @@
 #include <thrill/common/qsort.hpp>
 #include <thrill/common/reservoir_sampling.hpp>
 #include <thrill/core/multiway_merge.hpp>
+#include <thrill/core/parallel_multiway_merge.hpp>
 #include <thrill/data/file.hpp>
 #include <thrill/net/group.hpp>
 
@@ -35,6 +36,7 @@
 #include <functional>
 #include <numeric>
 #include <random>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -253,7 +255,8 @@ public:
 
                 // create new File for merged items
                 files_.emplace_back(context_.GetFile(this));
-                auto writer = files_.back().GetWriter();
+                auto writer = files_.back().GetWriter(
+                    data::BlockSizePolicy::Throughput());
 
                 while (puller.HasNext()) {
                     writer.Put(puller.Next());
@@ -271,23 +274,46 @@ public:
                 << "Start multi-way-merge of" << files_.size() << "files"
                 << "with prefetch" << prefetch;
 
-            // construct output merger of remaining Files
-            std::vector<data::File::Reader> seq;
-            seq.reserve(files_.size());
+            size_t total_items = 0;
+            for (const data::File& f : files_) total_items += f.num_items();
 
-            for (size_t t = 0; t < files_.size(); ++t) {
-                seq.emplace_back(
-                    files_[t].GetReader(consume, /* prefetch */ 0));
+            size_t merge_threads = MergeThreads();
+            if (merge_threads > 1 &&
+                total_items >= merge_threads * parallel_merge_min_items)
+            {
+                // split the runs into key ranges merged by separate threads,
+                // which are collected in order into one File, such that
+                // children see a single PushFile().
+                data::File merged = context_.GetFile(this);
+                core::ParallelMultiwayMerge<ValueType, Stable>(
+                    files_, consume, merge_threads, prefetch,
+                    compare_function_,
+                    [this]() { return context_.GetFile(this); }, merged);
+
+                local_size = merged.num_items();
+                this->PushFile(merged, /* consume */ true);
+
+                if (consume) files_.clear();
             }
+            else {
+                // construct output merger of remaining Files
+                std::vector<data::File::Reader> seq;
+                seq.reserve(files_.size());
+
+                for (size_t t = 0; t < files_.size(); ++t) {
+                    seq.emplace_back(
+                        files_[t].GetReader(consume, /* prefetch */ 0));
+                }
 
-            StartPrefetch(seq, prefetch);
+                StartPrefetch(seq, prefetch);
 
-            auto puller = MakeMultiwayMergeTree(
-                seq.begin(), seq.end(), compare_function_);
+                auto puller = MakeMultiwayMergeTree(
+                    seq.begin(), seq.end(), compare_function_);
 
-            while (puller.HasNext()) {
-                this->PushItem(puller.Next());
-                local_size++;
+                while (puller.HasNext()) {
+                    this->PushItem(puller.Next());
+                    local_size++;
+                }
             }
         }
 
@@ -306,6 +332,24 @@ public:
     }
 
 private:
+    //! minimum number of items per thread for a parallel final merge
+    static constexpr size_t parallel_merge_min_items = 1024 * 1024;
+
+    //! number of threads for the final merge: THRILL_SORT_MERGE_THREADS, or
+    //! the host's cores not used by other workers.
+    size_t MergeThreads() const {
+        const char* env_threads = getenv("THRILL_SORT_MERGE_THREADS");
+        if (env_threads != nullptr && *env_threads != 0) {
+            char* endptr;
+            size_t threads = std::strtoul(env_threads, &endptr, 10);
+            if (endptr && *endptr == 0 && threads != 0)
+                return threads;
+        }
+        return std::max<size_t>(
+            1, std::thread::hardware_concurrency()
+            / context_.workers_per_host());
+    }
+
     //! The comparison function which is applied to two elements.
     CompareFunction compare_function_;
 
@@ -592,6 +636,8 @@ private:
 
         // stream to send samples to process 0 and receive them back
         data::MixStreamPtr sample_stream = context_.GetNewMixStream(this);
+        // few samples are sent: small Blocks reduce latency.
+        sample_stream->set_block_size_policy(data::BlockSizePolicy::Latency());
 
         // Send all samples to worker 0.
         data::MixStream::Writers sample_writers = sample_stream->GetWriters();
@@ -704,9 +750,14 @@ private:
         std::vector<ValueType> vec;
         vec.reserve(capacity);
 
+        // raw items are read in batches, others one at a time.
+        using BatchReader = data::BatchItemReader<ValueType, decltype(reader)>;
+
         while (reader.HasNext()) {
             if (!mem::memory_exceeded && vec.size() < capacity) {
-                vec.push_back(reader.template Next<ValueType>());
+                reader.ReadMany(
+                    vec, std::min(capacity - vec.size(),
+                                  size_t(BatchReader::batch_size)));
             }
             else {
                 SortAndWriteToFile(vec);
@@ -744,11 +795,11 @@ private:
         Timer write_time;
         write_time.Start();
 
+        // sorted runs are likely spilled to disk: use large Blocks only.
         files_.emplace_back(context_.GetFile(this));
-        auto writer = files_.back().GetWriter();
-        for (const ValueType& elem : vec) {
-            writer.Put(elem);
-        }
+        auto writer = files_.back().GetWriter(
+            data::BlockSizePolicy::Throughput());
+        writer.PutMany(vec);
         writer.Close();
 
         write_time.Stop();
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace thrill {
@@ -71,30 +72,13 @@ public:
     //! writer preop: put item into file, create files as needed.
     void PreOp(const ValueType& input) {
         stats_total_elements_++;
-
-        if (!writer_) OpenNextFile();
-
-        try {
-            writer_->PutNoSelfVerify(input);
-        }
-        catch (data::FullException&) {
-            // sink is full. flush it. and repeat, which opens new file.
-            OpenNextFile();
-
-            try {
-                writer_->PutNoSelfVerify(input);
-            }
-            catch (data::FullException&) {
-                throw std::runtime_error(
-                          "Error in WriteBinary: "
-                          "an item is larger than the file size limit");
-            }
-        }
+        PutItem(input, std::integral_constant<bool, batched>());
     }
 
     //! Closes the output file
     void StopPreOp(size_t /* parent_index */) final {
         sLOG << "closing file" << out_pathbase_;
+        FlushBatch(std::integral_constant<bool, batched>());
         writer_.reset();
 
         Super::logger_
@@ -168,6 +152,77 @@ private:
     size_t stats_total_elements_ = 0;
     size_t stats_total_writes_ = 0;
 
+    //! whether items are serialized as raw bytes and written in batches
+    static constexpr bool batched =
+        data::is_raw_serializable<ValueType>::value
+        && !std::is_same<ValueType, bool>::value;
+
+    //! number of items collected before writing them with PutMany()
+    static constexpr size_t batch_size =
+        batched ? std::max<size_t>(1, 16384 / sizeof(ValueType)) : 1;
+
+    //! batch of raw items not yet written
+    std::vector<ValueType> batch_;
+
+    //! put raw item into batch, write batch if it is full.
+    void PutItem(const ValueType& input, std::true_type) {
+        batch_.push_back(input);
+        if (batch_.size() >= batch_size)
+            FlushBatch(std::true_type());
+    }
+
+    //! put other items individually
+    void PutItem(const ValueType& input, std::false_type) {
+        if (!writer_) OpenNextFile();
+
+        try {
+            writer_->PutNoSelfVerify(input);
+        }
+        catch (data::FullException&) {
+            // sink is full. flush it. and repeat, which opens new file.
+            OpenNextFile();
+
+            try {
+                writer_->PutNoSelfVerify(input);
+            }
+            catch (data::FullException&) {
+                throw std::runtime_error(
+                          "Error in WriteBinary: "
+                          "an item is larger than the file size limit");
+            }
+        }
+    }
+
+    //! write batch of raw items, open new files when the current is full.
+    void FlushBatch(std::true_type) {
+        size_t done = 0;
+        while (done < batch_.size()) {
+            if (!writer_) OpenNextFile();
+
+            size_t n = writer_->PutManyNoSelfVerify(
+                batch_.data() + done, batch_.size() - done);
+
+            if (n == 0) {
+                // sink is full. flush it. and repeat, which opens new file.
+                OpenNextFile();
+
+                n = writer_->PutManyNoSelfVerify(
+                    batch_.data() + done, batch_.size() - done);
+
+                if (n == 0) {
+                    throw std::runtime_error(
+                              "Error in WriteBinary: "
+                              "an item is larger than the file size limit");
+                }
+            }
+            done += n;
+        }
+        batch_.clear();
+    }
+
+    //! no batch for other items
+    void FlushBatch(std::false_type) { }
+
     //! Function to create sink_ and writer_ for next file
     void OpenNextFile() {
         writer_.reset();
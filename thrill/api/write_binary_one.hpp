@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * thrill/api/write_binary_one.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_API_WRITE_BINARY_ONE_HEADER
+#define THRILL_API_WRITE_BINARY_ONE_HEADER
+
+#include <thrill/api/action_node.hpp>
+#include <thrill/api/dia.hpp>
+#include <thrill/api/write_shared_file.hpp>
+#include <thrill/data/file.hpp>
+
+#include <string>
+
+namespace thrill {
+namespace api {
+
+/*!
+ * \ingroup api_layer
+ */
+template <typename ValueType>
+class WriteBinaryOneNode final : public ActionNode
+{
+    static constexpr bool debug = false;
+
+public:
+    using Super = ActionNode;
+    using Super::context_;
+
+    template <typename ParentDIA>
+    WriteBinaryOneNode(const ParentDIA& parent,
+                       const std::string& path_out)
+        : ActionNode(parent.ctx(), "WriteBinaryOne",
+                     { parent.id() }, { parent.node() }),
+          path_out_(path_out) {
+        sLOG << "Creating write node.";
+
+        auto pre_op_fn = [this](const ValueType& input) {
+                             PreOp(input);
+                         };
+        // close the function stack with our pre op and register it at parent
+        // node for output
+        auto lop_chain = parent.stack().push(pre_op_fn).fold();
+        parent.node()->AddChild(this, lop_chain);
+    }
+
+    //! serialize items into the temporary File in the format of WriteBinary
+    void PreOp(const ValueType& input) {
+        writer_.PutNoSelfVerify(input);
+        stats_total_elements_++;
+    }
+
+    void StopPreOp(size_t /* parent_index */) final {
+        writer_.Close();
+    }
+
+    //! Writes the items of all workers into the output file at their offsets
+    void Execute() final {
+        Super::logger_
+            << "class" << "WriteBinaryOneNode"
+            << "total_bytes" << temp_file_.size_bytes()
+            << "total_elements" << stats_total_elements_;
+
+        WriteSharedFile(context_, Super::dia_id(), temp_file_, path_out_);
+    }
+
+private:
+    //! Path of the output file.
+    std::string path_out_;
+
+    //! Temporary File containing the serialized items
+    data::File temp_file_ { context_.GetFile(this) };
+
+    //! File writer used.
+    data::File::Writer writer_ { temp_file_.GetWriter() };
+
+    size_t stats_total_elements_ = 0;
+};
+
+template <typename ValueType, typename Stack>
+void DIA<ValueType, Stack>::WriteBinaryOne(
+    const std::string& filepath) const {
+    assert(IsValid());
+
+    using WriteBinaryOneNode = api::WriteBinaryOneNode<ValueType>;
+
+    auto node = tlx::make_counting<WriteBinaryOneNode>(*this, filepath);
+
+    node->RunScope();
+}
+
+template <typename ValueType, typename Stack>
+Future<void> DIA<ValueType, Stack>::WriteBinaryOneFuture(
+    const std::string& filepath) const {
+    assert(IsValid());
+
+    using WriteBinaryOneNode = api::WriteBinaryOneNode<ValueType>;
+
+    auto node = tlx::make_counting<WriteBinaryOneNode>(*this, filepath);
+
+    return Future<void>(node);
+}
+
+} // namespace api
+} // namespace thrill
+
+#endif // !THRILL_API_WRITE_BINARY_ONE_HEADER
+
+/******************************************************************************/
@@ -16,9 +16,9 @@
 
 #include <thrill/api/action_node.hpp>
 #include <thrill/api/dia.hpp>
+#include <thrill/api/write_shared_file.hpp>
 #include <thrill/data/file.hpp>
 
-#include <fstream>
 #include <string>
 
 namespace thrill {
@@ -41,8 +41,7 @@ public:
                       const std::string& path_out)
         : ActionNode(parent.ctx(), "WriteLinesOne",
                      { parent.id() }, { parent.node() }),
-          path_out_(path_out),
-          file_(path_out_, std::ios::binary) {
+          path_out_(path_out) {
         sLOG << "Creating write node.";
 
         auto pre_op_fn = [this](const ValueType& input) {
@@ -54,8 +53,9 @@ public:
         parent.node()->AddChild(this, lop_chain);
     }
 
+    //! collect the raw bytes of the lines in the temporary File
     void PreOp(const ValueType& input) {
-        writer_.Put(input);
+        writer_.Append(input).PutByte('\n');
         local_size_ += input.size() + 1;
         local_lines_++;
     }
@@ -64,41 +64,24 @@ public:
         writer_.Close();
     }
 
-    //! Closes the output file
+    //! Writes the lines of all workers into the output file at their offsets
     void Execute() final {
         Super::logger_
             << "class" << "WriteLinesOneNode"
             << "total_bytes" << local_size_
             << "total_lines" << local_lines_;
 
-        // (Portable) allocation of output file, setting individual file pointers.
-        size_t prefix_elem = context_.net.ExPrefixSum(local_size_);
-        if (context_.my_rank() == context_.num_workers() - 1) {
-            file_.seekp(prefix_elem + local_size_ - 1);
-            file_.put('\0');
-        }
-        file_.seekp(prefix_elem);
-        context_.net.Barrier();
-
-        data::File::ConsumeReader reader = temp_file_.GetConsumeReader();
-        size_t num_items = temp_file_.num_items();
-
-        for (size_t i = 0; i < num_items; ++i) {
-            file_ << reader.Next<ValueType>() << '\n';
-        }
+        WriteSharedFile(context_, Super::dia_id(), temp_file_, path_out_);
     }
 
 private:
     //! Path of the output file.
     std::string path_out_;
 
-    //! File to write to
-    std::ofstream file_;
-
     //! Local file size
     size_t local_size_ = 0;
 
-    //! Temporary File for splitting correctly?
+    //! Temporary File containing the lines to write
     data::File temp_file_ { context_.GetFile(this) };
 
     //! File writer used.
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * thrill/api/write_shared_file.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/api/write_shared_file.hpp>
+
+#include <thrill/common/logger.hpp>
+#include <thrill/data/cat_stream.hpp>
+#include <thrill/vfs/file_io.hpp>
+
+#include <string>
+
+namespace thrill {
+namespace api {
+
+void WriteSharedFile(Context& ctx, size_t dia_id,
+                     data::File& file, const std::string& path) {
+    static constexpr bool debug = false;
+
+    size_t local_size = file.size_bytes();
+    size_t offset = local_size;
+    size_t total_size = ctx.net.ExPrefixSumTotal(offset);
+
+    // worker 0 checks whether the target can be written at offsets, and if so
+    // creates it with its final size before the others open it.
+    vfs::WriteAtStreamPtr stream;
+    bool write_at = false;
+    if (ctx.my_rank() == 0 && vfs::IsWriteAtSupported(path)) {
+        stream = vfs::OpenWriteAtStream(path, /* create */ true, total_size);
+        write_at = true;
+    }
+    write_at = ctx.net.Broadcast(write_at);
+
+    sLOG << "WriteSharedFile() path" << path << "write_at" << write_at
+         << "offset" << offset << "local_size" << local_size
+         << "total_size" << total_size;
+
+    if (write_at) {
+        if (!stream && local_size != 0)
+            stream = vfs::OpenWriteAtStream(path, /* create */ false);
+
+        for (size_t i = 0; i < file.num_blocks(); ++i) {
+            data::PinnedBlock b = file.block(i).PinWait(ctx.local_worker_id());
+            stream->write_at(b.data_begin(), b.size(), offset);
+            offset += b.size();
+        }
+        file.Clear();
+
+        if (stream) stream->close();
+
+        // the file is complete once the action returns on any worker.
+        ctx.net.Barrier();
+        return;
+    }
+
+    // fallback for non-seekable targets: send all bytes to worker 0, which
+    // receives them in order of the workers' ranks.
+    data::CatStreamPtr cat_stream = ctx.GetNewCatStream(dia_id);
+    data::CatStream::Writers writers = cat_stream->GetWriters();
+    for (size_t w = 1; w < writers.size(); ++w)
+        writers[w].Close();
+
+    for (size_t i = 0; i < file.num_blocks(); ++i) {
+        data::PinnedBlock b = file.block(i).PinWait(ctx.local_worker_id());
+        writers[0].Put(std::string(
+                           reinterpret_cast<const char*>(b.data_begin()),
+                           b.size()));
+    }
+    file.Clear();
+    writers[0].Close();
+
+    vfs::WriteStreamPtr out;
+    if (ctx.my_rank() == 0)
+        out = vfs::OpenWriteStream(path);
+
+    data::CatStream::CatReader reader =
+        cat_stream->GetCatReader(/* consume */ true);
+    while (reader.HasNext()) {
+        std::string data = reader.Next<std::string>();
+        out->write(data.data(), data.size());
+    }
+
+    if (out) out->close();
+    cat_stream.reset();
+
+    ctx.net.Barrier();
+}
+
+} // namespace api
+} // namespace thrill
+
+/******************************************************************************/
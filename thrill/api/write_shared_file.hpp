@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * thrill/api/write_shared_file.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_API_WRITE_SHARED_FILE_HEADER
+#define THRILL_API_WRITE_SHARED_FILE_HEADER
+
+#include <thrill/api/context.hpp>
+#include <thrill/data/file.hpp>
+
+#include <string>
+
+namespace thrill {
+namespace api {
+
+/*!
+ * Collectively write the raw bytes of each worker's File into the single output
+ * file at path, concatenated in the order of the workers' ranks. The File is
+ * consumed.
+ *
+ * If the target supports writing at offsets (see vfs::IsWriteAtSupported()),
+ * worker 0 creates the file with its final size, and each worker writes its
+ * bytes in parallel at the offset calculated by a prefix sum over the local
+ * sizes. Otherwise, e.g. for compressed files or remote uris, the bytes are
+ * sent to worker 0 which writes the file sequentially.
+ *
+ * \param ctx Context of the worker.
+ *
+ * \param dia_id Id of the calling DIANode, used for the fallback stream.
+ *
+ * \param file File containing the raw bytes to write.
+ *
+ * \param path Path of the output file.
+ */
+void WriteSharedFile(Context& ctx, size_t dia_id,
+                     data::File& file, const std::string& path);
+
+} // namespace api
+} // namespace thrill
+
+#endif // !THRILL_API_WRITE_SHARED_FILE_HEADER
+
+/******************************************************************************/
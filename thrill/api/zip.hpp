@@ -32,6 +32,7 @@
 #include <array>
 #include <functional>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace thrill {
@@ -350,49 +351,62 @@ private:
             });
     }
 
-    //! Access CatReaders for different different parents.
+    //! tuple of BatchItemReaders, one for each argument of the ZipFunction
+    template <typename Reader, typename ArgsTuple>
+    struct BatchReaderTuple;
+
+    template <typename Reader, typename... Args>
+    struct BatchReaderTuple<Reader, std::tuple<Args...> > {
+        using type = std::tuple<data::BatchItemReader<Args, Reader>...>;
+    };
+
+    //! Access CatReaders for different different parents. Items are read in
+    //! batches via BatchItemReader, which copies raw items as whole runs.
     template <typename Reader>
     class ReaderNext
     {
     public:
         ReaderNext(ZipNode& zip_node,
                    std::array<Reader, kNumInputs>& readers)
-            : zip_node_(zip_node), readers_(readers) { }
+            : ReaderNext(zip_node, readers,
+                         std::make_index_sequence<kNumInputs>()) { }
 
         //! helper for PushData() which checks all inputs
         bool HasNext() {
-            if (Pad) {
-                for (size_t i = 0; i < kNumInputs; ++i) {
-                    if (readers_[i].HasNext()) return true;
-                }
-                return false;
-            }
-            else {
-                for (size_t i = 0; i < kNumInputs; ++i) {
-                    if (!readers_[i].HasNext()) return false;
-                }
-                return true;
-            }
+            bool any = false, all = true;
+            tlx::call_for_range<kNumInputs>(
+                [this, &any, &all](auto index) {
+                    bool has_next =
+                        std::get<decltype(index)::index>(readers_).HasNext();
+                    any = any || has_next;
+                    all = all && has_next;
+                });
+            return Pad ? any : all;
         }
 
         template <typename Index>
         auto operator () (const Index&) {
 
-            // get the ZipFunction's argument for this index
-            using ZipArg = ZipArgN<Index::index>;
+            auto& reader = std::get<Index::index>(readers_);
 
-            if (Pad && !readers_[Index::index].HasNext()) {
+            if (Pad && !reader.HasNext()) {
                 // take padding_ if next is not available.
                 return std::get<Index::index>(zip_node_.padding_);
             }
-            return readers_[Index::index].template Next<ZipArg>();
+            return reader.Next();
         }
 
     private:
         ZipNode& zip_node_;
 
-        //! reference to the reader array in PushData().
-        std::array<Reader, kNumInputs>& readers_;
+        //! batch readers on the reader array in PushData().
+        typename BatchReaderTuple<Reader, ZipArgsTuple>::type readers_;
+
+        template <size_t... Is>
+        ReaderNext(ZipNode& zip_node,
+                   std::array<Reader, kNumInputs>& readers,
+                   std::index_sequence<Is...>)
+            : zip_node_(zip_node), readers_(std::get<Is>(readers) ...) { }
     };
 };
 
@@ -51,6 +51,16 @@ static constexpr bool g_debug_push_file = false;
 #define THRILL_HAVE_LINUXAIO_FILE 1
 #endif
 
+#if __linux__ && THRILL_HAVE_NET_TCP
+#define THRILL_HAVE_NET_SHM 1
+#endif
+
+#if __linux__ && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define THRILL_HAVE_IO_URING 1
+#endif
+#endif
+
 #if defined(_MSC_VER)
 #define THRILL_WINDOWS 1
 #define THRILL_MSVC 1
@@ -60,6 +70,11 @@ static constexpr bool g_debug_push_file = false;
 #define THRILL_HAVE_MMAP_FILE 1
 #endif
 
+// MSVC doesn't define __SSE2__, but it is always available on x86-64 // NOLINT
+#if defined(__SSE2__) || defined(_M_X64) || defined(__AVX__)
+#define THRILL_HAVE_SSE2
+#endif
+
 // MSVC doesn't define __SSE4_1__, so also check for __AVX__ // NOLINT
 #if defined(__SSE4_1__) || defined(__AVX__)
 #define THRILL_HAVE_SSE4_1
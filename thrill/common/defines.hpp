@@ -54,6 +54,15 @@ template <typename T>
 using is_trivially_copyable = std::is_trivially_copyable<T>;
 #endif
 
+/******************************************************************************/
+// software prefetch of a cache line which is about to be written
+
+#if defined(__GNUC__) || defined(__clang__)
+#define THRILL_PREFETCH_WRITE(addr) __builtin_prefetch((addr), 1)
+#else
+#define THRILL_PREFETCH_WRITE(addr) ((void)(addr))
+#endif
+
 } // namespace common
 } // namespace thrill
 
@@ -17,6 +17,7 @@
 #define THRILL_COMMON_STRING_VIEW_HEADER
 
 #include <algorithm>
+#include <cstring>
 #include <ostream>
 #include <string>
 
@@ -115,6 +116,39 @@ public:
         return !(operator == (other));
     }
 
+    //! Three-way lexicographical comparison with another StringView, which
+    //! orders like std::string::compare().
+    int compare(const StringView& other) const noexcept {
+        size_t n = std::min(size_, other.size_);
+        int r = n == 0 ? 0 : std::memcmp(data_, other.data_, n);
+        if (r != 0) return r;
+        return size_ < other.size_ ? -1 : size_ > other.size_ ? 1 : 0;
+    }
+
+    //! Less operator to compare a StringView with another StringView
+    //! lexicographically
+    bool operator < (const StringView& other) const noexcept {
+        return compare(other) < 0;
+    }
+
+    //! Greater operator to compare a StringView with another StringView
+    //! lexicographically
+    bool operator > (const StringView& other) const noexcept {
+        return other < *this;
+    }
+
+    //! Less-or-equal operator to compare a StringView with another StringView
+    //! lexicographically
+    bool operator <= (const StringView& other) const noexcept {
+        return !(other < *this);
+    }
+
+    //! Greater-or-equal operator to compare a StringView with another
+    //! StringView lexicographically
+    bool operator >= (const StringView& other) const noexcept {
+        return !(*this < other);
+    }
+
     //! make StringView ostreamable
     friend std::ostream& operator << (std::ostream& os, const StringView& sv) {
         return os.write(sv.data(), sv.size());
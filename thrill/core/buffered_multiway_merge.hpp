@@ -12,9 +12,12 @@
 #ifndef THRILL_CORE_BUFFERED_MULTIWAY_MERGE_HEADER
 #define THRILL_CORE_BUFFERED_MULTIWAY_MERGE_HEADER
 
+#include <thrill/core/lcp_loser_tree.hpp>
+
 #include <tlx/container/loser_tree.hpp>
 
 #include <algorithm>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -27,8 +30,12 @@ class BufferedMultiwayMergeTree
 public:
     using Reader = typename std::iterator_traits<ReaderIterator>::value_type;
 
-    using LoserTreeType = tlx::LoserTree<
-        /* stable */ false, ValueType, Comparator>;
+    //! whether the merge uses the LcpStringLoserTree
+    static constexpr bool use_lcp = is_lcp_mergeable<ValueType, Comparator>::value;
+
+    using LoserTreeType = typename std::conditional<
+        use_lcp, LcpStringLoserTree</* stable */ false>,
+        tlx::LoserTree</* stable */ false, ValueType, Comparator> >::type;
 
     BufferedMultiwayMergeTree(ReaderIterator readers_begin, ReaderIterator readers_end,
                               const Comparator& comp)
@@ -69,13 +76,12 @@ public:
 
         if (TLX_LIKELY(readers_[top].HasNext())) {
             current_[top].first = true;
-            current_[top].second = readers_[top].template Next<ValueType>();
-            lt_.delete_min_insert(&current_[top].second, false);
+            Refill(top, std::integral_constant<bool, use_lcp>());
             return true;
         }
         else {
             current_[top].first = false;
-            lt_.delete_min_insert(nullptr, true);
+            Exhaust(std::integral_constant<bool, use_lcp>());
             assert(remaining_inputs_ > 0);
             --remaining_inputs_;
             return (remaining_inputs_ > 0);
@@ -90,6 +96,30 @@ private:
     LoserTreeType lt_;
     //! current values in each input (exist flag, value)
     std::vector<std::pair<bool, ValueType> > current_;
+
+    //! replace the current value of input top by its next one.
+    void Refill(unsigned top, std::false_type) {
+        current_[top].second = readers_[top].template Next<ValueType>();
+        lt_.delete_min_insert(&current_[top].second, false);
+    }
+
+    //! replace the current string of input top by its next one, passing their
+    //! LCP to the LcpStringLoserTree.
+    void Refill(unsigned top, std::true_type) {
+        ValueType next = readers_[top].template Next<ValueType>();
+        size_t lcp = CalcStringLcp(current_[top].second, next);
+        current_[top].second = std::move(next);
+        lt_.delete_min_insert(&current_[top].second, false, lcp);
+    }
+
+    //! remove the exhausted input from the loser tree.
+    void Exhaust(std::false_type) {
+        lt_.delete_min_insert(nullptr, true);
+    }
+
+    void Exhaust(std::true_type) {
+        lt_.delete_min_insert(nullptr, true, 0);
+    }
 };
 
 /*!
@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * thrill/core/lcp_loser_tree.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_LCP_LOSER_TREE_HEADER
+#define THRILL_CORE_LCP_LOSER_TREE_HEADER
+
+#include <tlx/math/round_to_power_of_two.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+//! Calculate the longest common prefix of two strings
+static inline size_t CalcStringLcp(const std::string& a, const std::string& b) {
+    size_t n = std::min(a.size(), b.size()), lcp = 0;
+    while (lcp < n && a[lcp] == b[lcp]) ++lcp;
+    return lcp;
+}
+
+/*!
+ * Whether merging ValueTypes with Comparator can use the LcpStringLoserTree:
+ * this is the case for std::strings in lexicographic order.
+ */
+template <typename ValueType, typename Comparator>
+struct is_lcp_mergeable
+    : public std::integral_constant<
+          bool, std::is_same<ValueType, std::string>::value && (
+              std::is_same<Comparator, std::less<std::string> >::value ||
+              std::is_same<Comparator, std::less<> >::value)>{ };
+
+/*!
+ * Loser tree for merging sorted sequences of std::strings, which caches the
+ * longest common prefix (LCP) of each sequence's current string. The interface
+ * follows tlx::LoserTree, except that delete_min_insert() additionally takes
+ * the LCP of the new string with the last minimum, which is the previous string
+ * of the same sequence.
+ *
+ * All LCPs stored along the path of the minimum are relative to the minimum
+ * itself. When replaying the path for its successor, a match is decided by
+ * comparing the two LCPs alone, unless they are equal, in which case the
+ * characters are compared starting after the common prefix. Hence, common
+ * prefixes of the strings are not rescanned on each level of the tree, which
+ * makes the merge cost depend on the distinguishing prefixes only.
+ */
+template <bool Stable>
+class LcpStringLoserTree
+{
+public:
+    using Source = unsigned;
+
+    explicit LcpStringLoserTree(Source k)
+        : k_(static_cast<Source>(
+                 tlx::round_up_to_power_of_two(std::max<Source>(k, 1)))),
+          nodes_(k_, 0), leaves_(k_, Leaf { nullptr, 0, true }) { }
+
+    //! constructor interface of tlx::LoserTree, the Comparator is ignored since
+    //! strings are always merged in lexicographic order.
+    template <typename Comparator>
+    LcpStringLoserTree(Source k, const Comparator& /* comp */)
+        : LcpStringLoserTree(k) { }
+
+    //! set the initial string of input source, sup marks an empty input.
+    void insert_start(const std::string* key, Source source, bool sup) {
+        assert(source < k_);
+        leaves_[source] = Leaf { key, 0, sup };
+    }
+
+    //! play the initial tournament
+    void init() {
+        nodes_[0] = InitWinner(1);
+    }
+
+    //! return the input containing the smallest string
+    Source min_source() const { return nodes_[0]; }
+
+    //! replace the smallest string by key, which has the given LCP with it.
+    void delete_min_insert(const std::string* key, bool sup, size_t lcp) {
+        Source contender = nodes_[0];
+        leaves_[contender] = Leaf { key, lcp, sup };
+
+        for (Source node = (k_ + contender) >> 1; node > 0; node >>= 1)
+            UpdateNode(contender, nodes_[node]);
+
+        nodes_[0] = contender;
+    }
+
+private:
+    //! current string of each input
+    struct Leaf {
+        //! pointer to the string
+        const std::string* key;
+        //! LCP with the string which last beat it
+        size_t lcp;
+        //! whether the input is exhausted
+        bool sup;
+    };
+
+    //! number of leaves, a power of two
+    Source k_;
+
+    //! nodes_[0] is the winner, nodes_[1..k) the losers of each match
+    std::vector<Source> nodes_;
+
+    //! current strings of the inputs
+    std::vector<Leaf> leaves_;
+
+    //! play the initial matches of the subtree at root, returns the winner.
+    Source InitWinner(Source root) {
+        if (root >= k_) return root - k_;
+
+        Source contender = InitWinner(2 * root);
+        Source defender = InitWinner(2 * root + 1);
+        UpdateNode(contender, defender);
+        nodes_[root] = defender;
+        return contender;
+    }
+
+    //! play a match between the contender coming up the tree and the defender
+    //! stored in the node. Afterwards, contender is the winner and defender
+    //! the loser, both LCPs relative to the winner.
+    void UpdateNode(Source& contender, Source& defender) {
+        Leaf& d = leaves_[defender];
+        if (d.sup) return;
+
+        Leaf& c = leaves_[contender];
+        if (c.sup || d.lcp > c.lcp) {
+            // a longer LCP with the same string means the smaller string.
+            std::swap(contender, defender);
+            return;
+        }
+        if (d.lcp < c.lcp) return;
+
+        // equal LCPs: compare characters after the common prefix.
+        const std::string& ds = *d.key;
+        const std::string& cs = *c.key;
+        size_t n = std::min(ds.size(), cs.size()), lcp = d.lcp;
+        while (lcp < n && ds[lcp] == cs[lcp]) ++lcp;
+
+        bool defender_less;
+        if (lcp < n) {
+            defender_less = static_cast<unsigned char>(ds[lcp])
+                            < static_cast<unsigned char>(cs[lcp]);
+        }
+        else if (ds.size() != cs.size()) {
+            defender_less = ds.size() < cs.size();
+        }
+        else {
+            // equal strings: the smaller input wins in stable merges.
+            defender_less = Stable && defender < contender;
+        }
+
+        if (defender_less) {
+            c.lcp = lcp;
+            std::swap(contender, defender);
+        }
+        else {
+            d.lcp = lcp;
+        }
+    }
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_LCP_LOSER_TREE_HEADER
+
+/******************************************************************************/
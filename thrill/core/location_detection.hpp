@@ -25,6 +25,7 @@
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_old_probing_hash_table.hpp>
 #include <thrill/core/reduce_probing_hash_table.hpp>
+#include <thrill/core/reduce_swiss_hash_table.hpp>
 #include <thrill/core/reduce_table.hpp>
 #include <thrill/data/cat_stream.hpp>
 
@@ -12,16 +12,24 @@
 #ifndef THRILL_CORE_MULTIWAY_MERGE_HEADER
 #define THRILL_CORE_MULTIWAY_MERGE_HEADER
 
+#include <thrill/core/lcp_loser_tree.hpp>
+
 #include <tlx/container/loser_tree.hpp>
 
 #include <algorithm>
 #include <functional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace thrill {
 namespace core {
 
+/*!
+ * Multiway merge of sorted Readers using a loser tree. Strings in lexicographic
+ * order are merged with the LcpStringLoserTree, which caches the common
+ * prefixes of each input with the last output.
+ */
 template <
     typename ValueType,
     typename ReaderIterator,
@@ -32,8 +40,12 @@ class MultiwayMergeTree
 public:
     using Reader = typename std::iterator_traits<ReaderIterator>::value_type;
 
-    using LoserTreeType = tlx::LoserTree<
-        /* stable */ Stable, ValueType, Comparator>;
+    //! whether the merge uses the LcpStringLoserTree
+    static constexpr bool use_lcp = is_lcp_mergeable<ValueType, Comparator>::value;
+
+    using LoserTreeType = typename std::conditional<
+        use_lcp, LcpStringLoserTree<Stable>,
+        tlx::LoserTree</* stable */ Stable, ValueType, Comparator> >::type;
 
     MultiwayMergeTree(ReaderIterator readers_begin, ReaderIterator readers_end,
                       const Comparator& comp)
@@ -70,17 +82,7 @@ public:
         unsigned top = lt_.min_source();
         ValueType res = std::move(current_[top].second);
 
-        if (TLX_LIKELY(readers_[top].HasNext())) {
-            current_[top].first = true;
-            current_[top].second = readers_[top].template Next<ValueType>();
-            lt_.delete_min_insert(&current_[top].second, false);
-        }
-        else {
-            current_[top].first = false;
-            lt_.delete_min_insert(nullptr, true);
-            assert(remaining_inputs_ > 0);
-            --remaining_inputs_;
-        }
+        Replace(top, res, std::integral_constant<bool, use_lcp>());
 
         return std::make_pair(res, top);
     }
@@ -91,6 +93,22 @@ public:
         unsigned top = lt_.min_source();
         ValueType res = std::move(current_[top].second);
 
+        Replace(top, res, std::integral_constant<bool, use_lcp>());
+
+        return res;
+    }
+
+private:
+    ReaderIterator readers_;
+    unsigned num_inputs_;
+    size_t remaining_inputs_;
+
+    LoserTreeType lt_;
+    //! current values in each input (exist flag, value)
+    std::vector<std::pair<bool, ValueType> > current_;
+
+    //! refill input top, whose current value was taken out.
+    void Replace(unsigned top, const ValueType& /* res */, std::false_type) {
         if (TLX_LIKELY(readers_[top].HasNext())) {
             current_[top].first = true;
             current_[top].second = readers_[top].template Next<ValueType>();
@@ -102,18 +120,24 @@ public:
             assert(remaining_inputs_ > 0);
             --remaining_inputs_;
         }
-
-        return res;
     }
 
-private:
-    ReaderIterator readers_;
-    unsigned num_inputs_;
-    size_t remaining_inputs_;
-
-    LoserTreeType lt_;
-    //! current values in each input (exist flag, value)
-    std::vector<std::pair<bool, ValueType> > current_;
+    //! refill input top, passing the LCP of its next string with the
+    //! previous one res to the LcpStringLoserTree.
+    void Replace(unsigned top, const ValueType& res, std::true_type) {
+        if (TLX_LIKELY(readers_[top].HasNext())) {
+            current_[top].first = true;
+            current_[top].second = readers_[top].template Next<ValueType>();
+            lt_.delete_min_insert(&current_[top].second, false,
+                                  CalcStringLcp(res, current_[top].second));
+        }
+        else {
+            current_[top].first = false;
+            lt_.delete_min_insert(nullptr, true, 0);
+            assert(remaining_inputs_ > 0);
+            --remaining_inputs_;
+        }
+    }
 };
 
 /*!
@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * thrill/core/parallel_multiway_merge.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_PARALLEL_MULTIWAY_MERGE_HEADER
+#define THRILL_CORE_PARALLEL_MULTIWAY_MERGE_HEADER
+
+#include <thrill/common/logger.hpp>
+#include <thrill/common/porting.hpp>
+#include <thrill/core/multiway_merge.hpp>
+#include <thrill/data/file.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+/*!
+ * Binary search in the range [left,right) of a sorted File for the first item
+ * not less than the pivot, or if upper is set, greater than the pivot.
+ */
+template <typename ValueType, typename Comparator>
+size_t FileBound(const data::File& file, const ValueType& pivot,
+                 size_t left, size_t right, bool upper,
+                 const Comparator& less) {
+    while (left < right) {
+        size_t mid = (left + right) >> 1;
+        ValueType cur = file.GetItemAt<ValueType>(mid);
+        if (upper ? less(pivot, cur) : !less(cur, pivot))
+            right = mid;
+        else
+            left = mid + 1;
+    }
+    return left;
+}
+
+/*!
+ * Multisequence selection: given a container of k sorted Files and a rank,
+ * returns positions in each File such that the items before them are exactly
+ * the rank smallest items. Equal items are ordered by File index, hence the split is consistent
+ * with a stable multiway merge, and the positions of increasing ranks are
+ * componentwise increasing.
+ *
+ * Each round takes the middle item of the largest remaining range as pivot and
+ * locates it in all Files by binary search, which at least halves that range.
+ */
+template <typename ValueType, typename Files, typename Comparator>
+std::vector<size_t> MultisequenceSelect(
+    const Files& files, size_t rank, const Comparator& less) {
+    static constexpr bool debug = false;
+
+    size_t k = files.size();
+    std::vector<size_t> lo(k, 0), hi(k);
+    for (size_t i = 0; i < k; ++i)
+        hi[i] = files[i].num_items();
+
+    std::vector<size_t> lower(k), upper(k);
+
+    while (true) {
+        // select File with largest remaining range
+        size_t best = 0, best_size = 0;
+        for (size_t i = 0; i < k; ++i) {
+            if (hi[i] - lo[i] > best_size)
+                best = i, best_size = hi[i] - lo[i];
+        }
+        if (best_size == 0) break;
+
+        ValueType pivot = files[best].template GetItemAt<ValueType>(
+            lo[best] + best_size / 2);
+
+        // locate pivot's range of equal items in all Files
+        size_t sum_lower = 0, sum_upper = 0;
+        for (size_t i = 0; i < k; ++i) {
+            lower[i] = FileBound(files[i], pivot, lo[i], hi[i], false, less);
+            upper[i] = FileBound(files[i], pivot, lower[i], hi[i], true, less);
+            sum_lower += lower[i], sum_upper += upper[i];
+        }
+
+        sLOG << "MultisequenceSelect() rank" << rank
+             << "sum_lower" << sum_lower << "sum_upper" << sum_upper;
+
+        if (rank < sum_lower) {
+            hi = lower;
+        }
+        else if (rank > sum_upper) {
+            lo = upper;
+        }
+        else {
+            // rank splits the items equal to the pivot: take them in File
+            // order.
+            size_t rest = rank - sum_lower;
+            for (size_t i = 0; i < k; ++i) {
+                size_t take = std::min(rest, upper[i] - lower[i]);
+                lower[i] += take, rest -= take;
+            }
+            return lower;
+        }
+    }
+
+    return lo;
+}
+
+/*!
+ * Parallel multiway merge of sorted Files into the File output: the output is
+ * split into num_threads ranges of equal size by multisequence selection,
+ * which are merged concurrently. The first range is merged on the calling
+ * thread directly into output, the other ranges are merged by background
+ * threads into Files created by make_file, whose Blocks are appended to output
+ * in order. Hence, the output order is that of a sequential MultiwayMergeTree,
+ * and the result can be pushed with a single PushFile().
+ *
+ * The Files are split into the ranges without copying items, the parts share
+ * the Files' Blocks. If consume is set, the Files are cleared and each range
+ * is read by consuming Readers, hence the Blocks are released once merged and
+ * the merged ranges take their place.
+ */
+template <typename ValueType, bool Stable, typename Files,
+          typename Comparator, typename MakeFile>
+void ParallelMultiwayMerge(
+    Files& files, bool consume, size_t num_threads,
+    size_t prefetch, const Comparator& less, const MakeFile& make_file,
+    data::File& output) {
+
+    using Reader = data::File::Reader;
+
+    size_t total = 0;
+    for (const data::File& f : files) total += f.num_items();
+    num_threads = std::max<size_t>(1, std::min(num_threads, total));
+
+    // split positions of the ranges in each File
+    std::vector<std::vector<size_t> > bounds(num_threads - 1);
+    for (size_t t = 1; t < num_threads; ++t) {
+        bounds[t - 1] = MultisequenceSelect<ValueType>(
+            files, total * t / num_threads, less);
+    }
+
+    // parts[i][t] is range t of File i
+    std::vector<std::vector<data::File> > parts(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::vector<size_t> positions(num_threads - 1);
+        for (size_t t = 1; t < num_threads; ++t)
+            positions[t - 1] = bounds[t - 1][i];
+        parts[i] = files[i].template Split<ValueType>(positions);
+        if (consume) files[i].Clear();
+    }
+
+    // merge range t of all Files into file
+    auto merge_range =
+        [&](size_t t, data::File& file) {
+            auto writer = file.GetWriter(data::BlockSizePolicy::Throughput());
+
+            std::vector<Reader> seq;
+            seq.reserve(files.size());
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (parts[i][t].num_items() == 0) continue;
+                seq.emplace_back(
+                    parts[i][t].GetReader(consume, /* prefetch */ 0));
+            }
+            if (seq.empty()) return;
+
+            data::StartPrefetch(seq, prefetch / num_threads);
+
+            MultiwayMergeTree<
+                ValueType, typename std::vector<Reader>::iterator,
+                Comparator, Stable> puller(seq.begin(), seq.end(), less);
+
+            while (puller.HasNext())
+                writer.Put(puller.Next());
+        };
+
+    std::vector<data::File> segments;
+    segments.reserve(num_threads);
+    for (size_t t = 1; t < num_threads; ++t)
+        segments.emplace_back(make_file());
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < num_threads; ++t) {
+        threads.emplace_back(
+            common::CreateThread(
+                [&, t]() { merge_range(t, segments[t - 1]); }));
+    }
+
+    merge_range(0, output);
+
+    for (size_t t = 1; t < num_threads; ++t) {
+        threads[t - 1].join();
+        for (size_t b = 0; b < segments[t - 1].num_blocks(); ++b)
+            output.AppendBlock(segments[t - 1].block(b));
+        segments[t - 1].Clear();
+    }
+}
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_PARALLEL_MULTIWAY_MERGE_HEADER
+
+/******************************************************************************/
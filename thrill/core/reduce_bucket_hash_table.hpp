@@ -13,6 +13,7 @@
 #ifndef THRILL_CORE_REDUCE_BUCKET_HASH_TABLE_HEADER
 #define THRILL_CORE_REDUCE_BUCKET_HASH_TABLE_HEADER
 
+#include <thrill/common/defines.hpp>
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_table.hpp>
 
@@ -253,16 +254,16 @@ public:
      * items per bucket is reached.
      *
      * \param kv Value to be inserted into the table.
+     *
+     * \param h Index of the value as calculated by calculate_index(kv).
          *
          * \return true if a new key was inserted to the table
      */
-    bool Insert(const TableItem& kv) {
+    bool Insert(const TableItem& kv, const typename IndexFunction::Result& h) {
 
         while (TLX_UNLIKELY(mem::memory_exceeded && num_items_ != 0))
             SpillAnyPartition();
 
-        typename IndexFunction::Result h = calculate_index(kv);
-
         size_t local_index = h.local_index(num_buckets_per_partition_);
 
         assert(h.partition_id < num_partitions_);
@@ -330,6 +331,18 @@ public:
         return true;
     }
 
+    //! Inserts a value into the table, see Insert(kv, h).
+    bool Insert(const TableItem& kv) {
+        return Insert(kv, calculate_index(kv));
+    }
+
+    //! Prefetch the bucket of a value with index h for a following Insert().
+    void Prefetch(const typename IndexFunction::Result& h) const {
+        THRILL_PREFETCH_WRITE(
+            buckets_.data() + h.partition_id * num_buckets_per_partition_
+            + h.local_index(num_buckets_per_partition_));
+    }
+
     //! Deallocate memory
     void Dispose() {
         // destroy all block chains
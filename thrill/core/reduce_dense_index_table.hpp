@@ -0,0 +1,337 @@
+/*******************************************************************************
+ * thrill/core/reduce_dense_index_table.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_REDUCE_DENSE_INDEX_TABLE_HEADER
+#define THRILL_CORE_REDUCE_DENSE_INDEX_TABLE_HEADER
+
+#include <thrill/common/defines.hpp>
+#include <thrill/core/reduce_functional.hpp>
+#include <thrill/core/reduce_table.hpp>
+
+#include <tlx/vector_free.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+/*!
+ * A reduce table for ReduceToIndex, which stores items in a dense array
+ * addressed directly by the global index calculated by ReduceByIndex. Hence,
+ * there is no hashing and no probing: each slot is either empty or holds the
+ * item of the single key currently mapped to it, occupied slots are marked in
+ * a bit vector.
+ *
+ * If the memory limit allows one slot for each index in the range, all keys
+ * have distinct slots and the table is a plain array indexed by key, which is
+ * ideal for dense indexes as in PageRank-like algorithms. Otherwise, a range
+ * of consecutive keys shares each slot, and inserting a key different from the
+ * one in the slot evicts the previous item to the next phase (or spills the
+ * partition), like a direct-mapped cache.
+ *
+ * The partitions are contiguous ranges of slots, hence flushing a partition
+ * delivers its items in key order.
+ */
+template <typename TableItem, typename Key, typename Value,
+          typename KeyExtractor, typename ReduceFunction, typename Emitter,
+          const bool VolatileKey,
+          typename ReduceConfig_,
+          typename IndexFunction,
+          typename KeyEqualFunction = std::equal_to<Key> >
+class ReduceDenseIndexTable
+    : public ReduceTable<TableItem, Key, Value,
+                         KeyExtractor, ReduceFunction, Emitter,
+                         VolatileKey, ReduceConfig_,
+                         IndexFunction, KeyEqualFunction>
+{
+    using Super = ReduceTable<TableItem, Key, Value,
+                              KeyExtractor, ReduceFunction, Emitter,
+                              VolatileKey, ReduceConfig_, IndexFunction,
+                              KeyEqualFunction>;
+    using Super::debug;
+
+    static_assert(std::is_same<IndexFunction, ReduceByIndex<Key> >::value,
+                  "ReduceDenseIndexTable can only be used with ReduceByIndex, "
+                  "e.g. in ReduceToIndex");
+
+public:
+    using ReduceConfig = ReduceConfig_;
+
+    ReduceDenseIndexTable(
+        Context& ctx, size_t dia_id,
+        const KeyExtractor& key_extractor,
+        const ReduceFunction& reduce_function,
+        Emitter& emitter,
+        size_t num_partitions,
+        const ReduceConfig& config = ReduceConfig(),
+        bool immediate_flush = false,
+        const IndexFunction& index_function = IndexFunction(),
+        const KeyEqualFunction& key_equal_function = KeyEqualFunction())
+        : Super(ctx, dia_id,
+                key_extractor, reduce_function, emitter,
+                num_partitions, config, immediate_flush,
+                index_function, key_equal_function)
+    { assert(num_partitions > 0); }
+
+    //! Allocate the array with one slot per index in the range, or fewer if
+    //! limited by limit_memory_bytes.
+    void Initialize(size_t limit_memory_bytes) {
+        assert(items_.empty());
+
+        limit_memory_bytes_ = limit_memory_bytes;
+
+        size_t range_size = index_function_.range().size();
+
+        // slots per partition for storing each index separately
+        size_t dense_per_partition =
+            (range_size + num_partitions_ - 1) / num_partitions_;
+
+        // slots per partition fitting into the memory limit
+        size_t limit_per_partition =
+            limit_memory_bytes_ / sizeof(TableItem) / num_partitions_;
+
+        num_buckets_per_partition_ = std::max<size_t>(
+            1, std::min(dense_per_partition, limit_per_partition));
+
+        num_buckets_ = num_buckets_per_partition_ * num_partitions_;
+
+        sLOG << "ReduceDenseIndexTable::Initialize()"
+             << "range_size" << range_size
+             << "num_buckets_" << num_buckets_
+             << "dense" << (num_buckets_ >= range_size);
+
+        items_.resize(num_buckets_);
+        used_.resize(num_buckets_, false);
+    }
+
+    ~ReduceDenseIndexTable() {
+        Dispose();
+    }
+
+    /*!
+     * Inserts a value into the slot of its index, reducing it with the item
+     * there if the keys are equal. If the slot holds another key, that item is
+     * evicted first.
+     *
+     * \param kv Value to be inserted into the table.
+     *
+     * \param h Index of the value as calculated by calculate_index(kv).
+     *
+     * \return true if a new key was inserted to the table
+     */
+    bool Insert(const TableItem& kv, const typename IndexFunction::Result& h) {
+        assert(h.partition_id < num_partitions_);
+        assert(h.global_index < num_buckets_);
+
+        size_t slot = h.global_index;
+
+        if (used_[slot]) {
+            if (key_equal_function_(key(items_[slot]), key(kv))) {
+                items_[slot] = reduce(items_[slot], kv);
+                return false;
+            }
+
+            // another key shares the slot: only possible if the table is
+            // smaller than the index range.
+            if (immediate_flush_) {
+                this->emitter_.Emit(h.partition_id, items_[slot]);
+                items_[slot] = kv;
+                return true;
+            }
+
+            SpillPartition(h.partition_id);
+        }
+
+        items_[slot] = kv;
+        used_[slot] = true;
+
+        ++items_per_partition_[h.partition_id];
+        ++num_items_;
+
+        return true;
+    }
+
+    //! Inserts a value into the table, see Insert(kv, h).
+    bool Insert(const TableItem& kv) {
+        return Insert(kv, calculate_index(kv));
+    }
+
+    //! Prefetch the slot of a value with index h for a following Insert().
+    void Prefetch(const typename IndexFunction::Result& h) const {
+        THRILL_PREFETCH_WRITE(items_.data() + h.global_index);
+    }
+
+    //! Deallocate items and memory
+    void Dispose() {
+        tlx::vector_free(items_);
+        tlx::vector_free(used_);
+
+        Super::Dispose();
+    }
+
+    //! \name Spilling Mechanisms to External Memory Files
+    //! \{
+
+    //! Spill all items of a partition into an external memory File.
+    void SpillPartition(size_t partition_id) {
+
+        if (immediate_flush_) {
+            return FlushPartition(
+                partition_id, /* consume */ true, /* grow */ false);
+        }
+
+        LOG << "Spilling " << items_per_partition_[partition_id]
+            << " items of partition with id: " << partition_id;
+
+        if (items_per_partition_[partition_id] == 0)
+            return;
+
+        data::File::Writer writer = partition_files_[partition_id].GetWriter();
+
+        size_t begin = partition_id * num_buckets_per_partition_;
+        size_t end = begin + num_buckets_per_partition_;
+
+        for (size_t slot = begin; slot < end; ++slot) {
+            if (!used_[slot]) continue;
+            writer.Put(items_[slot]);
+            items_[slot] = TableItem();
+            used_[slot] = false;
+        }
+
+        // reset partition specific counter
+        num_items_ -= items_per_partition_[partition_id];
+        items_per_partition_[partition_id] = 0;
+        assert(num_items_ == this->num_items_calc());
+    }
+
+    //! Spill all items of an arbitrary partition into an external memory File.
+    void SpillAnyPartition() {
+        return SpillLargestPartition();
+    }
+
+    //! Spill all items of the largest partition into an external memory File.
+    void SpillLargestPartition() {
+        size_t size_max = 0, index = 0;
+
+        for (size_t i = 0; i < num_partitions_; ++i) {
+            if (items_per_partition_[i] > size_max) {
+                size_max = items_per_partition_[i];
+                index = i;
+            }
+        }
+
+        if (size_max == 0) {
+            return;
+        }
+
+        return SpillPartition(index);
+    }
+
+    //! \}
+
+    //! \name Flushing Mechanisms to Next Stage or Phase
+    //! \{
+
+    template <typename Emit>
+    void FlushPartitionEmit(
+        size_t partition_id, bool consume, bool /* grow */, Emit emit) {
+
+        LOG << "Flushing " << items_per_partition_[partition_id]
+            << " items of partition: " << partition_id;
+
+        size_t begin = partition_id * num_buckets_per_partition_;
+        size_t end = begin + num_buckets_per_partition_;
+
+        for (size_t slot = begin; slot < end; ++slot) {
+            if (!used_[slot]) continue;
+            emit(partition_id, items_[slot]);
+
+            if (consume) {
+                items_[slot] = TableItem();
+                used_[slot] = false;
+            }
+        }
+
+        if (consume) {
+            // reset partition specific counter
+            num_items_ -= items_per_partition_[partition_id];
+            items_per_partition_[partition_id] = 0;
+            assert(num_items_ == this->num_items_calc());
+        }
+
+        LOG << "Done flushed items of partition: " << partition_id;
+    }
+
+    void FlushPartition(size_t partition_id, bool consume, bool grow) {
+        FlushPartitionEmit(
+            partition_id, consume, grow,
+            [this](const size_t& partition_id, const TableItem& p) {
+                this->emitter_.Emit(partition_id, p);
+            });
+    }
+
+    void FlushAll() {
+        for (size_t i = 0; i < num_partitions_; ++i) {
+            FlushPartition(i, /* consume */ true, /* grow */ false);
+        }
+    }
+
+    //! \}
+
+public:
+    using Super::calculate_index;
+
+private:
+    using Super::immediate_flush_;
+    using Super::index_function_;
+    using Super::items_per_partition_;
+    using Super::key;
+    using Super::key_equal_function_;
+    using Super::limit_memory_bytes_;
+    using Super::num_buckets_;
+    using Super::num_buckets_per_partition_;
+    using Super::num_items_;
+    using Super::num_partitions_;
+    using Super::partition_files_;
+    using Super::reduce;
+
+    //! dense array of items, addressed by global index
+    std::vector<TableItem> items_;
+
+    //! flags marking the occupied slots of items_
+    std::vector<bool> used_;
+};
+
+template <typename TableItem, typename Key, typename Value,
+          typename KeyExtractor, typename ReduceFunction,
+          typename Emitter, const bool VolatileKey,
+          typename ReduceConfig, typename IndexFunction,
+          typename KeyEqualFunction>
+class ReduceTableSelect<
+        ReduceTableImpl::DENSE,
+        TableItem, Key, Value, KeyExtractor, ReduceFunction,
+        Emitter, VolatileKey, ReduceConfig, IndexFunction, KeyEqualFunction>
+{
+public:
+    using type = ReduceDenseIndexTable<
+        TableItem, Key, Value, KeyExtractor, ReduceFunction,
+        Emitter, VolatileKey, ReduceConfig,
+        IndexFunction, KeyEqualFunction>;
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_REDUCE_DENSE_INDEX_TABLE_HEADER
+
+/******************************************************************************/
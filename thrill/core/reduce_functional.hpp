@@ -20,9 +20,17 @@
 #include <thrill/common/hash.hpp>
 #include <thrill/common/math.hpp>
 
+#include <cstdint>
+
 namespace thrill {
 namespace core {
 
+//! Calculate a 7-bit fingerprint from the bits of an index or hash value by
+//! multiplicative hashing, used by ReduceSwissHashTable.
+static inline uint8_t ReduceFingerprint(uint64_t x) {
+    return static_cast<uint8_t>((x * UINT64_C(0x9E3779B97F4A7C15)) >> 57);
+}
+
 /*!
  * A reduce index function which returns a hash index and partition. It is used
  * by ReduceByKey.
@@ -42,6 +50,11 @@ public:
         size_t local_index(size_t size) const {
             return remaining_hash % size;
         }
+
+        //! 7-bit fingerprint of the key for tables storing it separately
+        uint8_t fingerprint() const {
+            return ReduceFingerprint(remaining_hash);
+        }
     };
 
     explicit ReduceByHash(
@@ -98,6 +111,11 @@ public:
             return global_index % num_buckets_per_partition
                    * size / num_buckets_per_partition;
         }
+
+        //! 7-bit fingerprint of the key for tables storing it separately
+        uint8_t fingerprint() const {
+            return ReduceFingerprint(global_index);
+        }
     };
 
     explicit ReduceByIndex(const common::Range& range)
@@ -13,6 +13,7 @@
 #ifndef THRILL_CORE_REDUCE_OLD_PROBING_HASH_TABLE_HEADER
 #define THRILL_CORE_REDUCE_OLD_PROBING_HASH_TABLE_HEADER
 
+#include <thrill/common/defines.hpp>
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_table.hpp>
 
@@ -165,16 +166,16 @@ public:
      * fill ratio per partition is reached.
      *
      * \param kv Value to be inserted into the table.
+     *
+     * \param h Index of the value as calculated by calculate_index(kv).
          *
          * \return true if a new key was inserted to the table
      */
-    bool Insert(const TableItem& kv) {
+    bool Insert(const TableItem& kv, const typename IndexFunction::Result& h) {
 
         while (TLX_UNLIKELY(mem::memory_exceeded && num_items_ != 0))
             SpillAnyPartition();
 
-        typename IndexFunction::Result h = calculate_index(kv);
-
         assert(h.partition_id < num_partitions_);
 
         if (key_equal_function_(key(kv), Key())) {
@@ -249,6 +250,18 @@ public:
         return true;
     }
 
+    //! Inserts a value into the table, see Insert(kv, h).
+    bool Insert(const TableItem& kv) {
+        return Insert(kv, calculate_index(kv));
+    }
+
+    //! Prefetch the slot of a value with index h for a following Insert().
+    void Prefetch(const typename IndexFunction::Result& h) const {
+        THRILL_PREFETCH_WRITE(
+            items_.data() + h.partition_id * num_buckets_per_partition_
+            + h.local_index(num_buckets_per_partition_));
+    }
+
     //! Deallocate memory
     void Dispose() {
         tlx::vector_free(items_);
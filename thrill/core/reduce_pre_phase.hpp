@@ -21,9 +21,11 @@
 #include <thrill/common/math.hpp>
 #include <thrill/core/duplicate_detection.hpp>
 #include <thrill/core/reduce_bucket_hash_table.hpp>
+#include <thrill/core/reduce_dense_index_table.hpp>
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_old_probing_hash_table.hpp>
 #include <thrill/core/reduce_probing_hash_table.hpp>
+#include <thrill/core/reduce_swiss_hash_table.hpp>
 #include <thrill/data/block_reader.hpp>
 #include <thrill/data/block_writer.hpp>
 #include <thrill/data/file.hpp>
@@ -142,13 +144,17 @@ public:
           table_(ctx, dia_id,
                  key_extractor, reduce_function, emit_,
                  num_partitions, config, !duplicates,
-                 index_function, key_equal_function) {
+                 index_function, key_equal_function),
+          limit_skip_reduction_rate_(config.limit_skip_reduction_rate()) {
 
         tlx::unused(hash_function);
 
         sLOG << "creating ReducePrePhase with" << emit.size() << "output emitters";
 
         assert(num_partitions == emit.size());
+
+        batch_.reserve(insert_batch_size_);
+        batch_index_.resize(insert_batch_size_);
     }
 
     //! non-copyable: delete copy-constructor
@@ -164,9 +170,38 @@ public:
         table_.InitializeSkip();
     }
 
-    bool Insert(const Value& v) {
+    /*!
+     * Inserts a value into the table. Values are collected in a batch of
+     * ReduceConfig::insert_batch_size_ items, for which first the table slots
+     * are calculated and prefetched, and then the values are inserted. Thus
+     * the cache misses of the inserts in a batch overlap. The batch is
+     * completed by FlushAll() and FlushPartition().
+     *
+     * Furthermore, the fraction of inserts which are reduced is sampled. If it
+     * is below limit_skip_reduction_rate, the table is bypassed and items are
+     * emitted directly as by InsertSkip(), until the rate is sampled again
+     * after ReduceConfig::skip_recheck_items_ items.
+     */
+    void Insert(const Value& v) {
+        if (skipping_) {
+            InsertSkip(v);
+            if (++sample_items_ == skip_recheck_items_) {
+                skipping_ = false;
+                sample_items_ = 0;
+            }
+            return;
+        }
+
         // for VolatileKey this makes std::pair and extracts the key
-        return table_.Insert(MakeTableItem::Make(v, table_.key_extractor()));
+        if (insert_batch_size_ == 0) {
+            SampleInsert(
+                table_.Insert(MakeTableItem::Make(v, table_.key_extractor())));
+            return;
+        }
+
+        batch_.emplace_back(MakeTableItem::Make(v, table_.key_extractor()));
+        if (batch_.size() == insert_batch_size_)
+            InsertBatch();
     }
 
     void InsertSkip(const Value& v) {
@@ -177,6 +212,8 @@ public:
 
     //! Flush all partitions
     void FlushAll() {
+        sLOG << "ReducePrePhase::FlushAll()"
+             << "num_skip_switches" << num_skip_switches_;
         for (size_t id = 0; id < table_.num_partitions(); ++id) {
             FlushPartition(id, /* consume */ true, /* grow */ false);
         }
@@ -184,6 +221,7 @@ public:
 
     //! Flushes a partition
     void FlushPartition(size_t partition_id, bool consume, bool grow) {
+        InsertBatch();
         table_.FlushPartition(partition_id, consume, grow);
         // data is flushed immediately, there is no spilled data
     }
@@ -215,6 +253,75 @@ protected:
 
     //! the first-level hash table implementation
     Table table_;
+
+private:
+    //! number of items inserted as a batch
+    static constexpr size_t insert_batch_size_ =
+        ReduceConfig::insert_batch_size_;
+
+    //! items collected for the next batch insert
+    std::vector<TableItem> batch_;
+
+    //! table indexes of the items in the batch
+    std::vector<typename IndexFunction::Result> batch_index_;
+
+    //! number of sampled inserts before deciding whether to skip the table
+    static constexpr size_t skip_sample_items_ =
+        ReduceConfig::skip_sample_items_;
+
+    //! number of items emitted directly before sampling again
+    static constexpr size_t skip_recheck_items_ =
+        ReduceConfig::skip_recheck_items_;
+
+    //! minimum fraction of reduced inserts for using the table
+    double limit_skip_reduction_rate_;
+
+    //! whether items are currently emitted directly
+    bool skipping_ = false;
+
+    //! number of items inserted or skipped in the current period
+    size_t sample_items_ = 0;
+
+    //! number of new keys inserted in the current sample period
+    size_t sample_new_keys_ = 0;
+
+    //! number of times the table was bypassed
+    size_t num_skip_switches_ = 0;
+
+    //! count an insert into the table for sampling the reduction rate, and
+    //! switch to skipping if it is too low.
+    void SampleInsert(bool new_key) {
+        if (limit_skip_reduction_rate_ <= 0.0) return;
+
+        sample_new_keys_ += new_key;
+        if (++sample_items_ < skip_sample_items_) return;
+
+        double reduction_rate =
+            static_cast<double>(sample_items_ - sample_new_keys_)
+            / static_cast<double>(sample_items_);
+
+        if (reduction_rate < limit_skip_reduction_rate_) {
+            sLOG << "ReducePrePhase: skipping table, reduction rate"
+                 << reduction_rate;
+            skipping_ = true;
+            ++num_skip_switches_;
+        }
+
+        sample_items_ = sample_new_keys_ = 0;
+    }
+
+    //! calculate and prefetch the slots of the items in the batch, then insert
+    //! them into the table.
+    void InsertBatch() {
+        for (size_t i = 0; i < batch_.size(); ++i) {
+            batch_index_[i] = table_.calculate_index(batch_[i]);
+            table_.Prefetch(batch_index_[i]);
+        }
+        for (size_t i = 0; i < batch_.size(); ++i) {
+            SampleInsert(table_.Insert(batch_[i], batch_index_[i]));
+        }
+        batch_.clear();
+    }
 };
 
 template <typename TableItem, typename Key, typename Value,
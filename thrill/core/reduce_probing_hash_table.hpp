@@ -14,6 +14,7 @@
 #ifndef THRILL_CORE_REDUCE_PROBING_HASH_TABLE_HEADER
 #define THRILL_CORE_REDUCE_PROBING_HASH_TABLE_HEADER
 
+#include <thrill/common/defines.hpp>
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_table.hpp>
 
@@ -185,11 +186,11 @@ public:
      *
      * \param kv Value to be inserted into the table.
      *
+     * \param h Index of the value as calculated by calculate_index(kv).
+     *
      * \return true if a new key was inserted to the table
      */
-    bool Insert(const TableItem& kv) {
-
-        typename IndexFunction::Result h = calculate_index(kv);
+    bool Insert(const TableItem& kv, const typename IndexFunction::Result& h) {
         assert(h.partition_id < num_partitions_);
 
         if (TLX_UNLIKELY(key_equal_function_(key(kv), Key()))) {
@@ -243,7 +244,7 @@ public:
             // flush partition and retry, if all slots are reserved
             if (TLX_UNLIKELY(iter == begin_iter)) {
                 GrowAndRehash(h.partition_id);
-                return Insert(kv);
+                return Insert(kv, h);
             }
         }
 
@@ -267,6 +268,18 @@ public:
         return true;
     }
 
+    //! Inserts a value into the table, see Insert(kv, h).
+    bool Insert(const TableItem& kv) {
+        return Insert(kv, calculate_index(kv));
+    }
+
+    //! Prefetch the slot of a value with index h for a following Insert().
+    void Prefetch(const typename IndexFunction::Result& h) const {
+        THRILL_PREFETCH_WRITE(
+            items_ + h.partition_id * num_buckets_per_partition_
+            + h.local_index(partition_size_[h.partition_id]));
+    }
+
     //! Deallocate items and memory
     void Dispose() {
         if (!items_) return;
@@ -0,0 +1,446 @@
+/*******************************************************************************
+ * thrill/core/reduce_shared_pre_phase.hpp
+ *
+ * Host-shared concurrent hash table for the reduce pre-phase.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_REDUCE_SHARED_PRE_PHASE_HEADER
+#define THRILL_CORE_REDUCE_SHARED_PRE_PHASE_HEADER
+
+#include <thrill/api/context.hpp>
+#include <thrill/common/config.hpp>
+#include <thrill/common/logger.hpp>
+#include <thrill/core/reduce_functional.hpp>
+#include <thrill/core/reduce_pre_phase.hpp>
+#include <thrill/core/reduce_table.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+/*!
+ * A concurrent reduce hash table shared by all workers of a host. The slots of
+ * each output partition are divided into shards, which are linear probing hash
+ * tables of fixed size, each protected by its own mutex. Hence, workers
+ * inserting into different shards do not contend.
+ *
+ * When the fill rate of a shard reaches its limit, the inserting worker
+ * flushes the whole shard to the partition via its own emitter, while holding
+ * the shard's lock. At the end, the workers flush the remaining shards
+ * jointly, each a disjoint subset.
+ *
+ * Compared to separate ReducePrePhase tables per worker, keys occurring on
+ * several workers of a host are reduced before they are transmitted, and the
+ * whole memory of the host is available to one table, which raises the local
+ * reduction ratio.
+ */
+template <typename TableItem, typename Key, typename Value,
+          typename KeyExtractor, typename ReduceFunction,
+          const bool VolatileKey,
+          typename IndexFunction = ReduceByHash<Key>,
+          typename KeyEqualFunction = std::equal_to<Key> >
+class ReduceSharedTable
+{
+    static constexpr bool debug = false;
+
+public:
+    using MakeTableItem = ReduceMakeTableItem<Value, TableItem, VolatileKey>;
+
+    /*!
+     * Construct the table for num_partitions output partitions, using
+     * limit_memory_bytes for the slots. The slots are divided into at least
+     * min_shards shards.
+     */
+    ReduceSharedTable(
+        size_t num_partitions, size_t min_shards,
+        size_t limit_memory_bytes, double limit_fill_rate,
+        const KeyExtractor& key_extractor,
+        const ReduceFunction& reduce_function,
+        const IndexFunction& index_function = IndexFunction(),
+        const KeyEqualFunction& key_equal_function = KeyEqualFunction())
+        : key_extractor_(key_extractor),
+          reduce_function_(reduce_function),
+          index_function_(index_function),
+          key_equal_function_(key_equal_function),
+          num_partitions_(num_partitions),
+          shards_per_partition_(
+              std::max<size_t>(
+                  1, (min_shards + num_partitions - 1) / num_partitions)),
+          num_shards_(num_partitions_ * shards_per_partition_),
+          shard_size_(
+              std::max<size_t>(
+                  size_t(min_shard_size),
+                  limit_memory_bytes / (sizeof(TableItem) + 1) / num_shards_)),
+          num_buckets_per_partition_(shards_per_partition_ * shard_size_),
+          num_buckets_(num_partitions_ * num_buckets_per_partition_),
+          limit_items_per_shard_(
+              std::max<size_t>(
+                  1, std::min<size_t>(
+                      shard_size_, static_cast<size_t>(
+                          static_cast<double>(shard_size_) * limit_fill_rate)))),
+          used_(num_buckets_, 0),
+          shards_(num_shards_) {
+
+        assert(num_partitions > 0);
+        assert(limit_fill_rate >= 0.0 && limit_fill_rate <= 1.0);
+
+        items_ = static_cast<TableItem*>(
+            operator new (num_buckets_ * sizeof(TableItem)));
+
+        LOG << "ReduceSharedTable()"
+            << " num_partitions_=" << num_partitions_
+            << " num_shards_=" << num_shards_
+            << " shard_size_=" << shard_size_
+            << " limit_items_per_shard_=" << limit_items_per_shard_;
+    }
+
+    //! non-copyable: delete copy-constructor
+    ReduceSharedTable(const ReduceSharedTable&) = delete;
+    //! non-copyable: delete assignment operator
+    ReduceSharedTable& operator = (const ReduceSharedTable&) = delete;
+
+    ~ReduceSharedTable() {
+        for (size_t i = 0; i < num_buckets_; ++i) {
+            if (used_[i]) items_[i].~TableItem();
+        }
+        operator delete (items_);
+    }
+
+    /*!
+     * Inserts an item into the table, reducing it with an item of the same key
+     * if present. If the shard of the item reaches its limit, the shard is
+     * flushed via emit(partition_id, item) by the calling thread.
+     *
+     * \return true if a new key was inserted to the table
+     */
+    template <typename Emit>
+    bool Insert(const TableItem& kv, Emit& emit) {
+        Key k = key(kv);
+        typename IndexFunction::Result h = index_function_(
+            k, num_partitions_, num_buckets_per_partition_, num_buckets_);
+        assert(h.partition_id < num_partitions_);
+
+        size_t local_index = h.local_index(num_buckets_per_partition_);
+        size_t shard_id =
+            h.partition_id * shards_per_partition_ + local_index / shard_size_;
+
+        Shard& shard = shards_[shard_id];
+        TableItem* items = items_ + shard_id * shard_size_;
+        uint8_t* used = used_.data() + shard_id * shard_size_;
+
+        size_t i = local_index % shard_size_;
+
+        std::unique_lock<std::mutex> lock(shard.mutex);
+
+        // the limit is below the shard size, hence an empty slot exists.
+        while (used[i]) {
+            if (key_equal_function_(key(items[i]), k)) {
+                items[i] = reduce(items[i], kv);
+                return false;
+            }
+            if (++i == shard_size_) i = 0;
+        }
+
+        new (items + i)TableItem(kv);
+        used[i] = 1;
+
+        if (++shard.num_items >= limit_items_per_shard_)
+            FlushShardLocked(shard_id, emit);
+
+        return true;
+    }
+
+    //! Flush all items of a shard via emit(partition_id, item).
+    template <typename Emit>
+    void FlushShard(size_t shard_id, Emit& emit) {
+        std::unique_lock<std::mutex> lock(shards_[shard_id].mutex);
+        FlushShardLocked(shard_id, emit);
+    }
+
+    //! \name Accessors
+    //! \{
+
+    //! Returns the number of shards
+    size_t num_shards() const { return num_shards_; }
+
+    //! Returns the number of slots in each shard
+    size_t shard_size() const { return shard_size_; }
+
+    //! Returns the number of flushes of full shards
+    size_t num_full_flushes() const { return num_full_flushes_; }
+
+    //! \}
+
+private:
+    //! a shard of the table: a lock and the number of items in the shard,
+    //! aligned such that no cache line is shared.
+    struct Shard {
+        alignas(common::g_cache_line_size)
+        std::mutex mutex;
+        size_t num_items = 0;
+    };
+
+    //! minimum number of slots in a shard
+    static constexpr size_t min_shard_size = 16;
+
+    //! Key extractor function for extracting a key from a value.
+    KeyExtractor key_extractor_;
+
+    //! Reduce function for reducing two values.
+    ReduceFunction reduce_function_;
+
+    //! Index Calculation functions: Hash or ByIndex.
+    IndexFunction index_function_;
+
+    //! Comparator function for keys.
+    KeyEqualFunction key_equal_function_;
+
+    //! Number of partitions
+    const size_t num_partitions_;
+
+    //! Number of shards of each partition
+    const size_t shards_per_partition_;
+
+    //! Number of shards
+    const size_t num_shards_;
+
+    //! Number of slots in each shard
+    const size_t shard_size_;
+
+    //! Number of slots in each partition
+    const size_t num_buckets_per_partition_;
+
+    //! Number of slots in the table
+    const size_t num_buckets_;
+
+    //! Number of items in a shard which triggers flushing it
+    const size_t limit_items_per_shard_;
+
+    //! Storing the items, slots are constructed only when used.
+    TableItem* items_;
+
+    //! Marks used slots.
+    std::vector<uint8_t> used_;
+
+    //! Locks and item counts of the shards.
+    std::vector<Shard> shards_;
+
+    //! Number of flushes of full shards, written under the shard locks.
+    std::atomic<size_t> num_full_flushes_ { 0 };
+
+    Key key(const TableItem& t) const {
+        return MakeTableItem::GetKey(t, key_extractor_);
+    }
+
+    TableItem reduce(const TableItem& a, const TableItem& b) const {
+        return MakeTableItem::Reduce(a, b, reduce_function_);
+    }
+
+    //! Flush all items of a shard, the shard's lock must be held.
+    template <typename Emit>
+    void FlushShardLocked(size_t shard_id, Emit& emit) {
+        Shard& shard = shards_[shard_id];
+        if (shard.num_items == 0) return;
+
+        if (shard.num_items >= limit_items_per_shard_)
+            ++num_full_flushes_;
+
+        size_t partition_id = shard_id / shards_per_partition_;
+        TableItem* items = items_ + shard_id * shard_size_;
+        uint8_t* used = used_.data() + shard_id * shard_size_;
+
+        for (size_t i = 0; i < shard_size_; ++i) {
+            if (!used[i]) continue;
+            emit(partition_id, items[i]);
+            items[i].~TableItem();
+            used[i] = 0;
+        }
+        shard.num_items = 0;
+    }
+};
+
+/*!
+ * Reduce pre-phase using one ReduceSharedTable for all workers of a host, with
+ * the same interface as ReducePrePhase. The table is allocated by local worker
+ * 0 with the memory limits of all local workers, and shared via the
+ * FlowControlChannel. Initialize() and FlushAll() are therefore collective
+ * operations of the workers of a host.
+ */
+template <typename TableItem, typename Key, typename Value,
+          typename KeyExtractor, typename ReduceFunction,
+          const bool VolatileKey,
+          typename BlockWriter,
+          typename ReduceConfig_ = DefaultReduceConfig,
+          typename IndexFunction = ReduceByHash<Key>,
+          typename KeyEqualFunction = std::equal_to<Key> >
+class ReduceSharedPrePhase
+{
+    static constexpr bool debug = false;
+
+public:
+    using ReduceConfig = ReduceConfig_;
+    using Emitter = ReducePrePhaseEmitter<TableItem, VolatileKey, BlockWriter>;
+    using MakeTableItem = ReduceMakeTableItem<Value, TableItem, VolatileKey>;
+
+    using Table = ReduceSharedTable<
+        TableItem, Key, Value, KeyExtractor, ReduceFunction, VolatileKey,
+        IndexFunction, KeyEqualFunction>;
+
+    ReduceSharedPrePhase(
+        Context& ctx, size_t /* dia_id */,
+        size_t num_partitions,
+        KeyExtractor key_extractor,
+        ReduceFunction reduce_function,
+        std::vector<BlockWriter>& emit,
+        const ReduceConfig& config = ReduceConfig(),
+        const IndexFunction& index_function = IndexFunction(),
+        const KeyEqualFunction& key_equal_function = KeyEqualFunction())
+        : ctx_(ctx), num_partitions_(num_partitions),
+          key_extractor_(key_extractor), reduce_function_(reduce_function),
+          config_(config),
+          index_function_(index_function),
+          key_equal_function_(key_equal_function),
+          emit_(emit),
+          emit_fn_(this) {
+        assert(num_partitions == emit.size());
+    }
+
+    //! constructor with the arguments of ReducePrePhase, the hash function is
+    //! only used there for duplicate detection.
+    template <typename HashFunction>
+    ReduceSharedPrePhase(
+        Context& ctx, size_t dia_id,
+        size_t num_partitions,
+        KeyExtractor key_extractor,
+        ReduceFunction reduce_function,
+        std::vector<BlockWriter>& emit,
+        const ReduceConfig& config,
+        const IndexFunction& index_function,
+        const KeyEqualFunction& key_equal_function,
+        const HashFunction& /* hash_function */)
+        : ReduceSharedPrePhase(ctx, dia_id, num_partitions,
+                               key_extractor, reduce_function, emit, config,
+                               index_function, key_equal_function) { }
+
+    //! non-copyable: delete copy-constructor
+    ReduceSharedPrePhase(const ReduceSharedPrePhase&) = delete;
+    //! non-copyable: delete assignment operator
+    ReduceSharedPrePhase& operator = (const ReduceSharedPrePhase&) = delete;
+
+    //! Collectively construct the shared table, using the memory limits of all
+    //! local workers.
+    void Initialize(size_t limit_memory_bytes) {
+        if (ctx_.local_worker_id() == 0) {
+            owned_table_ = std::make_unique<Table>(
+                num_partitions_,
+                shards_per_worker * ctx_.workers_per_host(),
+                limit_memory_bytes * ctx_.workers_per_host(),
+                config_.limit_partition_fill_rate(),
+                key_extractor_, reduce_function_,
+                index_function_, key_equal_function_);
+        }
+        table_ = ctx_.net.LocalShare(owned_table_.get());
+    }
+
+    void Insert(const Value& v) {
+        // for VolatileKey this makes std::pair and extracts the key
+        table_->Insert(MakeTableItem::Make(v, key_extractor_), emit_fn_);
+    }
+
+    //! Collectively flush all shards of the shared table: each local worker
+    //! flushes a disjoint subset of them.
+    void FlushAll() {
+        // wait for all local workers to finish inserting
+        ctx_.net.LocalBarrier();
+
+        for (size_t s = ctx_.local_worker_id(); s < table_->num_shards();
+             s += ctx_.workers_per_host()) {
+            table_->FlushShard(s, emit_fn_);
+        }
+
+        sLOG << "ReduceSharedPrePhase::FlushAll()"
+             << "num_full_flushes" << table_->num_full_flushes();
+
+        // wait for all local workers to finish flushing, then deallocate
+        ctx_.net.LocalBarrier();
+        table_ = nullptr;
+        owned_table_.reset();
+    }
+
+    //! Closes all emitter
+    void CloseAll() {
+        emit_.CloseAll();
+    }
+
+private:
+    //! emit functor passed to the shared table, which delivers items to this
+    //! worker's emitter
+    class EmitFunction
+    {
+    public:
+        explicit EmitFunction(ReduceSharedPrePhase* phase) : phase_(phase) { }
+
+        void operator () (const size_t& partition_id, const TableItem& p) {
+            phase_->emit_.Emit(partition_id, p);
+        }
+
+    private:
+        ReduceSharedPrePhase* phase_;
+    };
+
+    //! number of shards per local worker, which keeps contention low
+    static constexpr size_t shards_per_worker = 16;
+
+    //! Context
+    Context& ctx_;
+
+    //! Number of partitions
+    size_t num_partitions_;
+
+    //! Key extractor function for extracting a key from a value.
+    KeyExtractor key_extractor_;
+
+    //! Reduce function for reducing two values.
+    ReduceFunction reduce_function_;
+
+    //! config of reduce table
+    ReduceConfig config_;
+
+    //! Index Calculation functions: Hash or ByIndex.
+    IndexFunction index_function_;
+
+    //! Comparator function for keys.
+    KeyEqualFunction key_equal_function_;
+
+    //! Emitters used to parameterize hash table for output to network.
+    Emitter emit_;
+
+    //! emit functor for the shared table
+    EmitFunction emit_fn_;
+
+    //! the shared table, owned by local worker 0.
+    std::unique_ptr<Table> owned_table_;
+
+    //! pointer to the shared table
+    Table* table_ = nullptr;
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_REDUCE_SHARED_PRE_PHASE_HEADER
+
+/******************************************************************************/
@@ -0,0 +1,608 @@
+/*******************************************************************************
+ * thrill/core/reduce_swiss_hash_table.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_REDUCE_SWISS_HASH_TABLE_HEADER
+#define THRILL_CORE_REDUCE_SWISS_HASH_TABLE_HEADER
+
+#include <thrill/common/config.hpp>
+#include <thrill/common/defines.hpp>
+#include <thrill/core/reduce_functional.hpp>
+#include <thrill/core/reduce_table.hpp>
+
+#include <tlx/math/ffs.hpp>
+#include <tlx/vector_free.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#ifdef THRILL_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace thrill {
+namespace core {
+
+/*!
+ * A group of control bytes of a ReduceSwissHashTable, which are matched all at
+ * once: with SSE2 using a single byte-wise comparison, otherwise by a scalar
+ * loop. Each match returns a bitmask with bit i set if control byte i matches.
+ *
+ * A control byte is either the 7-bit fingerprint of the item in the slot, or
+ * has the highest bit set if the slot holds no final item: ctrl_empty for empty
+ * slots and ctrl_pending for slots with items awaiting rehashing.
+ */
+class SwissControlGroup
+{
+public:
+    //! number of slots in a group
+    static constexpr size_t size = 16;
+
+    //! control byte of empty slots
+    static constexpr uint8_t ctrl_empty = 0x80;
+
+    //! control byte of slots whose item is not yet rehashed
+    static constexpr uint8_t ctrl_pending = 0xFE;
+
+#ifdef THRILL_HAVE_SSE2
+    explicit SwissControlGroup(const uint8_t* ctrl)
+        : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) { }
+
+    //! match slots with the given fingerprint
+    uint32_t Match(uint8_t fingerprint) const {
+        __m128i match = _mm_set1_epi8(static_cast<char>(fingerprint));
+        return static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(match, ctrl_)));
+    }
+
+    //! match empty and pending slots, which have the highest bit set
+    uint32_t MatchNonFull() const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(ctrl_));
+    }
+#else
+    explicit SwissControlGroup(const uint8_t* ctrl)
+        : ctrl_(ctrl) { }
+
+    //! match slots with the given fingerprint
+    uint32_t Match(uint8_t fingerprint) const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < size; ++i)
+            mask |= uint32_t(ctrl_[i] == fingerprint) << i;
+        return mask;
+    }
+
+    //! match empty and pending slots, which have the highest bit set
+    uint32_t MatchNonFull() const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < size; ++i)
+            mask |= uint32_t(ctrl_[i] >> 7) << i;
+        return mask;
+    }
+#endif
+
+    //! match empty slots
+    uint32_t MatchEmpty() const { return Match(ctrl_empty); }
+
+    //! match slots containing items
+    uint32_t MatchFull() const { return ~MatchNonFull() & 0xFFFF; }
+
+    //! index of the lowest bit set in a non-zero mask
+    static size_t LowestBit(uint32_t mask) {
+        return static_cast<size_t>(tlx::ffs(mask)) - 1;
+    }
+
+private:
+#ifdef THRILL_HAVE_SSE2
+    __m128i ctrl_;
+#else
+    const uint8_t* ctrl_;
+#endif
+};
+
+/*!
+ * A reduce hash table in the style of Swiss tables: the slots of each partition
+ * are split into groups of SwissControlGroup::size slots, and for each slot a
+ * control byte containing a 7-bit fingerprint of the key is stored separately
+ * from the items. A lookup probes the groups linearly, starting at the group
+ * of the local index, and compares the fingerprints of a whole group at once.
+ * Keys are only compared for matching fingerprints, and the probe ends at the
+ * first group containing an empty slot.
+ *
+ * Compared to ReduceProbingHashTable, the probe sequence touches mostly the
+ * compact control bytes instead of full TableItems, which improves cache
+ * behavior for large items, and very few keys need to be compared. As empty
+ * slots are marked by their control byte, there is no sentinel key and slots
+ * contain only constructed TableItems when occupied.
+ *
+ * Partitions grow by doubling up to num_buckets_per_partition_ like in
+ * ReduceProbingHashTable, and are rehashed in place afterwards.
+ */
+template <typename TableItem, typename Key, typename Value,
+          typename KeyExtractor, typename ReduceFunction, typename Emitter,
+          const bool VolatileKey,
+          typename ReduceConfig_,
+          typename IndexFunction,
+          typename KeyEqualFunction = std::equal_to<Key> >
+class ReduceSwissHashTable
+    : public ReduceTable<TableItem, Key, Value,
+                         KeyExtractor, ReduceFunction, Emitter,
+                         VolatileKey, ReduceConfig_,
+                         IndexFunction, KeyEqualFunction>
+{
+    using Super = ReduceTable<TableItem, Key, Value,
+                              KeyExtractor, ReduceFunction, Emitter,
+                              VolatileKey, ReduceConfig_, IndexFunction,
+                              KeyEqualFunction>;
+    using Super::debug;
+
+    using Group = SwissControlGroup;
+    static constexpr size_t group_size = Group::size;
+
+public:
+    using ReduceConfig = ReduceConfig_;
+
+    ReduceSwissHashTable(
+        Context& ctx, size_t dia_id,
+        const KeyExtractor& key_extractor,
+        const ReduceFunction& reduce_function,
+        Emitter& emitter,
+        size_t num_partitions,
+        const ReduceConfig& config = ReduceConfig(),
+        bool immediate_flush = false,
+        const IndexFunction& index_function = IndexFunction(),
+        const KeyEqualFunction& key_equal_function = KeyEqualFunction())
+        : Super(ctx, dia_id,
+                key_extractor, reduce_function, emitter,
+                num_partitions, config, immediate_flush,
+                index_function, key_equal_function)
+    { assert(num_partitions > 0); }
+
+    //! Construct the hash table itself: allocate the slots and set all control
+    //! bytes to empty.
+    void Initialize(size_t limit_memory_bytes) {
+        assert(!items_);
+
+        limit_memory_bytes_ = limit_memory_bytes;
+
+        // calculate num_buckets_per_partition_ from the memory limit, each slot
+        // needs an item and a control byte. Partitions consist of whole groups.
+
+        num_buckets_per_partition_ =
+            static_cast<size_t>(
+                static_cast<double>(limit_memory_bytes_)
+                / static_cast<double>(sizeof(TableItem) + 1)
+                / static_cast<double>(num_partitions_))
+            / group_size * group_size;
+
+        num_buckets_per_partition_ =
+            std::max(num_buckets_per_partition_, size_t(group_size));
+
+        num_buckets_ = num_buckets_per_partition_ * num_partitions_;
+
+        partition_size_.resize(
+            num_partitions_,
+            std::min(RoundUpToGroup(config_.initial_items_per_partition_),
+                     num_buckets_per_partition_));
+
+        // calculate limit on the number of items in a partition before these
+        // are spilled to disk or flushed to network.
+
+        double limit_fill_rate = config_.limit_partition_fill_rate();
+
+        assert(limit_fill_rate >= 0.0 && limit_fill_rate <= 1.0
+               && "limit_partition_fill_rate must be between 0.0 and 1.0. "
+               "with a fill rate of 0.0, items are immediately flushed.");
+
+        limit_items_per_partition_.resize(
+            num_partitions_,
+            static_cast<size_t>(
+                static_cast<double>(partition_size_[0]) * limit_fill_rate));
+
+        // allocate the slots, which are constructed only when occupied.
+
+        items_ = static_cast<TableItem*>(
+            operator new (num_buckets_ * sizeof(TableItem)));
+
+        ctrl_.resize(num_buckets_, uint8_t(Group::ctrl_empty));
+    }
+
+    ~ReduceSwissHashTable() {
+        if (items_) Dispose();
+    }
+
+    /*!
+     * Inserts a value into the table, potentially reducing it in case both the
+     * key of the value already in the table and the key of the value to be
+     * inserted are the same.
+     *
+     * An insert may trigger a resize of the partition in case the maximal fill
+     * ratio per partition is reached, or a spill if it cannot grow further.
+     *
+     * \param kv Value to be inserted into the table.
+     *
+     * \param h Index of the value as calculated by calculate_index(kv).
+     *
+     * \return true if a new key was inserted to the table
+     */
+    bool Insert(const TableItem& kv, const typename IndexFunction::Result& h) {
+        assert(h.partition_id < num_partitions_);
+
+        const size_t partition_id = h.partition_id;
+        const Key k = key(kv);
+        const uint8_t fingerprint = h.fingerprint();
+
+        TableItem* items = items_ + partition_id * num_buckets_per_partition_;
+        uint8_t* ctrl = ctrl_.data() + partition_id * num_buckets_per_partition_;
+
+        size_t num_groups = partition_size_[partition_id] / group_size;
+        size_t group =
+            h.local_index(partition_size_[partition_id]) / group_size;
+
+        for (size_t probe = 0; probe < num_groups; ++probe)
+        {
+            size_t offset = group * group_size;
+            Group g(ctrl + offset);
+
+            for (uint32_t m = g.Match(fingerprint); m; m &= m - 1) {
+                TableItem& item = items[offset + Group::LowestBit(m)];
+                if (key_equal_function_(key(item), k)) {
+                    item = reduce(item, kv);
+                    return false;
+                }
+            }
+
+            uint32_t empty = g.MatchEmpty();
+            if (empty) {
+                // insert new pair into first empty slot of the group
+                size_t i = offset + Group::LowestBit(empty);
+                new (items + i)TableItem(kv);
+                ctrl[i] = fingerprint;
+
+                // increase counter for partition
+                ++items_per_partition_[partition_id];
+                ++num_items_;
+
+                while (TLX_UNLIKELY(
+                           items_per_partition_[partition_id] >=
+                           limit_items_per_partition_[partition_id])) {
+                    LOG << "Grow due to "
+                        << items_per_partition_[partition_id] << " >= "
+                        << limit_items_per_partition_[partition_id]
+                        << " among " << partition_size_[partition_id];
+                    GrowAndRehash(partition_id);
+                }
+
+                return true;
+            }
+
+            // wrap around if beyond the current partition
+            if (++group == num_groups)
+                group = 0;
+        }
+
+        // flush partition and retry, if all slots are reserved
+        GrowAndRehash(partition_id);
+        return Insert(kv, h);
+    }
+
+    //! Inserts a value into the table, see Insert(kv, h).
+    bool Insert(const TableItem& kv) {
+        return Insert(kv, calculate_index(kv));
+    }
+
+    //! Prefetch the control bytes and first slot probed for a value with index
+    //! h for a following Insert().
+    void Prefetch(const typename IndexFunction::Result& h) const {
+        size_t offset =
+            h.partition_id * num_buckets_per_partition_
+            + h.local_index(partition_size_[h.partition_id])
+            / group_size * group_size;
+        THRILL_PREFETCH_WRITE(ctrl_.data() + offset);
+        THRILL_PREFETCH_WRITE(items_ + offset);
+    }
+
+    //! Deallocate items and memory
+    void Dispose() {
+        if (!items_) return;
+
+        // dispose the items by destructor
+
+        for (size_t offset = 0; offset < num_buckets_; offset += group_size) {
+            for (uint32_t m = Group(ctrl_.data() + offset).MatchFull();
+                 m; m &= m - 1) {
+                items_[offset + Group::LowestBit(m)].~TableItem();
+            }
+        }
+
+        operator delete (items_);
+        items_ = nullptr;
+
+        tlx::vector_free(ctrl_);
+
+        Super::Dispose();
+    }
+
+    void GrowAndRehash(size_t partition_id) {
+
+        size_t old_size = partition_size_[partition_id];
+        GrowPartition(partition_id);
+        if (partition_size_[partition_id] == old_size) {
+            SpillPartition(partition_id);
+            return;
+        }
+
+        RehashPartition(partition_id, old_size);
+    }
+
+    //! Grow a partition after a spill or flush (if possible)
+    void GrowPartition(size_t partition_id) {
+
+        if (TLX_UNLIKELY(mem::memory_exceeded)) {
+            SpillPartition(partition_id);
+            return;
+        }
+
+        if (partition_size_[partition_id] == num_buckets_per_partition_)
+            return;
+
+        size_t new_size = std::min(
+            num_buckets_per_partition_, 2 * partition_size_[partition_id]);
+
+        sLOG << "Growing partition" << partition_id
+             << "from" << partition_size_[partition_id] << "to" << new_size
+             << "limit_items" << new_size * config_.limit_partition_fill_rate();
+
+        // the control bytes of the new slots are already empty
+
+        partition_size_[partition_id] = new_size;
+        limit_items_per_partition_[partition_id]
+            = new_size * config_.limit_partition_fill_rate();
+    }
+
+    //! \name Spilling Mechanisms to External Memory Files
+    //! \{
+
+    //! Spill all items of a partition into an external memory File.
+    void SpillPartition(size_t partition_id) {
+
+        if (immediate_flush_) {
+            return FlushPartition(
+                partition_id, /* consume */ true, /* grow */ !mem::memory_exceeded);
+        }
+
+        LOG << "Spilling " << items_per_partition_[partition_id]
+            << " items of partition with id: " << partition_id;
+
+        if (items_per_partition_[partition_id] == 0)
+            return;
+
+        data::File::Writer writer = partition_files_[partition_id].GetWriter();
+
+        ScanPartition(
+            partition_id, /* consume */ true,
+            [&writer](const TableItem& item) { writer.Put(item); });
+
+        // reset partition specific counter
+        num_items_ -= items_per_partition_[partition_id];
+        items_per_partition_[partition_id] = 0;
+        assert(num_items_ == this->num_items_calc());
+
+        LOG << "Spilled items of partition with id: " << partition_id;
+    }
+
+    //! Spill all items of an arbitrary partition into an external memory File.
+    void SpillAnyPartition() {
+        // maybe make a policy later -tb
+        return SpillLargestPartition();
+    }
+
+    //! Spill all items of the largest partition into an external memory File.
+    void SpillLargestPartition() {
+        // get partition with max size
+        size_t size_max = 0, index = 0;
+
+        for (size_t i = 0; i < num_partitions_; ++i)
+        {
+            if (items_per_partition_[i] > size_max)
+            {
+                size_max = items_per_partition_[i];
+                index = i;
+            }
+        }
+
+        if (size_max == 0) {
+            return;
+        }
+
+        return SpillPartition(index);
+    }
+
+    //! \}
+
+    //! \name Flushing Mechanisms to Next Stage or Phase
+    //! \{
+
+    template <typename Emit>
+    void FlushPartitionEmit(
+        size_t partition_id, bool consume, bool grow, Emit emit) {
+
+        LOG << "Flushing " << items_per_partition_[partition_id]
+            << " items of partition: " << partition_id;
+
+        ScanPartition(
+            partition_id, consume,
+            [&emit, partition_id](const TableItem& item) {
+                emit(partition_id, item);
+            });
+
+        if (consume) {
+            // reset partition specific counter
+            num_items_ -= items_per_partition_[partition_id];
+            items_per_partition_[partition_id] = 0;
+            assert(num_items_ == this->num_items_calc());
+        }
+
+        LOG << "Done flushed items of partition: " << partition_id;
+
+        if (grow)
+            GrowPartition(partition_id);
+    }
+
+    void FlushPartition(size_t partition_id, bool consume, bool grow) {
+        FlushPartitionEmit(
+            partition_id, consume, grow,
+            [this](const size_t& partition_id, const TableItem& p) {
+                this->emitter_.Emit(partition_id, p);
+            });
+    }
+
+    void FlushAll() {
+        for (size_t i = 0; i < num_partitions_; ++i) {
+            FlushPartition(i, /* consume */ true, /* grow */ false);
+        }
+    }
+
+    //! \}
+
+public:
+    using Super::calculate_index;
+
+private:
+    using Super::config_;
+    using Super::immediate_flush_;
+    using Super::index_function_;
+    using Super::items_per_partition_;
+    using Super::key;
+    using Super::key_equal_function_;
+    using Super::limit_memory_bytes_;
+    using Super::num_buckets_;
+    using Super::num_buckets_per_partition_;
+    using Super::num_items_;
+    using Super::num_partitions_;
+    using Super::partition_files_;
+    using Super::reduce;
+
+    //! Storing the items, slots are constructed only when occupied.
+    TableItem* items_ = nullptr;
+
+    //! Control bytes of the slots: fingerprints of the items or empty.
+    std::vector<uint8_t> ctrl_;
+
+    //! Current sizes of the partitions because the valid allocated areas grow
+    std::vector<size_t> partition_size_;
+
+    //! Current limits on the number of items in a partitions, different for
+    //! different partitions, because the valid allocated areas grow.
+    std::vector<size_t> limit_items_per_partition_;
+
+    //! round up to a multiple of the group size
+    static size_t RoundUpToGroup(size_t size) {
+        return (size + group_size - 1) / group_size * group_size;
+    }
+
+    //! call visit for all items of a partition, and destruct them if consume.
+    template <typename Visit>
+    void ScanPartition(size_t partition_id, bool consume, Visit visit) {
+        TableItem* items = items_ + partition_id * num_buckets_per_partition_;
+        uint8_t* ctrl = ctrl_.data() + partition_id * num_buckets_per_partition_;
+
+        size_t size = partition_size_[partition_id];
+        for (size_t offset = 0; offset < size; offset += group_size) {
+            for (uint32_t m = Group(ctrl + offset).MatchFull(); m; m &= m - 1) {
+                size_t i = offset + Group::LowestBit(m);
+                visit(items[i]);
+                if (consume) {
+                    items[i].~TableItem();
+                    ctrl[i] = Group::ctrl_empty;
+                }
+            }
+        }
+    }
+
+    //! find the first empty or pending slot in the probe sequence starting at
+    //! group, the partition must contain one.
+    static size_t FindNonFull(const uint8_t* ctrl, size_t size, size_t group) {
+        size_t num_groups = size / group_size;
+        while (true) {
+            size_t offset = group * group_size;
+            uint32_t m = Group(ctrl + offset).MatchNonFull();
+            if (m) return offset + Group::LowestBit(m);
+            if (++group == num_groups) group = 0;
+        }
+    }
+
+    /*!
+     * Rehash the items in the first old_size slots of a partition after it has
+     * grown, in place. All items are first marked pending, then each pending
+     * item is moved to the first empty or pending slot of its probe sequence,
+     * swapping with the pending item found there. Hence, probe sequences of
+     * rehashed items only pass over slots with rehashed items, which remain
+     * occupied.
+     */
+    void RehashPartition(size_t partition_id, size_t old_size) {
+        TableItem* items = items_ + partition_id * num_buckets_per_partition_;
+        uint8_t* ctrl = ctrl_.data() + partition_id * num_buckets_per_partition_;
+
+        size_t size = partition_size_[partition_id];
+
+        for (size_t i = 0; i < old_size; ++i) {
+            if (ctrl[i] != Group::ctrl_empty)
+                ctrl[i] = Group::ctrl_pending;
+        }
+
+        for (size_t i = 0; i < old_size; ++i) {
+            while (ctrl[i] == Group::ctrl_pending) {
+                typename IndexFunction::Result h = calculate_index(items[i]);
+                size_t j = FindNonFull(
+                    ctrl, size, h.local_index(size) / group_size);
+
+                if (j == i) {
+                    ctrl[i] = h.fingerprint();
+                }
+                else if (ctrl[j] == Group::ctrl_empty) {
+                    new (items + j)TableItem(std::move(items[i]));
+                    items[i].~TableItem();
+                    ctrl[i] = Group::ctrl_empty;
+                    ctrl[j] = h.fingerprint();
+                }
+                else {
+                    // swap with pending item and rehash that one next
+                    std::swap(items[i], items[j]);
+                    ctrl[j] = h.fingerprint();
+                }
+            }
+        }
+    }
+};
+
+template <typename TableItem, typename Key, typename Value,
+          typename KeyExtractor, typename ReduceFunction,
+          typename Emitter, const bool VolatileKey,
+          typename ReduceConfig, typename IndexFunction,
+          typename KeyEqualFunction>
+class ReduceTableSelect<
+        ReduceTableImpl::SWISS,
+        TableItem, Key, Value, KeyExtractor, ReduceFunction,
+        Emitter, VolatileKey, ReduceConfig, IndexFunction, KeyEqualFunction>
+{
+public:
+    using type = ReduceSwissHashTable<
+        TableItem, Key, Value, KeyExtractor, ReduceFunction,
+        Emitter, VolatileKey, ReduceConfig,
+        IndexFunction, KeyEqualFunction>;
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_REDUCE_SWISS_HASH_TABLE_HEADER
+
+/******************************************************************************/
@@ -27,9 +27,10 @@
 namespace thrill {
 namespace core {
 
-//! Enum class to select a hash table implementation.
+//! Enum class to select a hash table implementation. DENSE is a direct-mapped
+//! array which can only be used with ReduceByIndex, e.g. in ReduceToIndex.
 enum class ReduceTableImpl {
-    PROBING, OLD_PROBING, BUCKET
+    PROBING, OLD_PROBING, BUCKET, SWISS, DENSE
 };
 
 /*!
@@ -48,12 +49,28 @@ public:
     //! relative to the maximum possible number.
     double bucket_rate_ = 0.6;
 
+    //! only for ReducePrePhase: bypass the table and emit items directly, if
+    //! fewer than this fraction of sampled inserts were reduced. 0 disables.
+    double limit_skip_reduction_rate_ = 0.05;
+
     //! select the hash table in the reduce phase by enum
     static constexpr ReduceTableImpl table_impl_ = ReduceTableImpl::PROBING;
 
     //! only for growing ProbingHashTable: items initially in a partition.
     static constexpr size_t initial_items_per_partition_ = 512;
 
+    //! only for ReducePrePhase: number of items whose table slots are
+    //! calculated and prefetched before inserting them, 0 disables batching.
+    static constexpr size_t insert_batch_size_ = 16;
+
+    //! only for ReducePrePhase: number of inserts sampled to determine the
+    //! reduction rate.
+    static constexpr size_t skip_sample_items_ = 64 * 1024;
+
+    //! only for ReducePrePhase: number of items emitted directly while
+    //! bypassing the table, before sampling the reduction rate again.
+    static constexpr size_t skip_recheck_items_ = 1024 * 1024;
+
     //! only for BucketHashTable: size of a block in the bucket chain in bytes
     //! (must be a static constexpr)
     static constexpr size_t bucket_block_size_ = 512;
@@ -66,6 +83,10 @@ public:
     //! the pre and post phases simultaneously.
     static constexpr bool use_post_thread_ = true;
 
+    //! use one concurrent pre-phase table shared by all workers of a host in
+    //! ReduceNode instead of one table per worker.
+    static constexpr bool use_shared_pre_phase_ = false;
+
     //! \name Accessors
     //! \{
 
@@ -76,6 +97,10 @@ public:
     //! Returns bucket_rate_
     double bucket_rate() const { return bucket_rate_; }
 
+    //! Returns limit_skip_reduction_rate_
+    double limit_skip_reduction_rate() const
+    { return limit_skip_reduction_rate_; }
+
     //! \}
 };
 
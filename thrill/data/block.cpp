@@ -32,13 +32,18 @@ std::ostream& operator << (std::ostream& os, const Block& b) {
     return os << "]";
 }
 
-PinnedBlock Block::PinWait(size_t local_worker_id) const {
-    return Pin(local_worker_id)->Wait();
+PinnedBlock Block::PinWait(size_t local_worker_id, AccessHint hint) const {
+    return Pin(local_worker_id, hint)->Wait();
 }
 
-PinRequestPtr Block::Pin(size_t local_worker_id) const {
+PinRequestPtr Block::Pin(size_t local_worker_id, AccessHint hint) const {
     assert(IsValid());
-    return byte_block()->block_pool_->PinBlock(*this, local_worker_id);
+    return byte_block()->block_pool_->PinBlock(*this, local_worker_id, hint);
+}
+
+void Block::AdviseAccess(AccessHint hint) const {
+    assert(IsValid());
+    return byte_block_->AdviseAccess(hint);
 }
 
 /******************************************************************************/
@@ -96,6 +96,9 @@ public:
     //! accessor to end_
     void set_end(size_t i) { end_ = i; }
 
+    //! accessor to num_items_
+    void set_num_items(size_t n) { num_items_ = n; }
+
     //! return length of valid data in bytes.
     size_t size() const { return end_ - begin_; }
 
@@ -112,11 +115,17 @@ public:
 
     //! Creates a pinned copy of this Block. If the underlying data::ByteBlock
     //! is already pinned, the Future is directly filled with a copy if this
-    //! block.  Otherwise an async pin call will be issued.
-    PinRequestPtr Pin(size_t local_worker_id) const;
+    //! block.  Otherwise an async pin call will be issued. The hint declares
+    //! how the ByteBlock is accessed once the pin is released.
+    PinRequestPtr Pin(size_t local_worker_id,
+                      AccessHint hint = AccessHint::Normal) const;
 
     //! Convenience function to call Pin() and wait for the future.
-    PinnedBlock PinWait(size_t local_worker_id) const;
+    PinnedBlock PinWait(size_t local_worker_id,
+                        AccessHint hint = AccessHint::Normal) const;
+
+    //! Advise the BlockPool how the underlying ByteBlock will be accessed.
+    void AdviseAccess(AccessHint hint) const;
 
 protected:
     static constexpr bool debug = false;
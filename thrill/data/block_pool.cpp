@@ -12,12 +12,13 @@
 #include <thrill/common/math.hpp>
 #include <thrill/data/block.hpp>
 #include <thrill/data/block_pool.hpp>
+#include <thrill/data/byte_block_recycler.hpp>
 #include <thrill/mem/aligned_allocator.hpp>
+#include <thrill/mem/huge_page_arena.hpp>
 #include <thrill/mem/pool.hpp>
 
 #include <foxxll/io/file.hpp>
 #include <foxxll/io/iostats.hpp>
-#include <tlx/container/lru_cache.hpp>
 #include <tlx/die.hpp>
 #include <tlx/math/is_power_of_two.hpp>
 #include <tlx/string/join_generic.hpp>
@@ -26,6 +27,7 @@
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <list>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
@@ -223,6 +225,110 @@ std::ostream& operator << (std::ostream& os, const BlockPool::PinCount& p) {
     return os;
 }
 
+/******************************************************************************/
+// UnpinnedBlockSet
+
+/*!
+ * Set of unpinned ByteBlocks in RAM, ordered for eviction by their AccessHint.
+ *
+ * The ByteBlocks are kept in three lists: Scanned blocks are evicted first,
+ * most recently scanned first, such that a repeated scan over a File larger
+ * than RAM keeps its beginning in memory instead of evicting each block just
+ * before it is needed again. Normal blocks are evicted in LRU order, and
+ * WillNeed blocks only when no other unpinned blocks are left. Hence one large
+ * sequential scan does not flush the working set of other Files.
+ */
+class UnpinnedBlockSet
+{
+public:
+    //! insert an unpinned ByteBlock into the list given by its access_hint().
+    void put(ByteBlock* block_ptr) {
+        size_t l = list_index(block_ptr->access_hint());
+        lists_[l].push_front(block_ptr);
+        bool inserted =
+            map_.emplace(block_ptr, Entry { lists_[l].begin(), l }).second;
+        die_unless(inserted);
+    }
+
+    //! check whether the ByteBlock is contained
+    bool exists(ByteBlock* block_ptr) const {
+        return map_.find(block_ptr) != map_.end();
+    }
+
+    //! remove a contained ByteBlock
+    void erase(ByteBlock* block_ptr) {
+        auto it = map_.find(block_ptr);
+        die_unless(it != map_.end());
+        lists_[it->second.list].erase(it->second.iter);
+        map_.erase(it);
+    }
+
+    //! move a ByteBlock to the list given by its changed access_hint(), if it
+    //! is contained.
+    void update(ByteBlock* block_ptr) {
+        auto it = map_.find(block_ptr);
+        if (it == map_.end()) return;
+        size_t l = list_index(block_ptr->access_hint());
+        // splice keeps the iterator valid
+        lists_[l].splice(lists_[l].begin(),
+                         lists_[it->second.list], it->second.iter);
+        it->second.list = l;
+    }
+
+    //! remove and return the next ByteBlock to evict.
+    ByteBlock * pop() {
+        die_unless(size() != 0);
+        ByteBlock* block_ptr;
+        if (!lists_[0].empty())
+            block_ptr = lists_[0].front();
+        else if (!lists_[1].empty())
+            block_ptr = lists_[1].back();
+        else
+            block_ptr = lists_[2].back();
+        erase(block_ptr);
+        return block_ptr;
+    }
+
+    //! number of contained ByteBlocks
+    size_t size() const { return map_.size(); }
+
+    //! number of contained ByteBlocks with given hint
+    size_t size(AccessHint hint) const {
+        return lists_[list_index(hint)].size();
+    }
+
+private:
+    using List = std::list<ByteBlock*, mem::GPoolAllocator<ByteBlock*> >;
+
+    //! position of a ByteBlock in the lists
+    struct Entry {
+        List::iterator iter;
+        size_t list;
+    };
+
+    //! lists of ByteBlocks in order of eviction: scanned, normal, will need.
+    //! New ByteBlocks are inserted at the front.
+    List lists_[3];
+
+    //! map of ByteBlocks to their position
+    std::unordered_map<
+        ByteBlock*, Entry, std::hash<ByteBlock*>, std::equal_to<>,
+        mem::GPoolAllocator<std::pair<ByteBlock* const, Entry> > > map_;
+
+    //! index of list for a hint
+    static size_t list_index(AccessHint hint) {
+        switch (hint) {
+        case AccessHint::Scanned:
+            return 0;
+        case AccessHint::Normal:
+            return 1;
+        case AccessHint::WillNeed:
+            return 2;
+        }
+        return 1;
+    }
+};
+
 /******************************************************************************/
 // BlockPool::Data
 
@@ -256,9 +362,9 @@ public:
     //! print a message on the first block evicted to external memory
     bool notify_em_used_ = false;
 
-    //! list of all blocks that are _in_memory_ but are _not_ pinned.
-    tlx::LruCacheSet<
-        ByteBlock*, mem::GPoolAllocator<ByteBlock*> > unpinned_blocks_;
+    //! set of all blocks that are _in_memory_ but are _not_ pinned, ordered
+    //! for eviction.
+    UnpinnedBlockSet unpinned_blocks_;
 
     //! set of ByteBlocks currently begin written to EM.
     WritingMap writing_;
@@ -284,6 +390,89 @@ public:
     //! I/O. Allocations are counted via mem_manager_.
     mem::AlignedAllocator<Byte, mem::Allocator<char> > aligned_alloc_;
 
+    //! reference to BlockPool's Manager for counting arena allocations.
+    mem::Manager& mem_manager_;
+
+    //! Arenas of huge page backed regions for ByteBlocks, one for each
+    //! power-of-two size from min_arena_block_size up to default_block_size,
+    //! and one for default_block_size itself. Blocks of mixed sizes, as
+    //! created by BlockSizePolicy, are thus served by the arenas. Other sizes
+    //! or allocations beyond an arena's limit fall back to aligned_alloc_.
+    //! Idle slots count as used RAM and are released to the operating system
+    //! under memory pressure, or when another size needs new memory.
+    std::vector<std::unique_ptr<mem::HugePageArena> > block_arenas_;
+
+    //! smallest ByteBlock size allocated from an arena, smaller blocks are
+    //! cheap for the aligned allocator.
+    static constexpr size_t min_arena_block_size = 64 * 1024;
+
+    //! return arena for ByteBlocks of given size, or nullptr.
+    mem::HugePageArena * FindBlockArena(size_t size) {
+        if (size < min_arena_block_size) return nullptr;
+        for (const std::unique_ptr<mem::HugePageArena>& a : block_arenas_) {
+            if (a->slot_size() == size) return a.get();
+        }
+        return nullptr;
+    }
+
+    //! resident memory of the arenas which is not used by ByteBlocks, e.g.
+    //! freed slots and explicit huge page regions, which are committed in full.
+    size_t ArenaIdleBytes() const {
+        size_t idle = 0;
+        for (const std::unique_ptr<mem::HugePageArena>& a : block_arenas_)
+            idle += a->idle_bytes();
+        return idle;
+    }
+
+    //! release the idle memory of the arenas to the operating system.
+    void IntTrimArenas() {
+        size_t released = 0;
+        for (const std::unique_ptr<mem::HugePageArena>& a : block_arenas_)
+            released += a->Trim();
+        LOGC(debug_mem && released != 0)
+            << "BlockPool::IntTrimArenas() released=" << released;
+    }
+
+    //! RAM counted against the limits: ByteBlocks, reservations, and idle
+    //! arena memory.
+    size_t IntRamBytes() const {
+        return total_ram_bytes_ + ArenaIdleBytes();
+    }
+
+    //! recyclers caching the memory of destroyed ByteBlocks, which stays
+    //! counted in total_ram_bytes_.
+    std::vector<ByteBlockRecycler*> recyclers_;
+
+    //! memory cached by all recyclers
+    size_t RecycledBytes() const {
+        size_t cached = 0;
+        for (const ByteBlockRecycler* r : recyclers_)
+            cached += r->cached_bytes();
+        return cached;
+    }
+
+    //! deallocate memory taken from a recycler and release it from the RAM
+    //! counted.
+    void IntDeallocateRecycled(
+        const std::vector<std::pair<Byte*, size_t> >& areas) {
+        for (const std::pair<Byte*, size_t>& a : areas) {
+            sLOGC(debug_alloc)
+                << "ByteBlock deallocate recycled" << (void*)a.first
+                << "size" << a.second;
+            DeallocateBlockData(a.first, a.second);
+            IntReleaseInternalMemory(a.second);
+        }
+    }
+
+    //! release the memory cached by all recyclers, they refill when RAM is
+    //! available again.
+    void IntDrainRecyclers() {
+        for (ByteBlockRecycler* r : recyclers_) {
+            if (r->cached_bytes() == 0) continue;
+            IntDeallocateRecycled(r->TakeAll(/* close */ false));
+        }
+    }
+
     //! next unique File id
     std::atomic<size_t> next_file_id_ { 0 };
 
@@ -333,7 +522,34 @@ public:
           hard_ram_limit_(hard_ram_limit),
           bm_(foxxll::block_manager::get_instance()),
           aligned_alloc_(mem::Allocator<char>(block_pool.mem_manager_)),
-          pin_count_(workers_per_host) { }
+          mem_manager_(block_pool.mem_manager_),
+          pin_count_(workers_per_host) {
+
+        if (use_block_arena && default_block_size % THRILL_DEFAULT_ALIGN == 0) {
+            // use regions of 1 GiB (possibly gigantic pages) only if there is
+            // a large amount of RAM.
+            size_t region_size =
+                hard_ram_limit >= 8 * 1024 * 1024 * 1024llu
+                ? 1024 * 1024 * 1024llu
+                : mem::HugePageArena::default_region_size;
+            // regions only reserve address space, hence arenas of unused
+            // sizes cost nothing.
+            for (size_t size = min_arena_block_size;
+                 size < default_block_size; size *= 2) {
+                block_arenas_.emplace_back(
+                    std::make_unique<mem::HugePageArena>(size, region_size));
+            }
+            block_arenas_.emplace_back(
+                std::make_unique<mem::HugePageArena>(
+                    default_block_size, region_size));
+        }
+    }
+
+    //! Allocate memory for a ByteBlock, from the arena if possible.
+    Byte * AllocateBlockData(size_t size);
+
+    //! Deallocate the memory of a ByteBlock.
+    void DeallocateBlockData(Byte* data, size_t size);
 
     //! Updates the memory manager for internal memory. If the hard limit is
     //! reached, the call is blocked intil memory is free'd
@@ -348,7 +564,7 @@ public:
     void IntUnpinBlock(
         BlockPool& bp, ByteBlock* block_ptr, size_t local_worker_id);
 
-    //! Evict a block from the lru list into external memory
+    //! Evict the next block from the unpinned set into external memory
     foxxll::request_ptr IntEvictBlockLRU();
 
     //! Evict a block into external memory. The block must be unpinned and not
@@ -367,6 +583,35 @@ public:
     //! \}
 };
 
+Byte* BlockPool::Data::AllocateBlockData(size_t size) {
+    if (mem::HugePageArena* arena = FindBlockArena(size)) {
+        // the slot commits new memory: first release the idle slots of other
+        // sizes, which are left over from phases with other block sizes.
+        if (!arena->has_resident_free()) {
+            for (const std::unique_ptr<mem::HugePageArena>& a : block_arenas_) {
+                if (a.get() != arena && a->releasable_bytes() >= size)
+                    a->Trim();
+            }
+        }
+        Byte* data = static_cast<Byte*>(arena->allocate());
+        if (data) {
+            mem_manager_.add(size);
+            return data;
+        }
+    }
+    return aligned_alloc_.allocate(size);
+}
+
+void BlockPool::Data::DeallocateBlockData(Byte* data, size_t size) {
+    mem::HugePageArena* arena = FindBlockArena(size);
+    if (arena && arena->contains(data)) {
+        arena->deallocate(data);
+        mem_manager_.subtract(size);
+        return;
+    }
+    aligned_alloc_.deallocate(data, size);
+}
+
 /******************************************************************************/
 // BlockPool
 
@@ -481,7 +726,8 @@ BlockPool::~BlockPool() {
 }
 
 PinnedByteBlockPtr
-BlockPool::AllocateByteBlock(size_t size, size_t local_worker_id) {
+BlockPool::AllocateByteBlock(size_t size, size_t local_worker_id,
+                             const ByteBlockRecyclerPtr& recycler) {
     assert(local_worker_id < workers_per_host_);
     std::unique_lock<std::mutex> lock(mutex_);
 
@@ -493,19 +739,24 @@ BlockPool::AllocateByteBlock(size_t size, size_t local_worker_id) {
             "ByteBlocks must be >= " << THRILL_DEFAULT_ALIGN << " and a power of two.");
     }
 
-    d_->IntRequestInternalMemory(lock, size);
+    // reuse memory of a destroyed ByteBlock, which is still counted as used
+    // RAM, or request RAM and allocate block memory. -- unlock mutex for that
+    // time, since it may require block eviction.
+    Byte* data = recycler ? recycler->Take(size) : nullptr;
+    if (!data) {
+        d_->IntRequestInternalMemory(lock, size);
 
-    // allocate block memory. -- unlock mutex for that time, since it may
-    // require block eviction.
-    lock.unlock();
-    Byte* data = d_->aligned_alloc_.allocate(size);
-    LOGC(debug_alloc)
-        << "ByteBlock aligned_alloc: " << (void*)data << " size " << size;
-    lock.lock();
+        lock.unlock();
+        data = d_->AllocateBlockData(size);
+        LOGC(debug_alloc)
+            << "ByteBlock aligned_alloc: " << (void*)data << " size " << size;
+        lock.lock();
+    }
 
     // create tlx::CountingPtr, no need for special make_shared()-equivalent
     PinnedByteBlockPtr block_ptr(
         mem::GPool().make<ByteBlock>(this, data, size), local_worker_id);
+    block_ptr->recycler_ = recycler;
     ++d_->total_byte_blocks_;
     d_->total_bytes_ += size;
     d_->max_total_bytes_ = std::max(d_->max_total_bytes_, d_->total_bytes_.value);
@@ -545,12 +796,16 @@ ByteBlockPtr BlockPool::MapExternalBlock(
 }
 
 //! Pins a block by swapping it in if required.
-PinRequestPtr BlockPool::PinBlock(const Block& block, size_t local_worker_id) {
+PinRequestPtr BlockPool::PinBlock(const Block& block, size_t local_worker_id,
+                                  AccessHint hint) {
     assert(local_worker_id < workers_per_host_);
     std::unique_lock<std::mutex> lock(mutex_);
 
     ByteBlock* block_ptr = block.byte_block().get();
 
+    // the latest pin determines the eviction order once unpinned.
+    block_ptr->access_hint_ = hint;
+
     if (block_ptr->pin_count_[local_worker_id] > 0) {
         // We may get a Block who's underlying is already pinned, since
         // PinnedBlock become Blocks when transfered between Files or delivered
@@ -673,7 +928,7 @@ PinRequestPtr BlockPool::PinBlock(const Block& block, size_t local_worker_id) {
     // allocate block memory.
     lock.unlock();
     Byte* data = read->byte_block()->data_ =
-        d_->aligned_alloc_.allocate(block_ptr->size());
+        d_->AllocateBlockData(block_ptr->size());
     lock.lock();
 
     if (!block_ptr->ext_file_) {
@@ -700,6 +955,18 @@ PinRequestPtr BlockPool::PinBlock(const Block& block, size_t local_worker_id) {
     return read;
 }
 
+void BlockPool::AdviseAccess(ByteBlock* block_ptr, AccessHint hint) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (block_ptr->access_hint_ == hint) return;
+
+    LOGC(debug_pin)
+        << "BlockPool::AdviseAccess() byte_block=" << block_ptr
+        << " hint " << block_ptr->access_hint_ << " -> " << hint;
+
+    block_ptr->access_hint_ = hint;
+    d_->unpinned_blocks_.update(block_ptr);
+}
+
 std::pair<size_t, size_t> BlockPool::MaxMergeDegreePrefetch(size_t num_files) {
     size_t avail_bytes = hard_ram_limit() / workers_per_host_ / 2;
     size_t avail_blocks = avail_bytes / default_block_size;
@@ -748,7 +1015,7 @@ void BlockPool::OnReadComplete(
         sLOGC(debug_alloc)
             << "ByteBlock  deallocate"
             << (void*)read->byte_block()->data_ << "size" << block_size;
-        d_->aligned_alloc_.deallocate(read->byte_block()->data_, block_size);
+        d_->DeallocateBlockData(read->byte_block()->data_, block_size);
 
         d_->IntReleaseInternalMemory(block_size);
 
@@ -1025,7 +1292,7 @@ void BlockPool::DestroyBlock(ByteBlock* block_ptr) {
         sLOGC(debug_alloc)
             << "ByteBlock deallocate"
             << (void*)block_ptr->data_ << "size" << block_ptr->size();
-        d_->aligned_alloc_.deallocate(block_ptr->data_, block_ptr->size());
+        d_->DeallocateBlockData(block_ptr->data_, block_ptr->size());
         block_ptr->data_ = nullptr;
 
         d_->IntReleaseInternalMemory(block_ptr->size());
@@ -1048,14 +1315,18 @@ void BlockPool::DestroyBlock(ByteBlock* block_ptr) {
             d_->unpinned_bytes_ -= block_ptr->size();
         }
 
-        // release memory
-        sLOGC(debug_alloc)
-            << "ByteBlock deallocate"
-            << (void*)block_ptr->data_ << "size" << block_ptr->size();
-        d_->aligned_alloc_.deallocate(block_ptr->data_, block_ptr->size());
+        // release memory, unless the recycler keeps it for the next ByteBlock,
+        // in which case it remains counted.
+        if (!block_ptr->recycler_ ||
+            !block_ptr->recycler_->Put(block_ptr->data_, block_ptr->size()))
+        {
+            sLOGC(debug_alloc)
+                << "ByteBlock deallocate"
+                << (void*)block_ptr->data_ << "size" << block_ptr->size();
+            d_->DeallocateBlockData(block_ptr->data_, block_ptr->size());
+            d_->IntReleaseInternalMemory(block_ptr->size());
+        }
         block_ptr->data_ = nullptr;
-
-        d_->IntReleaseInternalMemory(block_ptr->size());
     }
     else
     {
@@ -1080,6 +1351,19 @@ void BlockPool::DestroyBlock(ByteBlock* block_ptr) {
     d_->cv_total_byte_blocks_.notify_all();
 }
 
+void BlockPool::AddRecycler(ByteBlockRecycler* recycler) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    d_->recyclers_.push_back(recycler);
+}
+
+void BlockPool::CloseRecycler(ByteBlockRecycler* recycler) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = std::find(d_->recyclers_.begin(), d_->recyclers_.end(), recycler);
+    if (it != d_->recyclers_.end())
+        d_->recyclers_.erase(it);
+    d_->IntDeallocateRecycled(recycler->TakeAll(/* close */ true));
+}
+
 void BlockPool::RequestInternalMemory(size_t size) {
     std::unique_lock<std::mutex> lock(mutex_);
     return d_->IntRequestInternalMemory(lock, size);
@@ -1102,9 +1386,17 @@ void BlockPool::Data::IntRequestInternalMemory(
         << " unpinned_blocks_.size()=" << unpinned_blocks_.size()
         << " swapped_.size()=" << swapped_.size();
 
+    // recycled and idle arena memory is counted as used, hand it back before
+    // evicting.
+    if (soft_ram_limit_ != 0 &&
+        IntRamBytes() + requested_bytes_ > soft_ram_limit_) {
+        IntDrainRecyclers();
+        IntTrimArenas();
+    }
+
     while (soft_ram_limit_ != 0 &&
            unpinned_blocks_.size() &&
-           total_ram_bytes_ + requested_bytes_ > soft_ram_limit_ + writing_bytes_)
+           IntRamBytes() + requested_bytes_ > soft_ram_limit_ + writing_bytes_)
     {
         // evict blocks: schedule async writing which increases writing_bytes_.
         IntEvictBlockLRU();
@@ -1116,11 +1408,16 @@ void BlockPool::Data::IntRequestInternalMemory(
     size_t last_writing_bytes = 0;
 
     // wait for memory change due to blocks begin written and deallocated.
-    while (hard_ram_limit_ != 0 && total_ram_bytes_ + size > hard_ram_limit_)
+    while (hard_ram_limit_ != 0 && IntRamBytes() + size > hard_ram_limit_)
     {
+        // blocks freed meanwhile may have returned memory to the recyclers
+        // and arenas
+        IntDrainRecyclers();
+        IntTrimArenas();
+
         while (hard_ram_limit_ != 0 &&
                unpinned_blocks_.size() &&
-               total_ram_bytes_ + requested_bytes_ > hard_ram_limit_ + writing_bytes_)
+               IntRamBytes() + requested_bytes_ > hard_ram_limit_ + writing_bytes_)
         {
             // evict blocks: schedule async writing which increases writing_bytes_.
             IntEvictBlockLRU();
@@ -1140,7 +1437,7 @@ void BlockPool::Data::IntRequestInternalMemory(
             << " swapped_.size()=" << swapped_.size();
 
         if (writing_bytes_ == 0 &&
-            total_ram_bytes_ + requested_bytes_ > hard_ram_limit_) {
+            IntRamBytes() + requested_bytes_ > hard_ram_limit_) {
 
             LOG1 << "abort() due to out-of-pinned-memory ???"
                  << " total_ram_bytes_=" << total_ram_bytes_
@@ -1183,7 +1480,7 @@ void BlockPool::AdviseFree(size_t size) {
         << " swapped_.size()=" << d_->swapped_.size();
 
     while (d_->soft_ram_limit_ != 0 && d_->unpinned_blocks_.size() &&
-           d_->total_ram_bytes_ + d_->requested_bytes_ + size > d_->hard_ram_limit_ + d_->writing_bytes_)
+           d_->IntRamBytes() + d_->requested_bytes_ + size > d_->hard_ram_limit_ + d_->writing_bytes_)
     {
         // evict blocks: schedule async writing which increases writing_bytes_.
         d_->IntEvictBlockLRU();
@@ -1256,7 +1553,7 @@ foxxll::request_ptr BlockPool::Data::IntEvictBlock(ByteBlock* block_ptr) {
         sLOGC(debug_alloc)
             << "ByteBlock deallocate"
             << (void*)block_ptr->data_ << "size" << block_ptr->size();
-        aligned_alloc_.deallocate(block_ptr->data_, block_ptr->size());
+        DeallocateBlockData(block_ptr->data_, block_ptr->size());
         block_ptr->data_ = nullptr;
 
         IntReleaseInternalMemory(block_ptr->size());
@@ -1334,7 +1631,7 @@ void BlockPool::OnWriteComplete(
         sLOGC(debug_alloc)
             << "ByteBlock deallocate"
             << (void*)block_ptr->data_ << "size" << block_ptr->size();
-        d_->aligned_alloc_.deallocate(block_ptr->data_, block_ptr->size());
+        d_->DeallocateBlockData(block_ptr->data_, block_ptr->size());
         block_ptr->data_ = nullptr;
 
         d_->IntReleaseInternalMemory(block_ptr->size());
@@ -1362,6 +1659,14 @@ void BlockPool::RunTask(const std::chrono::steady_clock::time_point& tp) {
     size_t reading_bytes = d_->reading_bytes_.hmax_update();
     size_t pinned_bytes = d_->pin_count_.total_pinned_bytes_.hmax_update();
 
+    size_t arena_reserved_bytes = 0, arena_resident_bytes = 0;
+    size_t arena_used_blocks = 0;
+    for (const std::unique_ptr<mem::HugePageArena>& a : d_->block_arenas_) {
+        arena_reserved_bytes += a->reserved_bytes();
+        arena_resident_bytes += a->resident_bytes();
+        arena_used_blocks += a->used_slots();
+    }
+
     logger_ << "class" << "BlockPool"
             << "event" << "profile"
             << "total_blocks" << d_->int_total_blocks()
@@ -1373,6 +1678,10 @@ void BlockPool::RunTask(const std::chrono::steady_clock::time_point& tp) {
             << "pinned_blocks" << d_->pin_count_.total_pins_
             << "pinned_bytes" << pinned_bytes
             << "unpinned_blocks" << d_->unpinned_blocks_.size()
+            << "unpinned_scanned_blocks"
+            << d_->unpinned_blocks_.size(AccessHint::Scanned)
+            << "unpinned_will_need_blocks"
+            << d_->unpinned_blocks_.size(AccessHint::WillNeed)
             << "unpinned_bytes" << unpinned_bytes
             << "swapped_blocks" << d_->swapped_.size()
             << "swapped_bytes" << d_->swapped_bytes_.hmax_update()
@@ -1392,7 +1701,12 @@ void BlockPool::RunTask(const std::chrono::steady_clock::time_point& tp) {
             << "wr_ops" << stp.get_write_count()
             << "wr_bytes" << stp.get_write_bytes()
             << "wr_speed" << static_cast<double>(stp.get_write_bytes()) / elapsed
-            << "disk_allocation" << d_->bm_->current_allocation();
+            << "disk_allocation" << d_->bm_->current_allocation()
+            << "arena_reserved_bytes" << arena_reserved_bytes
+            << "arena_resident_bytes" << arena_resident_bytes
+            << "arena_idle_bytes" << d_->ArenaIdleBytes()
+            << "arena_used_blocks" << arena_used_blocks
+            << "recycled_bytes" << d_->RecycledBytes();
 }
 
 size_t BlockPool::next_file_id() {
@@ -109,8 +109,11 @@ public:
     //! Allocates a byte block with the request size. May block this thread if
     //! the hard memory limit is reached, until memory is freed by another
     //! thread.  The returned Block is allocated in RAM, but with a zero pin
-    //! count.
-    PinnedByteBlockPtr AllocateByteBlock(size_t size, size_t local_worker_id);
+    //! count. If a recycler is given, its cached memory is reused and the
+    //! memory is returned to it when the ByteBlock is destroyed.
+    PinnedByteBlockPtr AllocateByteBlock(
+        size_t size, size_t local_worker_id,
+        const ByteBlockRecyclerPtr& recycler = ByteBlockRecyclerPtr());
 
     //! Allocate a byte block from an external file, used to directly map system
     //! files to data::File.
@@ -169,8 +172,14 @@ public:
 
     //! \}
 
-    //! Pins a block by swapping it in if required.
-    PinRequestPtr PinBlock(const Block& block, size_t local_worker_id);
+    //! Pins a block by swapping it in if required. The hint is stored in the
+    //! ByteBlock and determines its eviction order once it is unpinned.
+    PinRequestPtr PinBlock(const Block& block, size_t local_worker_id,
+                           AccessHint hint = AccessHint::Normal);
+
+    //! Change the access hint of a ByteBlock, which moves it in the eviction
+    //! order if it is currently unpinned.
+    void AdviseAccess(ByteBlock* block_ptr, AccessHint hint);
 
     //! calculate maximum merging degree from available memory and the number of
     //! files. additionally calculate the prefetch size of each File.
@@ -208,6 +217,13 @@ private:
     //! Increment a ByteBlock's pin count - without locking the mutex
     void IntIncBlockPinCount(ByteBlock* block_ptr, size_t local_worker_id);
 
+    //! Register a ByteBlockRecycler, whose cached memory is counted as used
+    //! RAM and released under memory pressure.
+    void AddRecycler(ByteBlockRecycler* recycler);
+
+    //! Close and unregister a ByteBlockRecycler, deallocating its memory.
+    void CloseRecycler(ByteBlockRecycler* recycler);
+
     //! callback for async write of blocks during eviction
     void OnWriteComplete(ByteBlock* block_ptr, foxxll::request* req, bool success);
 
@@ -222,6 +238,9 @@ private:
 
     //! for calling OnReadComplete and access to mutex and cvs
     friend class PinRequest;
+
+    //! for calling AddRecycler and CloseRecycler
+    friend class ByteBlockRecycler;
 };
 
 /*!
@@ -54,6 +54,7 @@ public:
     using ConsumeReader = BlockReader<ConsumeBlockQueueSource>;
 
     using CloseCallback = tlx::delegate<void (BlockQueue&)>;
+    using PopCallback = tlx::delegate<void (BlockQueue&)>;
 
     //! Constructor from BlockPool
     BlockQueue(BlockPool& block_pool, size_t local_worker_id,
@@ -94,6 +95,8 @@ public:
         Block b;
         queue_.pop(b);
         read_closed_ = !b.IsValid();
+        if (!read_closed_ && pop_callback_)
+            pop_callback_(*this);
         return b;
     }
 
@@ -108,6 +111,11 @@ public:
         close_callback_ = cb;
     }
 
+    //! set the callback issued when the reader consumed a Block
+    void set_pop_callback(const PopCallback& cb) {
+        pop_callback_ = cb;
+    }
+
     //! check if writer side Close() was called.
     bool write_closed() const { return write_closed_; }
 
@@ -165,6 +173,10 @@ private:
     //! stats
     CloseCallback close_callback_;
 
+    //! callback to issue when the reader pops a Block -- for granting credits
+    //! to the sender
+    PopCallback pop_callback_;
+
     //! for access to file_
     friend class CacheBlockQueueSource;
 };
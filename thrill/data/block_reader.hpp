@@ -15,6 +15,7 @@
 #include <thrill/common/config.hpp>
 #include <thrill/common/item_serialization_tools.hpp>
 #include <thrill/common/logger.hpp>
+#include <thrill/common/string_view.hpp>
 #include <thrill/data/block.hpp>
 #include <thrill/data/serialization.hpp>
 
@@ -24,6 +25,7 @@
 
 #include <algorithm>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace thrill {
@@ -74,6 +76,17 @@ public:
             block_.first_item_absolute(), num_items_, typecode_verify_);
     }
 
+    //! return the unread items of the current Block as an unpinned Block
+    //! starting at the cursor, which must be at an item boundary.
+    Block RestBlock() const {
+        assert(block_.IsValid());
+        return Block(byte_block(),
+                     current_ - byte_block()->begin(),
+                     end_ - byte_block()->begin(),
+                     current_ - byte_block()->begin(),
+                     num_items_, typecode_verify_);
+    }
+
     //! return current ByteBlock
     ByteBlockPtr byte_block() const { return block_.byte_block(); }
 
@@ -91,19 +104,34 @@ public:
         assert(num_items_ > 0);
         --num_items_;
 
-        if (self_verify && typecode_verify_) {
-            // for self-verification, T is prefixed with its hash code
-            size_t code = GetRaw<size_t>();
-            if (code != typeid(T).hash_code()) {
-                die("BlockReader::Next() attempted to retrieve item "
-                    "with different typeid! - expected "
-                    << tlx::hexdump_type(typeid(T).hash_code())
-                    << " got " << tlx::hexdump_type(code));
-            }
-        }
+        if (self_verify && typecode_verify_) VerifyTypecode<T>();
         return Serialization<BlockReader, T>::Deserialize(*this);
     }
 
+    /*!
+     * NextView() reads a complete item T, which must be a std::string, and
+     * returns a StringView of its characters instead of allocating a new
+     * std::string. If the item lies within the current Block, the view points
+     * directly into the pinned ByteBlock. Items straddling a Block boundary are
+     * copied into a buffer of the BlockReader.
+     *
+     * \attention The view is only valid until the next call of any reading
+     * method of this BlockReader, including HasNext(), since these may release
+     * the pinned Block.
+     */
+    template <typename T>
+    TLX_ATTRIBUTE_ALWAYS_INLINE
+    common::StringView NextView() {
+        static_assert(std::is_same<T, std::string>::value,
+                      "NextView() can only read std::string items.");
+        assert(HasNext());
+        assert(num_items_ > 0);
+        --num_items_;
+
+        if (self_verify && typecode_verify_) VerifyTypecode<T>();
+        return ReadView(this->GetVarint());
+    }
+
     //! Next() reads a complete item T, without item counter or self
     //! verification
     template <typename T>
@@ -124,12 +152,55 @@ public:
         return true;
     }
 
+    /*!
+     * ReadMany reads up to n complete items T into an array, and returns the
+     * number of items read, which is less than n only if the BlockReader ran
+     * empty. Items serialized as raw bytes (see is_raw_serializable) are copied
+     * as whole runs out of each Block, instead of one Next() per item. Other
+     * items and items straddling a Block boundary are read individually.
+     */
+    template <typename T>
+    size_t ReadMany(T* out, size_t n) {
+        size_t done = 0;
+        while (done < n && HasNext()) {
+            if (is_raw_serializable<T>::value &&
+                !(self_verify && typecode_verify_))
+            {
+                // copy all items which completely lie in the current Block
+                size_t fit = std::min(
+                    std::min(n - done, num_items_),
+                    static_cast<size_t>(end_ - current_) / sizeof(T));
+                if (fit != 0) {
+                    std::copy(current_, current_ + fit * sizeof(T),
+                              reinterpret_cast<Byte*>(out + done));
+                    current_ += fit * sizeof(T);
+                    num_items_ -= fit;
+                    done += fit;
+                    continue;
+                }
+            }
+            out[done++] = Next<T>();
+        }
+        return done;
+    }
+
+    //! ReadMany appending up to n items to a std::vector, see
+    //! ReadMany(T*, size_t). Returns the number of items appended.
+    template <typename T, typename Alloc>
+    size_t ReadMany(std::vector<T, Alloc>& out, size_t n) {
+        return ReadManyVector(
+            out, n, std::integral_constant<
+                bool, is_raw_serializable<T>::value
+                && !std::is_same<T, bool>::value>());
+    }
+
     //! Return complete contents until empty as a std::vector<T>. Use this only
     //! if you are sure that it will fit into memory, -> only use it for tests.
     template <typename ItemType>
     std::vector<ItemType> ReadComplete() {
         std::vector<ItemType> out;
-        while (HasNext()) out.emplace_back(Next<ItemType>());
+        // read all items starting in each Block at once
+        while (HasNext()) ReadMany(out, std::max<size_t>(num_items_, 1));
         return out;
     }
 
@@ -296,6 +367,21 @@ public:
         return out;
     }
 
+    //! Fetch a number of unstructured bytes as a StringView, advancing the
+    //! cursor. The view points into the current Block if the bytes are
+    //! contiguous, otherwise they are copied into a buffer. The view is only
+    //! valid until the next reading call.
+    common::StringView ReadView(size_t size) {
+        if (TLX_LIKELY(current_ + size <= end_)) {
+            const char* data = reinterpret_cast<const char*>(current_);
+            current_ += size;
+            return common::StringView(data, size);
+        }
+        view_buffer_.resize(size);
+        Read(&view_buffer_[0], size);
+        return common::StringView(view_buffer_.data(), size);
+    }
+
     //! Advance the cursor given number of bytes without reading them.
     BlockReader& Skip(size_t items, size_t bytes) {
         while (TLX_UNLIKELY(current_ + bytes > end_)) {
@@ -370,6 +456,45 @@ private:
     //! BlockReader, this is false to needed to read external files.
     bool typecode_verify_;
 
+    //! buffer for items delivered by ReadView() which straddle Blocks
+    std::string view_buffer_;
+
+    //! ReadMany into a std::vector of raw items, which is resized and filled
+    //! directly.
+    template <typename T, typename Alloc>
+    size_t ReadManyVector(std::vector<T, Alloc>& out, size_t n, std::true_type) {
+        size_t pos = out.size();
+        out.resize(pos + n);
+        size_t done = ReadMany(out.data() + pos, n);
+        out.resize(pos + done);
+        return done;
+    }
+
+    //! ReadMany into a std::vector of other items, which are appended
+    //! individually.
+    template <typename T, typename Alloc>
+    size_t ReadManyVector(std::vector<T, Alloc>& out, size_t n, std::false_type) {
+        size_t done = 0;
+        while (done < n && HasNext()) {
+            out.emplace_back(Next<T>());
+            ++done;
+        }
+        return done;
+    }
+
+    //! read the self verification hash code of T and compare it.
+    template <typename T>
+    void VerifyTypecode() {
+        // for self-verification, T is prefixed with its hash code
+        size_t code = GetRaw<size_t>();
+        if (code != typeid(T).hash_code()) {
+            die("BlockReader::Next() attempted to retrieve item "
+                "with different typeid! - expected "
+                << tlx::hexdump_type(typeid(T).hash_code())
+                << " got " << tlx::hexdump_type(code));
+        }
+    }
+
     //! Call source_.NextBlock with appropriate parameters
     bool NextBlock() {
         // first release old pin.
@@ -391,6 +516,57 @@ private:
     }
 };
 
+/*!
+ * Delivers the items of a BlockReader one at a time, but reads them in batches
+ * via ReadMany(). This is for consumers such as PushItem(), which take single
+ * items: for items serialized as raw bytes, the per-item deserialization is
+ * replaced by copying whole runs out of the Blocks. Other items are read
+ * directly with Next().
+ */
+template <typename ItemType, typename Reader>
+class BatchItemReader
+{
+public:
+    //! whether items are read in batches
+    static constexpr bool batched =
+        is_raw_serializable<ItemType>::value
+        && !std::is_same<ItemType, bool>::value;
+
+    //! number of items read per batch
+    static constexpr size_t batch_size =
+        batched ? std::max<size_t>(1, 16384 / sizeof(ItemType)) : 1;
+
+    //! construct reading from a BlockReader, which must outlive this object.
+    explicit BatchItemReader(Reader& reader)
+        : reader_(reader) { }
+
+    //! HasNext() returns true if at least one more item is available.
+    bool HasNext() {
+        if (!batched) return reader_.HasNext();
+        if (pos_ < batch_.size()) return true;
+        batch_.clear(), pos_ = 0;
+        return reader_.ReadMany(batch_, batch_size) != 0;
+    }
+
+    //! Next() returns the next item
+    ItemType Next() {
+        if (!batched) return reader_.template Next<ItemType>();
+        if (TLX_UNLIKELY(pos_ == batch_.size()))
+            die_unless(HasNext());
+        return std::move(batch_[pos_++]);
+    }
+
+private:
+    //! reader to read batches from
+    Reader& reader_;
+
+    //! current batch of items
+    std::vector<ItemType> batch_;
+
+    //! next item in batch
+    size_t pos_ = 0;
+};
+
 //! \}
 
 } // namespace data
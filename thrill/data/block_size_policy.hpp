@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * thrill/data/block_size_policy.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_DATA_BLOCK_SIZE_POLICY_HEADER
+#define THRILL_DATA_BLOCK_SIZE_POLICY_HEADER
+
+#include <thrill/data/byte_block.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+
+namespace thrill {
+namespace data {
+
+//! \addtogroup data_layer
+//! \{
+
+/*!
+ * Policy determining the sizes of the Blocks allocated by a BlockWriter. The
+ * first Block has start_size bytes, and each following Block is growth times
+ * larger than the previous until max_size is reached.
+ *
+ * Small first Blocks reduce the latency and memory of Files and Streams with
+ * few items, while large steady-state Blocks reduce per-Block overhead for
+ * network transfers and external memory I/O. Files and Streams carry their own
+ * policy, which is used by the BlockWriters they create.
+ */
+class BlockSizePolicy
+{
+public:
+    //! default policy: start_block_size growing to default_block_size.
+    BlockSizePolicy()
+        : BlockSizePolicy(start_block_size, default_block_size) { }
+
+    //! policy with start and maximum size
+    BlockSizePolicy(size_t start_size, size_t max_size, size_t growth = 2)
+        : start_size_(std::min(start_size, max_size)), max_size_(max_size),
+          growth_(growth) {
+        assert(start_size_ > 0);
+        assert(growth_ >= 1);
+    }
+
+    //! default policy: start_block_size growing to default_block_size.
+    static BlockSizePolicy Default() {
+        return BlockSizePolicy();
+    }
+
+    //! policy for latency-sensitive exchanges of few small items, such as
+    //! samples and collectives: small Blocks which are flushed early.
+    static BlockSizePolicy Latency() {
+        return BlockSizePolicy(
+            start_block_size,
+            std::min(default_block_size, size_t(latency_max_size)));
+    }
+
+    //! policy for I/O-bound Files which are likely spilled to external memory,
+    //! such as sorted runs: constant Blocks of default_block_size.
+    static BlockSizePolicy Throughput() {
+        return BlockSizePolicy(default_block_size, default_block_size, 1);
+    }
+
+    //! return policy with all Block sizes limited to max_size.
+    BlockSizePolicy Capped(size_t max_size) const {
+        return BlockSizePolicy(
+            std::min(start_size_, max_size), std::min(max_size_, max_size),
+            growth_);
+    }
+
+    //! size of the first Block
+    size_t start_size() const { return start_size_; }
+
+    //! maximum size of Blocks
+    size_t max_size() const { return max_size_; }
+
+    //! growth factor from one Block to the next
+    size_t growth() const { return growth_; }
+
+    //! size of the Block following a Block of given size.
+    size_t next(size_t size) const {
+        if (size >= max_size_ / growth_) return max_size_;
+        return size * growth_;
+    }
+
+    //! make ostream-able
+    friend std::ostream& operator << (
+        std::ostream& os, const BlockSizePolicy& p) {
+        return os << "[BlockSizePolicy start=" << p.start_size_
+                  << " max=" << p.max_size_ << " growth=" << p.growth_ << "]";
+    }
+
+private:
+    //! maximum Block size of the Latency() policy
+    static constexpr size_t latency_max_size = 64 * 1024;
+
+    //! size of the first Block
+    size_t start_size_;
+    //! maximum size of Blocks
+    size_t max_size_;
+    //! growth factor from one Block to the next
+    size_t growth_;
+};
+
+//! \}
+
+} // namespace data
+} // namespace thrill
+
+#endif // !THRILL_DATA_BLOCK_SIZE_POLICY_HEADER
+
+/******************************************************************************/
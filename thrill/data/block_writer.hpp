@@ -17,12 +17,14 @@
 #include <thrill/common/item_serialization_tools.hpp>
 #include <thrill/data/block.hpp>
 #include <thrill/data/block_sink.hpp>
+#include <thrill/data/block_size_policy.hpp>
 #include <thrill/data/serialization.hpp>
 #include <tlx/die.hpp>
 
 #include <algorithm>
 #include <deque>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace thrill {
@@ -61,10 +63,16 @@ public:
     //! Start build (appending blocks) to a File
     explicit BlockWriter(BlockSink&& sink,
                          size_t max_block_size = default_block_size)
+        : BlockWriter(std::move(sink),
+                      BlockSizePolicy::Default().Capped(max_block_size)) { }
+
+    //! Start build (appending blocks) to a File with Block sizes determined by
+    //! the policy.
+    BlockWriter(BlockSink&& sink, const BlockSizePolicy& policy)
         : sink_(std::move(sink)),
-          block_size_(std::min(size_t(start_block_size), max_block_size)),
-          max_block_size_(max_block_size) {
-        assert(max_block_size_ > 0);
+          block_size_(policy.start_size()),
+          policy_(policy) {
+        assert(policy_.max_size() > 0);
     }
 
     //! default constructor
@@ -86,7 +94,7 @@ public:
           do_queue_(std::move(bw.do_queue_)),
           sink_queue_(std::move(bw.sink_queue_)),
           block_size_(std::move(bw.block_size_)),
-          max_block_size_(std::move(bw.max_block_size_)),
+          policy_(std::move(bw.policy_)),
           closed_(std::move(bw.closed_)) {
         // set closed flag -> disables destructor
         bw.closed_ = true;
@@ -105,7 +113,7 @@ public:
         do_queue_ = std::move(bw.do_queue_);
         sink_queue_ = std::move(bw.sink_queue_);
         block_size_ = std::move(bw.block_size_);
-        max_block_size_ = std::move(bw.max_block_size_);
+        policy_ = std::move(bw.policy_);
         closed_ = std::move(bw.closed_);
         // set closed flag -> disables destructor
         bw.closed_ = true;
@@ -131,6 +139,9 @@ public:
     //! Returns block_size_
     size_t block_size() const { return block_size_; }
 
+    //! Returns the policy determining Block sizes
+    const BlockSizePolicy& block_size_policy() const { return policy_; }
+
     //! Flush the current block (only really meaningful for a network sink).
     void Flush() {
         if (!bytes_) return;
@@ -326,6 +337,34 @@ public:
         return *this;
     }
 
+    /*!
+     * PutMany appends n complete items from an array. Items serialized as raw
+     * bytes (see is_raw_serializable) are copied as whole runs into each Block,
+     * instead of one Put() with bounds checks per item. Other items and items
+     * straddling a Block boundary are Put() individually.
+     *
+     * Returns the number of items appended, which is less than n only if the
+     * BlockSink is full. Then, like after Put() threw a FullException, the
+     * remaining items can be appended to another BlockWriter.
+     */
+    template <typename T>
+    size_t PutMany(const T* items, size_t n) {
+        return PutManyImpl<T, false>(items, n);
+    }
+
+    //! PutMany of a std::vector, see PutMany(const T*, size_t).
+    template <typename T, typename Alloc>
+    size_t PutMany(const std::vector<T, Alloc>& items) {
+        return PutManyVector<false>(items, is_vector_raw<T>());
+    }
+
+    //! PutManyNoSelfVerify appends n complete items from an array without any
+    //! self verification information, see PutMany().
+    template <typename T>
+    size_t PutManyNoSelfVerify(const T* items, size_t n) {
+        return PutManyImpl<T, true>(items, n);
+    }
+
     //! \}
 
     //! \name Appending Write Functions
@@ -397,6 +436,82 @@ public:
     //! \}
 
 private:
+    //! whether a std::vector<T> can be appended as a whole: std::vector<bool>
+    //! has no data() array.
+    template <typename T>
+    using is_vector_raw = std::integral_constant<
+              bool, is_raw_serializable<T>::value
+              && !std::is_same<T, bool>::value>;
+
+    //! implementation of PutMany() and PutManyNoSelfVerify()
+    template <typename T, bool NoSelfVerify>
+    size_t PutManyImpl(const T* items, size_t n) {
+        assert(!closed_);
+
+        static constexpr bool raw =
+            is_raw_serializable<T>::value && (!self_verify || NoSelfVerify);
+
+        size_t done = 0;
+        while (done < n) {
+            if (raw) {
+                // copy all items which completely fit into the current Block
+                size_t fit = std::min(
+                    n - done, static_cast<size_t>(end_ - current_) / sizeof(T));
+                if (fit != 0) {
+                    if (nitems_ == 0)
+                        first_offset_ = current_ - bytes_->begin();
+                    nitems_ += fit;
+
+                    const Byte* cdata = reinterpret_cast<const Byte*>(items + done);
+                    std::copy(cdata, cdata + fit * sizeof(T), current_);
+                    current_ += fit * sizeof(T);
+                    done += fit;
+                    continue;
+                }
+            }
+
+            // put next item individually, which allocates the next Block.
+            if (!PutOrFull<T, NoSelfVerify>(items[done]))
+                return done;
+            ++done;
+        }
+        return done;
+    }
+
+    //! PutMany of a std::vector with a data() array
+    template <bool NoSelfVerify, typename T, typename Alloc>
+    size_t PutManyVector(const std::vector<T, Alloc>& items, std::true_type) {
+        return PutManyImpl<T, NoSelfVerify>(items.data(), items.size());
+    }
+
+    //! PutMany of any other std::vector
+    template <bool NoSelfVerify, typename T, typename Alloc>
+    size_t PutManyVector(const std::vector<T, Alloc>& items, std::false_type) {
+        size_t done = 0;
+        for (const T& item : items) {
+            if (!PutOrFull<T, NoSelfVerify>(item))
+                return done;
+            ++done;
+        }
+        return done;
+    }
+
+    //! put a single item, returns false instead of throwing a FullException.
+    template <typename T, bool NoSelfVerify>
+    bool PutOrFull(const T& x) {
+        if (!BlockSink::allocate_can_fail_) {
+            PutUnsafe<T, NoSelfVerify>(x);
+            return true;
+        }
+        try {
+            PutSafe<T, NoSelfVerify>(x);
+            return true;
+        }
+        catch (FullException&) {
+            return false;
+        }
+    }
+
     //! Allocate a new block (overwriting the existing one).
     void AllocateBlock() {
         bytes_ = sink_.AllocateByteBlock(block_size_);
@@ -406,8 +521,7 @@ private:
         }
         sLOG << "AllocateBlock(): good, got" << bytes_.get();
         // increase block size, up to max.
-        if (2 * block_size_ < max_block_size_)
-            block_size_ *= 2;
+        block_size_ = policy_.next(block_size_);
 
         current_ = bytes_->begin();
         end_ = bytes_->end();
@@ -444,8 +558,8 @@ private:
     //! size of data blocks to construct
     size_t block_size_;
 
-    //! size of data blocks to construct
-    size_t max_block_size_;
+    //! policy determining the growth of block_size_
+    BlockSizePolicy policy_;
 
     //! Flag if Close was called explicitly
     bool closed_ = false;
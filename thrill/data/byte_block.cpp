@@ -23,6 +23,7 @@ namespace data {
 
 size_t start_block_size = 4 * 1024;
 size_t default_block_size = 2 * 1024 * 1024;
+bool use_block_arena = true;
 
 size_t File::default_prefetch_size_ = 2 * default_block_size;
 
@@ -72,16 +73,33 @@ void ByteBlock::DecPinCount(size_t local_worker_id) {
     return block_pool_->DecBlockPinCount(this, local_worker_id);
 }
 
+void ByteBlock::AdviseAccess(AccessHint hint) {
+    return block_pool_->AdviseAccess(this, hint);
+}
+
 void ByteBlock::OnWriteComplete(foxxll::request* req, bool success) {
     return block_pool_->OnWriteComplete(this, req, success);
 }
 
+std::ostream& operator << (std::ostream& os, const AccessHint& h) {
+    switch (h) {
+    case AccessHint::Normal:
+        return os << "Normal";
+    case AccessHint::Scanned:
+        return os << "Scanned";
+    case AccessHint::WillNeed:
+        return os << "WillNeed";
+    }
+    return os << "Invalid";
+}
+
 std::ostream& operator << (std::ostream& os, const ByteBlock& b) {
     os << "[ByteBlock" << " " << &b
        << " data_=" << static_cast<const void*>(b.data_)
        << " size_=" << b.size_
        << " block_pool_=" << b.block_pool_
        << " total_pins_=" << b.total_pins_
+       << " access_hint_=" << b.access_hint_
        << " ext_file_=" << b.ext_file_;
     return os << "]";
 }
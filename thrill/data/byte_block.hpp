@@ -12,12 +12,14 @@
 #ifndef THRILL_DATA_BYTE_BLOCK_HEADER
 #define THRILL_DATA_BYTE_BLOCK_HEADER
 
+#include <thrill/data/byte_block_recycler.hpp>
 #include <thrill/mem/pool.hpp>
 
 #include <foxxll/io/file.hpp>
 #include <foxxll/mng/bid.hpp>
 #include <tlx/counting_ptr.hpp>
 
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -33,12 +35,35 @@ extern size_t start_block_size;
 //! default size of blocks in File, Channel, BlockQueue, etc.
 extern size_t default_block_size;
 
+//! allocate ByteBlocks from huge page backed arenas in the BlockPool.
+extern bool use_block_arena;
+
 //! type of underlying memory area
 using Byte = uint8_t;
 
 // forward declarations.
 class BlockPool;
 
+/*!
+ * Hint given by the holder of a pin about how an unpinned ByteBlock will be
+ * accessed. The BlockPool uses the hint to select which unpinned ByteBlocks are
+ * evicted to external memory first.
+ */
+enum class AccessHint : uint8_t {
+    //! no information, evicted in least-recently-used order.
+    Normal,
+    //! the ByteBlock was read by a sequential scan and is unlikely to be needed
+    //! again soon. Evicted before all others, most recently scanned first,
+    //! which keeps the beginning of a File in memory for repeated scans.
+    Scanned,
+    //! the ByteBlock will be read soon, e.g. it is next in a Reader's
+    //! prefetch. Evicted only if no other unpinned ByteBlocks are left.
+    WillNeed
+};
+
+//! make AccessHint ostream-able
+std::ostream& operator << (std::ostream& os, const AccessHint& h);
+
 /*!
  * A ByteBlock is the basic storage units of containers like File, BlockQueue,
  * etc. It consists of a fixed number of bytes without any type and meta
@@ -104,12 +129,19 @@ public:
         return pin_count_.empty();
     }
 
+    //! access hint given by the last pin, used for eviction when unpinned.
+    AccessHint access_hint() const { return access_hint_; }
+
     //! increment pin count, must be >= 1 before.
     void IncPinCount(size_t local_worker_id);
 
     //! decrement pin count, possibly signal block pool that if it reaches zero.
     void DecPinCount(size_t local_worker_id);
 
+    //! change the access hint, which reorders the ByteBlock for eviction if it
+    //! is currently unpinned.
+    void AdviseAccess(AccessHint hint);
+
 private:
     //! the memory block itself is referenced as it is in a a separate memory
     //! region that can be swapped out
@@ -128,6 +160,10 @@ private:
     //! reaches zero.
     size_t total_pins_ = 0;
 
+    //! how the ByteBlock will be accessed after being unpinned, set by the
+    //! BlockPool when pinned or advised.
+    AccessHint access_hint_ = AccessHint::Normal;
+
     //! external memory block, which contains a pointer to foxxll::file, an
     //! offset into the file, and (unfortunately) also the size.
     foxxll::BID<0> em_bid_;
@@ -136,6 +172,9 @@ private:
     //! was created for directly reading binary files.
     foxxll::file_ptr ext_file_;
 
+    //! recycler which receives the memory when the ByteBlock is destroyed.
+    ByteBlockRecyclerPtr recycler_;
+
     // BlockPool is a friend to call ctor and to manipulate data_.
     friend class BlockPool;
     // Block is a friend to call {Increase,Reduce}PinCount()
@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * thrill/data/byte_block_recycler.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/data/block_pool.hpp>
+#include <thrill/data/byte_block_recycler.hpp>
+
+#include <tlx/die.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace data {
+
+ByteBlockRecycler::ByteBlockRecycler(BlockPool& block_pool, size_t capacity)
+    : block_pool_(block_pool), capacity_(capacity) {
+    free_.reserve(capacity_);
+    block_pool_.AddRecycler(this);
+}
+
+ByteBlockRecycler::~ByteBlockRecycler() {
+    // the last ByteBlock is destroyed outside the BlockPool's mutex
+    if (!closed_) Close();
+    die_unless(free_.empty());
+}
+
+uint8_t* ByteBlockRecycler::Take(size_t size) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // most recently returned memory first, it may still be in the caches.
+    for (size_t i = free_.size(); i != 0; --i) {
+        if (free_[i - 1].second != size) continue;
+        uint8_t* data = free_[i - 1].first;
+        free_.erase(free_.begin() + (i - 1));
+        cached_bytes_ -= size;
+        ++hits_;
+        return data;
+    }
+    ++misses_;
+    return nullptr;
+}
+
+bool ByteBlockRecycler::Put(uint8_t* data, size_t size) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_ || free_.size() >= capacity_) return false;
+    free_.emplace_back(data, size);
+    cached_bytes_ += size;
+    ++recycled_;
+    return true;
+}
+
+void ByteBlockRecycler::Close() {
+    block_pool_.CloseRecycler(this);
+}
+
+std::vector<std::pair<uint8_t*, size_t> >
+ByteBlockRecycler::TakeAll(bool close) {
+    std::vector<std::pair<uint8_t*, size_t> > free;
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (close) closed_ = true;
+    std::swap(free, free_);
+    cached_bytes_ = 0;
+    return free;
+}
+
+} // namespace data
+} // namespace thrill
+
+/******************************************************************************/
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * thrill/data/byte_block_recycler.hpp
+ *
+ * Cache of ByteBlock memory for reuse by incoming Blocks of a connection.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_DATA_BYTE_BLOCK_RECYCLER_HEADER
+#define THRILL_DATA_BYTE_BLOCK_RECYCLER_HEADER
+
+#include <tlx/counting_ptr.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace data {
+
+//! \addtogroup data_layer
+//! \{
+
+class BlockPool;
+
+/*!
+ * A small cache of the memory of destroyed ByteBlocks, which is reused for new
+ * ByteBlocks of the same size instead of calling the allocator.
+ *
+ * ByteBlocks allocated via BlockPool::AllocateByteBlock() with a recycler
+ * return their memory to it when they are destroyed by the last consumer,
+ * provided that they were not evicted meanwhile and the recycler is not full.
+ * The Multiplexer keeps one per connection, hence in steady state received
+ * Blocks are written into the memory of previously consumed ones.
+ *
+ * The cached memory stays counted as used RAM by the BlockPool, which releases
+ * it from all recyclers under memory pressure before evicting Blocks. The
+ * recycler must be Close()d or destroyed before the BlockPool is destroyed.
+ */
+class ByteBlockRecycler : public tlx::ReferenceCounter
+{
+public:
+    //! construct recycler caching up to capacity memory areas.
+    ByteBlockRecycler(BlockPool& block_pool, size_t capacity);
+
+    //! non-copyable: delete copy-constructor
+    ByteBlockRecycler(const ByteBlockRecycler&) = delete;
+    //! non-copyable: delete assignment operator
+    ByteBlockRecycler& operator = (const ByteBlockRecycler&) = delete;
+
+    ~ByteBlockRecycler();
+
+    //! Take cached memory of the given size, or nullptr if there is none.
+    uint8_t * Take(size_t size);
+
+    //! Cache memory of a destroyed ByteBlock. Returns false if the recycler is
+    //! full or closed, in which case the caller must deallocate it.
+    bool Put(uint8_t* data, size_t size);
+
+    //! Deallocate all cached memory via the BlockPool, later Put()s fail.
+    void Close();
+
+    //! number of bytes of cached memory
+    size_t cached_bytes() const { return cached_bytes_; }
+
+    //! \name Statistics
+    //! \{
+
+    //! number of Take() calls served from the cache
+    size_t hits() const { return hits_; }
+
+    //! number of Take() calls which found no memory of matching size
+    size_t misses() const { return misses_; }
+
+    //! number of memory areas returned by destroyed ByteBlocks
+    size_t recycled() const { return recycled_; }
+
+    //! fraction of Take() calls served from the cache
+    double hit_rate() const {
+        size_t total = hits_ + misses_;
+        return total == 0 ? 0.0 : static_cast<double>(hits_) / total;
+    }
+
+    //! \}
+
+private:
+    //! BlockPool to deallocate memory in Close()
+    BlockPool& block_pool_;
+
+    //! Remove all cached memory areas, and set closed_ if close is set. Called
+    //! by the BlockPool with its mutex held.
+    std::vector<std::pair<uint8_t*, size_t> > TakeAll(bool close);
+
+    //! maximum number of cached memory areas
+    size_t capacity_;
+
+    //! protects free_ and closed_, Take() and Put() run in different threads.
+    std::mutex mutex_;
+
+    //! cached memory areas and their size
+    std::vector<std::pair<uint8_t*, size_t> > free_;
+
+    //! total size of free_
+    std::atomic<size_t> cached_bytes_ { 0 };
+
+    //! set by Close()
+    bool closed_ = false;
+
+    //! statistics
+    std::atomic<size_t> hits_ { 0 }, misses_ { 0 }, recycled_ { 0 };
+
+    //! for calling TakeAll()
+    friend class BlockPool;
+};
+
+using ByteBlockRecyclerPtr = tlx::CountingPtr<ByteBlockRecycler>;
+
+//! \}
+
+} // namespace data
+} // namespace thrill
+
+#endif // !THRILL_DATA_BYTE_BLOCK_RECYCLER_HEADER
+
+/******************************************************************************/
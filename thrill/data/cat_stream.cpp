@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <map>
+#include <mutex>
 #include <vector>
 
 namespace thrill {
@@ -28,12 +29,12 @@ namespace data {
 CatStreamData::CatStreamData(Multiplexer& multiplexer, size_t send_size_limit,
                              const StreamId& id,
                              size_t local_worker_id, size_t dia_id)
-    : StreamData(multiplexer, send_size_limit, id, local_worker_id, dia_id) {
+    : StreamData(multiplexer, send_size_limit, id, local_worker_id, dia_id),
+      seq_(num_workers()) {
 
     remaining_closing_blocks_ = (num_hosts() - 1) * workers_per_host();
 
     queues_.reserve(num_workers());
-    seq_.resize(num_workers());
 
     // construct StreamSink array
     for (size_t host = 0; host < num_hosts(); ++host) {
@@ -61,9 +62,13 @@ CatStreamData::CatStreamData(Multiplexer& multiplexer, size_t send_size_limit,
                     });
             }
             else {
-                // construct inbound BlockQueues
+                // construct inbound BlockQueues, which grant credits to the
+                // sender when Blocks are consumed.
+                size_t from = host * workers_per_host() + worker;
                 queues_.emplace_back(
                     multiplexer_.block_pool_, local_worker_id, dia_id);
+                queues_.back().set_pop_callback(
+                    [this, from](BlockQueue&) { OnBlockConsumed(from); });
             }
         }
     }
@@ -87,6 +92,11 @@ CatStreamData::Writers CatStreamData::GetWriters() {
     size_t block_size = tlx::round_down_to_power_of_two(block_size_base);
     if (block_size == 0 || block_size > default_block_size)
         block_size = default_block_size;
+    // writers to all targets hold one open Block each, which is accounted
+    // against hard_ram_limit / 4 above. Keep stream Blocks at half of that
+    // bound, as before BlockSizePolicy, to leave room for Blocks in flight.
+    BlockSizePolicy policy = block_size_policy_.Capped(
+        std::max(block_size / 2, std::min(start_block_size, block_size)));
 
     {
         std::unique_lock<std::mutex> lock(multiplexer_.mutex_);
@@ -101,6 +111,7 @@ CatStreamData::Writers CatStreamData::GetWriters() {
         << " hard_ram_limit=" << hard_ram_limit
         << " block_size_base=" << block_size_base
         << " block_size=" << block_size
+        << " policy=" << policy
         << " active_streams=" << multiplexer_.active_streams_
         << " max_active_streams=" << multiplexer_.max_active_streams_;
 
@@ -124,19 +135,18 @@ CatStreamData::Writers CatStreamData::GetWriters() {
                         id_,
                         my_host_rank(), local_worker_id_,
                         host, worker),
-                    block_size);
+                    policy);
             }
             else {
                 result.emplace_back(
                     StreamSink(
                         StreamDataPtr(this),
                         multiplexer_.block_pool_,
-                        &multiplexer_.group_.connection(host),
                         MagicByte::CatStreamBlock,
                         id_,
                         my_host_rank(), local_worker_id_,
                         host, worker),
-                    block_size);
+                    policy);
             }
         }
     }
@@ -197,10 +207,20 @@ void CatStreamData::Close() {
     if (!queues_[my_global_worker_id].write_closed())
         queues_[my_global_worker_id].Close();
 
+    // Blocks which are not read anymore must still arrive, hence lift the flow
+    // control of senders which did not finish.
+    for (size_t w = 0; w < queues_.size(); ++w) {
+        if (!queues_[w].write_closed())
+            GrantUnlimitedCredit(w);
+    }
+
     // wait for close packets to arrive
     for (size_t i = 0; i < queues_.size() - workers_per_host(); ++i)
         sem_closing_blocks_.wait();
 
+    // wait for Blocks held back for lack of credit to be sent
+    WaitDeferred();
+
     tx_lifetime_.StopEventually();
     tx_timespan_.StopEventually();
     OnAllClosed("CatStreamData");
@@ -230,6 +250,10 @@ struct CatStreamData::SeqReordering {
 
     //! queue of waiting Blocks, ordered by sequence number
     std::map<uint32_t, PinnedBlock> waiting_;
+
+    //! protects the reordering, as the Blocks of a sender are delivered by
+    //! multiple dispatcher threads if the Multiplexer stripes connections.
+    std::mutex                      mutex_;
 };
 
 void CatStreamData::OnStreamBlock(size_t from, uint32_t seq, PinnedBlock&& b) {
@@ -250,6 +274,10 @@ void CatStreamData::OnStreamBlock(size_t from, uint32_t seq, PinnedBlock&& b) {
              << tlx::hexdump(b.ToString());
     }
 
+    // lock only this sender's sequence, such that the dispatcher threads
+    // serving different peers do not contend.
+    std::unique_lock<std::mutex> lock(seq_[from].mutex_);
+
     if (TLX_UNLIKELY(seq != seq_[from].seq_)) {
         // sequence mismatch: put into queue
         die_unless(seq >= seq_[from].seq_);
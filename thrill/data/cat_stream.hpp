@@ -108,6 +108,8 @@ public:
     //! shuts the stream down.
     void Close() final;
 
+    MagicByte credit_magic() const final { return MagicByte::CatStreamCredit; }
+
     //! Indicates if the stream is closed - meaning all remaining streams have
     //! been closed. This does *not* include the loopback stream
     bool closed() const final;
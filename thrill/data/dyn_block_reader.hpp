@@ -16,6 +16,7 @@
 #define THRILL_DATA_DYN_BLOCK_READER_HEADER
 
 #include <thrill/data/block_reader.hpp>
+#include <thrill/data/prefetch_group.hpp>
 
 namespace thrill {
 namespace data {
@@ -36,6 +37,10 @@ public:
 
     //! set number of blocks to prefetch
     virtual void Prefetch(size_t size) = 0;
+
+    //! join a group sharing a prefetch budget. Only File sources prefetch by
+    //! group, all other sources ignore it.
+    virtual void SetPrefetchGroup(const PrefetchGroupPtr& group) = 0;
 };
 
 /*!
@@ -63,6 +68,10 @@ public:
         return block_source_ptr_->Prefetch(size);
     }
 
+    void SetPrefetchGroup(const PrefetchGroupPtr& group) {
+        return block_source_ptr_->SetPrefetchGroup(group);
+    }
+
 private:
     tlx::CountingPtr<DynBlockSourceInterface> block_source_ptr_;
 };
@@ -98,8 +107,24 @@ public:
         return block_source_.Prefetch(size);
     }
 
+    void SetPrefetchGroup(const PrefetchGroupPtr& group) final {
+        return ForwardPrefetchGroup(block_source_, group, 0);
+    }
+
 private:
     BlockSource block_source_;
+
+    //! forward the group to BlockSources supporting it (File sources)
+    template <typename Source>
+    static auto ForwardPrefetchGroup(
+        Source& source, const PrefetchGroupPtr& group, int)
+    -> decltype(source.SetPrefetchGroup(group)) {
+        return source.SetPrefetchGroup(group);
+    }
+
+    //! all other BlockSources ignore the group
+    template <typename Source>
+    static void ForwardPrefetchGroup(Source&, const PrefetchGroupPtr&, long) { }
 };
 
 /*!
@@ -41,6 +41,7 @@ File::~File() {
 
 File File::Copy() const {
     File f(*block_pool(), local_worker_id(), dia_id_);
+    f.block_size_policy_ = block_size_policy_;
     f.blocks_ = blocks_;
     f.num_items_sum_ = num_items_sum_;
     f.size_bytes_ = size_bytes_;
@@ -60,9 +61,17 @@ void File::Clear() {
     size_bytes_ = 0;
 }
 
-File::Writer File::GetWriter(size_t block_size) {
+File::Writer File::GetWriter() {
+    return GetWriter(block_size_policy_);
+}
+
+File::Writer File::GetWriter(size_t max_block_size) {
+    return GetWriter(block_size_policy_.Capped(max_block_size));
+}
+
+File::Writer File::GetWriter(const BlockSizePolicy& policy) {
     return Writer(
-        FileBlockSink(tlx::CountingPtrNoDelete<File>(this)), block_size);
+        FileBlockSink(tlx::CountingPtrNoDelete<File>(this)), policy);
 }
 
 File::KeepReader File::GetKeepReader(size_t prefetch_size) const {
@@ -114,6 +123,25 @@ KeepFileBlockSource::KeepFileBlockSource(
       first_block_(first_block), current_block_(first_block),
       first_item_(first_item) { }
 
+KeepFileBlockSource::KeepFileBlockSource(KeepFileBlockSource&& s)
+    : file_(s.file_), local_worker_id_(s.local_worker_id_),
+      prefetch_size_(s.prefetch_size_),
+      fetching_blocks_(std::move(s.fetching_blocks_)),
+      fetching_bytes_(s.fetching_bytes_),
+      prefetch_group_(std::move(s.prefetch_group_)),
+      prefetch_share_(s.prefetch_share_),
+      first_block_(s.first_block_), current_block_(s.current_block_),
+      first_item_(s.first_item_),
+      advised_block_(std::move(s.advised_block_)) { }
+
+KeepFileBlockSource::~KeepFileBlockSource() {
+    // an abandoned reader must not leave the Block ranked as WillNeed.
+    if (advised_block_)
+        advised_block_->AdviseAccess(AccessHint::Normal);
+    if (prefetch_group_)
+        prefetch_group_->Leave(prefetch_share_);
+}
+
 void KeepFileBlockSource::Prefetch(size_t prefetch_size) {
     if (prefetch_size >= prefetch_size_) {
         prefetch_size_ = prefetch_size;
@@ -123,7 +151,8 @@ void KeepFileBlockSource::Prefetch(size_t prefetch_size) {
         {
             Block b = NextUnpinnedBlock();
             fetching_bytes_ += b.size();
-            fetching_blocks_.emplace_back(b.Pin(local_worker_id_));
+            fetching_blocks_.emplace_back(
+                b.Pin(local_worker_id_, AccessHint::Scanned));
         }
     }
     else if (prefetch_size < prefetch_size_) {
@@ -132,15 +161,29 @@ void KeepFileBlockSource::Prefetch(size_t prefetch_size) {
     }
 }
 
+void KeepFileBlockSource::SetPrefetchGroup(const PrefetchGroupPtr& group) {
+    if (prefetch_group_)
+        prefetch_group_->Leave(prefetch_share_);
+    prefetch_group_ = group;
+    if (prefetch_group_)
+        prefetch_group_->Join(prefetch_share_);
+}
+
 PinnedBlock KeepFileBlockSource::NextBlock() {
 
     if (current_block_ >= file_.num_blocks() && fetching_blocks_.empty())
         return PinnedBlock();
 
+    if (prefetch_group_)
+        prefetch_size_ = prefetch_group_->Deliver(prefetch_share_);
+
+    // Blocks are read sequentially, hence they are not needed again soon after
+    // the reader releases them.
     if (prefetch_size_ == 0)
     {
         // operate without prefetching
-        return NextUnpinnedBlock().PinWait(local_worker_id_);
+        return NextUnpinnedBlock().PinWait(
+            local_worker_id_, AccessHint::Scanned);
     }
     else
     {
@@ -150,9 +193,12 @@ PinnedBlock KeepFileBlockSource::NextBlock() {
         {
             Block b = NextUnpinnedBlock();
             fetching_bytes_ += b.size();
-            fetching_blocks_.emplace_back(b.Pin(local_worker_id_));
+            fetching_blocks_.emplace_back(
+                b.Pin(local_worker_id_, AccessHint::Scanned));
         }
 
+        AdviseNextBlock();
+
         // this might block if the prefetching is not finished
         PinnedBlock b = fetching_blocks_.front()->Wait();
         fetching_bytes_ -= b.size();
@@ -161,8 +207,25 @@ PinnedBlock KeepFileBlockSource::NextBlock() {
     }
 }
 
+void KeepFileBlockSource::AdviseNextBlock() {
+    // the Block after the prefetched ones is pinned next, try to keep it in
+    // RAM. Advise it only once, since the hint takes the BlockPool's lock.
+    if (current_block_ >= file_.num_blocks()) {
+        advised_block_.reset();
+        return;
+    }
+    const ByteBlockPtr& next = file_.block(current_block_).byte_block();
+    if (next == advised_block_) return;
+    next->AdviseAccess(AccessHint::WillNeed);
+    advised_block_ = next;
+}
+
 //! Determine current unpinned Block to deliver via NextBlock()
 Block KeepFileBlockSource::NextUnpinnedBlock() {
+    // pinning replaces the WillNeed hint
+    if (file_.block(current_block_).byte_block() == advised_block_)
+        advised_block_.reset();
+
     if (current_block_ == first_block_) {
         // construct first block differently, in case we want to shorten it.
         Block b = file_.block(current_block_++);
@@ -190,7 +253,10 @@ ConsumeFileBlockSource::ConsumeFileBlockSource(ConsumeFileBlockSource&& s)
     : file_(s.file_), local_worker_id_(s.local_worker_id_),
       prefetch_size_(s.prefetch_size_),
       fetching_blocks_(std::move(s.fetching_blocks_)),
-      fetching_bytes_(s.fetching_bytes_) {
+      fetching_bytes_(s.fetching_bytes_),
+      prefetch_group_(std::move(s.prefetch_group_)),
+      prefetch_share_(s.prefetch_share_),
+      advised_block_(std::move(s.advised_block_)) {
     s.file_ = nullptr;
 }
 
@@ -201,7 +267,11 @@ void ConsumeFileBlockSource::Prefetch(size_t prefetch_size) {
         while (fetching_bytes_ < prefetch_size_ && !file_->blocks_.empty()) {
             Block& b = file_->blocks_.front();
             fetching_bytes_ += b.size();
-            fetching_blocks_.emplace_back(b.Pin(local_worker_id_));
+            fetching_blocks_.emplace_back(
+                b.Pin(local_worker_id_, AccessHint::Scanned));
+            // pinning replaces the WillNeed hint
+            if (b.byte_block() == advised_block_)
+                advised_block_.reset();
             file_->blocks_.pop_front();
         }
     }
@@ -211,14 +281,29 @@ void ConsumeFileBlockSource::Prefetch(size_t prefetch_size) {
     }
 }
 
+void ConsumeFileBlockSource::SetPrefetchGroup(const PrefetchGroupPtr& group) {
+    if (prefetch_group_)
+        prefetch_group_->Leave(prefetch_share_);
+    prefetch_group_ = group;
+    if (prefetch_group_)
+        prefetch_group_->Join(prefetch_share_);
+}
+
 PinnedBlock ConsumeFileBlockSource::NextBlock() {
     assert(file_);
     if (file_->blocks_.empty() && fetching_blocks_.empty())
         return PinnedBlock();
 
+    if (prefetch_group_)
+        prefetch_size_ = prefetch_group_->Deliver(prefetch_share_);
+
+    // consumed Blocks are not needed again by this reader, but may be shared.
     // operate without prefetching
     if (prefetch_size_ == 0) {
-        PinRequestPtr f = file_->blocks_.front().Pin(local_worker_id_);
+        PinRequestPtr f = file_->blocks_.front().Pin(
+            local_worker_id_, AccessHint::Scanned);
+        if (file_->blocks_.front().byte_block() == advised_block_)
+            advised_block_.reset();
         file_->blocks_.pop_front();
         return f->Wait();
     }
@@ -227,10 +312,15 @@ PinnedBlock ConsumeFileBlockSource::NextBlock() {
     while (fetching_bytes_ < prefetch_size_ && !file_->blocks_.empty()) {
         Block& b = file_->blocks_.front();
         fetching_bytes_ += b.size();
-        fetching_blocks_.emplace_back(b.Pin(local_worker_id_));
+        fetching_blocks_.emplace_back(
+            b.Pin(local_worker_id_, AccessHint::Scanned));
+        if (b.byte_block() == advised_block_)
+            advised_block_.reset();
         file_->blocks_.pop_front();
     }
 
+    AdviseNextBlock();
+
     // this might block if the prefetching is not finished
     PinnedBlock b = fetching_blocks_.front()->Wait();
     fetching_bytes_ -= b.size();
@@ -238,7 +328,27 @@ PinnedBlock ConsumeFileBlockSource::NextBlock() {
     return b;
 }
 
+void ConsumeFileBlockSource::AdviseNextBlock() {
+    // the Block after the prefetched ones is pinned next, try to keep it in
+    // RAM. Advise it only once, since the hint takes the BlockPool's lock.
+    if (file_->blocks_.empty()) {
+        advised_block_.reset();
+        return;
+    }
+    const ByteBlockPtr& next = file_->blocks_.front().byte_block();
+    if (next == advised_block_) return;
+    next->AdviseAccess(AccessHint::WillNeed);
+    advised_block_ = next;
+}
+
 ConsumeFileBlockSource::~ConsumeFileBlockSource() {
+    // an abandoned reader must not leave the Block ranked as WillNeed, it may
+    // be shared with another File.
+    if (advised_block_)
+        advised_block_->AdviseAccess(AccessHint::Normal);
+    advised_block_.reset();
+    if (prefetch_group_)
+        prefetch_group_->Leave(prefetch_share_);
     if (file_ != nullptr)
         file_->Clear();
 }
@@ -17,11 +17,14 @@
 #include <thrill/data/block.hpp>
 #include <thrill/data/block_reader.hpp>
 #include <thrill/data/block_sink.hpp>
+#include <thrill/data/block_size_policy.hpp>
 #include <thrill/data/block_writer.hpp>
 #include <thrill/data/dyn_block_reader.hpp>
+#include <thrill/data/prefetch_group.hpp>
 
 #include <tlx/die.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <deque>
 #include <functional>
@@ -135,8 +138,14 @@ public:
     //! \name Writers and Readers
     //! \{
 
-    //! Get BlockWriter.
-    Writer GetWriter(size_t block_size = default_block_size);
+    //! Get BlockWriter using the File's BlockSizePolicy.
+    Writer GetWriter();
+
+    //! Get BlockWriter with Blocks of at most max_block_size bytes.
+    Writer GetWriter(size_t max_block_size);
+
+    //! Get BlockWriter with Block sizes determined by the given policy.
+    Writer GetWriter(const BlockSizePolicy& policy);
 
     /*!
      * Get BlockReader or a consuming BlockReader for beginning of File
@@ -244,6 +253,16 @@ public:
     template <typename ItemType>
     std::vector<Block> GetItemRange(size_t begin, size_t end) const;
 
+    /*!
+     * Split the File at the given non-decreasing item positions into
+     * positions.size() + 1 consecutive Files, which share the ByteBlocks of
+     * this File. Only the Blocks containing a split position are read to find
+     * the item boundary. This File is unchanged, Clear() it to release its
+     * Blocks once the parts are consumed.
+     */
+    template <typename ItemType>
+    std::vector<File> Split(const std::vector<size_t>& positions) const;
+
     //! Output the Block objects contained in this File.
     friend std::ostream& operator << (std::ostream& os, const File& f);
 
@@ -251,6 +270,16 @@ public:
     //! construction)
     void set_dia_id(size_t dia_id) { dia_id_ = dia_id; }
 
+    //! policy for the Block sizes of Writers created by GetWriter()
+    const BlockSizePolicy& block_size_policy() const {
+        return block_size_policy_;
+    }
+
+    //! change the policy for the Block sizes of Writers created by GetWriter()
+    void set_block_size_policy(const BlockSizePolicy& policy) {
+        block_size_policy_ = policy;
+    }
+
 private:
     //! unique file id
     size_t id_;
@@ -258,6 +287,9 @@ private:
     //! optionally associated DIANode id
     size_t dia_id_;
 
+    //! policy for the Block sizes of Writers created by GetWriter()
+    BlockSizePolicy block_size_policy_;
+
     //! container holding Blocks and thus shared pointers to all byte blocks.
     std::deque<Block> blocks_;
 
@@ -355,6 +387,14 @@ public:
         size_t prefetch_size = File::default_prefetch_size_,
         size_t first_block = 0, size_t first_item = keep_first_item);
 
+    //! non-copyable: delete copy-constructor
+    KeepFileBlockSource(const KeepFileBlockSource&) = delete;
+    //! move-constructor: leaves the hint and prefetch group to the new source
+    KeepFileBlockSource(KeepFileBlockSource&& s);
+
+    //! Clear the WillNeed hint of a Block not read and leave the prefetch group
+    ~KeepFileBlockSource();
+
     //! Advance to next block of file, delivers current_ and end_ for
     //! BlockReader
     PinnedBlock NextBlock();
@@ -362,6 +402,14 @@ public:
     //! Perform prefetch
     void Prefetch(size_t prefetch_size);
 
+    //! Join a PrefetchGroup, which then determines the prefetch size from the
+    //! predicted consumption of this reader.
+    void SetPrefetchGroup(const PrefetchGroupPtr& group);
+
+    //! index of the next Block to deliver. Without prefetch, the Block read
+    //! last has the index before it.
+    size_t next_block() const { return current_block_; }
+
 protected:
     //! Determine current unpinned Block to deliver via NextBlock()
     Block NextUnpinnedBlock();
@@ -385,6 +433,12 @@ private:
     //! current number of bytes in prefetch
     size_t fetching_bytes_;
 
+    //! group sharing the prefetch budget, if any
+    PrefetchGroupPtr prefetch_group_;
+
+    //! state of this reader in prefetch_group_
+    PrefetchGroup::Share prefetch_share_;
+
     //! number of the first block
     size_t first_block_;
 
@@ -393,6 +447,12 @@ private:
 
     //! offset of first item in first block read
     size_t first_item_;
+
+    //! Block advised as WillNeed and not pinned yet, if any
+    ByteBlockPtr advised_block_;
+
+    //! advise WillNeed for the Block at current_block_ if it changed.
+    void AdviseNextBlock();
 };
 
 /*!
@@ -426,6 +486,10 @@ public:
     //! Get the next block of file.
     PinnedBlock NextBlock();
 
+    //! Join a PrefetchGroup, which then determines the prefetch size from the
+    //! predicted consumption of this reader.
+    void SetPrefetchGroup(const PrefetchGroupPtr& group);
+
     //! Consume unread blocks and reset File to zero items.
     ~ConsumeFileBlockSource();
 
@@ -444,6 +508,18 @@ private:
 
     //! current number of bytes in prefetch
     size_t fetching_bytes_;
+
+    //! group sharing the prefetch budget, if any
+    PrefetchGroupPtr prefetch_group_;
+
+    //! state of this reader in prefetch_group_
+    PrefetchGroup::Share prefetch_share_;
+
+    //! Block advised as WillNeed and not pinned yet, if any
+    ByteBlockPtr advised_block_;
+
+    //! advise WillNeed for the front Block of the File if it changed.
+    void AdviseNextBlock();
 };
 
 //! Get BlockReader seeked to the corresponding item index
@@ -565,7 +641,66 @@ std::vector<Block> File::GetItemRange(size_t begin, size_t end) const {
            .template GetItemBatch<ItemType>(end - begin);
 }
 
-//! Take a vector of Readers and prefetch equally from them
+template <typename ItemType>
+std::vector<File> File::Split(const std::vector<size_t>& positions) const {
+    std::vector<File> out;
+    out.reserve(positions.size() + 1);
+
+    // index of the next Block to append, and the Block itself, which is the
+    // rest of blocks_[b] if it was split before.
+    size_t b = 0, prev = 0;
+    Block front = blocks_.empty() ? Block() : blocks_[0];
+
+    auto append_rest =
+        [&](File& part) {
+            if (b >= blocks_.size()) return;
+            part.AppendBlock(front);
+            for (++b; b < blocks_.size(); ++b)
+                part.AppendBlock(blocks_[b]);
+        };
+
+    for (size_t pos : positions) {
+        assert(prev <= pos && pos <= num_items());
+        out.emplace_back(*block_pool(), local_worker_id(), dia_id_);
+        File& part = out.back();
+        if (pos == prev) continue;
+        prev = pos;
+
+        if (pos == num_items()) {
+            append_rest(part);
+            continue;
+        }
+
+        // locate the Block in which item pos starts, the reader is positioned
+        // in it since it does not prefetch.
+        KeepReader reader = GetReaderAt<ItemType>(pos, /* prefetch */ 0);
+        size_t j = reader.source().next_block() - 1;
+        Block rest = reader.RestBlock();
+
+        for ( ; b < j; front = blocks_[++b])
+            part.AppendBlock(front);
+
+        // the head of the split Block ends before item pos
+        front.set_end(rest.first_item_absolute());
+        front.set_num_items(front.num_items() - rest.num_items());
+        part.AppendBlock(front);
+        front = std::move(rest);
+    }
+
+    out.emplace_back(*block_pool(), local_worker_id(), dia_id_);
+    if (prev < num_items())
+        append_rest(out.back());
+
+    return out;
+}
+
+/*!
+ * Take a vector of Readers which are consumed together, e.g. by a multiway
+ * merge, and prefetch equally from them. Afterwards the Readers share a
+ * PrefetchGroup with a budget of prefetch_size bytes per Reader, which shifts
+ * the prefetch towards the Readers the merge consumes fastest. The group only
+ * applies to File Readers, Readers of other sources keep their fixed prefetch.
+ */
 template <typename Reader>
 void StartPrefetch(std::vector<Reader>& readers, size_t prefetch_size) {
     for (size_t p = default_block_size; p < prefetch_size;
@@ -576,6 +711,14 @@ void StartPrefetch(std::vector<Reader>& readers, size_t prefetch_size) {
     }
     for (Reader& r : readers)
         r.source().Prefetch(prefetch_size);
+
+    if (prefetch_size == 0 || readers.size() <= 1) return;
+
+    PrefetchGroupPtr group = tlx::make_counting<PrefetchGroup>(
+        prefetch_size * readers.size(), readers.size(),
+        std::min(prefetch_size, default_block_size));
+    for (Reader& r : readers)
+        r.source().SetPrefetchGroup(group);
 }
 
 //! \}
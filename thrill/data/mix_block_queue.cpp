@@ -74,6 +74,9 @@ MixBlockQueue::SrcBlockPair MixBlockQueue::Pop() {
             << " read_open_ " << read_open_ << " -> " << read_open_ - 1;
         --read_open_;
     }
+    else if (pop_callback_) {
+        pop_callback_(b.src);
+    }
     return b;
 }
 
@@ -22,6 +22,7 @@
 #include <thrill/data/dyn_block_reader.hpp>
 #include <thrill/data/file.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace thrill {
@@ -74,6 +75,9 @@ public:
 
     using Reader = MixBlockQueueReader;
 
+    //! callback issued with the source worker when a Block was consumed
+    using PopCallback = tlx::delegate<void (size_t src)>;
+
     //! Constructor from BlockPool
     MixBlockQueue(BlockPool& block_pool, size_t num_workers,
                   size_t local_worker_id, size_t dia_id);
@@ -106,6 +110,9 @@ public:
     //! Blocking retrieval of a (source,block) pair.
     SrcBlockPair Pop();
 
+    //! set the callback issued when the reader consumed a Block
+    void set_pop_callback(const PopCallback& cb) { pop_callback_ = cb; }
+
     //! check if writer side Close() was called.
     bool write_closed() const { return write_open_count_ == 0; }
 
@@ -136,6 +143,10 @@ private:
     //! BlockQueues to deliver blocks to from mix queue.
     std::vector<BlockQueue> queues_;
 
+    //! callback to issue when Pop() returns a Block -- for granting credits to
+    //! the sender
+    PopCallback pop_callback_;
+
     //! for access to queues_ and other internals.
     friend class MixBlockQueueReader;
 };
@@ -212,6 +223,20 @@ public:
         }
     }
 
+    //! ReadMany appends up to n items to a std::vector, see
+    //! BlockReader::ReadMany(). Items are only taken from the currently
+    //! selected sub-reader. Returns the number of items appended.
+    template <typename T, typename Alloc>
+    size_t ReadMany(std::vector<T, Alloc>& out, size_t n) {
+        if (reread_) return cat_reader_.ReadMany(out, n);
+        if (!HasNext()) return 0;
+
+        size_t m = readers_[selected_].ReadMany(out, std::min(n, available_));
+        assert(m <= available_);
+        available_ -= m;
+        return m;
+    }
+
 private:
     //! reference to mix queue
     MixBlockQueue& mix_queue_;
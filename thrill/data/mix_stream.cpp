@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <map>
+#include <mutex>
 #include <vector>
 
 namespace thrill {
@@ -32,6 +33,10 @@ MixStreamData::MixStreamData(Multiplexer& multiplexer, size_t send_size_limit,
       queue_(multiplexer_.block_pool_, num_workers(),
              local_worker_id, dia_id) {
     remaining_closing_blocks_ = num_hosts() * workers_per_host();
+
+    // grant credits to the sender when Blocks are consumed
+    queue_.set_pop_callback(
+        [this](size_t src) { OnBlockConsumed(src); });
 }
 
 MixStreamData::~MixStreamData() {
@@ -50,6 +55,11 @@ MixStreamData::Writers MixStreamData::GetWriters() {
     size_t block_size = tlx::round_down_to_power_of_two(block_size_base);
     if (block_size == 0 || block_size > default_block_size)
         block_size = default_block_size;
+    // writers to all targets hold one open Block each, which is accounted
+    // against hard_ram_limit / 4 above. Keep stream Blocks at half of that
+    // bound, as before BlockSizePolicy, to leave room for Blocks in flight.
+    BlockSizePolicy policy = block_size_policy_.Capped(
+        std::max(block_size / 2, std::min(start_block_size, block_size)));
 
     {
         std::unique_lock<std::mutex> lock(multiplexer_.mutex_);
@@ -64,6 +74,7 @@ MixStreamData::Writers MixStreamData::GetWriters() {
         << " hard_ram_limit=" << hard_ram_limit
         << " block_size_base=" << block_size_base
         << " block_size=" << block_size
+        << " policy=" << policy
         << " active_streams=" << multiplexer_.active_streams_
         << " max_active_streams=" << multiplexer_.max_active_streams_;
 
@@ -85,19 +96,18 @@ MixStreamData::Writers MixStreamData::GetWriters() {
                         id_,
                         my_host_rank(), local_worker_id_,
                         host, worker),
-                    block_size);
+                    policy);
             }
             else {
                 result.emplace_back(
                     StreamSink(
                         StreamDataPtr(this),
                         multiplexer_.block_pool_,
-                        &multiplexer_.group_.connection(host),
                         MagicByte::MixStreamBlock,
                         id_,
                         my_host_rank(), local_worker_id_,
                         host, worker),
-                    block_size);
+                    policy);
             }
         }
     }
@@ -119,6 +129,13 @@ void MixStreamData::Close() {
     if (is_closed_) return;
     is_closed_ = true;
 
+    // Blocks which are not read anymore must still arrive, hence lift the flow
+    // control of all senders.
+    if (!queue_.write_closed()) {
+        for (size_t w = 0; w < num_workers(); ++w)
+            GrantUnlimitedCredit(w);
+    }
+
     // wait for all close packets to arrive.
     for (size_t i = 0; i < num_hosts() * workers_per_host(); ++i) {
         LOG << "MixStreamData::Close() wait for closing block"
@@ -127,6 +144,9 @@ void MixStreamData::Close() {
         sem_closing_blocks_.wait();
     }
 
+    // wait for Blocks held back for lack of credit to be sent
+    WaitDeferred();
+
     tx_lifetime_.StopEventually();
     tx_timespan_.StopEventually();
     OnAllClosed("MixStreamData");
@@ -155,6 +175,10 @@ struct MixStreamData::SeqReordering {
 
     //! queue of waiting Blocks, ordered by sequence number
     std::map<uint32_t, PinnedBlock> waiting_;
+
+    //! protects the reordering, as the Blocks of a sender are delivered by
+    //! multiple dispatcher threads if the Multiplexer stripes connections.
+    std::mutex                      mutex_;
 };
 
 void MixStreamData::OnStreamBlock(size_t from, uint32_t seq, PinnedBlock&& b) {
@@ -170,6 +194,10 @@ void MixStreamData::OnStreamBlock(size_t from, uint32_t seq, PinnedBlock&& b) {
          << "from" << from
          << "for worker" << my_worker_rank();
 
+    // lock only this sender's sequence, such that the dispatcher threads
+    // serving different peers do not contend.
+    std::unique_lock<std::mutex> lock(seq_[from].mutex_);
+
     if (TLX_UNLIKELY(seq != seq_[from].seq_)) {
         // sequence mismatch: put into queue
         die_unless(seq >= seq_[from].seq_);
@@ -80,6 +80,8 @@ public:
     //! shuts the stream down.
     void Close() final;
 
+    MagicByte credit_magic() const final { return MagicByte::MixStreamCredit; }
+
     //! Indicates if the stream is closed - meaning all remaining outbound
     //! queues have been closed.
     bool closed() const final;
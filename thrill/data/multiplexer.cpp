@@ -11,6 +11,8 @@
 
 #include <thrill/data/multiplexer.hpp>
 
+#include <thrill/common/concurrent_bounded_queue.hpp>
+#include <thrill/common/logger.hpp>
 #include <thrill/data/cat_stream.hpp>
 #include <thrill/data/mix_stream.hpp>
 #include <thrill/data/multiplexer_header.hpp>
@@ -20,6 +22,8 @@
 #include <tlx/math/round_to_power_of_two.hpp>
 
 #include <algorithm>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -89,6 +93,12 @@ public:
         die("object " + std::to_string(object_id) + " not in repository");
     }
 
+    //! Returns whether the local worker has already allocated object_id
+    bool IsAllocated(Id object_id, size_t local_worker_id) const {
+        assert(local_worker_id < next_id_.size());
+        return object_id < next_id_[local_worker_id];
+    }
+
     //! Remove id from map
     void EraseOrDie(Id object_id) {
         auto it = map_.find(object_id);
@@ -113,27 +123,64 @@ private:
 /******************************************************************************/
 // Multiplexer
 
+//! number of consumed ByteBlocks per connection whose memory is kept for reuse
+//! by received Blocks.
+static const size_t recv_recycler_capacity = 4;
+
 struct Multiplexer::Data {
     //! Streams have an ID in block headers. (worker id, stream id)
     Repository<StreamSetBase>         stream_sets_;
 
-    //! array of number of open requests
+    //! array of number of open requests, indexed by stripe * num_hosts + peer
     std::vector<std::atomic<size_t> > ongoing_requests_;
 
-    explicit Data(size_t num_hosts, size_t workers_per_host)
+    //! recyclers of received ByteBlocks' memory, indexed like
+    //! ongoing_requests_.
+    std::vector<ByteBlockRecyclerPtr> recyclers_;
+
+    //! jobs of the pin thread, an empty job terminates it.
+    common::ConcurrentBoundedQueue<net::DispatcherThread::Job> pin_jobs_;
+
+    //! thread pinning deferred Blocks of Streams, see RunInPinThread()
+    std::thread pin_thread_;
+
+    explicit Data(size_t num_connections, size_t workers_per_host)
         : stream_sets_(workers_per_host),
-          ongoing_requests_(num_hosts) { }
+          ongoing_requests_(num_connections) { }
 };
 
 Multiplexer::Multiplexer(mem::Manager& mem_manager, BlockPool& block_pool,
                          net::DispatcherThread& dispatcher, net::Group& group,
                          size_t workers_per_host)
+    : Multiplexer(mem_manager, block_pool,
+                  std::vector<net::DispatcherThread*>({ &dispatcher }),
+                  std::vector<net::Group*>({ &group }), workers_per_host) { }
+
+Multiplexer::Multiplexer(mem::Manager& mem_manager, BlockPool& block_pool,
+                         const std::vector<net::DispatcherThread*>& dispatchers,
+                         const std::vector<net::Group*>& groups,
+                         size_t workers_per_host)
     : mem_manager_(mem_manager),
       block_pool_(block_pool),
-      dispatcher_(dispatcher),
-      group_(group),
+      groups_(groups),
+      group_(*groups_.at(0)),
       workers_per_host_(workers_per_host),
-      d_(std::make_unique<Data>(group_.num_hosts(), workers_per_host)) {
+      d_(std::make_unique<Data>(
+             groups_.size() * group_.num_hosts(), workers_per_host)) {
+
+    if (dispatchers.size() == groups_.size()) {
+        // one dispatcher for all connections of each Group
+        for (size_t s = 0; s < groups_.size(); ++s)
+            dispatchers_.insert(dispatchers_.end(), num_hosts(), dispatchers[s]);
+    }
+    else {
+        die_unless(dispatchers.size() == groups_.size() * num_hosts());
+        dispatchers_ = dispatchers;
+    }
+    for (net::Group* g : groups_) {
+        die_unless(g->num_hosts() == group_.num_hosts());
+        die_unless(g->my_host_rank() == group_.my_host_rank());
+    }
 
     num_parallel_async_ = group_.num_parallel_async();
     if (num_parallel_async_ == 0) {
@@ -152,14 +199,44 @@ Multiplexer::Multiplexer(mem::Manager& mem_manager, BlockPool& block_pool,
     if (send_size_limit_ < 2 * default_block_size)
         send_size_limit_ = 2 * default_block_size;
 
-    // launch initial async reads
-    for (size_t id = 0; id < group_.num_hosts(); id++) {
-        if (id == group_.my_host_rank()) continue;
-        AsyncReadMultiplexerHeader(id, group_.connection(id));
+    // credits of each sender, such that all senders together fill the send
+    // queue size limit of a receiving worker.
+    stream_credits_ = std::max<size_t>(
+        2, send_size_limit_ / (num_workers() * default_block_size));
+
+    // one recycler for each connection
+    for (size_t i = 0; i < d_->ongoing_requests_.size(); ++i) {
+        d_->recyclers_.emplace_back(
+            tlx::make_counting<ByteBlockRecycler>(
+                block_pool_, recv_recycler_capacity));
+    }
+
+    d_->pin_thread_ = std::thread(
+        [this]() {
+            common::NameThisThread(
+                "host " + std::to_string(my_host_rank()) + " pinner");
+            net::DispatcherThread::Job job;
+            for (d_->pin_jobs_.pop(job); job; d_->pin_jobs_.pop(job))
+                job();
+        });
+
+    // launch initial async reads on all stripes
+    for (size_t stripe = 0; stripe < groups_.size(); ++stripe) {
+        for (size_t id = 0; id < group_.num_hosts(); id++) {
+            if (id == group_.my_host_rank()) continue;
+            AsyncReadMultiplexerHeader(
+                stripe, id, groups_[stripe]->connection(id));
+        }
     }
 }
 
 void Multiplexer::Close() {
+    // all Streams were closed, hence the pin thread has no more jobs
+    if (d_->pin_thread_.joinable()) {
+        d_->pin_jobs_.emplace();
+        d_->pin_thread_.join();
+    }
+
     std::unique_lock<std::mutex> lock(mutex_);
 
     if (!d_->stream_sets_.map().empty()) {
@@ -171,6 +248,22 @@ void Multiplexer::Close() {
     // destroy all still open Streams
     d_->stream_sets_.map().clear();
 
+    // release cached memory of received Blocks and log how often it was reused
+    size_t hits = 0, misses = 0, recycled = 0;
+    for (ByteBlockRecyclerPtr& r : d_->recyclers_) {
+        r->Close();
+        hits += r->hits(), misses += r->misses(), recycled += r->recycled();
+    }
+
+    logger()
+        << "class" << "Multiplexer"
+        << "event" << "close"
+        << "recv_buffer_hits" << hits
+        << "recv_buffer_misses" << misses
+        << "recv_buffer_recycled" << recycled
+        << "recv_buffer_hit_rate"
+        << (hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses));
+
     closed_ = true;
 }
 
@@ -178,7 +271,12 @@ Multiplexer::~Multiplexer() {
     if (!closed_)
         Close();
 
-    group_.Close();
+    for (net::Group* g : groups_)
+        g->Close();
+}
+
+void Multiplexer::RunInPinThread(net::DispatcherThread::Job&& job) {
+    d_->pin_jobs_.emplace(std::move(job));
 }
 
 size_t Multiplexer::AllocateCatStreamId(size_t local_worker_id) {
@@ -245,6 +343,28 @@ MixStreamDataPtr Multiplexer::IntGetOrCreateMixStreamData(
     return ptr;
 }
 
+StreamDataPtr Multiplexer::GetStreamDataForCredit(
+    MagicByte magic, size_t id, size_t local_worker_id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = d_->stream_sets_.map().find(id);
+    if (it != d_->stream_sets_.map().end())
+        return it->second->GetStreamData(local_worker_id);
+
+    // if the local worker has allocated the stream, it was already released.
+    // Otherwise a receiver which closed early granted unlimited credit before
+    // the stream was created here.
+    if (d_->stream_sets_.IsAllocated(id, local_worker_id))
+        return StreamDataPtr();
+
+    if (magic == MagicByte::CatStreamCredit)
+        return IntGetOrCreateCatStreamData(
+            id, local_worker_id, /* dia_id (unknown at this time) */ 0);
+    else
+        return IntGetOrCreateMixStreamData(
+            id, local_worker_id, /* dia_id (unknown at this time) */ 0);
+}
+
 void Multiplexer::IntReleaseCatStream(size_t id, size_t local_worker_id) {
 
     tlx::CountingPtr<CatStreamSet> set =
@@ -279,25 +399,34 @@ common::JsonLogger& Multiplexer::logger() {
 
 /******************************************************************************/
 
-void Multiplexer::AsyncReadMultiplexerHeader(size_t peer, Connection& s) {
+void Multiplexer::AsyncReadMultiplexerHeader(
+    size_t stripe, size_t peer, Connection& s) {
+
+    std::atomic<size_t>& ongoing =
+        d_->ongoing_requests_[stripe * num_hosts() + peer];
 
-    while (d_->ongoing_requests_[peer] < num_parallel_async_) {
+    while (ongoing < num_parallel_async_) {
         uint32_t seq = 42 + (s.rx_seq_.fetch_add(2) & 0xFFFF);
-        dispatcher_.AsyncRead(
+        dispatcher(stripe, peer).AsyncRead(
             s, seq, MultiplexerHeader::total_size,
-            [this, peer, seq](Connection& s, net::Buffer&& buffer) {
-                return OnMultiplexerHeader(peer, seq, s, std::move(buffer));
+            [this, stripe, peer, seq](Connection& s, net::Buffer&& buffer) {
+                return OnMultiplexerHeader(
+                    stripe, peer, seq, s, std::move(buffer));
             });
 
-        d_->ongoing_requests_[peer]++;
+        ongoing++;
     }
 }
 
 void Multiplexer::OnMultiplexerHeader(
-    size_t peer, uint32_t seq, Connection& s, net::Buffer&& buffer) {
+    size_t stripe, size_t peer, uint32_t seq, Connection& s,
+    net::Buffer&& buffer) {
 
-    die_unless(d_->ongoing_requests_[peer] > 0);
-    d_->ongoing_requests_[peer]--;
+    std::atomic<size_t>& ongoing =
+        d_->ongoing_requests_[stripe * num_hosts() + peer];
+
+    die_unless(ongoing > 0);
+    ongoing--;
 
     // received invalid Buffer: the connection has closed?
     if (!buffer.IsValid()) return;
@@ -322,6 +451,10 @@ void Multiplexer::OnMultiplexerHeader(
     if (alloc_size < THRILL_DEFAULT_ALIGN) alloc_size = THRILL_DEFAULT_ALIGN;
     alloc_size = tlx::round_up_to_power_of_two(alloc_size);
 
+    // received Blocks reuse the memory of consumed ones of this connection
+    const ByteBlockRecyclerPtr& recycler =
+        d_->recyclers_[stripe * num_hosts() + peer];
+
     if (header.magic == MagicByte::CatStreamBlock)
     {
         CatStreamDataPtr stream = GetOrCreateCatStreamData(
@@ -343,16 +476,17 @@ void Multiplexer::OnMultiplexerHeader(
                  << "size" << header.size;
 
             PinnedByteBlockPtr bytes = block_pool_.AllocateByteBlock(
-                alloc_size, local_worker);
+                alloc_size, local_worker, recycler);
             sLOG << "new PinnedByteBlockPtr bytes=" << *bytes;
 
-            d_->ongoing_requests_[peer]++;
+            ongoing++;
 
-            dispatcher_.AsyncRead(
+            dispatcher(stripe, peer).AsyncRead(
                 s, seq + 1, header.size, std::move(bytes),
-                [this, peer, header, stream]
+                [this, stripe, peer, header, stream]
                     (Connection& s, PinnedByteBlockPtr&& bytes) {
-                    OnCatStreamBlock(peer, s, header, stream, std::move(bytes));
+                    OnCatStreamBlock(stripe, peer, s, header, stream,
+                                     std::move(bytes));
                 });
         }
     }
@@ -377,31 +511,49 @@ void Multiplexer::OnMultiplexerHeader(
                  << "size" << header.size;
 
             PinnedByteBlockPtr bytes = block_pool_.AllocateByteBlock(
-                alloc_size, local_worker);
+                alloc_size, local_worker, recycler);
 
-            d_->ongoing_requests_[peer]++;
+            ongoing++;
 
-            dispatcher_.AsyncRead(
+            dispatcher(stripe, peer).AsyncRead(
                 s, seq + 1, header.size, std::move(bytes),
-                [this, peer, header, stream]
+                [this, stripe, peer, header, stream]
                     (Connection& s, PinnedByteBlockPtr&& bytes) mutable {
-                    OnMixStreamBlock(peer, s, header, stream, std::move(bytes));
+                    OnMixStreamBlock(stripe, peer, s, header, stream,
+                                     std::move(bytes));
                 });
         }
     }
+    else if (header.magic == MagicByte::CatStreamCredit ||
+             header.magic == MagicByte::MixStreamCredit)
+    {
+        sLOG << "credit from" << s << "on Stream" << id
+             << "from worker" << header.sender_worker
+             << "for local_worker" << local_worker
+             << "credits" << header.num_items;
+
+        StreamDataPtr stream = GetStreamDataForCredit(
+            header.magic, id, local_worker);
+        if (stream)
+            stream->OnCredit(header.sender_worker, header.num_items);
+    }
     else {
         die("Invalid magic byte in MultiplexerHeader");
     }
 
-    AsyncReadMultiplexerHeader(peer, s);
+    AsyncReadMultiplexerHeader(stripe, peer, s);
 }
 
 void Multiplexer::OnCatStreamBlock(
-    size_t peer, Connection& s, const StreamMultiplexerHeader& header,
+    size_t stripe, size_t peer, Connection& s,
+    const StreamMultiplexerHeader& header,
     const CatStreamDataPtr& stream, PinnedByteBlockPtr&& bytes) {
 
-    die_unless(d_->ongoing_requests_[peer] > 0);
-    d_->ongoing_requests_[peer]--;
+    std::atomic<size_t>& ongoing =
+        d_->ongoing_requests_[stripe * num_hosts() + peer];
+
+    die_unless(ongoing > 0);
+    ongoing--;
 
     sLOG << "Multiplexer::OnCatStreamBlock()"
          << "got block" << *bytes << "seq" << header.seq << "on" << s
@@ -418,15 +570,19 @@ void Multiplexer::OnCatStreamBlock(
         stream->OnStreamBlock(header.sender_worker, header.seq + 1,
                               PinnedBlock());
 
-    AsyncReadMultiplexerHeader(peer, s);
+    AsyncReadMultiplexerHeader(stripe, peer, s);
 }
 
 void Multiplexer::OnMixStreamBlock(
-    size_t peer, Connection& s, const StreamMultiplexerHeader& header,
+    size_t stripe, size_t peer, Connection& s,
+    const StreamMultiplexerHeader& header,
     const MixStreamDataPtr& stream, PinnedByteBlockPtr&& bytes) {
 
-    die_unless(d_->ongoing_requests_[peer] > 0);
-    d_->ongoing_requests_[peer]--;
+    std::atomic<size_t>& ongoing =
+        d_->ongoing_requests_[stripe * num_hosts() + peer];
+
+    die_unless(ongoing > 0);
+    ongoing--;
 
     sLOG << "Multiplexer::OnMixStreamBlock()"
          << "got block" << *bytes << "seq" << header.seq << "on" << s
@@ -443,7 +599,7 @@ void Multiplexer::OnMixStreamBlock(
         stream->OnStreamBlock(header.sender_worker, header.seq + 1,
                               PinnedBlock());
 
-    AsyncReadMultiplexerHeader(peer, s);
+    AsyncReadMultiplexerHeader(stripe, peer, s);
 }
 
 CatStreamDataPtr Multiplexer::CatLoopback(
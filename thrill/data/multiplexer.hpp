@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <atomic>
 #include <memory>
+#include <vector>
 
 namespace thrill {
 namespace data {
@@ -27,6 +28,9 @@ namespace data {
 //! \addtogroup data_layer
 //! \{
 
+class StreamData;
+using StreamDataPtr = tlx::CountingPtr<StreamData>;
+
 class StreamSetBase;
 
 template <typename Stream>
@@ -50,6 +54,8 @@ class MixBlockQueueSink;
 
 class StreamMultiplexerHeader;
 
+enum class MagicByte : uint8_t;
+
 /*!
  * Multiplexes virtual Connections on Dispatcher.
  *
@@ -63,6 +69,21 @@ class StreamMultiplexerHeader;
  * All sockets are polled for headers. As soon as the a header arrives it is
  * either attached to an existing stream or a new stream instance is
  * created.
+ *
+ * The Multiplexer can be given multiple net::Groups, which provide parallel
+ * connections (stripes) to each peer, each served by a DispatcherThread. The
+ * Blocks of a Stream are then distributed round-robin across the stripes, and
+ * reassembled by the receiving Stream using the Blocks' sequence numbers.
+ *
+ * The connections may also be sharded across a pool of DispatcherThreads, such
+ * that each connection is served by one thread, but the network I/O of
+ * different peers proceeds in parallel.
+ *
+ * The Blocks of a Stream are subject to credit-based flow control: a sender may
+ * pass stream_credits_ Blocks to each receiving worker, which grants further
+ * credits as its reader consumes them. Blocks without credit are held back
+ * unpinned in the sender's BlockPool, which bounds the memory of slow readers.
+ * When credit arrives, they are pinned again by a separate pin thread.
  */
 class Multiplexer
 {
@@ -73,6 +94,16 @@ public:
                 net::DispatcherThread& dispatcher, net::Group& group,
                 size_t workers_per_host);
 
+    //! Construct Multiplexer striping Blocks across the connections of
+    //! multiple Groups. Either the connections of groups[i] are served by
+    //! dispatchers[i], or dispatchers contains one entry per connection, where
+    //! connection(peer) of groups[i] is served by dispatchers[i * num_hosts +
+    //! peer]. The dispatchers may be the same.
+    Multiplexer(mem::Manager& mem_manager, BlockPool& block_pool,
+                const std::vector<net::DispatcherThread*>& dispatchers,
+                const std::vector<net::Group*>& groups,
+                size_t workers_per_host);
+
     //! non-copyable: delete copy-constructor
     Multiplexer(const Multiplexer&) = delete;
     //! non-copyable: delete assignment operator
@@ -104,6 +135,11 @@ public:
         return workers_per_host_;
     }
 
+    //! number of parallel connections (stripes) to each peer
+    size_t num_stripes() const {
+        return groups_.size();
+    }
+
     //! Get the used BlockPool
     BlockPool& block_pool() { return block_pool_; }
 
@@ -147,11 +183,15 @@ private:
     //! reference to host-global BlockPool.
     BlockPool& block_pool_;
 
-    //! dispatcher used for all communication by data::Multiplexer, the thread
-    //! never leaves the data components!
-    net::DispatcherThread& dispatcher_;
+    //! dispatchers used for all communication by data::Multiplexer, one for
+    //! each connection, indexed by stripe * num_hosts + peer. The threads never
+    //! leave the data components!
+    std::vector<net::DispatcherThread*> dispatchers_;
+
+    //! Groups holding the NetConnections of each stripe
+    std::vector<net::Group*> groups_;
 
-    // Holds NetConnections for outgoing Streams
+    // Holds NetConnections for outgoing Streams, the first stripe.
     net::Group& group_;
 
     //! Number of workers per host
@@ -169,6 +209,10 @@ private:
     //! Calculated send queue size limit for StreamData semaphores
     size_t send_size_limit_;
 
+    //! number of Blocks a sender may send to a receiving worker of a Stream
+    //! before the receiver has consumed any (credit-based flow control)
+    size_t stream_credits_;
+
     //! number of active Cat/MixStreams
     std::atomic<size_t> active_streams_ { 0 };
 
@@ -176,6 +220,7 @@ private:
     std::atomic<size_t> max_active_streams_ { 0 };
 
     //! friends for access to network components
+    friend class StreamData;
     friend class CatStreamData;
     friend class MixStreamData;
     friend class StreamSink;
@@ -185,6 +230,24 @@ private:
     CatStreamDataPtr CatLoopback(size_t stream_id, size_t to_worker_id);
     MixStreamDataPtr MixLoopback(size_t stream_id, size_t to_worker_id);
 
+    //! stripe used to send the Block with sequence number seq of a Stream from
+    //! a local worker: consecutive Blocks are sent round-robin, starting at
+    //! different stripes for different Streams and workers.
+    size_t StripeOf(size_t stream_id, size_t local_worker_id,
+                    uint32_t seq) const {
+        return (stream_id + local_worker_id + seq) % groups_.size();
+    }
+
+    //! dispatcher serving the connection to peer in the given stripe
+    net::DispatcherThread& dispatcher(size_t stripe, size_t peer) const {
+        return *dispatchers_[stripe * num_hosts() + peer];
+    }
+
+    //! Run job in the pin thread, which pins the Blocks StreamData held back
+    //! for lack of credit. BlockPool::PinBlock() may wait for memory or for the
+    //! Block to be read from disk, which must not stall a dispatcher thread.
+    void RunInPinThread(net::DispatcherThread::Job&& job);
+
     /**************************************************************************/
 
     //! pimpl data structure
@@ -198,6 +261,12 @@ private:
     MixStreamDataPtr IntGetOrCreateMixStreamData(
         size_t id, size_t local_worker_id, size_t dia_id);
 
+    //! Get stream of a local worker to deliver credits to. Returns nullptr if
+    //! the worker already released it. Streams not yet allocated by the worker
+    //! are created.
+    StreamDataPtr GetStreamDataForCredit(
+        MagicByte magic, size_t id, size_t local_worker_id);
+
     //! release pointer onto a CatStreamData object
     void IntReleaseCatStream(size_t id, size_t local_worker_id);
     //! release pointer onto a MixStream object
@@ -209,21 +278,24 @@ private:
 
     //! expects the next MultiplexerHeader from a socket and passes to
     //! OnMultiplexerHeader
-    void AsyncReadMultiplexerHeader(size_t peer, Connection& s);
+    void AsyncReadMultiplexerHeader(size_t stripe, size_t peer, Connection& s);
 
-    //! parses MultiplexerHeader and decides whether to receive Block or close
-    //! Stream
+    //! parses MultiplexerHeader and decides whether to receive Block, close
+    //! Stream, or deliver credits
     void OnMultiplexerHeader(
-        size_t peer, uint32_t seq, Connection& s, net::Buffer&& buffer);
+        size_t stripe, size_t peer, uint32_t seq, Connection& s,
+        net::Buffer&& buffer);
 
     //! Receives and dispatches a Block to a CatStreamData
     void OnCatStreamBlock(
-        size_t peer, Connection& s, const StreamMultiplexerHeader& header,
+        size_t stripe, size_t peer, Connection& s,
+        const StreamMultiplexerHeader& header,
         const CatStreamDataPtr& stream, PinnedByteBlockPtr&& bytes);
 
     //! Receives and dispatches a Block to a MixStream
     void OnMixStreamBlock(
-        size_t peer, Connection& s, const StreamMultiplexerHeader& header,
+        size_t stripe, size_t peer, Connection& s,
+        const StreamMultiplexerHeader& header,
         const MixStreamDataPtr& stream, PinnedByteBlockPtr&& bytes);
 };
 
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * thrill/data/prefetch_group.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_DATA_PREFETCH_GROUP_HEADER
+#define THRILL_DATA_PREFETCH_GROUP_HEADER
+
+#include <tlx/counting_ptr.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace thrill {
+namespace data {
+
+//! \addtogroup data_layer
+//! \{
+
+/*!
+ * A prefetch budget shared by a group of Readers which are consumed together,
+ * such as the Files of a multiway merge. Instead of a fixed prefetch size per
+ * Reader, the budget is split according to the consumption order of the
+ * merge: each Reader tracks how many Blocks the whole group delivered between
+ * two of its own Blocks, and uses the inverse as the predicted share of the
+ * merge's consumption. Runs which the merge reads quickly thus get deep
+ * prefetch, while runs which currently do not advance hold only a single Block
+ * in flight. The sizes of all Readers together never exceed the total budget, a
+ * Reader can grow only into the bytes which others gave up.
+ */
+class PrefetchGroup : public tlx::ReferenceCounter
+{
+public:
+    //! per-Reader state kept in the BlockSource
+    struct Share {
+        //! group tick of last Block delivered
+        size_t last_tick = 0;
+        //! smoothed number of group Blocks between two of own Blocks
+        double gap = 1.0;
+        //! current prefetch size of the Reader, counted in the group
+        size_t size = 0;
+    };
+
+    /*!
+     * Construct a group with total_size bytes of prefetch for num_readers
+     * Readers. Each Reader prefetches at least min_size bytes (one Block) and
+     * at most half the budget.
+     */
+    PrefetchGroup(size_t total_size, size_t num_readers, size_t min_size)
+        : total_size_(total_size), num_readers_(num_readers),
+          min_size_(min_size),
+          max_size_(std::max(min_size, total_size / 2)) {
+        assert(num_readers_ > 0);
+    }
+
+    //! total prefetch size of the group
+    size_t total_size() const { return total_size_; }
+
+    //! number of Blocks delivered by all Readers
+    size_t ticks() const { return ticks_; }
+
+    //! prefetch size currently assigned to all Readers
+    size_t assigned_size() const { return assigned_size_; }
+
+    //! initialize the Share of a Reader joining the group with an equal split.
+    void Join(Share& share) {
+        share.last_tick = ticks_;
+        share.gap = static_cast<double>(num_readers_);
+        share.size = std::max(total_size_ / num_readers_, min_size_);
+        assigned_size_ += share.size;
+    }
+
+    //! return the prefetch size of a Reader leaving the group to the others.
+    void Leave(Share& share) {
+        assert(assigned_size_ >= share.size);
+        assigned_size_ -= share.size;
+        share.size = 0;
+    }
+
+    //! Called when a Reader delivers a Block. Updates the Reader's predicted
+    //! share of the consumption and returns its new prefetch size.
+    size_t Deliver(Share& share) {
+        size_t tick = ++ticks_;
+        double gap = static_cast<double>(tick - share.last_tick);
+        share.last_tick = tick;
+        share.gap = (1.0 - smoothing) * share.gap + smoothing * gap;
+
+        size_t size = static_cast<size_t>(
+            static_cast<double>(total_size_) / share.gap);
+        size = std::min(std::max(size, min_size_), max_size_);
+
+        // clamp to the budget not assigned to the other Readers, which is at
+        // least the current size.
+        size_t others = assigned_size_ - share.size;
+        if (others < total_size_)
+            size = std::min(size, std::max(total_size_ - others, min_size_));
+        else
+            size = min_size_;
+
+        assigned_size_ = others + size;
+        share.size = size;
+        return size;
+    }
+
+private:
+    //! weight of newest observed gap in exponential smoothing
+    static constexpr double smoothing = 0.25;
+
+    //! total prefetch size of the group
+    size_t total_size_;
+    //! number of Readers in the group
+    size_t num_readers_;
+    //! minimum prefetch size of each Reader
+    size_t min_size_;
+    //! maximum prefetch size of each Reader
+    size_t max_size_;
+    //! number of Blocks delivered by all Readers
+    size_t ticks_ = 0;
+    //! sum of the current prefetch sizes of all Readers
+    size_t assigned_size_ = 0;
+};
+
+using PrefetchGroupPtr = tlx::CountingPtr<PrefetchGroup>;
+
+//! \}
+
+} // namespace data
+} // namespace thrill
+
+#endif // !THRILL_DATA_PREFETCH_GROUP_HEADER
+
+/******************************************************************************/
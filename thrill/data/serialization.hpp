@@ -14,9 +14,12 @@
 
 #include <thrill/common/functional.hpp>
 #include <thrill/data/serialization_fwd.hpp>
+#include <tlx/die.hpp>
 #include <tlx/meta/has_member.hpp>
 
 #include <array>
+#include <cstdint>
+#include <initializer_list>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -31,12 +34,24 @@ namespace data {
 
 /******************* Serialization of plain old data types ********************/
 
+TLX_MAKE_HAS_MEMBER(thrill_fields);
+
+/*!
+ * Whether items of type T are serialized as their raw memory bytes by the
+ * specialization below: PODs which are not pointers, and do not declare
+ * thrill_fields(). Arrays of such items can be copied into and out of Blocks as
+ * a whole.
+ */
+template <typename T>
+struct is_raw_serializable
+    : public std::integral_constant<
+          bool, std::is_pod<T>::value && !std::is_pointer<T>::value
+          && !has_member_thrill_fields<T>::value>{ };
+
 template <typename Archive, typename T>
 struct Serialization<Archive, T,
                      typename std::enable_if<
-                         // a POD, but not a pointer
-                         std::is_pod<T>::value
-                         && !std::is_pointer<T>::value
+                         is_raw_serializable<T>::value
                          >::type> {
     static void Serialize(const T& x, Archive& ar) {
         ar.template PutRaw<T>(x);
@@ -160,9 +175,20 @@ struct TupleDeserializer<Archive, 0, std::tuple<> > {
 
 //! \}
 
+/*!
+ * Trait to opt a tuple type into compact serialization: specialize as
+ * std::true_type, then integral elements are Varint/zigzag encoded, see
+ * "Compact Serialization" below.
+ */
+template <typename Tuple>
+struct is_compact_tuple : public std::false_type { };
+
 // -------------------- tuple de-/serializer interface -----------------------//
 template <typename Archive, typename... Args>
-struct Serialization<Archive, std::tuple<Args...> > {
+struct Serialization<Archive, std::tuple<Args...>,
+                     typename std::enable_if<
+                         !is_compact_tuple<std::tuple<Args...> >::value
+                         >::type> {
     static void Serialize(const std::tuple<Args...>& x, Archive& ar) {
         detail::TupleSerialization<
             Archive, sizeof ... (Args), Args...>::Serialize(x, ar);
@@ -244,6 +270,302 @@ struct Serialization<Archive, T,
     static constexpr size_t fixed_size = T::thrill_fixed_size;
 };
 
+/************************* Compact Serialization ******************************/
+
+/*!
+ * Zigzag maps signed to unsigned integers such that values of small magnitude
+ * remain small: 0, -1, 1, -2, 2, ... are mapped to 0, 1, 2, 3, 4, ...
+ */
+static inline uint64_t ZigzagEncode(int64_t x) {
+    return (static_cast<uint64_t>(x) << 1) ^ static_cast<uint64_t>(x >> 63);
+}
+
+//! inverse of ZigzagEncode()
+static inline int64_t ZigzagDecode(uint64_t v) {
+    return static_cast<int64_t>((v >> 1) ^ (~(v & 1) + 1));
+}
+
+/*!
+ * Encoding of a single field. Plain fields use the Serialization of their
+ * type, compact integral fields are written as Varint, signed ones after
+ * zigzag mapping. Single byte integers gain nothing from a Varint and are
+ * always written raw.
+ */
+template <typename T, bool Compact, typename Enable = void>
+struct FieldEncoding {
+    template <typename Archive>
+    static void Serialize(const T& x, Archive& ar) {
+        Serialization<Archive, T>::Serialize(x, ar);
+    }
+    template <typename Archive>
+    static T Deserialize(Archive& ar) {
+        return Serialization<Archive, T>::Deserialize(ar);
+    }
+};
+
+template <typename T>
+struct FieldEncoding<T, true, typename std::enable_if<
+                         std::is_integral<T>::value &&
+                         std::is_unsigned<T>::value &&
+                         (sizeof(T) > 1) && (sizeof(T) <= 8)
+                         >::type> {
+    template <typename Archive>
+    static void Serialize(const T& x, Archive& ar) {
+        ar.PutVarint(static_cast<uint64_t>(x));
+    }
+    template <typename Archive>
+    static T Deserialize(Archive& ar) {
+        return static_cast<T>(ar.GetVarint());
+    }
+};
+
+template <typename T>
+struct FieldEncoding<T, true, typename std::enable_if<
+                         std::is_integral<T>::value &&
+                         std::is_signed<T>::value &&
+                         (sizeof(T) > 1) && (sizeof(T) <= 8)
+                         >::type> {
+    template <typename Archive>
+    static void Serialize(const T& x, Archive& ar) {
+        ar.PutVarint(ZigzagEncode(static_cast<int64_t>(x)));
+    }
+    template <typename Archive>
+    static T Deserialize(Archive& ar) {
+        return static_cast<T>(ZigzagDecode(ar.GetVarint()));
+    }
+};
+
+/*!
+ * Descriptor of a data member of Class, which is serialized plainly or
+ * compactly. Construct with Field() or CompactField().
+ */
+template <typename Class, typename Type, bool Compact>
+struct FieldDescriptor {
+    using ValueType = Type;
+    static constexpr bool compact = Compact;
+
+    //! pointer to the data member
+    Type Class::* member;
+};
+
+//! describe a data member serialized with the Serialization of its type.
+template <typename Class, typename Type>
+FieldDescriptor<Class, Type, false> Field(Type Class::* member) {
+    return FieldDescriptor<Class, Type, false>{ member };
+}
+
+//! describe a data member serialized compactly, integers as Varint.
+template <typename Class, typename Type>
+FieldDescriptor<Class, Type, true> CompactField(Type Class::* member) {
+    return FieldDescriptor<Class, Type, true>{ member };
+}
+
+namespace detail {
+
+//! logical or of a list of bools
+template <bool... Bs>
+struct AnyOf : public std::false_type { };
+
+template <bool B, bool... Bs>
+struct AnyOf<B, Bs...>
+    : public std::integral_constant<bool, B || AnyOf<Bs...>::value>{ };
+
+//! logical and of a list of bools
+template <bool... Bs>
+struct AllOf : public std::true_type { };
+
+template <bool B, bool... Bs>
+struct AllOf<B, Bs...>
+    : public std::integral_constant<bool, B && AllOf<Bs...>::value>{ };
+
+//! sum of a list of sizes
+template <size_t... Ss>
+struct SumOf : public std::integral_constant<size_t, 0>{ };
+
+template <size_t S, size_t... Ss>
+struct SumOf<S, Ss...>
+    : public std::integral_constant<size_t, S + SumOf<Ss...>::value>{ };
+
+} // namespace detail
+
+/*!
+ * List of FieldDescriptors, returned by a static method thrill_fields() of a
+ * class to declare its serialization without writing Serialize and
+ * Deserialize methods:
+ *
+ * \code
+ * struct PagePageLink {
+ *     size_t src, tgt;
+ *     static auto thrill_fields() {
+ *         return data::MakeCompactFields(
+ *             &PagePageLink::src, &PagePageLink::tgt);
+ *     }
+ * };
+ * \endcode
+ *
+ * The class must be default constructible. Lists containing only plain Fields
+ * are written as the concatenation of the fields. If any field is compact, the
+ * item is prefixed by the number of fields: items written with fewer fields
+ * can still be read after new fields are appended to the list, the missing
+ * fields are value-initialized.
+ */
+template <typename... Fields>
+struct FieldList {
+    //! number of fields
+    static constexpr size_t size = sizeof ... (Fields);
+
+    //! whether any field is compact, then the field count is written.
+    static constexpr bool compact = detail::AnyOf<Fields::compact...>::value;
+
+    //! the field descriptors
+    std::tuple<Fields...> fields;
+};
+
+//! construct a FieldList from Field() and CompactField() descriptors
+template <typename... Fields>
+FieldList<Fields...> MakeFields(const Fields& ... fields) {
+    return FieldList<Fields...>{ std::make_tuple(fields...) };
+}
+
+//! construct a FieldList of compact fields from data member pointers
+template <typename Class, typename... Types>
+FieldList<FieldDescriptor<Class, Types, true>...>
+MakeCompactFields(Types Class::* ... members) {
+    return FieldList<FieldDescriptor<Class, Types, true>...>{
+        std::make_tuple(CompactField(members) ...)
+    };
+}
+
+//! \addtogroup data_internal Data Internals
+//! \{
+
+namespace detail {
+
+//! read the field count written before compact items and check it.
+template <typename Archive>
+size_t GetCompactFieldCount(Archive& ar, size_t size) {
+    size_t count = ar.GetVarint();
+    if (count > size) {
+        die("Serialization: item with " << count << " fields, "
+            "but only " << size << " fields are known.");
+    }
+    return count;
+}
+
+template <typename Archive, typename T, typename List, typename Indexes>
+struct FieldListSerialization;
+
+template <typename Archive, typename T, typename... Fields, size_t... Is>
+struct FieldListSerialization<
+    Archive, T, FieldList<Fields...>, std::index_sequence<Is...> >{
+
+    using List = FieldList<Fields...>;
+
+    static void Serialize(const List& list, const T& x, Archive& ar) {
+        if (List::compact) ar.PutVarint(List::size);
+        (void)std::initializer_list<int>{
+            (FieldEncoding<typename Fields::ValueType, Fields::compact>
+             ::Serialize(x.*(std::get<Is>(list.fields).member), ar), 0) ...
+        };
+    }
+
+    static T Deserialize(const List& list, Archive& ar) {
+        size_t count = List::compact
+                       ? GetCompactFieldCount(ar, List::size) : List::size;
+        T out = T();
+        (void)std::initializer_list<int>{
+            (Is < count
+             ? (void)(out.*(std::get<Is>(list.fields).member) =
+                          FieldEncoding<typename Fields::ValueType,
+                                        Fields::compact>::Deserialize(ar))
+             : (void)0, 0) ...
+        };
+        return out;
+    }
+
+    static constexpr bool   is_fixed_size =
+        !List::compact && AllOf<
+            Serialization<Archive, typename Fields::ValueType>
+            ::is_fixed_size...>::value;
+
+    static constexpr size_t fixed_size =
+        !is_fixed_size ? 0 : SumOf<
+            Serialization<Archive, typename Fields::ValueType>
+            ::fixed_size...>::value;
+};
+
+template <typename Archive, typename Tuple, typename Indexes>
+struct CompactTupleSerialization;
+
+template <typename Archive, typename... Args, size_t... Is>
+struct CompactTupleSerialization<
+    Archive, std::tuple<Args...>, std::index_sequence<Is...> >{
+
+    static void Serialize(const std::tuple<Args...>& x, Archive& ar) {
+        ar.PutVarint(sizeof ... (Args));
+        (void)std::initializer_list<int>{
+            (FieldEncoding<Args, true>::Serialize(std::get<Is>(x), ar), 0) ...
+        };
+    }
+
+    static std::tuple<Args...> Deserialize(Archive& ar) {
+        size_t count = GetCompactFieldCount(ar, sizeof ... (Args));
+        std::tuple<Args...> out;
+        (void)std::initializer_list<int>{
+            (Is < count
+             ? (void)(std::get<Is>(out) =
+                          FieldEncoding<Args, true>::Deserialize(ar))
+             : (void)0, 0) ...
+        };
+        return out;
+    }
+};
+
+} // namespace detail
+
+//! \}
+
+//! Serialization of classes declaring their fields via thrill_fields().
+template <typename Archive, typename T>
+struct Serialization<Archive, T,
+                     typename std::enable_if<
+                         has_member_thrill_fields<T>::value
+                         >::type
+                     > {
+    using List = decltype(T::thrill_fields());
+    using Impl = detail::FieldListSerialization<
+              Archive, T, List, std::make_index_sequence<List::size> >;
+
+    static void Serialize(const T& x, Archive& ar) {
+        Impl::Serialize(T::thrill_fields(), x, ar);
+    }
+    static T Deserialize(Archive& ar) {
+        return Impl::Deserialize(T::thrill_fields(), ar);
+    }
+    static constexpr bool   is_fixed_size = Impl::is_fixed_size;
+    static constexpr size_t fixed_size = Impl::fixed_size;
+};
+
+//! Serialization of tuples opted in via is_compact_tuple.
+template <typename Archive, typename... Args>
+struct Serialization<Archive, std::tuple<Args...>,
+                     typename std::enable_if<
+                         is_compact_tuple<std::tuple<Args...> >::value
+                         >::type> {
+    using Impl = detail::CompactTupleSerialization<
+              Archive, std::tuple<Args...>,
+              std::index_sequence_for<Args...> >;
+
+    static void Serialize(const std::tuple<Args...>& x, Archive& ar) {
+        Impl::Serialize(x, ar);
+    }
+    static std::tuple<Args...> Deserialize(Archive& ar) {
+        return Impl::Deserialize(ar);
+    }
+    static constexpr bool   is_fixed_size = false;
+    static constexpr size_t fixed_size = 0;
+};
+
 //! \}
 
 } // namespace data
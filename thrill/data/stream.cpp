@@ -79,6 +79,10 @@ size_t Stream::rx_net_blocks() const {
     return data().rx_net_blocks_;
 }
 
+size_t Stream::tx_net_deferred() const {
+    return data().tx_net_deferred_;
+}
+
 /*----------------------------------------------------------------------------*/
 
 size_t Stream::tx_int_items() const {
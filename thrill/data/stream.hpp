@@ -57,6 +57,12 @@ public:
     //! once, otherwise the block sequence is incorrectly interleaved!
     virtual Writers GetWriters() = 0;
 
+    //! change the policy for the Block sizes of the Writers, must be called
+    //! before GetWriters().
+    void set_block_size_policy(const BlockSizePolicy& policy) {
+        data().set_block_size_policy(policy);
+    }
+
     /*!
      * Scatters a File to many worker: elements from [offset[0],offset[1]) are
      * sent to the first worker, elements from [offset[1], offset[2]) are sent
@@ -169,6 +175,9 @@ public:
     //! return number of blocks received via network excluding internal tx
     size_t rx_net_blocks() const;
 
+    //! return number of blocks held back for lack of credit from the receiver
+    size_t tx_net_deferred() const;
+
     /*------------------------------------------------------------------------*/
 
     //! return number of items transmitted via internal loopback queues
@@ -13,10 +13,56 @@
 
 #include <thrill/data/cat_stream.hpp>
 #include <thrill/data/mix_stream.hpp>
+#include <thrill/data/multiplexer_header.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
 
 namespace thrill {
 namespace data {
 
+/******************************************************************************/
+// StreamData::TxCredit
+
+//! credits granted by GrantUnlimitedCredit(), effectively disables the flow
+//! control for the remaining Blocks.
+static const uint32_t unlimited_credits = 0xFFFFFFFF;
+
+/*!
+ * Send state of a StreamData towards one target worker: the number of Blocks
+ * the receiver can still accept, and the Blocks held back until it grants more.
+ */
+struct StreamData::TxCredit {
+    //! a Block held back for lack of credit
+    struct Deferred {
+        uint32_t      seq;
+        net::Buffer   header;
+        Block         block;
+        //! the Block pinned again by the pin thread once credit arrived
+        PinnedBlock   pinned;
+    };
+
+    //! protects all fields: SendBlock() is called by the worker thread,
+    //! OnCredit() by the dispatcher threads, and PumpDeferred() also by the pin
+    //! thread.
+    std::mutex mutex;
+
+    //! number of Blocks which can be sent without waiting
+    size_t credits = 0;
+
+    //! Blocks held back, in the order they were written
+    std::deque<Deferred> deferred;
+
+    //! whether the pin thread is pinning the first deferred Block
+    bool pinning = false;
+
+    //! signaled when deferred becomes empty
+    std::condition_variable cv;
+};
+
 /******************************************************************************/
 // StreamData
 
@@ -27,8 +73,12 @@ StreamData::StreamData(Multiplexer& multiplexer, size_t send_size_limit,
       id_(id),
       local_worker_id_(local_worker_id),
       dia_id_(dia_id),
-      multiplexer_(multiplexer)
-{ }
+      multiplexer_(multiplexer),
+      tx_credit_(new TxCredit[multiplexer.num_workers()]),
+      rx_consumed_(multiplexer.num_workers(), 0) {
+    for (size_t w = 0; w < multiplexer.num_workers(); ++w)
+        tx_credit_[w].credits = multiplexer.stream_credits_;
+}
 
 StreamData::~StreamData() = default;
 
@@ -53,7 +103,153 @@ void StreamData::OnAllClosed(const char* stream_type) {
         << "rx_int_blocks" << rx_int_blocks_
         << "tx_int_items" << tx_int_items_
         << "tx_int_bytes" << tx_int_bytes_
-        << "tx_int_blocks" << tx_int_blocks_;
+        << "tx_int_blocks" << tx_int_blocks_
+        << "tx_net_deferred" << tx_net_deferred_
+        << "rx_net_credits" << rx_net_credits_;
+}
+
+/******************************************************************************/
+// StreamData Credit-based Flow Control
+
+void StreamData::SendBlock(size_t peer_worker, uint32_t seq,
+                           net::Buffer&& header, PinnedBlock&& block) {
+    TxCredit& c = tx_credit_[peer_worker];
+    {
+        std::unique_lock<std::mutex> lock(c.mutex);
+        if (c.credits == 0 || !c.deferred.empty()) {
+            // the receiver has not consumed enough Blocks: keep the Block
+            // unpinned, such that the BlockPool may swap it out here instead
+            // of at the receiver.
+            c.deferred.emplace_back(TxCredit::Deferred {
+                                        seq, std::move(header),
+                                        std::move(block).MoveToBlock(),
+                                        PinnedBlock()
+                                    });
+            ++tx_net_deferred_;
+            return;
+        }
+        --c.credits;
+    }
+
+    size_t send_size = header.size() + block.size();
+    sem_queue_.wait(send_size);
+
+    IntSendBlock(peer_worker, seq, std::move(header), std::move(block),
+                 send_size);
+}
+
+void StreamData::OnCredit(size_t peer_worker, size_t credits) {
+    assert(peer_worker < num_workers());
+    TxCredit& c = tx_credit_[peer_worker];
+    std::unique_lock<std::mutex> lock(c.mutex);
+
+    // saturating add, unlimited credits must not wrap around.
+    c.credits = std::min(c.credits, std::numeric_limits<size_t>::max() - credits)
+                + credits;
+
+    PumpDeferred(peer_worker, c);
+}
+
+void StreamData::PumpDeferred(size_t peer_worker, TxCredit& c) {
+    while (c.credits != 0 && !c.deferred.empty())
+    {
+        TxCredit::Deferred& d = c.deferred.front();
+        if (!d.pinned.IsValid()) {
+            // PinBlock() may wait for memory or for the Block to be read from
+            // disk, hence pin it in the pin thread, without holding the mutex,
+            // and continue from there.
+            if (!c.pinning) {
+                c.pinning = true;
+                multiplexer_.RunInPinThread(
+                    [s = StreamDataPtr(this), peer_worker, block = d.block]() {
+                        PinnedBlock pinned = block.PinWait(s->local_worker_id_);
+
+                        TxCredit& c = s->tx_credit_[peer_worker];
+                        std::unique_lock<std::mutex> lock(c.mutex);
+                        // only PumpDeferred() removes the first Block, and not
+                        // before it is pinned.
+                        c.deferred.front().pinned = std::move(pinned);
+                        c.pinning = false;
+                        s->PumpDeferred(peer_worker, c);
+                    });
+            }
+            return;
+        }
+
+        // deferred Blocks are already bounded by the credits, hence they are
+        // not counted in sem_queue_.
+        IntSendBlock(peer_worker, d.seq, std::move(d.header),
+                     std::move(d.pinned), /* send_size */ 0);
+        c.deferred.pop_front();
+        --c.credits;
+    }
+
+    if (c.deferred.empty())
+        c.cv.notify_all();
+}
+
+void StreamData::IntSendBlock(
+    size_t peer_worker, uint32_t seq, net::Buffer&& header,
+    PinnedBlock&& block, size_t send_size) {
+
+    size_t peer = peer_worker / workers_per_host();
+    size_t stripe = multiplexer_.StripeOf(id_, local_worker_id_, seq);
+    net::Connection& connection = multiplexer_.groups_[stripe]->connection(peer);
+
+    multiplexer_.dispatcher(stripe, peer).AsyncWrite(
+        connection, 42 + (connection.tx_seq_.fetch_add(2) & 0xFFFF),
+        // send out Buffer and Block, guaranteed to be successive
+        std::move(header), std::move(block),
+        [s = StreamDataPtr(this), send_size](net::Connection&) {
+            s->sem_queue_.signal(send_size);
+        });
+}
+
+void StreamData::SendCredit(size_t peer_worker, size_t credits) {
+    StreamMultiplexerHeader header;
+    header.magic = credit_magic();
+    header.stream_id = id_;
+    header.sender_worker = my_worker_rank();
+    header.receiver_local_worker = peer_worker % workers_per_host();
+    header.num_items = static_cast<uint32_t>(credits);
+
+    net::BufferBuilder bb;
+    header.Serialize(bb);
+
+    ++rx_net_credits_;
+
+    size_t peer = peer_worker / workers_per_host();
+    size_t stripe = multiplexer_.StripeOf(id_, local_worker_id_, 0);
+    net::Connection& connection = multiplexer_.groups_[stripe]->connection(peer);
+
+    multiplexer_.dispatcher(stripe, peer).AsyncWrite(
+        connection, 42 + (connection.tx_seq_.fetch_add(2) & 0xFFFF),
+        bb.ToBuffer());
+}
+
+void StreamData::OnBlockConsumed(size_t from) {
+    if (from / workers_per_host() == my_host_rank()) return;
+
+    // grant credits in batches of half the window to save messages, the
+    // sender can always send the other half meanwhile.
+    size_t batch = (multiplexer_.stream_credits_ + 1) / 2;
+    if (++rx_consumed_[from] < batch) return;
+
+    SendCredit(from, rx_consumed_[from]);
+    rx_consumed_[from] = 0;
+}
+
+void StreamData::GrantUnlimitedCredit(size_t from) {
+    if (from / workers_per_host() == my_host_rank()) return;
+    SendCredit(from, unlimited_credits);
+}
+
+void StreamData::WaitDeferred() {
+    for (size_t w = 0; w < num_workers(); ++w) {
+        TxCredit& c = tx_credit_[w];
+        std::unique_lock<std::mutex> lock(c.mutex);
+        c.cv.wait(lock, [&c]() { return c.deferred.empty(); });
+    }
 }
 
 /******************************************************************************/
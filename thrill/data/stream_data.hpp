@@ -18,8 +18,10 @@
 #include <thrill/data/block_writer.hpp>
 #include <thrill/data/file.hpp>
 #include <thrill/data/multiplexer.hpp>
+#include <thrill/net/buffer.hpp>
 #include <tlx/semaphore.hpp>
 
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -32,7 +34,8 @@ namespace data {
 using StreamId = size_t;
 
 enum class MagicByte : uint8_t {
-    Invalid, CatStreamBlock, MixStreamBlock, PartitionBlock
+    Invalid, CatStreamBlock, MixStreamBlock, PartitionBlock,
+    CatStreamCredit, MixStreamCredit
 };
 
 class StreamSink;
@@ -105,12 +108,43 @@ public:
     //! shuts the stream down.
     virtual void Close() = 0;
 
+    //! MagicByte of credit messages for this type of stream
+    virtual MagicByte credit_magic() const = 0;
+
     virtual bool closed() const = 0;
 
     //! Creates BlockWriters for each worker. BlockWriter can only be opened
     //! once, otherwise the block sequence is incorrectly interleaved!
     virtual Writers GetWriters() = 0;
 
+    //! policy for the Block sizes of the Writers, capped by GetWriters()
+    //! depending on the available memory.
+    const BlockSizePolicy& block_size_policy() const {
+        return block_size_policy_;
+    }
+
+    //! change the policy for the Block sizes, must be called before
+    //! GetWriters().
+    void set_block_size_policy(const BlockSizePolicy& policy) {
+        block_size_policy_ = policy;
+    }
+
+    //! \name Credit-based Flow Control
+    //! \{
+
+    //! Send a Block with its serialized StreamMultiplexerHeader to a worker on
+    //! another host if the receiver granted credit for it. Otherwise the Block
+    //! is kept unpinned, such that the BlockPool may swap it out locally, until
+    //! the receiver consumed earlier Blocks.
+    void SendBlock(size_t peer_worker, uint32_t seq,
+                   net::Buffer&& header, PinnedBlock&& block);
+
+    //! Called by the Multiplexer when a receiver grants credits for further
+    //! Blocks, sends out deferred Blocks.
+    void OnCredit(size_t peer_worker, size_t credits);
+
+    //! \}
+
     ///////// expose these members - getters would be too java-ish /////////////
 
     //! StatsCounter for incoming data transfer.  Does not include loopback data
@@ -133,6 +167,10 @@ public:
     std::atomic<size_t>
     tx_int_items_ { 0 }, tx_int_bytes_ { 0 }, tx_int_blocks_ { 0 };
 
+    //! StatsCounter for outgoing Blocks which were held back for lack of
+    //! credit, and for credit messages sent back for incoming Blocks.
+    std::atomic<size_t> tx_net_deferred_ { 0 }, rx_net_credits_ { 0 };
+
     //! Timers from creation of stream until rx / tx direction is closed.
     common::StatsTimerStart tx_lifetime_, rx_lifetime_;
 
@@ -157,6 +195,9 @@ protected:
     //! reference to multiplexer
     Multiplexer& multiplexer_;
 
+    //! policy for the Block sizes of the Writers
+    BlockSizePolicy block_size_policy_;
+
     //! number of remaining expected stream closing operations. Required to know
     //! when to stop rx_lifetime
     std::atomic<size_t> remaining_closing_blocks_;
@@ -164,6 +205,43 @@ protected:
     //! number of received stream closing Blocks.
     tlx::Semaphore sem_closing_blocks_;
 
+    //! Called by the BlockQueues when the reader consumed a Block received
+    //! from the worker from, grants new credits to it in batches.
+    void OnBlockConsumed(size_t from);
+
+    //! Grant unlimited credit to a remote sender, called on Close() for
+    //! senders whose Blocks were not all received, since they are not read
+    //! anymore but must still arrive.
+    void GrantUnlimitedCredit(size_t from);
+
+    //! Wait until all Blocks held back for lack of credit were sent, called on
+    //! Close() before the Stream is released.
+    void WaitDeferred();
+
+private:
+    //! send state of the credits for one target worker, see stream_data.cpp
+    struct TxCredit;
+
+    //! send state for each target worker, unused for local workers
+    std::unique_ptr<TxCredit[]> tx_credit_;
+
+    //! number of consumed Blocks of each source worker not yet granted back,
+    //! only accessed by the reader's thread.
+    std::vector<size_t> rx_consumed_;
+
+    //! send credit message to a remote sender
+    void SendCredit(size_t peer_worker, size_t credits);
+
+    //! send deferred Blocks to peer_worker while credit is available, must
+    //! hold TxCredit's mutex. Unpinned Blocks are pinned in the Multiplexer's
+    //! pin thread, which calls it again.
+    void PumpDeferred(size_t peer_worker, TxCredit& c);
+
+    //! pass header and Block to the network, signal the sem_queue_ with
+    //! send_size when done.
+    void IntSendBlock(size_t peer_worker, uint32_t seq, net::Buffer&& header,
+                      PinnedBlock&& block, size_t send_size);
+
     //! friends for access to multiplexer_
     friend class StreamSink;
 };
@@ -180,6 +258,9 @@ public:
 
     //! Close all streams in the set.
     virtual void Close() = 0;
+
+    //! Returns the stream of the local worker, or nullptr if it was released.
+    virtual StreamDataPtr GetStreamData(size_t local_worker_id) = 0;
 };
 
 /*!
@@ -228,6 +309,11 @@ public:
             c->Close();
     }
 
+    data::StreamDataPtr GetStreamData(size_t local_worker_id) final {
+        assert(local_worker_id < streams_.size());
+        return data::StreamDataPtr(streams_[local_worker_id].get());
+    }
+
 private:
     //! 'owns' all streams belonging to one stream id for all local workers.
     std::vector<StreamDataPtr> streams_;
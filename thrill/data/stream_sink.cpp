@@ -24,13 +24,11 @@ StreamSink::StreamSink()
     : BlockSink(nullptr, -1), closed_(true) { }
 
 StreamSink::StreamSink(StreamDataPtr stream, BlockPool& block_pool,
-                       net::Connection* connection,
                        MagicByte magic, StreamId stream_id,
                        size_t host_rank, size_t host_local_worker,
                        size_t peer_rank, size_t peer_local_worker)
     : BlockSink(block_pool, host_local_worker),
       stream_(std::move(stream)),
-      connection_(connection),
       magic_(magic),
       id_(stream_id),
       host_rank_(host_rank),
@@ -157,22 +155,16 @@ void StreamSink::AppendPinnedBlock(PinnedBlock&& block, bool is_last_block) {
     net::Buffer buffer = bb.ToBuffer();
     assert(buffer.size() == MultiplexerHeader::total_size);
 
-    size_t send_size = buffer.size() + block.size();
-    stream_->sem_queue_.wait(send_size);
-
     // StreamData statistics for network transfer
     stream_->tx_net_items_ += block.num_items();
-    stream_->tx_net_bytes_ += send_size;
+    stream_->tx_net_bytes_ += buffer.size() + block.size();
     stream_->tx_net_blocks_++;
     byte_counter_ += buffer.size();
 
-    stream_->multiplexer_.dispatcher_.AsyncWrite(
-        *connection_, 42 + (connection_->tx_seq_.fetch_add(2) & 0xFFFF),
-        // send out Buffer and Block, guaranteed to be successive
-        std::move(buffer), std::move(block),
-        [s = stream_, send_size](net::Connection&) {
-            s->sem_queue_.signal(send_size);
-        });
+    // send out Buffer and Block, or hold them back until the receiver grants
+    // credit.
+    stream_->SendBlock(peer_worker_rank(), header.seq,
+                       std::move(buffer), std::move(block));
 
     if (is_last_block) {
         assert(!closed_);
@@ -233,8 +225,13 @@ void StreamSink::Close() {
     stream_->tx_net_blocks_++;
     byte_counter_ += buffer.size();
 
-    stream_->multiplexer_.dispatcher_.AsyncWrite(
-        *connection_, 42 + (connection_->tx_seq_.fetch_add(2) & 0xFFFF),
+    Multiplexer& multiplexer = stream_->multiplexer_;
+    size_t stripe = multiplexer.StripeOf(id_, local_worker_id_, header.seq);
+    net::Connection& connection =
+        multiplexer.groups_[stripe]->connection(peer_rank_);
+
+    multiplexer.dispatcher(stripe, peer_rank_).AsyncWrite(
+        connection, 42 + (connection.tx_seq_.fetch_add(2) & 0xFFFF),
         std::move(buffer),
         [s = stream_](net::Connection&) {
             s->sem_queue_.signal(MultiplexerHeader::total_size);
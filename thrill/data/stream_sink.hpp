@@ -46,9 +46,9 @@ public:
     //! where Blocks are directly sent to local workers.
     StreamSink();
 
-    //! StreamSink sending out to network.
+    //! StreamSink sending out to network, the Blocks are striped across the
+    //! Multiplexer's connections to the peer host.
     StreamSink(StreamDataPtr stream, BlockPool& block_pool,
-               net::Connection* connection,
                MagicByte magic, StreamId stream_id,
                size_t host_rank, size_t host_local_worker,
                size_t peer_rank, size_t peer_local_worker);
@@ -108,7 +108,6 @@ private:
     //! \name StreamSink To Network
     //! \{
 
-    net::Connection* connection_ = nullptr;
     MagicByte magic_ = MagicByte::Invalid;
 
     //! \}
@@ -0,0 +1,274 @@
+/*******************************************************************************
+ * thrill/mem/huge_page_arena.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/common/logger.hpp>
+#include <thrill/mem/huge_page_arena.hpp>
+
+#include <tlx/die.hpp>
+
+#if __linux__
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace thrill {
+namespace mem {
+
+//! size of the default (2 MiB) huge pages, used to align regions
+static constexpr size_t kHugePageSize = 2 * 1024 * 1024llu;
+
+//! size of gigantic (1 GiB) huge pages
+static constexpr size_t kGiganticPageSize = 1024 * 1024 * 1024llu;
+
+HugePageArena::HugePageArena(
+    size_t slot_size, size_t region_size, size_t max_regions)
+    : slot_size_(slot_size) {
+
+    die_unless(slot_size_ > 0);
+
+    // round region size up to a multiple of the slot size
+    region_size_ = std::max(region_size, slot_size_);
+    region_size_ = (region_size_ + slot_size_ - 1) / slot_size_ * slot_size_;
+    slots_per_region_ = region_size_ / slot_size_;
+
+    // slot indexes must fit into the 32-bit fields of the free list.
+    max_regions = std::min(
+        max_regions,
+        (std::numeric_limits<uint32_t>::max() - 1) / slots_per_region_);
+    die_unless(max_regions > 0);
+
+    regions_.resize(max_regions);
+}
+
+HugePageArena::~HugePageArena() {
+    if (used_slots_ != 0) {
+        LOG1 << "~HugePageArena() still contains " << used_slots_
+             << " allocated slots";
+    }
+
+    for (size_t r = 0; r < num_regions_; ++r) {
+        Region& region = regions_[r];
+#if __linux__
+        munmap(region.map_addr, region.map_size);
+#endif
+        delete[] region.next;
+    }
+}
+
+bool HugePageArena::MapRegion() {
+#if __linux__
+    size_t r = num_regions_.load();
+    if (r >= regions_.size())
+        return false;
+
+    Region& region = regions_[r];
+
+    // first try explicit huge pages, which must be preallocated by the admin.
+    // MAP_HUGETLB mappings are always aligned to the huge page size. They must
+    // not be mapped with MAP_NORESERVE, since then a page fault without free
+    // huge pages raises SIGBUS instead of mmap() failing.
+    static constexpr int base_flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    void* addr = MAP_FAILED;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    if (region_size_ % kGiganticPageSize == 0) {
+        addr = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE,
+                    base_flags | MAP_HUGETLB | (30 << MAP_HUGE_SHIFT), -1, 0);
+    }
+#endif
+#if defined(MAP_HUGETLB)
+    if (addr == MAP_FAILED && region_size_ % kHugePageSize == 0) {
+        addr = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE,
+                    base_flags | MAP_HUGETLB, -1, 0);
+    }
+#endif
+
+    if (addr != MAP_FAILED) {
+        region.map_addr = addr;
+        region.map_size = region_size_;
+        region.base = static_cast<uint8_t*>(addr);
+        region.hugetlb = true;
+        ++hugetlb_regions_;
+        // explicit huge pages are committed when mapped
+        resident_bytes_ += region_size_;
+    }
+    else {
+        // fallback: map normal pages with extra space to align the region to
+        // huge page boundaries, and advise the kernel to use transparent huge
+        // pages.
+        size_t map_size = region_size_ + kHugePageSize;
+        addr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE,
+                    base_flags | MAP_NORESERVE, -1, 0);
+        if (addr == MAP_FAILED) {
+            LOG1 << "HugePageArena: mmap() of " << map_size
+                 << " bytes failed, falling back to allocator.";
+            return false;
+        }
+
+        uintptr_t uaddr = reinterpret_cast<uintptr_t>(addr);
+        uintptr_t ubase = (uaddr + kHugePageSize - 1) & ~(kHugePageSize - 1);
+
+        region.map_addr = addr;
+        region.map_size = map_size;
+        region.base = reinterpret_cast<uint8_t*>(ubase);
+        region.hugetlb = false;
+
+#if defined(MADV_HUGEPAGE)
+        madvise(region.base, region_size_, MADV_HUGEPAGE);
+#endif
+    }
+
+    region.next = new std::atomic<uint32_t>[slots_per_region_];
+
+    LOG << "HugePageArena: mapped region " << r
+        << " at " << static_cast<void*>(region.base)
+        << " size " << region_size_
+        << " hugetlb " << region.hugetlb;
+
+    // publish the region to lock-free readers
+    num_regions_.store(r + 1, std::memory_order_release);
+    return true;
+#else
+    // no mmap() support: the caller falls back to the aligned allocator.
+    return false;
+#endif
+}
+
+size_t HugePageArena::PopFree(std::atomic<uint64_t>& head) {
+    uint64_t h = head.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(h) != 0) {
+        size_t index = static_cast<uint32_t>(h) - 1;
+        uint32_t next = slot_next(index).load(std::memory_order_relaxed);
+        uint64_t new_head = (((h >> 32) + 1) << 32) | next;
+        if (head.compare_exchange_weak(
+                h, new_head,
+                std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return index + 1;
+        }
+    }
+    return 0;
+}
+
+void HugePageArena::PushFree(std::atomic<uint64_t>& head, size_t index) {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    uint64_t new_head;
+    do {
+        slot_next(index).store(
+            static_cast<uint32_t>(h), std::memory_order_relaxed);
+        new_head = (((h >> 32) + 1) << 32) | (index + 1);
+    } while (!head.compare_exchange_weak(
+                 h, new_head,
+                 std::memory_order_release, std::memory_order_relaxed));
+}
+
+void* HugePageArena::allocate() {
+    // first try to reuse a resident free slot, then a released one.
+    if (size_t index = PopFree(free_head_)) {
+        ++used_slots_;
+        return slot_ptr(index - 1);
+    }
+    if (size_t index = PopFree(released_head_)) {
+        resident_bytes_ += slot_size_;
+        ++used_slots_;
+        return slot_ptr(index - 1);
+    }
+
+    // mapping failed before, fall back permanently without taking the mutex.
+    if (exhausted_.load(std::memory_order_relaxed))
+        return nullptr;
+
+    // else carve a fresh slot, mapping a new region if needed.
+    size_t index = fresh_slots_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= num_regions_.load(std::memory_order_acquire) * slots_per_region_)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (index >= num_regions_.load() * slots_per_region_) {
+            if (exhausted_ || !MapRegion()) {
+                exhausted_ = true;
+                // give back the slot counter, such that the arena stays
+                // consistent. The index may be lost if other threads raced
+                // ahead, which only leaks address space.
+                size_t expected = index + 1;
+                fresh_slots_.compare_exchange_strong(expected, index);
+                return nullptr;
+            }
+        }
+    }
+
+    // slots of normal page regions are committed when first touched
+    if (!slot_hugetlb(index))
+        resident_bytes_ += slot_size_;
+    ++used_slots_;
+    return slot_ptr(index);
+}
+
+size_t HugePageArena::slot_index(const void* ptr) const {
+    const uint8_t* p = static_cast<const uint8_t*>(ptr);
+    size_t num_regions = num_regions_.load(std::memory_order_acquire);
+    for (size_t r = 0; r < num_regions; ++r) {
+        const Region& region = regions_[r];
+        if (p >= region.base && p < region.base + region_size_) {
+            size_t offset = static_cast<size_t>(p - region.base);
+            die_unless(offset % slot_size_ == 0);
+            return r * slots_per_region_ + offset / slot_size_;
+        }
+    }
+    return size_t(-1);
+}
+
+bool HugePageArena::contains(const void* ptr) const {
+    return slot_index(ptr) != size_t(-1);
+}
+
+void HugePageArena::deallocate(void* ptr) {
+    size_t index = slot_index(ptr);
+    die_unless(index != size_t(-1));
+
+    PushFree(free_head_, index);
+    --used_slots_;
+}
+
+size_t HugePageArena::Trim() {
+#if __linux__ && defined(MADV_DONTNEED)
+    // slots in explicit huge page regions can only be released in whole pages
+    bool hugetlb_release = slot_size_ % kHugePageSize == 0;
+
+    size_t released = 0;
+    std::vector<size_t> kept;
+    while (size_t index = PopFree(free_head_)) {
+        --index;
+        if ((!slot_hugetlb(index) || hugetlb_release) &&
+            madvise(slot_ptr(index), slot_size_, MADV_DONTNEED) == 0) {
+            resident_bytes_ -= slot_size_;
+            released += slot_size_;
+            PushFree(released_head_, index);
+        }
+        else {
+            kept.push_back(index);
+        }
+    }
+    for (size_t index : kept)
+        PushFree(free_head_, index);
+    // the remaining idle bytes, e.g. uncarved parts of hugetlb regions
+    unreleasable_bytes_ = idle_bytes();
+
+    LOG << "HugePageArena: trimmed " << released << " bytes of slot size "
+        << slot_size_;
+    return released;
+#else
+    return 0;
+#endif
+}
+
+} // namespace mem
+} // namespace thrill
+
+/******************************************************************************/
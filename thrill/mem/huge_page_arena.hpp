@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * thrill/mem/huge_page_arena.hpp
+ *
+ * An arena of large memory regions, preferably backed by huge pages, from which
+ * equally sized slots are carved using a lock-free free list.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_MEM_HUGE_PAGE_ARENA_HEADER
+#define THRILL_MEM_HUGE_PAGE_ARENA_HEADER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace thrill {
+namespace mem {
+
+/*!
+ * An arena allocator for equally sized slots, used by the BlockPool to allocate
+ * the memory of ByteBlocks of a fixed size.
+ *
+ * The arena reserves large Regions of virtual memory using mmap(). Each Region
+ * is first tried with explicit huge pages (MAP_HUGETLB, 1 GiB pages if the
+ * Region size allows it, then the default 2 MiB pages). If no explicit huge
+ * pages are available, the Region is mapped with normal pages and marked
+ * MADV_HUGEPAGE for transparent huge pages. Such Regions use MAP_NORESERVE,
+ * hence physical memory is only committed when touched.
+ *
+ * Slots are carved from the Regions in two ways: previously freed slots are
+ * reused via a lock-free Treiber stack of slot indexes with an ABA tag, and
+ * fresh slots are taken by atomically incrementing a bump counter. Only
+ * mapping a new Region takes a mutex.
+ *
+ * Freed slots stay resident in RAM and are reused first by later allocations.
+ * Trim() hands the memory of all free slots back to the operating system with
+ * MADV_DONTNEED; such released slots are reused after the resident ones. The
+ * physical memory held by the arena is reported by resident_bytes(), which
+ * counts explicit huge page Regions in full, since they are committed when
+ * mapped, and idle_bytes() is the part of it not used by allocated slots.
+ *
+ * The arena never maps more than max_regions Regions. Afterwards, or once
+ * mapping a Region failed, allocate() returns nullptr without further attempts
+ * if no free slot is left, and the caller must fall back to another allocator.
+ */
+class HugePageArena
+{
+    static constexpr bool debug = false;
+
+public:
+    //! default size of the reserved regions
+    static constexpr size_t default_region_size = 256 * 1024 * 1024llu;
+
+    /*!
+     * Construct an arena delivering slots of slot_size bytes.
+     *
+     * \param slot_size size of each slot, must be a multiple of the page size.
+     *
+     * \param region_size size of the virtual memory regions reserved at once,
+     * rounded up to a multiple of slot_size.
+     *
+     * \param max_regions maximum number of regions to map.
+     */
+    explicit HugePageArena(size_t slot_size,
+                           size_t region_size = default_region_size,
+                           size_t max_regions = 1024);
+
+    //! non-copyable: delete copy-constructor
+    HugePageArena(const HugePageArena&) = delete;
+    //! non-copyable: delete assignment operator
+    HugePageArena& operator = (const HugePageArena&) = delete;
+
+    //! unmap all regions, all slots must have been deallocated.
+    ~HugePageArena();
+
+    //! allocate a slot of slot_size() bytes. Returns nullptr if no more
+    //! regions can be mapped.
+    void * allocate();
+
+    //! return a slot previously delivered by allocate().
+    void deallocate(void* ptr);
+
+    //! release the memory of all free slots to the operating system. Returns
+    //! the number of bytes released.
+    size_t Trim();
+
+    //! check whether ptr points into a region of this arena.
+    bool contains(const void* ptr) const;
+
+    //! size of the slots delivered
+    size_t slot_size() const { return slot_size_; }
+
+    //! size of the reserved regions
+    size_t region_size() const { return region_size_; }
+
+    //! number of regions currently mapped
+    size_t num_regions() const { return num_regions_.load(); }
+
+    //! number of regions backed by explicit (hugetlbfs) huge pages
+    size_t hugetlb_regions() const { return hugetlb_regions_.load(); }
+
+    //! total number of bytes of virtual memory reserved
+    size_t reserved_bytes() const { return num_regions() * region_size_; }
+
+    //! number of slots currently allocated
+    size_t used_slots() const { return used_slots_.load(); }
+
+    //! number of bytes of physical memory committed by the arena
+    size_t resident_bytes() const { return resident_bytes_.load(); }
+
+    //! number of resident bytes not used by allocated slots
+    size_t idle_bytes() const {
+        size_t resident = resident_bytes(), used = used_slots() * slot_size_;
+        return resident > used ? resident - used : 0;
+    }
+
+    //! idle bytes which Trim() can release, excluding those it could not
+    //! release last time.
+    size_t releasable_bytes() const {
+        size_t idle = idle_bytes(), kept = unreleasable_bytes_.load();
+        return idle > kept ? idle - kept : 0;
+    }
+
+    //! whether a resident free slot is available, such that allocate() does
+    //! not commit new memory.
+    bool has_resident_free() const {
+        return static_cast<uint32_t>(free_head_.load()) != 0;
+    }
+
+    //! whether no more regions are mapped
+    bool exhausted() const { return exhausted_.load(); }
+
+private:
+    //! a contiguous mapped memory area subdivided into slots
+    struct Region {
+        //! beginning of slot area
+        uint8_t* base = nullptr;
+        //! beginning of the actual mapping (may be smaller than base due to
+        //! alignment)
+        void* map_addr = nullptr;
+        //! size of the actual mapping
+        size_t map_size = 0;
+        //! whether the region is backed by explicit huge pages
+        bool hugetlb = false;
+        //! next pointers of the free list for each slot, as index + 1.
+        std::atomic<uint32_t>* next = nullptr;
+    };
+
+    //! size of each slot
+    size_t slot_size_;
+
+    //! size of each region
+    size_t region_size_;
+
+    //! number of slots in each region
+    size_t slots_per_region_;
+
+    //! array of regions, only the first num_regions_ are valid.
+    std::vector<Region> regions_;
+
+    //! number of valid regions, written under mutex_, read lock-free.
+    std::atomic<size_t> num_regions_ { 0 };
+
+    //! number of regions with explicit huge pages
+    std::atomic<size_t> hugetlb_regions_ { 0 };
+
+    //! heads of the lock-free free lists of resident and of released slots:
+    //! high 32 bits ABA tag, low 32 bits slot index + 1 (zero for the empty
+    //! list).
+    std::atomic<uint64_t> free_head_ { 0 }, released_head_ { 0 };
+
+    //! counter of fresh slots carved from the regions.
+    std::atomic<size_t> fresh_slots_ { 0 };
+
+    //! number of currently allocated slots
+    std::atomic<size_t> used_slots_ { 0 };
+
+    //! bytes of physical memory committed by the arena
+    std::atomic<size_t> resident_bytes_ { 0 };
+
+    //! idle bytes which the last Trim() could not release
+    std::atomic<size_t> unreleasable_bytes_ { 0 };
+
+    //! set once mapping a region failed, no further attempts are made.
+    std::atomic<bool> exhausted_ { false };
+
+    //! mutex protecting mapping of new regions
+    std::mutex mutex_;
+
+    //! pointer to slot with given global index
+    uint8_t * slot_ptr(size_t index) const {
+        return regions_[index / slots_per_region_].base
+               + (index % slots_per_region_) * slot_size_;
+    }
+
+    //! next pointer of slot with given global index
+    std::atomic<uint32_t>& slot_next(size_t index) const {
+        return regions_[index / slots_per_region_].next[
+            index % slots_per_region_];
+    }
+
+    //! find global slot index of ptr, or size_t(-1) if not in arena.
+    size_t slot_index(const void* ptr) const;
+
+    //! whether the memory of slot index is committed with its region
+    bool slot_hugetlb(size_t index) const {
+        return regions_[index / slots_per_region_].hugetlb;
+    }
+
+    //! pop a slot from a free list, returns its index + 1 or zero if empty.
+    size_t PopFree(std::atomic<uint64_t>& head);
+
+    //! push a slot onto a free list.
+    void PushFree(std::atomic<uint64_t>& head, size_t index);
+
+    //! map a new Region, called with mutex_ held. Returns false on failure.
+    bool MapRegion();
+};
+
+} // namespace mem
+} // namespace thrill
+
+#endif // !THRILL_MEM_HUGE_PAGE_ARENA_HEADER
+
+/******************************************************************************/
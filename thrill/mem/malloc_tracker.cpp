@@ -18,16 +18,20 @@
 #include <thrill/mem/malloc_tracker.hpp>
 #include <tlx/backtrace.hpp>
 #include <tlx/define.hpp>
+#include <tlx/unused.hpp>
 
 #if __linux__ || __APPLE__ || __FreeBSD__
 
 #include <dlfcn.h>
+#include <execinfo.h>
 
 #endif
 
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -54,6 +58,26 @@
 #define ATTRIBUTE_NO_SANITIZE
 #endif
 
+#if __APPLE__
+
+#define NOEXCEPT
+#define MALLOC_USABLE_SIZE malloc_size
+#include <malloc/malloc.h>
+
+#elif __FreeBSD__
+
+#define NOEXCEPT
+#define MALLOC_USABLE_SIZE malloc_usable_size
+#include <malloc_np.h>
+
+#elif __linux__
+
+#define NOEXCEPT noexcept
+#define MALLOC_USABLE_SIZE malloc_usable_size
+#include <malloc.h>
+
+#endif
+
 namespace thrill {
 namespace mem {
 
@@ -294,6 +318,310 @@ void set_memory_limit_indication(ssize_t size) {
     memory_limit_indication = size;
 }
 
+/******************************************************************************/
+// Sampling mode: track only allocations hit by a Poisson process over the
+// allocated bytes, similar to tcmalloc's heap profiler.
+//
+// Each thread counts down a random, exponentially distributed number of bytes.
+// The allocation which crosses zero is sampled: it is stored in a lock-free
+// table of live sampled pointers with a weight estimating the number of bytes
+// it represents, and its call site is recorded. All other allocations and
+// their free() only cost a thread-local subtraction and one cache line lookup.
+// The memory counters then contain unbiased estimates, and allocation counts
+// refer to the number of samples.
+
+//! mean number of bytes between two sampled allocations, zero if every
+//! allocation is tracked. Set once at startup from THRILL_MALLOC_SAMPLE.
+static size_t sample_interval = 0;
+
+//! number of stack frames recorded for each sampled call site
+static constexpr size_t kSampleFrames = 8;
+
+//! maximum number of distinct sampled call sites
+static constexpr size_t kSampleSites = 1024;
+
+//! site index for samples whose call site could not be recorded
+static constexpr uint64_t kSampleNoSite = 0xFFFF;
+
+//! number of buckets in the table of live sampled allocations
+static constexpr size_t kSampleBuckets = 32768;
+
+//! entries per bucket, such that a bucket fills one cache line
+static constexpr size_t kSampleBucketSize = 4;
+
+struct SampleSite {
+    //! hash of the stack frames, zero for unused sites
+    uint64_t    hash;
+    //! recorded stack frames
+    void        * frames[kSampleFrames];
+    //! number of samples taken at this site
+    CounterType samples;
+    //! estimated bytes allocated at this site in total
+    CounterType total_bytes;
+    //! estimated bytes allocated at this site and not yet freed
+    CounterType live_bytes;
+};
+
+static SampleSite s_sample_sites[kSampleSites];
+static std::mutex s_sample_sites_mutex;
+
+struct alignas(64) SampleBucket {
+    struct Entry {
+        //! sampled live pointer, nullptr for an empty entry
+        void     * ptr;
+        //! site index in the high 16 bits, estimated weight in the low 48.
+        uint64_t weight_site;
+    };
+    Entry entry[kSampleBucketSize];
+};
+
+static SampleBucket s_sample_table[kSampleBuckets];
+
+//! number of samples dropped due to a full bucket
+static CounterType s_sample_dropped COUNTER_ZERO;
+
+#if HAVE_THREAD_LOCAL
+struct LocalSampler {
+    //! bytes remaining until the next sample
+    ssize_t  bytes_left;
+    //! xorshift random state, zero if not yet seeded
+    uint64_t rng;
+    //! set while taking a sample, allocations meanwhile are ignored.
+    bool     busy;
+};
+
+static thread_local LocalSampler tl_sampler = { 0, 0, false };
+#endif
+
+//! bucket of the sample table for ptr
+ATTRIBUTE_NO_SANITIZE
+static inline SampleBucket& sample_bucket(const void* ptr) {
+    uint64_t x = reinterpret_cast<uintptr_t>(ptr) >> 4;
+    x *= 0x9E3779B97F4A7C15LLU;
+    return s_sample_table[(x >> 32) % kSampleBuckets];
+}
+
+//! find or create the call site of the current stack, returns its index
+ATTRIBUTE_NO_SANITIZE
+static uint64_t sample_site() {
+#if __linux__ || __APPLE__ || __FreeBSD__
+    // skip frames of sample_site() and sample_record()
+    static constexpr int skip = 2;
+    void* frames[kSampleFrames + skip];
+    int num = backtrace(frames, kSampleFrames + skip) - skip;
+    if (num <= 0) return kSampleNoSite;
+
+    uint64_t hash = 0xCBF29CE484222325LLU;
+    for (int i = 0; i < num; ++i) {
+        hash ^= reinterpret_cast<uintptr_t>(frames[skip + i]);
+        hash *= 0x100000001B3LLU;
+    }
+    if (hash == 0) hash = 1;
+
+    std::unique_lock<std::mutex> lock(s_sample_sites_mutex);
+    for (size_t i = 0; i < kSampleSites; ++i) {
+        size_t idx = (hash + i) % kSampleSites;
+        SampleSite& site = s_sample_sites[idx];
+        if (site.hash == hash)
+            return idx;
+        if (site.hash == 0) {
+            std::fill(site.frames, site.frames + kSampleFrames, nullptr);
+            std::copy(frames + skip, frames + skip + num, site.frames);
+            site.hash = hash;
+            return idx;
+        }
+    }
+#endif
+    return kSampleNoSite;
+}
+
+//! store a sampled allocation and add its estimated weight to the counters
+ATTRIBUTE_NO_SANITIZE
+static void sample_record(void* ptr, size_t size) {
+    // unbiased estimate of the bytes represented by this sample
+    double dsize = static_cast<double>(std::max<size_t>(size, 1));
+    uint64_t weight = static_cast<uint64_t>(
+        dsize / (1.0 - std::exp(-dsize / static_cast<double>(sample_interval))));
+    weight = std::min<uint64_t>(weight, (uint64_t(1) << 48) - 1);
+
+    uint64_t site = sample_site();
+
+    SampleBucket& bucket = sample_bucket(ptr);
+    for (size_t i = 0; i < kSampleBucketSize; ++i) {
+        SampleBucket::Entry& e = bucket.entry[i];
+        if (e.ptr != nullptr ||
+            !__sync_bool_compare_and_swap(&e.ptr, nullptr, ptr))
+            continue;
+
+        e.weight_site = (site << 48) | weight;
+        inc_count(weight);
+
+        if (site != kSampleNoSite) {
+            SampleSite& s = s_sample_sites[site];
+            sync_add_and_fetch(s.samples, 1);
+            sync_add_and_fetch(s.total_bytes, weight);
+            sync_add_and_fetch(s.live_bytes, weight);
+        }
+        return;
+    }
+
+    sync_add_and_fetch(s_sample_dropped, 1);
+}
+
+//! draw the number of bytes until the next sample
+ATTRIBUTE_NO_SANITIZE
+static ssize_t sample_next_interval(uint64_t& rng) {
+    // xorshift64
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    double u = static_cast<double>(rng >> 11) * (1.0 / 9007199254740992.0);
+    return static_cast<ssize_t>(
+        -std::log(1.0 - u) * static_cast<double>(sample_interval)) + 1;
+}
+
+//! account an allocation in sampling mode
+ATTRIBUTE_NO_SANITIZE
+static inline void sample_malloc(void* ptr, size_t size) {
+#if HAVE_THREAD_LOCAL
+    LocalSampler& s = tl_sampler;
+    s.bytes_left -= static_cast<ssize_t>(size);
+    if (TLX_LIKELY(s.bytes_left > 0) || s.busy)
+        return;
+
+    s.busy = true;
+    if (s.rng == 0) {
+        // seed the thread's generator, the first countdown is not sampled.
+        s.rng = (reinterpret_cast<uintptr_t>(&s) ^ static_cast<uint64_t>(
+                     std::chrono::steady_clock::now().time_since_epoch().count()))
+                | 1;
+    }
+    else {
+        sample_record(ptr, size);
+    }
+    s.bytes_left = sample_next_interval(s.rng);
+    s.busy = false;
+#else
+    tlx::unused(ptr, size);
+#endif
+}
+
+//! account a deallocation in sampling mode
+ATTRIBUTE_NO_SANITIZE
+static inline void sample_free(void* ptr) {
+    SampleBucket& bucket = sample_bucket(ptr);
+    for (size_t i = 0; i < kSampleBucketSize; ++i) {
+        SampleBucket::Entry& e = bucket.entry[i];
+        if (e.ptr != ptr) continue;
+
+        uint64_t weight_site = e.weight_site;
+        if (!__sync_bool_compare_and_swap(&e.ptr, ptr, nullptr))
+            return;
+
+        uint64_t weight = weight_site & ((uint64_t(1) << 48) - 1);
+        uint64_t site = weight_site >> 48;
+        dec_count(weight);
+
+        if (site != kSampleNoSite)
+            sync_sub_and_fetch(s_sample_sites[site].live_bytes, weight);
+        return;
+    }
+}
+
+//! read THRILL_MALLOC_SAMPLE, called before any allocation is tracked.
+static void init_sampling() {
+    const char* env = getenv("THRILL_MALLOC_SAMPLE");
+    if (!env || !*env) return;
+
+    char* endptr;
+    unsigned long long interval = strtoull(env, &endptr, 10);
+    if (*endptr != 0) {
+        fprintf(stderr, PPREFIX "invalid THRILL_MALLOC_SAMPLE=%s, "
+                "tracking all allocations.\n", env);
+        return;
+    }
+#if !defined(MALLOC_USABLE_SIZE)
+    // the generic tracker prefixes every allocation with its size, and cannot
+    // tell sampled from unsampled allocations in free().
+    if (interval != 0) {
+        fprintf(stderr, PPREFIX "THRILL_MALLOC_SAMPLE requires "
+                "malloc_usable_size(), tracking all allocations.\n");
+    }
+#elif HAVE_THREAD_LOCAL
+    sample_interval = static_cast<size_t>(interval);
+#if __linux__ || __APPLE__ || __FreeBSD__
+    if (sample_interval != 0) {
+        // the first backtrace() loads the unwinder with dlopen(), which
+        // allocates. Do it now, while allocations are served by the init heap
+        // and not sampled, instead of within the first sampled malloc().
+        void* frames[kSampleFrames];
+        backtrace(frames, kSampleFrames);
+    }
+#endif
+#else
+    if (interval != 0) {
+        fprintf(stderr, PPREFIX "THRILL_MALLOC_SAMPLE requires thread_local, "
+                "tracking all allocations.\n");
+    }
+#endif
+}
+
+size_t malloc_tracker_sample_interval() {
+    return sample_interval;
+}
+
+ATTRIBUTE_NO_SANITIZE
+void malloc_tracker_print_sampled_sites(size_t limit) {
+    if (sample_interval == 0) return;
+
+    // copy the sites under the lock and print them afterwards, since printf()
+    // may allocate and take a sample, which locks the sites again.
+    struct PrintSite {
+        void* frames[kSampleFrames];
+        ssize_t samples, total_bytes, live_bytes;
+    };
+    static constexpr size_t kPrintSites = 64;
+    PrintSite sites[kPrintSites];
+    size_t num = 0, num_print;
+    {
+        std::unique_lock<std::mutex> lock(s_sample_sites_mutex);
+
+        // sort site indexes by live bytes, without allocating memory.
+        uint16_t order[kSampleSites];
+        for (size_t i = 0; i < kSampleSites; ++i) {
+            if (s_sample_sites[i].hash != 0)
+                order[num++] = static_cast<uint16_t>(i);
+        }
+        std::sort(order, order + num,
+                  [](uint16_t a, uint16_t b) {
+                      return get(s_sample_sites[a].live_bytes) >
+                      get(s_sample_sites[b].live_bytes);
+                  });
+
+        num_print = std::min(std::min(num, limit), kPrintSites);
+        for (size_t i = 0; i < num_print; ++i) {
+            const SampleSite& site = s_sample_sites[order[i]];
+            std::copy(site.frames, site.frames + kSampleFrames,
+                      sites[i].frames);
+            sites[i].samples = get(site.samples);
+            sites[i].total_bytes = get(site.total_bytes);
+            sites[i].live_bytes = get(site.live_bytes);
+        }
+    }
+
+    printf(PPREFIX "sampled call sites: %zu, interval %zu, dropped %zu\n",
+           num, sample_interval, get(s_sample_dropped));
+
+    for (size_t i = 0; i < num_print; ++i) {
+        const PrintSite& site = sites[i];
+        void* const* f = site.frames;
+        printf(PPREFIX "site live %zd total %zd samples %zd: "
+               "%p %p %p %p %p %p %p %p\n",
+               site.live_bytes, site.total_bytes, site.samples,
+               f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7]);
+    }
+}
+
 /******************************************************************************/
 // Run-time memory profiler
 
@@ -369,6 +697,9 @@ void MemoryProfiler::RunTask(const std::chrono::steady_clock::time_point&) {
          << "float" << copy_float.close
          << "base" << copy_base.close;
 
+    if (sample_interval != 0)
+        line << "sample_interval" << sample_interval;
+
     line.sub("float_hlc")
         << "high" << copy_float.high
         << "low" << copy_float.low
@@ -393,6 +724,10 @@ void StartMemProfiler(common::ProfileThread& sched, common::JsonLogger& logger)
 ATTRIBUTE_NO_SANITIZE
 static __attribute__ ((constructor)) void init() { // NOLINT
 
+    // must be set before real_malloc, such that no allocations are tracked in
+    // the wrong mode.
+    init_sampling();
+
     // try to use AddressSanitizer's malloc first.
     real_malloc = (malloc_type)dlsym(RTLD_DEFAULT, "__interceptor_malloc");
     if (real_malloc)
@@ -444,6 +779,10 @@ static __attribute__ ((destructor)) void finish() { // NOLINT
             get(total_bytes), get(peak_bytes),
             get(float_curr), get(base_curr),
             get(total_allocs), get(current_allocs));
+    if (sample_interval != 0) {
+        fprintf(stderr, PPREFIX "sampling interval %zu, dropped samples %zu\n",
+                sample_interval, get(s_sample_dropped));
+    }
 }
 
 #endif
@@ -741,26 +1080,6 @@ static void preinit_free(void* ptr) {
     }
 }
 
-#if __APPLE__
-
-#define NOEXCEPT
-#define MALLOC_USABLE_SIZE malloc_size
-#include <malloc/malloc.h>
-
-#elif __FreeBSD__
-
-#define NOEXCEPT
-#define MALLOC_USABLE_SIZE malloc_usable_size
-#include <malloc_np.h>
-
-#elif __linux__
-
-#define NOEXCEPT noexcept
-#define MALLOC_USABLE_SIZE malloc_usable_size
-#include <malloc.h>
-
-#endif
-
 /******************************************************************************/
 // Super-simple and Super-Slow Leak Detection
 
@@ -868,6 +1187,12 @@ void * malloc(size_t size) NOEXCEPT {
         return nullptr;
     }
 
+    if (sample_interval != 0) {
+        // sampling mode: count only sampled allocations
+        sample_malloc(ret, size);
+        return ret;
+    }
+
     size_t size_used = MALLOC_USABLE_SIZE(ret);
     inc_count(size_used);
 
@@ -924,6 +1249,11 @@ void free(void* ptr) NOEXCEPT {
         return;
     }
 
+    if (sample_interval != 0) {
+        sample_free(ptr);
+        return (*real_free)(ptr);
+    }
+
     size_t size_used = MALLOC_USABLE_SIZE(ptr);
     dec_count(size_used);
 
@@ -969,6 +1299,14 @@ void * realloc(void* ptr, size_t size) NOEXCEPT {
         return malloc(size);
     }
 
+    if (sample_interval != 0) {
+        sample_free(ptr);
+        void* newptr = (*real_realloc)(ptr, size);
+        if (!newptr) return nullptr;
+        sample_malloc(newptr, size);
+        return newptr;
+    }
+
     size_t oldsize_used = MALLOC_USABLE_SIZE(ptr);
     dec_count(oldsize_used);
 
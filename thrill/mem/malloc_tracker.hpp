@@ -72,6 +72,15 @@ void malloc_tracker_print_status();
 //! user function which prints new unfreed areas to stdout since the last call
 void malloc_tracker_print_leaks();
 
+//! returns the mean number of bytes between two sampled allocations, or zero if
+//! every allocation is tracked. Sampling is enabled by setting the environment
+//! variable THRILL_MALLOC_SAMPLE to the interval in bytes.
+size_t malloc_tracker_sample_interval();
+
+//! user function which prints the sampled call sites with the most live bytes
+//! to stdout, at most 64 of them
+void malloc_tracker_print_sampled_sites(size_t limit = 16);
+
 //! launch profiler task
 void StartMemProfiler(common::ProfileThread& sched, common::JsonLogger& logger);
 
@@ -10,6 +10,7 @@
 
 #include <thrill/mem/pool.hpp>
 
+#include <tlx/define/likely.hpp>
 #include <tlx/die.hpp>
 #include <tlx/math/ffs.hpp>
 #include <tlx/math/integer_log2.hpp>
@@ -24,7 +25,7 @@ namespace mem {
 /******************************************************************************/
 
 Pool& GPool() {
-    static Pool* pool = new Pool();
+    static Pool* pool = new Pool(16384, /* thread_cache */ true);
     return *pool;
 }
 
@@ -383,6 +384,45 @@ void Pool::ObjectPool::self_verify() {
     die_unequal(total_used, total_slots_ - total_free_);
 }
 
+/******************************************************************************/
+// Pool::ThreadCache of small items
+
+struct Pool::ThreadCache {
+    //! maximum number of items in each magazine
+    static constexpr size_t kMagazineSize = 64;
+
+    struct Magazine {
+        //! number of cached items
+        size_t size;
+        //! cached free items
+        void   * items[kMagazineSize];
+    };
+
+    //! Pool this thread's cache is bound to
+    Pool     * pool;
+    //! set once the cache was flushed at thread exit
+    bool     dead;
+    //! one magazine per ObjectPool size class
+    Magazine mags[4];
+};
+
+//! The per-thread cache is trivially destructible, hence it remains accessible
+//! while other thread_local objects are destroyed at thread exit. It is flushed
+//! by a separate guard object.
+static thread_local Pool::ThreadCache s_thread_cache;
+
+struct PoolThreadCacheGuard {
+    bool armed = false;
+
+    ~PoolThreadCacheGuard() {
+        if (s_thread_cache.pool)
+            s_thread_cache.pool->FlushThreadCache();
+        s_thread_cache.dead = true;
+    }
+};
+
+static thread_local PoolThreadCacheGuard s_thread_cache_guard;
+
 /******************************************************************************/
 // internal methods
 
@@ -402,11 +442,17 @@ static inline size_t bin_lower_bound(size_t bin) {
         return (size_t(1) << (bin - 1));
 }
 
+//! determine ObjectPool size class for small items of at most 256 bytes.
+static inline size_t calc_size_class(size_t size) {
+    return size <= 32 ? 0 : size <= 64 ? 1 : size <= 128 ? 2 : 3;
+}
+
 /******************************************************************************/
 // Pool
 
-Pool::Pool(size_t default_arena_size) noexcept
-    : default_arena_size_(default_arena_size) {
+Pool::Pool(size_t default_arena_size, bool thread_cache) noexcept
+    : default_arena_size_(default_arena_size),
+      use_thread_cache_(thread_cache) {
     std::unique_lock<std::mutex> lock(mutex_);
 
     for (size_t i = 0; i < num_bins + 1; ++i)
@@ -426,6 +472,10 @@ Pool::Pool(size_t default_arena_size) noexcept
 
 Pool::~Pool() noexcept {
     std::unique_lock<std::mutex> lock(mutex_);
+    if (s_thread_cache.pool == this) {
+        IntFlushThreadCache(s_thread_cache);
+        s_thread_cache.pool = nullptr;
+    }
     if (size_ != 0) {
         std::cout << "~Pool() pool still contains "
                   << sizeof(Slot) * size_ << " bytes" << std::endl;
@@ -621,9 +671,78 @@ size_t Pool::bytes_per_arena(size_t arena_size) {
     return arena_size - sizeof(Arena);
 }
 
+Pool::ObjectPool* Pool::object_pool(size_t size_class) {
+    switch (size_class) {
+    case 0: return object_32_;
+    case 1: return object_64_;
+    case 2: return object_128_;
+    default: return object_256_;
+    }
+}
+
+Pool::ThreadCache* Pool::thread_cache() {
+    ThreadCache& tc = s_thread_cache;
+    if (TLX_LIKELY(tc.pool == this))
+        return &tc;
+    // cache is bound to another Pool or the thread is exiting
+    if (tc.pool != nullptr || tc.dead)
+        return nullptr;
+
+    // bind cache to this Pool and construct the guard flushing it at exit.
+    tc.pool = this;
+    s_thread_cache_guard.armed = true;
+    return &tc;
+}
+
+void* Pool::CachedAllocate(ThreadCache& tc, size_t size_class) {
+    ThreadCache::Magazine& mag = tc.mags[size_class];
+    if (TLX_UNLIKELY(mag.size == 0)) {
+        // refill half of the magazine under the lock
+        std::unique_lock<std::mutex> lock(mutex_);
+        ObjectPool* pool = object_pool(size_class);
+        while (mag.size < ThreadCache::kMagazineSize / 2)
+            mag.items[mag.size++] = pool->allocate();
+    }
+    return mag.items[--mag.size];
+}
+
+void Pool::CachedDeallocate(ThreadCache& tc, size_t size_class, void* ptr) {
+    ThreadCache::Magazine& mag = tc.mags[size_class];
+    if (TLX_UNLIKELY(mag.size == ThreadCache::kMagazineSize)) {
+        // flush half of the magazine under the lock
+        std::unique_lock<std::mutex> lock(mutex_);
+        ObjectPool* pool = object_pool(size_class);
+        while (mag.size > ThreadCache::kMagazineSize / 2)
+            pool->deallocate(mag.items[--mag.size]);
+    }
+    mag.items[mag.size++] = ptr;
+}
+
+void Pool::IntFlushThreadCache(ThreadCache& tc) {
+    for (size_t c = 0; c < 4; ++c) {
+        ThreadCache::Magazine& mag = tc.mags[c];
+        ObjectPool* pool = object_pool(c);
+        while (mag.size != 0)
+            pool->deallocate(mag.items[--mag.size]);
+    }
+}
+
+void Pool::FlushThreadCache() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (s_thread_cache.pool != this) return;
+    IntFlushThreadCache(s_thread_cache);
+    // unbind, the thread may later use another Pool's cache
+    s_thread_cache.pool = nullptr;
+}
+
 void* Pool::allocate(size_t bytes) {
     // return malloc(bytes);
 
+    if (bytes <= 256 && use_thread_cache_ && !debug_check_pairing) {
+        if (ThreadCache* tc = thread_cache())
+            return CachedAllocate(*tc, calc_size_class(bytes));
+    }
+
     std::unique_lock<std::mutex> lock(mutex_);
 
     if (debug) {
@@ -702,6 +821,11 @@ void Pool::deallocate(void* ptr, size_t bytes) {
 
     if (ptr == nullptr) return;
 
+    if (bytes <= 256 && use_thread_cache_ && !debug_check_pairing) {
+        if (ThreadCache* tc = thread_cache())
+            return CachedDeallocate(*tc, calc_size_class(bytes), ptr);
+    }
+
     std::unique_lock<std::mutex> lock(mutex_);
     if (debug) {
         std::cout << "Pool::deallocate() ptr " << ptr
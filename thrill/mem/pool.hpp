@@ -70,6 +70,14 @@ namespace mem {
  * For faster allocation, Arenas are categorized into many bins. Bin k always
  * contains all Arenas with log_2(k) to log_2(k+1)-1 free space in them. On
  * allocation and deallocation, the Arenas are moved between bins.
+ *
+ * Small items of at most 256 bytes are allocated from ObjectPools of fixed size
+ * classes. If the thread cache is enabled, each thread keeps a magazine of free
+ * items per size class, which is refilled from or flushed into the ObjectPools
+ * in batches of half a magazine. Hence most small allocations and deallocations
+ * do not take the Pool's mutex. A Pool with thread cache must outlive all
+ * threads using it (except the thread destroying it), since threads return
+ * their cached items on exit. This is the case for the GPool().
  */
 class Pool
 {
@@ -80,8 +88,10 @@ class Pool
     static constexpr size_t check_limit = 4 * 1024 * 1024;
 
 public:
-    //! construct with base allocator
-    explicit Pool(size_t default_arena_size = 16384) noexcept;
+    //! construct with base allocator, optionally with per-thread caches for
+    //! small items.
+    explicit Pool(size_t default_arena_size = 16384,
+                  bool thread_cache = false) noexcept;
 
     //! non-copyable: delete copy-constructor
     Pool(const Pool&) = delete;
@@ -126,6 +136,12 @@ public:
     //! deallocate all Arenas
     void DeallocateAll();
 
+    //! return the calling thread's cached items to the Pool
+    void FlushThreadCache();
+
+    //! per-thread magazines of small items
+    struct ThreadCache;
+
 private:
     //! struct in a Slot, which contains free information
     struct Slot;
@@ -168,6 +184,9 @@ private:
     ObjectPool* object_128_;
     ObjectPool* object_256_;
 
+    //! whether threads keep magazines of small items
+    bool use_thread_cache_;
+
     //! array of allocations for checking
     std::vector<std::pair<void*, size_t> > allocs_;
 
@@ -182,6 +201,21 @@ private:
 
     //! deallocate all Arenas
     void IntDeallocateAll();
+
+    //! return ObjectPool of size class
+    ObjectPool * object_pool(size_t size_class);
+
+    //! return the calling thread's cache if it is bound to this Pool
+    ThreadCache * thread_cache();
+
+    //! allocate a small item using the thread cache
+    void * CachedAllocate(ThreadCache& tc, size_t size_class);
+
+    //! deallocate a small item using the thread cache
+    void CachedDeallocate(ThreadCache& tc, size_t size_class, void* ptr);
+
+    //! return all items of a thread cache to the ObjectPools
+    void IntFlushThreadCache(ThreadCache& tc);
 };
 
 //! singleton instance of global pool for I/O data structures
@@ -611,6 +611,9 @@ public:
     //! received bytes
     std::atomic<size_t> rx_bytes_ = { 0 };
 
+    //! number of send system calls, counted by the TCP backend
+    std::atomic<size_t> tx_sends_ { 0 };
+
     //! previous read of sent bytes
     size_t prev_tx_bytes_ = 0;
 
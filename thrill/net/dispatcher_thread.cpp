@@ -12,6 +12,7 @@
 #include <thrill/net/dispatcher_thread.hpp>
 #include <thrill/net/group.hpp>
 
+#include <algorithm>
 #include <deque>
 #include <string>
 #include <vector>
@@ -20,9 +21,10 @@ namespace thrill {
 namespace net {
 
 DispatcherThread::DispatcherThread(
-    std::unique_ptr<class Dispatcher> dispatcher, size_t host_rank)
+    std::unique_ptr<class Dispatcher> dispatcher, size_t host_rank,
+    size_t index)
     : dispatcher_(std::move(dispatcher)),
-      host_rank_(host_rank) {
+      host_rank_(host_rank), index_(index) {
     // start thread
     thread_ = std::thread(&DispatcherThread::Work, this);
 }
@@ -137,9 +139,11 @@ void DispatcherThread::Enqueue(Job&& job) {
 
 void DispatcherThread::Work() {
     common::NameThisThread(
-        "host " + std::to_string(host_rank_) + " dispatcher");
-    // pin DispatcherThread to last core
-    common::SetCpuAffinity(std::thread::hardware_concurrency() - 1);
+        "host " + std::to_string(host_rank_) + " dispatcher"
+        + (index_ != 0 ? " " + std::to_string(index_) : std::string()));
+    // pin DispatcherThread to last cores, one per dispatcher thread
+    size_t num_cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    common::SetCpuAffinity(num_cores - 1 - index_ % num_cores);
 
     while (!terminate_ ||
            dispatcher_->HasAsyncWrites() || !jobqueue_.empty())
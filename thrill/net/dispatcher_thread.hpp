@@ -65,9 +65,11 @@ public:
     //! Signature of async jobs to be run by the dispatcher thread.
     using Job = tlx::delegate<void (), mem::GPoolAllocator<char> >;
 
+    //! Start thread running the dispatcher. The index distinguishes multiple
+    //! dispatcher threads of a host, thread i is pinned to the i-th last core.
     DispatcherThread(
         std::unique_ptr<class Dispatcher> dispatcher,
-        size_t host_rank);
+        size_t host_rank, size_t index = 0);
 
     ~DispatcherThread();
 
@@ -171,6 +173,10 @@ private:
 
     //! for thread name for logging
     size_t host_rank_;
+
+    //! index among the dispatcher threads of the host, for thread name and
+    //! core pinning
+    size_t index_;
 };
 
 //! \}
@@ -781,6 +781,23 @@ public:
 
     //! A trivial local thread barrier
     void LocalBarrier();
+
+    /*!
+     * Shares a pointer among the workers of this host: returns the pointer
+     * passed by the local worker origin on all local workers. This does not
+     * communicate with other hosts.
+     */
+    template <typename T>
+    T * LocalShare(T* ptr, size_t origin = 0) {
+        assert(origin < thread_count_);
+
+        size_t step = GetNextStep();
+        SetLocalShared(step, ptr);
+
+        barrier_.Await();
+
+        return GetLocalShared<T>(step, origin);
+    }
 };
 
 /******************************************************************************/
@@ -18,6 +18,8 @@
 #endif
 
 #include <functional>
+#include <iterator>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -49,17 +51,18 @@ std::ostream& operator << (std::ostream& os, const Traffic& t) {
 
 Manager::Manager(std::array<GroupPtr, kGroupCount>&& groups,
                  common::JsonLogger& logger) noexcept
-    : groups_(std::move(groups)), logger_(logger) { }
+    : groups_(std::make_move_iterator(groups.begin()),
+              std::make_move_iterator(groups.end())),
+      logger_(logger) { }
 
 Manager::Manager(std::vector<GroupPtr>&& groups,
                  common::JsonLogger& logger) noexcept
-    : logger_(logger) {
-    assert(groups.size() == kGroupCount);
-    std::move(groups.begin(), groups.end(), groups_.begin());
+    : groups_(std::move(groups)), logger_(logger) {
+    assert(groups_.size() >= kGroupCount);
 }
 
 void Manager::Close() {
-    for (size_t i = 0; i < kGroupCount; i++) {
+    for (size_t i = 0; i < groups_.size(); i++) {
         groups_[i]->Close();
     }
 }
@@ -67,7 +70,7 @@ void Manager::Close() {
 net::Traffic Manager::Traffic() const {
     size_t total_tx = 0, total_rx = 0;
 
-    for (size_t g = 0; g < kGroupCount; ++g) {
+    for (size_t g = 0; g < groups_.size(); ++g) {
         Group& group = *groups_[g];
 
         for (size_t h = 0; h < group.num_hosts(); ++h) {
@@ -91,13 +94,13 @@ void Manager::RunTask(const std::chrono::steady_clock::time_point& tp) {
         std::chrono::duration_cast<std::chrono::microseconds>(
             tp - tp_last_).count()) / 1e6;
 
-    size_t total_tx = 0, total_rx = 0;
+    size_t total_tx = 0, total_rx = 0, total_sends = 0;
     size_t prev_total_tx = 0, prev_total_rx = 0;
 
-    for (size_t g = 0; g < kGroupCount; ++g) {
+    for (size_t g = 0; g < groups_.size(); ++g) {
         Group& group = *groups_[g];
 
-        size_t group_tx = 0, group_rx = 0;
+        size_t group_tx = 0, group_rx = 0, group_sends = 0;
         size_t prev_group_tx = 0, prev_group_rx = 0;
         std::vector<size_t> tx_per_host(group.num_hosts());
         std::vector<size_t> rx_per_host(group.num_hosts());
@@ -120,11 +123,14 @@ void Manager::RunTask(const std::chrono::steady_clock::time_point& tp) {
             prev_group_rx += prev_rx;
             group.connection(h).prev_rx_bytes_ = rx;
 
+            group_sends += conn.tx_sends_.load(std::memory_order_relaxed);
+
             tx_per_host[h] = tx;
             rx_per_host[h] = rx;
         }
 
-        line.sub(g == 0 ? "flow" : g == 1 ? "data" : "???")
+        line.sub(g == 0 ? std::string("flow") : g == 1 ? std::string("data")
+                 : "data" + std::to_string(g - 1))
             << "tx_bytes" << group_tx
             << "rx_bytes" << group_rx
             << "tx_speed"
@@ -132,10 +138,12 @@ void Manager::RunTask(const std::chrono::steady_clock::time_point& tp) {
             << "rx_speed"
             << static_cast<double>(group_rx - prev_group_rx) / elapsed
             << "tx_per_host" << tx_per_host
-            << "rx_per_host" << rx_per_host;
+            << "rx_per_host" << rx_per_host
+            << "tx_sends" << group_sends;
 
         total_tx += group_tx;
         total_rx += group_rx;
+        total_sends += group_sends;
         prev_total_tx += prev_group_tx;
         prev_total_rx += prev_group_rx;
 
@@ -149,7 +157,8 @@ void Manager::RunTask(const std::chrono::steady_clock::time_point& tp) {
         << "tx_speed"
         << static_cast<double>(total_tx - prev_total_tx) / elapsed
         << "rx_speed"
-        << static_cast<double>(total_rx - prev_total_rx) / elapsed;
+        << static_cast<double>(total_rx - prev_total_rx) / elapsed
+        << "tx_sends" << total_sends;
 }
 
 /******************************************************************************/
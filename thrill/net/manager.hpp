@@ -19,6 +19,7 @@
 #include <thrill/net/group.hpp>
 
 #include <array>
+#include <cassert>
 #include <chrono>
 #include <string>
 #include <utility>
@@ -49,6 +50,10 @@ struct Traffic {
  *
  * \details This class is responsible for initializing the three net::Groups for
  * the major network components, SystemControl, FlowControl and DataManagement,
+ *
+ * Additional Groups beyond kGroupCount are further data Groups: the data
+ * Multiplexer stripes Blocks across the connections of all data Groups to run
+ * multiple connections per host pair in parallel.
  */
 class Manager final : public common::ProfileTask
 {
@@ -77,7 +82,8 @@ public:
     Manager(std::array<GroupPtr, kGroupCount>&& groups,
             common::JsonLogger& logger) noexcept;
 
-    //! Construct Manager from already initialized net::Groups.
+    //! Construct Manager from already initialized net::Groups, at least
+    //! kGroupCount, additional ones are further data Groups.
     Manager(std::vector<GroupPtr>&& groups,
             common::JsonLogger& logger) noexcept;
 
@@ -86,9 +92,16 @@ public:
         return *groups_[0];
     }
 
-    //! Returns the net::Group for the data manager.
-    Group& GetDataGroup() {
-        return *groups_[1];
+    //! Returns the i-th net::Group for the data manager.
+    Group& GetDataGroup(size_t i = 0) {
+        assert(1 + i < groups_.size());
+        return *groups_[1 + i];
+    }
+
+    //! Returns the number of data Groups, which are striped by the data
+    //! Multiplexer.
+    size_t num_data_groups() const {
+        return groups_.size() - 1;
     }
 
     void Close();
@@ -105,7 +118,7 @@ public:
 
 private:
     //! The Groups initialized and managed by this Manager.
-    std::array<GroupPtr, kGroupCount> groups_;
+    std::vector<GroupPtr> groups_;
 
     //! JsonLogger for statistics output
     common::JsonLogger& logger_;
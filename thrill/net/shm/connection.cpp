@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * thrill/net/shm/connection.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/net/shm/connection.hpp>
+
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include <sys/socket.h>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+Connection::Connection(Ring&& tx, Ring&& rx, tcp::Connection&& doorbell,
+                       size_t peer)
+    : tx_(std::move(tx)), rx_(std::move(rx)),
+      doorbell_(std::move(doorbell)), peer_(peer) {
+    is_loopback_ = true;
+}
+
+Connection::~Connection() {
+    Close();
+}
+
+std::string Connection::ToString() const {
+    return "shm:" + std::to_string(peer_);
+}
+
+std::ostream& Connection::OutputOstream(std::ostream& os) const {
+    return os << "[shm::Connection"
+              << " peer=" << peer_
+              << " doorbell=" << doorbell_.GetSocket().fd() << "]";
+}
+
+void Connection::Close() {
+    if (!doorbell_.IsValid()) return;
+    tx_.Close();
+    rx_.Close();
+    Notify();
+    doorbell_.Close();
+}
+
+void Connection::Notify() {
+    if (tx_.Notify() && doorbell_.IsValid()) {
+        // if the socket buffer is full, the peer has doorbells pending anyway.
+        char c = 0;
+        doorbell_.GetSocket().send_one(&c, 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+    }
+}
+
+void Connection::Wait(uint32_t seen) {
+    // the timeout only limits the time until a dead peer is noticed.
+    rx_.Wait(seen, std::chrono::milliseconds(100));
+}
+
+bool Connection::DoorbellCallback() {
+    char buf[64];
+    ssize_t r;
+    while ((r = doorbell_.GetSocket().recv_one(
+                buf, sizeof(buf), MSG_DONTWAIT)) > 0) { }
+
+    if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        // the peer went away, possibly without closing the rings.
+        sLOG << "shm::Connection doorbell of peer" << peer_ << "closed";
+        tx_.Close();
+        rx_.Close();
+        return false;
+    }
+    return true;
+}
+
+ssize_t Connection::SendOne(const void* data, size_t size, Flags /* flags */) {
+    if (tx_.closed()) {
+        errno = EPIPE;
+        return -1;
+    }
+    size_t wb = tx_.Write(data, size);
+    ++tx_sends_;
+    if (wb == 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+    Notify();
+    tx_bytes_ += wb;
+    return static_cast<ssize_t>(wb);
+}
+
+ssize_t Connection::RecvOne(void* out_data, size_t size) {
+    size_t rb = rx_.Read(out_data, size);
+    if (rb == 0) {
+        if (rx_.closed() && rx_.readable() == 0) {
+            // end of stream, like recv() on a closed socket
+            errno = 0;
+            return 0;
+        }
+        errno = EAGAIN;
+        return -1;
+    }
+    Notify();
+    rx_bytes_ += rb;
+    return static_cast<ssize_t>(rb);
+}
+
+void Connection::SyncSendRecv(const void* send_data, size_t send_size,
+                              void* recv_data, size_t recv_size) {
+    const uint8_t* sp = static_cast<const uint8_t*>(send_data);
+    uint8_t* rp = static_cast<uint8_t*>(recv_data);
+    size_t spins = 0;
+
+    // both directions progress concurrently, hence large exchanges cannot
+    // deadlock in full rings.
+    while (send_size != 0 || recv_size != 0)
+    {
+        // event must be read before the rings to not miss a wakeup.
+        uint32_t seen = rx_.event();
+
+        size_t wb = send_size ? tx_.Write(sp, send_size) : 0;
+        size_t rb = recv_size ? rx_.Read(rp, recv_size) : 0;
+
+        if (wb != 0 || rb != 0) {
+            Notify();
+            sp += wb, send_size -= wb, tx_bytes_ += wb;
+            rp += rb, recv_size -= rb, rx_bytes_ += rb;
+            spins = 0;
+            continue;
+        }
+
+        if (tx_.closed()) {
+            throw Exception(
+                      send_size ? "Error during SyncSend" : "Error during SyncRecv",
+                      send_size ? EPIPE : ECONNRESET);
+        }
+
+        if (++spins >= spin_count_)
+            Wait(seen);
+    }
+}
+
+void Connection::SyncRecvSend(const void* send_data, size_t send_size,
+                              void* recv_data, size_t recv_size) {
+    SyncSendRecv(send_data, send_size, recv_data, recv_size);
+}
+
+void Connection::SyncSend(const void* data, size_t size, Flags /* flags */) {
+    SyncSendRecv(data, size, nullptr, 0);
+    ++tx_sends_;
+}
+
+void Connection::SyncRecv(void* out_data, size_t size) {
+    SyncSendRecv(nullptr, 0, out_data, size);
+}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+/******************************************************************************/
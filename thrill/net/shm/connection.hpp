@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * thrill/net/shm/connection.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_NET_SHM_CONNECTION_HEADER
+#define THRILL_NET_SHM_CONNECTION_HEADER
+
+#include <thrill/net/connection.hpp>
+#include <thrill/net/shm/ring.hpp>
+#include <thrill/net/tcp/connection.hpp>
+
+#include <string>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+//! \addtogroup net_shm Shared Memory API
+//! \{
+
+class Dispatcher;
+
+/*!
+ * Connection to a peer process on the same host through two shared memory
+ * Rings, one for each direction. Data is copied directly into the peer's
+ * address space without passing through the kernel.
+ *
+ * Synchronous operations sleep on a futex in the receive Ring. A stream
+ * socket to the peer serves as doorbell for Dispatchers, which wait in
+ * select(): when the Dispatcher has pending callbacks, it requests a doorbell,
+ * and the peer sends a single byte after its next change to the rings.
+ */
+class Connection final : public net::Connection
+{
+    static constexpr bool debug = false;
+
+public:
+    //! Construct from the send Ring, the receive Ring, and a socket to the
+    //! same peer used as doorbell.
+    Connection(Ring&& tx, Ring&& rx, tcp::Connection&& doorbell, size_t peer);
+
+    //! non-copyable: delete copy-constructor
+    Connection(const Connection&) = delete;
+    //! non-copyable: delete assignment operator
+    Connection& operator = (const Connection&) = delete;
+
+    ~Connection();
+
+    //! \name Base Status Functions
+    //! \{
+
+    bool IsValid() const final { return rx_.IsValid(); }
+
+    std::string ToString() const final;
+
+    std::ostream& OutputOstream(std::ostream& os) const final;
+
+    //! \}
+
+    //! \name Send Functions
+    //! \{
+
+    void SyncSend(const void* data, size_t size, Flags flags = NoFlags) final;
+
+    ssize_t SendOne(const void* data, size_t size, Flags flags = NoFlags) final;
+
+    //! \}
+
+    //! \name Receive Functions
+    //! \{
+
+    void SyncRecv(void* out_data, size_t size) final;
+
+    ssize_t RecvOne(void* out_data, size_t size) final;
+
+    //! \}
+
+    //! \name Paired SendReceive Methods
+    //! \{
+
+    void SyncSendRecv(const void* send_data, size_t send_size,
+                      void* recv_data, size_t recv_size) final;
+
+    void SyncRecvSend(const void* send_data, size_t send_size,
+                      void* recv_data, size_t recv_size) final;
+
+    //! \}
+
+    //! Close the rings and the doorbell socket.
+    void Close();
+
+    //! id of the peer
+    size_t peer() const { return peer_; }
+
+private:
+    //! Ring to the peer
+    Ring tx_;
+
+    //! Ring from the peer
+    Ring rx_;
+
+    //! stream socket to the peer, used only to wake up its Dispatcher
+    tcp::Connection doorbell_;
+
+    //! id of the peer
+    size_t peer_;
+
+    //! number of polls of the rings before sleeping on the futex
+    static constexpr size_t spin_count_ = 256;
+
+    //! wake the peer after a change to either ring
+    void Notify();
+
+    //! Block until the peer changes a ring, given the event seen before
+    //! finding no progress.
+    void Wait(uint32_t seen);
+
+    //! whether a read callback can make progress: data or end of stream
+    bool ReadReady() const { return rx_.readable() != 0 || rx_.closed(); }
+
+    //! whether a write callback can make progress: space or broken pipe
+    bool WriteReady() const { return tx_.writable() != 0 || tx_.closed(); }
+
+    //! Drain the doorbell socket, called by the Dispatcher.
+    bool DoorbellCallback();
+
+    //! for access to rings and doorbell
+    friend class Dispatcher;
+};
+
+//! \}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+#endif // !THRILL_NET_SHM_CONNECTION_HEADER
+
+/******************************************************************************/
@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * thrill/net/shm/dispatcher.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/net/shm/dispatcher.hpp>
+
+#include <utility>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+Dispatcher::Dispatcher()
+    : Dispatcher(std::make_unique<tcp::SelectDispatcher>()) { }
+
+Dispatcher::Dispatcher(std::unique_ptr<tcp::SelectDispatcher> select)
+    : select_(std::move(select)) { }
+
+Dispatcher::~Dispatcher() = default;
+
+Dispatcher::Watch& Dispatcher::GetWatch(Connection* c) {
+    for (Watch& w : watch_) {
+        if (w.conn == c) return w;
+    }
+    watch_.emplace_back();
+    watch_.back().conn = c;
+    return watch_.back();
+}
+
+void Dispatcher::AddRead(net::Connection& c, const Callback& read_cb) {
+    if (Connection* sc = dynamic_cast<Connection*>(&c))
+        GetWatch(sc).read_cb.emplace_back(read_cb);
+    else
+        select_->AddRead(c, read_cb);
+}
+
+void Dispatcher::AddWrite(net::Connection& c, const Callback& write_cb) {
+    if (Connection* sc = dynamic_cast<Connection*>(&c))
+        GetWatch(sc).write_cb.emplace_back(write_cb);
+    else
+        select_->AddWrite(c, write_cb);
+}
+
+void Dispatcher::Cancel(net::Connection& c) {
+    if (Connection* sc = dynamic_cast<Connection*>(&c)) {
+        Watch& w = GetWatch(sc);
+        w.read_cb.clear();
+        w.write_cb.clear();
+    }
+    else {
+        select_->Cancel(c);
+    }
+}
+
+void Dispatcher::AsyncWrite(
+    net::Connection& c, uint32_t seq, Buffer&& buffer,
+    const AsyncWriteCallback& done_cb) {
+    if (dynamic_cast<Connection*>(&c))
+        net::Dispatcher::AsyncWrite(c, seq, std::move(buffer), done_cb);
+    else
+        select_->AsyncWrite(c, seq, std::move(buffer), done_cb);
+}
+
+void Dispatcher::AsyncWrite(
+    net::Connection& c, uint32_t seq, data::PinnedBlock&& block,
+    const AsyncWriteCallback& done_cb) {
+    if (dynamic_cast<Connection*>(&c))
+        net::Dispatcher::AsyncWrite(c, seq, std::move(block), done_cb);
+    else
+        select_->AsyncWrite(c, seq, std::move(block), done_cb);
+}
+
+bool Dispatcher::HasAsyncWrites() const {
+    return net::Dispatcher::HasAsyncWrites() || select_->HasAsyncWrites();
+}
+
+void Dispatcher::Interrupt() {
+    select_->Interrupt();
+}
+
+bool Dispatcher::RunCallbacks() {
+    bool progress = false;
+
+    for (size_t i = 0; i < watch_.size(); ++i)
+    {
+        Watch& w = watch_[i];
+
+        // run callbacks until one returns true, in which case it wants to be
+        // called again when the ring is ready the next time.
+        while (!w.read_cb.empty() && w.conn->ReadReady()) {
+            progress = true;
+            if (w.read_cb.front()()) break;
+            w.read_cb.pop_front();
+        }
+        while (!w.write_cb.empty() && w.conn->WriteReady()) {
+            progress = true;
+            if (w.write_cb.front()()) break;
+            w.write_cb.pop_front();
+        }
+    }
+
+    return progress;
+}
+
+void Dispatcher::DispatchOne(const std::chrono::milliseconds& timeout) {
+
+    bool ready = RunCallbacks();
+
+    if (!ready) {
+        // request doorbells of connections with pending callbacks, then check
+        // the rings again, since the peer may have changed them meanwhile.
+        for (size_t i = 0; i < watch_.size(); ++i)
+        {
+            Watch& w = watch_[i];
+            if (w.read_cb.empty() && w.write_cb.empty()) continue;
+
+            Connection* c = w.conn;
+            if (!w.doorbell && c->doorbell_.IsValid()) {
+                select_->AddRead(
+                    c->doorbell_.GetSocket().fd(),
+                    Callback::make<Connection, &Connection::DoorbellCallback>(c));
+                w.doorbell = true;
+            }
+            c->rx_.RequestDoorbell();
+
+            if ((!w.read_cb.empty() && c->ReadReady()) ||
+                (!w.write_cb.empty() && c->WriteReady()))
+                ready = true;
+        }
+    }
+
+    LOG << "shm::Dispatcher::DispatchOne() ready=" << ready;
+
+    select_->DispatchOne(ready ? std::chrono::milliseconds(0) : timeout);
+
+    RunCallbacks();
+}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+/******************************************************************************/
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * thrill/net/shm/dispatcher.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_NET_SHM_DISPATCHER_HEADER
+#define THRILL_NET_SHM_DISPATCHER_HEADER
+
+#include <thrill/mem/pool.hpp>
+#include <thrill/net/dispatcher.hpp>
+#include <thrill/net/shm/connection.hpp>
+#include <thrill/net/tcp/select_dispatcher.hpp>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+//! \addtogroup net_shm Shared Memory API
+//! \{
+
+/*!
+ * Dispatcher for Groups mixing shm::Connections to peers on the same host with
+ * tcp::Connections to remote peers. Callbacks on tcp::Connections are
+ * forwarded to an inner tcp::SelectDispatcher, those on shm::Connections are
+ * run whenever their Rings allow progress.
+ *
+ * Before select() waits for tcp events, the shm::Connections with pending
+ * callbacks request their doorbells, which are part of the same select(). If
+ * any Ring is ready, select() only polls.
+ */
+class Dispatcher final : public net::Dispatcher
+{
+    static constexpr bool debug = false;
+
+public:
+    //! type for readiness callbacks
+    using Callback = AsyncCallback;
+
+    //! constructor with new inner SelectDispatcher
+    Dispatcher();
+
+    //! constructor wrapping an existing SelectDispatcher, e.g. one used to
+    //! construct the tcp::Groups.
+    explicit Dispatcher(std::unique_ptr<tcp::SelectDispatcher> select);
+
+    //! non-copyable: delete copy-constructor
+    Dispatcher(const Dispatcher&) = delete;
+    //! non-copyable: delete assignment operator
+    Dispatcher& operator = (const Dispatcher&) = delete;
+
+    ~Dispatcher();
+
+    //! \name Implementation of Virtual Methods
+    //! \{
+
+    void AddRead(net::Connection& c, const Callback& read_cb) final;
+
+    void AddWrite(net::Connection& c, const Callback& write_cb) final;
+
+    void Cancel(net::Connection& c) final;
+
+    //! tcp::Connections use the write queues of the SelectDispatcher.
+    void AsyncWrite(
+        net::Connection& c, uint32_t seq, Buffer&& buffer,
+        const AsyncWriteCallback& done_cb = AsyncWriteCallback()) final;
+
+    //! tcp::Connections use the write queues of the SelectDispatcher.
+    void AsyncWrite(
+        net::Connection& c, uint32_t seq, data::PinnedBlock&& block,
+        const AsyncWriteCallback& done_cb = AsyncWriteCallback()) final;
+
+    bool HasAsyncWrites() const final;
+
+    void Interrupt() final;
+
+    void DispatchOne(const std::chrono::milliseconds& timeout) final;
+
+    //! \}
+
+private:
+    //! inner dispatcher for tcp::Connections and the doorbells
+    std::unique_ptr<tcp::SelectDispatcher> select_;
+
+    //! callbacks of a shm::Connection
+    struct Watch {
+        //! the connection
+        Connection* conn;
+        //! queue of callbacks waiting for data or end of stream
+        std::deque<Callback, mem::GPoolAllocator<Callback> > read_cb;
+        //! queue of callbacks waiting for space
+        std::deque<Callback, mem::GPoolAllocator<Callback> > write_cb;
+        //! whether the doorbell socket is registered with select_
+        bool doorbell = false;
+    };
+
+    //! watched shm::Connections, a deque for stable references while
+    //! callbacks add new ones.
+    std::deque<Watch> watch_;
+
+    //! find or create Watch of a shm::Connection
+    Watch& GetWatch(Connection* c);
+
+    //! Run callbacks of shm::Connections whose Rings allow progress, returns
+    //! true if any was called.
+    bool RunCallbacks();
+};
+
+//! \}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+#endif // !THRILL_NET_SHM_DISPATCHER_HEADER
+
+/******************************************************************************/
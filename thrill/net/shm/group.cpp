@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * thrill/net/shm/group.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/net/shm/group.hpp>
+
+#include <tlx/math/round_to_power_of_two.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+size_t ring_size = 1024 * 1024;
+
+//! counter making segment names unique within the process
+static std::atomic<size_t> s_segment_counter { 0 };
+
+//! Generate a unique name for a shared memory segment
+static std::string SegmentName(size_t group_id, size_t from, size_t to) {
+    return "/thrill-" + std::to_string(::getpid())
+           + "-" + std::to_string(s_segment_counter++)
+           + "-" + std::to_string(group_id)
+           + "-" + std::to_string(from) + "-" + std::to_string(to);
+}
+
+Group::Group(std::unique_ptr<tcp::Group> tcp_group)
+    : net::Group(tcp_group->my_host_rank()),
+      tcp_group_(std::move(tcp_group)),
+      shm_connections_(tcp_group_->num_hosts()) { }
+
+Group::~Group() {
+    Close();
+}
+
+net::Connection& Group::connection(size_t id) {
+    if (is_shm(id))
+        return *shm_connections_[id];
+    return tcp_group_->connection(id);
+}
+
+size_t Group::num_shm_peers() const {
+    size_t count = 0;
+    for (const std::unique_ptr<Connection>& c : shm_connections_)
+        count += (c != nullptr);
+    return count;
+}
+
+void Group::Close() {
+    for (std::unique_ptr<Connection>& c : shm_connections_) {
+        if (c) c->Close();
+    }
+    tcp_group_->Close();
+}
+
+std::unique_ptr<net::Dispatcher> Group::ConstructDispatcher() const {
+    return std::make_unique<Dispatcher>();
+}
+
+void Group::UpgradeConnection(size_t peer, size_t group_id, size_t ring_size) {
+    tcp::Connection& tc = tcp_group_->tcp_connection(peer);
+
+    // create our receive ring and tell the peer its name
+    std::string name = SegmentName(group_id, my_rank_, peer);
+    Ring rx(Segment::Create(name, Ring::SegmentSize(ring_size)), true);
+
+    try {
+        std::string peer_name;
+        tc.Send(name);
+        tc.Receive(&peer_name);
+
+        Ring tx(Segment::Open(peer_name), false);
+
+        // after both sides mapped both rings, the names are not needed.
+        uint8_t ack = 1;
+        tc.Send(ack);
+        tc.Receive(&ack);
+        Segment::Unlink(name);
+
+        sLOG << "shm::Group" << group_id << "host" << my_rank_
+             << "connected to" << peer << "via" << name << peer_name;
+
+        shm_connections_[peer] = std::make_unique<Connection>(
+            std::move(tx), std::move(rx), std::move(tc), peer);
+    }
+    catch (...) {
+        Segment::Unlink(name);
+        throw;
+    }
+}
+
+std::vector<std::unique_ptr<Group> > Group::Construct(
+    std::vector<std::unique_ptr<tcp::Group> >&& groups,
+    const std::string& hostname, size_t ring_size) {
+
+    assert(!groups.empty());
+    ring_size = tlx::round_up_to_power_of_two(std::max<size_t>(ring_size, 4096));
+
+    // exchange host names over the first group: send to all, then receive.
+    tcp::Group& first = *groups[0];
+    size_t my_rank = first.my_host_rank(), num_hosts = first.num_hosts();
+
+    for (size_t p = 0; p < num_hosts; ++p) {
+        if (p == my_rank) continue;
+        first.connection(p).Send(hostname);
+    }
+
+    std::vector<bool> local(num_hosts, false);
+    for (size_t p = 0; p < num_hosts; ++p) {
+        if (p == my_rank) continue;
+        std::string peer_hostname;
+        first.connection(p).Receive(&peer_hostname);
+        local[p] = (peer_hostname == hostname);
+    }
+
+    // replace connections to local peers in all groups, all hosts proceed in
+    // increasing peer order, hence the pairwise handshakes cannot deadlock.
+    std::vector<std::unique_ptr<Group> > result;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        result.emplace_back(std::make_unique<Group>(std::move(groups[g])));
+
+        for (size_t p = 0; p < num_hosts; ++p) {
+            if (local[p])
+                result.back()->UpgradeConnection(p, g, ring_size);
+        }
+    }
+
+    return result;
+}
+
+std::vector<std::unique_ptr<Group> > Group::ConstructLoopbackMesh(
+    size_t num_hosts, size_t hosts_per_node) {
+
+    size_t ring_size = tlx::round_up_to_power_of_two(shm::ring_size);
+
+    std::vector<std::unique_ptr<tcp::Group> > tcp_groups =
+        tcp::Group::ConstructLoopbackMesh(num_hosts);
+
+    std::vector<std::unique_ptr<Group> > groups(num_hosts);
+    for (size_t i = 0; i < num_hosts; ++i)
+        groups[i] = std::make_unique<Group>(std::move(tcp_groups[i]));
+
+    // create a ring for each direction between local peers. Both ends map the
+    // segment separately, as they would in different processes.
+    auto make_ring_pair =
+        [ring_size](size_t from, size_t to) {
+            std::string name = SegmentName(0, from, to);
+            Ring reader(Segment::Create(name, Ring::SegmentSize(ring_size)),
+                        true);
+            Ring writer(Segment::Open(name), false);
+            Segment::Unlink(name);
+            return std::make_pair(std::move(writer), std::move(reader));
+        };
+
+    for (size_t i = 0; i < num_hosts; ++i) {
+        for (size_t j = i + 1; j < num_hosts; ++j) {
+            if (hosts_per_node != 0 &&
+                i / hosts_per_node != j / hosts_per_node) continue;
+
+            std::pair<Ring, Ring> ij = make_ring_pair(i, j);
+            std::pair<Ring, Ring> ji = make_ring_pair(j, i);
+
+            groups[i]->shm_connections_[j] = std::make_unique<Connection>(
+                std::move(ij.first), std::move(ji.second),
+                std::move(groups[i]->tcp_group_->tcp_connection(j)), j);
+            groups[j]->shm_connections_[i] = std::make_unique<Connection>(
+                std::move(ji.first), std::move(ij.second),
+                std::move(groups[j]->tcp_group_->tcp_connection(i)), i);
+        }
+    }
+
+    return groups;
+}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+/******************************************************************************/
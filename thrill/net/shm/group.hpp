@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * thrill/net/shm/group.hpp
+ *
+ * net::Group connecting processes on the same host via shared memory and
+ * remote hosts via TCP.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_NET_SHM_GROUP_HEADER
+#define THRILL_NET_SHM_GROUP_HEADER
+
+#include <thrill/net/group.hpp>
+#include <thrill/net/shm/connection.hpp>
+#include <thrill/net/shm/dispatcher.hpp>
+#include <thrill/net/tcp/group.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+//! \addtogroup net_shm Shared Memory API
+//! \{
+
+//! default size of each shared memory Ring, set via THRILL_NET_SHM_SIZE.
+extern size_t ring_size;
+
+/*!
+ * A Group whose Connections to peers on the same host are shm::Connections,
+ * which exchange data through shared memory Rings, while Connections to remote
+ * peers remain tcp::Connections. The tcp::Connections to local peers are kept
+ * as doorbells of the shm::Connections.
+ */
+class Group final : public net::Group
+{
+    static constexpr bool debug = false;
+
+public:
+    //! \name Construction and Initialization
+    //! \{
+
+    /*!
+     * Upgrade tcp::Groups: the peers on the same host are determined by
+     * exchanging host names over the first Group, and the Connections to them
+     * are replaced by shared memory Rings. This is a collective operation of
+     * all hosts.
+     */
+    static std::vector<std::unique_ptr<Group> > Construct(
+        std::vector<std::unique_ptr<tcp::Group> >&& groups,
+        const std::string& hostname, size_t ring_size = shm::ring_size);
+
+    /*!
+     * Construct a test network of num_hosts peers in this process. Peers
+     * whose ranks divided by hosts_per_node are equal are connected via shared
+     * memory, others via loopback stream sockets. hosts_per_node = 0 connects
+     * all peers via shared memory.
+     */
+    static std::vector<std::unique_ptr<Group> > ConstructLoopbackMesh(
+        size_t num_hosts, size_t hosts_per_node = 0);
+
+    //! Construct from a tcp::Group, without local peers.
+    explicit Group(std::unique_ptr<tcp::Group> tcp_group);
+
+    //! \}
+
+    //! non-copyable: delete copy-constructor
+    Group(const Group&) = delete;
+    //! non-copyable: delete assignment operator
+    Group& operator = (const Group&) = delete;
+
+    ~Group();
+
+    //! \name Status and Access to Connections
+    //! \{
+
+    size_t num_hosts() const final { return tcp_group_->num_hosts(); }
+
+    net::Connection& connection(size_t id) final;
+
+    //! whether the peer id is connected via shared memory
+    bool is_shm(size_t id) const {
+        return id < shm_connections_.size() && shm_connections_[id];
+    }
+
+    //! number of peers connected via shared memory
+    size_t num_shm_peers() const;
+
+    void Close() final;
+
+    using Dispatcher = shm::Dispatcher;
+
+    std::unique_ptr<net::Dispatcher> ConstructDispatcher() const final;
+
+    //! \}
+
+private:
+    //! underlying Group with the tcp::Connections
+    std::unique_ptr<tcp::Group> tcp_group_;
+
+    //! shm::Connections to local peers, nullptr for remote peers
+    std::vector<std::unique_ptr<Connection> > shm_connections_;
+
+    //! Replace the tcp::Connection to a local peer by rings. Collective with
+    //! the peer.
+    void UpgradeConnection(size_t peer, size_t group_id, size_t ring_size);
+};
+
+//! \}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+#endif // !THRILL_NET_SHM_GROUP_HEADER
+
+/******************************************************************************/
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * thrill/net/shm/ring.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/net/exception.hpp>
+#include <thrill/net/shm/ring.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+/******************************************************************************/
+// Segment
+
+Segment Segment::Create(const std::string& name, size_t size) {
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        // left over by a crashed process with the same pid.
+        ::shm_unlink(name.c_str());
+        fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    if (fd < 0)
+        throw Exception("Could not create shared memory " + name, errno);
+
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        int err = errno;
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw Exception("Could not resize shared memory " + name, err);
+    }
+
+    return Map(fd, size, name);
+}
+
+Segment Segment::Open(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+        throw Exception("Could not open shared memory " + name, errno);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw Exception("Could not stat shared memory " + name, err);
+    }
+
+    return Map(fd, static_cast<size_t>(st.st_size), name);
+}
+
+void Segment::Unlink(const std::string& name) {
+    ::shm_unlink(name.c_str());
+}
+
+Segment Segment::Map(int fd, size_t size, const std::string& name) {
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+    int err = errno;
+    ::close(fd);
+
+    if (addr == MAP_FAILED)
+        throw Exception("Could not map shared memory " + name, err);
+
+    Segment s;
+    s.data_ = addr;
+    s.size_ = size;
+    return s;
+}
+
+void Segment::Release() {
+    if (data_ == nullptr) return;
+    ::munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+/******************************************************************************/
+// Ring
+
+Ring::Ring(Segment&& segment, bool create)
+    : segment_(std::move(segment)) {
+    if (segment_.size() < sizeof(Header))
+        throw Exception("Shared memory segment is too small for a ring.");
+
+    void* addr = segment_.data();
+    if (create) {
+        header_ = new (addr)Header();
+        header_->head = 0;
+        header_->tail = 0;
+        header_->event = 0;
+        header_->sleepers = 0;
+        header_->doorbell = 0;
+        header_->closed = 0;
+        header_->capacity = segment_.size() - sizeof(Header);
+    }
+    else {
+        header_ = static_cast<Header*>(addr);
+    }
+
+    data_ = static_cast<uint8_t*>(addr) + sizeof(Header);
+    capacity_ = static_cast<size_t>(header_->capacity);
+
+    if (capacity_ == 0 || (capacity_ & (capacity_ - 1)) != 0 ||
+        capacity_ > segment_.size() - sizeof(Header))
+        throw Exception("Shared memory ring has invalid capacity.");
+}
+
+size_t Ring::Write(const void* data, size_t size) {
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+    uint64_t tail = header_->tail.load(std::memory_order_acquire);
+
+    size = std::min(size, capacity_ - static_cast<size_t>(head - tail));
+    if (size == 0) return 0;
+
+    // copy in up to two pieces, wrapping around the end of the data area
+    size_t pos = static_cast<size_t>(head) & (capacity_ - 1);
+    size_t first = std::min(size, capacity_ - pos);
+    std::memcpy(data_ + pos, data, first);
+    std::memcpy(data_, static_cast<const uint8_t*>(data) + first, size - first);
+
+    header_->head.store(head + size, std::memory_order_release);
+    return size;
+}
+
+size_t Ring::Read(void* out_data, size_t size) {
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+
+    size = std::min(size, static_cast<size_t>(head - tail));
+    if (size == 0) return 0;
+
+    size_t pos = static_cast<size_t>(tail) & (capacity_ - 1);
+    size_t first = std::min(size, capacity_ - pos);
+    std::memcpy(out_data, data_ + pos, first);
+    std::memcpy(static_cast<uint8_t*>(out_data) + first, data_, size - first);
+
+    header_->tail.store(tail + size, std::memory_order_release);
+    return size;
+}
+
+void Ring::Wait(uint32_t seen, const std::chrono::milliseconds& timeout) {
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    ts.tv_nsec = static_cast<long>(timeout.count() % 1000) * 1000000;
+
+    // announce the sleeper before the futex compares event with seen, hence a
+    // Notify() either changed event before or sees the sleeper and wakes us.
+    header_->sleepers.fetch_add(1);
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->event),
+              FUTEX_WAIT, seen, &ts, nullptr, 0);
+    header_->sleepers.fetch_sub(1);
+}
+
+bool Ring::Notify() {
+    header_->event.fetch_add(1);
+
+    if (header_->sleepers.load() != 0) {
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->event),
+                  FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    // pairs with the fence in RequestDoorbell(): either the consumer sees our
+    // change, or we see its doorbell request.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    return header_->doorbell.load(std::memory_order_relaxed) != 0 &&
+           header_->doorbell.exchange(0) != 0;
+}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+/******************************************************************************/
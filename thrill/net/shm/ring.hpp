@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * thrill/net/shm/ring.hpp
+ *
+ * Single-producer single-consumer byte ring buffer in a POSIX shared memory
+ * segment, with futex wakeups between processes.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_NET_SHM_RING_HEADER
+#define THRILL_NET_SHM_RING_HEADER
+
+#include <thrill/common/config.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+//! \addtogroup net_shm Shared Memory API
+//! \ingroup net
+//! \{
+
+/*!
+ * A POSIX shared memory object mapped into the address space. The mapping is
+ * released on destruction, the name must be removed explicitly via Unlink()
+ * once all processes have opened it.
+ */
+class Segment
+{
+public:
+    //! default constructor: no mapping
+    Segment() = default;
+
+    //! create a new named shared memory object of the given size and map it.
+    static Segment Create(const std::string& name, size_t size);
+
+    //! open and map an existing named shared memory object.
+    static Segment Open(const std::string& name);
+
+    //! remove the name of a shared memory object, mappings stay valid.
+    static void Unlink(const std::string& name);
+
+    //! non-copyable: delete copy-constructor
+    Segment(const Segment&) = delete;
+    //! non-copyable: delete assignment operator
+    Segment& operator = (const Segment&) = delete;
+
+    //! move-constructor
+    Segment(Segment&& s) noexcept
+        : data_(s.data_), size_(s.size_) {
+        s.data_ = nullptr, s.size_ = 0;
+    }
+    //! move-assignment operator
+    Segment& operator = (Segment&& s) noexcept {
+        if (this == &s) return *this;
+        Release();
+        data_ = s.data_, size_ = s.size_;
+        s.data_ = nullptr, s.size_ = 0;
+        return *this;
+    }
+
+    ~Segment() { Release(); }
+
+    //! address of the mapping
+    void * data() const { return data_; }
+
+    //! size of the mapping
+    size_t size() const { return size_; }
+
+private:
+    //! address of the mapping
+    void* data_ = nullptr;
+
+    //! size of the mapping
+    size_t size_ = 0;
+
+    //! map the shared memory object fd and close it.
+    static Segment Map(int fd, size_t size, const std::string& name);
+
+    //! unmap the segment
+    void Release();
+};
+
+/*!
+ * A single-producer single-consumer byte ring buffer located in a shared
+ * memory Segment: one process writes, the peer process reads. The positions
+ * are free running 64-bit counters, hence no space is lost for distinguishing
+ * full from empty.
+ *
+ * The header additionally contains the wakeup state of the consumer: the
+ * futex word event is bumped by the peer after each change of either ring of a
+ * connection, and the consumer sleeps on it in Wait(). Consumers waiting in a
+ * Dispatcher cannot sleep on a futex, instead they set the doorbell flag, and
+ * the peer rings the doorbell socket once when seeing it.
+ */
+class Ring
+{
+public:
+    //! shared header of the ring, followed by the data area
+    struct Header {
+        //! write position, advanced by the producer
+        alignas(common::g_cache_line_size) std::atomic<uint64_t> head;
+        //! read position, advanced by the consumer
+        alignas(common::g_cache_line_size) std::atomic<uint64_t> tail;
+        //! futex word of the consumer, bumped by the producer process
+        alignas(common::g_cache_line_size) std::atomic<uint32_t> event;
+        //! number of consumer threads sleeping on event
+        std::atomic<uint32_t> sleepers;
+        //! set by the consumer to request a ring of the doorbell socket
+        std::atomic<uint32_t> doorbell;
+        //! set when either side closed the connection
+        std::atomic<uint32_t> closed;
+        //! size of the data area, a power of two
+        uint64_t capacity;
+    };
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+                  ATOMIC_INT_LOCK_FREE == 2,
+                  "futex words must be plain lock-free 32-bit integers");
+
+    //! default constructor: invalid ring
+    Ring() = default;
+
+    //! Attach to a ring in a Segment, which is initialized if create is set.
+    Ring(Segment&& segment, bool create);
+
+    //! move-constructor
+    Ring(Ring&& r) noexcept
+        : segment_(std::move(r.segment_)), header_(r.header_),
+          data_(r.data_), capacity_(r.capacity_) {
+        r.header_ = nullptr, r.data_ = nullptr, r.capacity_ = 0;
+    }
+    //! move-assignment operator
+    Ring& operator = (Ring&& r) noexcept {
+        if (this == &r) return *this;
+        segment_ = std::move(r.segment_);
+        header_ = r.header_, data_ = r.data_, capacity_ = r.capacity_;
+        r.header_ = nullptr, r.data_ = nullptr, r.capacity_ = 0;
+        return *this;
+    }
+
+    //! size of a Segment holding a ring of the given capacity
+    static size_t SegmentSize(size_t capacity) {
+        return sizeof(Header) + capacity;
+    }
+
+    //! whether the ring is attached to a Segment
+    bool IsValid() const { return header_ != nullptr; }
+
+    //! \name Producer and Consumer Methods
+    //! \{
+
+    //! Copy up to size bytes into the ring, returns the number written.
+    size_t Write(const void* data, size_t size);
+
+    //! Copy up to size bytes out of the ring, returns the number read.
+    size_t Read(void* out_data, size_t size);
+
+    //! number of bytes that can be read
+    size_t readable() const {
+        return static_cast<size_t>(
+            header_->head.load(std::memory_order_acquire) -
+            header_->tail.load(std::memory_order_relaxed));
+    }
+
+    //! number of bytes that can be written
+    size_t writable() const {
+        return capacity_ - static_cast<size_t>(
+            header_->head.load(std::memory_order_relaxed) -
+            header_->tail.load(std::memory_order_acquire));
+    }
+
+    //! \}
+
+    //! \name Wakeup and Shutdown
+    //! \{
+
+    //! current value of the consumer's futex word, pass it to Wait().
+    uint32_t event() const { return header_->event.load(); }
+
+    //! Consumer: sleep until the event word differs from seen, or timeout.
+    void Wait(uint32_t seen, const std::chrono::milliseconds& timeout);
+
+    //! Producer: wake the consumer after a change, returns true if the
+    //! consumer's dispatcher requested a ring of the doorbell socket.
+    bool Notify();
+
+    //! Consumer: request a ring of the doorbell socket on the next Notify().
+    //! Check the rings again afterwards, a change may have raced the request.
+    void RequestDoorbell() {
+        header_->doorbell.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    //! mark the ring as closed for both sides
+    void Close() { if (header_) header_->closed.store(1); }
+
+    //! whether the ring was closed by either side
+    bool closed() const { return header_->closed.load() != 0; }
+
+    //! \}
+
+private:
+    //! shared memory segment containing the ring
+    Segment segment_;
+
+    //! header at the beginning of the segment
+    Header* header_ = nullptr;
+
+    //! data area following the header
+    uint8_t* data_ = nullptr;
+
+    //! copy of header_->capacity
+    size_t capacity_ = 0;
+};
+
+//! \}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+#endif // !THRILL_NET_SHM_RING_HEADER
+
+/******************************************************************************/
@@ -19,6 +19,8 @@
 #include <thrill/net/connection.hpp>
 #include <thrill/net/tcp/socket.hpp>
 
+#include <tlx/unused.hpp>
+
 #include <cassert>
 #include <cerrno>
 #include <cstdio>
@@ -166,6 +168,7 @@ public:
         if (socket_.send(data, size, f) != static_cast<ssize_t>(size))
             throw Exception("Error during SyncSend", errno);
         tx_bytes_ += size;
+        ++tx_sends_;
     }
 
     ssize_t SendOne(const void* data, size_t size, Flags flags) final {
@@ -177,6 +180,28 @@ public:
         if (flags & MsgMore) f |= MSG_MORE;
         ssize_t wb = socket_.send_one(data, size, f);
         if (wb > 0) tx_bytes_ += wb;
+        ++tx_sends_;
+        return wb;
+    }
+
+    //! Non-blocking send of the scatter/gather list iov[0,iovcnt) in one
+    //! system call, optionally with MSG_ZEROCOPY. Returns the number of bytes
+    //! sent, check errno for errors.
+    ssize_t SendVectorOne(const struct iovec* iov, size_t iovcnt,
+                          bool zerocopy = false) {
+#if __APPLE__
+        // MacOSX has no MSG_DONTWAIT
+        SetNonBlocking(true);
+#endif
+        int f = MSG_DONTWAIT;
+#if THRILL_NET_TCP_HAVE_ZEROCOPY
+        if (zerocopy) f |= MSG_ZEROCOPY;
+#else
+        tlx::unused(zerocopy);
+#endif
+        ssize_t wb = socket_.send_vector_one(iov, iovcnt, f);
+        if (wb > 0) tx_bytes_ += wb;
+        ++tx_sends_;
         return wb;
     }
 
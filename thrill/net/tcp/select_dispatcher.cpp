@@ -12,12 +12,16 @@
 
 #include <thrill/net/tcp/select_dispatcher.hpp>
 
+#include <sys/uio.h>
+
 #include <sstream>
 
 namespace thrill {
 namespace net {
 namespace tcp {
 
+size_t zerocopy_threshold = 0;
+
 //! Run one iteration of dispatching select().
 void SelectDispatcher::DispatchOne(const std::chrono::milliseconds& timeout) {
 
@@ -59,6 +63,11 @@ void SelectDispatcher::DispatchOne(const std::chrono::milliseconds& timeout) {
 
     int r = fdset.select_timeout(static_cast<double>(timeout.count()));
 
+    // completions of zero-copy sends arrive on the error queue, which also
+    // marks the socket readable: always collect them to release the items.
+    if (num_zerocopy_pending_ != 0)
+        ReapZeroCopy();
+
     if (r < 0) {
         // if we caught a signal, this is intended to interrupt a select().
         if (errno == EINTR) {
@@ -161,6 +170,203 @@ void SelectDispatcher::DispatchOne(const std::chrono::milliseconds& timeout) {
     }
 }
 
+void SelectDispatcher::QueueWrite(net::Connection& c, QueuedWrite&& item) {
+    assert(dynamic_cast<Connection*>(&c));
+    Connection& tc = static_cast<Connection&>(c);
+    int fd = tc.GetSocket().fd();
+    CheckSize(fd);
+
+    Watch& w = watch_[fd];
+    if (!w.write_queue)
+        w.write_queue = std::make_unique<WriteQueue>(&tc);
+
+    WriteQueue* q = w.write_queue.get();
+    if (q->conn != &tc) {
+        if (q->conn != nullptr) {
+            // the fd was reused without Cancel(), hence the old socket is
+            // closed: drop its items, the kernel released zero-copy pages.
+            num_queued_writes_ -= q->queue.size();
+            num_zerocopy_pending_ -= q->zerocopy_pending.size();
+            q->queue.clear();
+            q->zerocopy_pending.clear();
+            q->offset = 0;
+            q->zerocopy_calls = 0;
+            q->zerocopy_state = 0;
+        }
+        q->conn = &tc;
+    }
+
+    q->queue.emplace_back(std::move(item));
+    ++num_queued_writes_;
+
+    if (q->active) return;
+
+    q->active = true;
+    AddWrite(tc, Callback([this, q]() { return WriteQueueCallback(q); }));
+}
+
+bool SelectDispatcher::WriteQueueCallback(WriteQueue* q) {
+    if (q->queue.empty()) {
+        q->active = false;
+        return false;
+    }
+
+    // gather front items of the queue into an iovec array
+    struct iovec iov[max_iovecs_];
+    size_t iovcnt = 0, total = 0;
+
+    for (auto it = q->queue.begin();
+         it != q->queue.end() && iovcnt < max_iovecs_; ++it, ++iovcnt)
+    {
+        size_t skip = (iovcnt == 0 ? q->offset : 0);
+        iov[iovcnt].iov_base = const_cast<uint8_t*>(it->data() + skip);
+        iov[iovcnt].iov_len = it->size() - skip;
+        total += iov[iovcnt].iov_len;
+    }
+
+    bool zerocopy = false;
+    if (zerocopy_threshold != 0 && total >= zerocopy_threshold) {
+        if (q->zerocopy_state == 0)
+            q->zerocopy_state = q->conn->GetSocket().SetZeroCopy() ? 1 : -1;
+        zerocopy = (q->zerocopy_state > 0);
+    }
+
+    ssize_t r = q->conn->SendVectorOne(iov, iovcnt, zerocopy);
+
+    if (r < 0 && zerocopy && errno == ENOBUFS) {
+        // pinning the pages exceeded the socket's option memory, copy instead.
+        zerocopy = false;
+        r = q->conn->SendVectorOne(iov, iovcnt, false);
+    }
+
+    if (r <= 0) {
+        if (errno == EINTR || errno == EAGAIN) return true;
+
+        if (errno == EPIPE) {
+            LOG1 << "SelectDispatcher() got EPIPE";
+            // signal artificial completion, for clean up.
+            q->offset = 0;
+            while (!q->queue.empty())
+                CompleteWrite(q);
+            q->active = false;
+            return false;
+        }
+        throw Exception("SelectDispatcher() error in sendmsg", errno);
+    }
+
+    // the kernel numbers successful zero-copy send calls consecutively
+    uint32_t zerocopy_id = zerocopy ? q->zerocopy_calls++ : 0;
+
+    sLOG << "SelectDispatcher::WriteQueueCallback()"
+         << "iovcnt" << iovcnt << "total" << total << "sent" << r
+         << "zerocopy" << zerocopy;
+
+    // advance over items sent completely, and into a partially sent one
+    size_t sent = static_cast<size_t>(r);
+    while (sent != 0 && !q->queue.empty())
+    {
+        QueuedWrite& front = q->queue.front();
+        if (zerocopy) {
+            front.zerocopy = true;
+            front.zerocopy_id = zerocopy_id;
+        }
+
+        size_t rest = front.size() - q->offset;
+        if (sent < rest) {
+            q->offset += sent;
+            break;
+        }
+
+        sent -= rest;
+        q->offset = 0;
+        CompleteWrite(q);
+    }
+
+    if (q->queue.empty()) {
+        q->active = false;
+        return false;
+    }
+    return true;
+}
+
+void SelectDispatcher::CompleteWrite(WriteQueue* q) {
+    QueuedWrite item = std::move(q->queue.front());
+    q->queue.pop_front();
+    --num_queued_writes_;
+
+    AsyncWriteCallback callback = item.callback;
+
+    if (item.zerocopy) {
+        // the kernel may still read the data: hold it until completion.
+        item.callback = AsyncWriteCallback();
+        q->zerocopy_pending.emplace_back(std::move(item));
+        ++num_zerocopy_pending_;
+    }
+
+    if (callback) callback(*q->conn);
+}
+
+void SelectDispatcher::ReapZeroCopy() {
+    for (Watch& w : watch_)
+    {
+        if (!w.write_queue || !w.write_queue->conn ||
+            w.write_queue->zerocopy_pending.empty())
+            continue;
+
+        WriteQueue& q = *w.write_queue;
+        ReapZeroCopy(q.conn->GetSocket(), q.zerocopy_pending);
+    }
+
+    for (auto it = zerocopy_orphans_.begin(); it != zerocopy_orphans_.end(); )
+    {
+        ReapZeroCopy(it->socket, it->pending);
+        // closes the duplicate socket
+        if (it->pending.empty())
+            it = zerocopy_orphans_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void SelectDispatcher::ReapZeroCopy(
+    Socket& socket, QueuedWriteDeque& pending) {
+    uint32_t lo, hi;
+    while (socket.RecvZeroCopyCompletion(&lo, &hi))
+    {
+        // TCP completes send calls in order, compare ids modulo 2^32.
+        while (!pending.empty() &&
+               static_cast<int32_t>(pending.front().zerocopy_id - hi) <= 0)
+        {
+            pending.pop_front();
+            --num_zerocopy_pending_;
+        }
+    }
+}
+
+void SelectDispatcher::OrphanZeroCopy(WriteQueue& q) {
+    if (q.conn && !q.zerocopy_pending.empty()) {
+        ReapZeroCopy(q.conn->GetSocket(), q.zerocopy_pending);
+
+        if (!q.zerocopy_pending.empty()) {
+            int fd = ::dup(q.conn->GetSocket().fd());
+            if (fd < 0)
+                throw Exception("SelectDispatcher() error in dup", errno);
+            zerocopy_orphans_.emplace_back(
+                ZeroCopyOrphan {
+                    Socket(fd, /* loopback_socket */ true),
+                    std::move(q.zerocopy_pending)
+                });
+            q.zerocopy_pending.clear();
+        }
+    }
+
+    // the kernel numbers zero-copy sends per socket, and a later Connection
+    // on the fd may or may not be the same socket. Hence a queue which sent
+    // with MSG_ZEROCOPY does not use it again, since its completions could
+    // not be matched, otherwise SO_ZEROCOPY is set again if needed.
+    q.zerocopy_state = (q.zerocopy_calls != 0 ? -1 : 0);
+}
+
 void SelectDispatcher::Interrupt() {
     // there are multiple very platform-dependent ways to do this. we'll try
     // to use the self-pipe trick for now. The select() method waits on
@@ -34,6 +34,7 @@
 #include <csignal>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace thrill {
@@ -43,10 +44,21 @@ namespace tcp {
 //! \addtogroup net_tcp TCP Socket API
 //! \{
 
+//! minimum size of vectored sends to transmit with MSG_ZEROCOPY, zero disables
+//! zero-copy sends. Set via THRILL_NET_ZEROCOPY.
+extern size_t zerocopy_threshold;
+
 /*!
  * SelectDispatcher is a higher level wrapper for select(). One can register
  * Socket objects for readability and writability checks, buffered reads and
  * writes with completion callbacks, and also timer functions.
+ *
+ * AsyncWrite()s of Buffers and Blocks are appended to a write queue per
+ * connection, which is sent with vectored sendmsg() calls over up to
+ * max_iovecs_ items. Hence, the multiplexer's small headers and the payload of
+ * small Blocks are coalesced into few system calls and TCP segments. Large
+ * vectored sends can additionally use MSG_ZEROCOPY, in which case the items
+ * are held until the kernel signals completion on the socket's error queue.
  */
 class SelectDispatcher final : public net::Dispatcher
 {
@@ -54,6 +66,9 @@ class SelectDispatcher final : public net::Dispatcher
 
     static constexpr bool self_verify_ = common::g_self_verify;
 
+    //! maximum number of items sent with one sendmsg()
+    static constexpr size_t max_iovecs_ = 64;
+
 public:
     //! type for file descriptor readiness callbacks
     using Callback = AsyncCallback;
@@ -131,6 +146,43 @@ public:
         watch_[fd].write_cb.emplace_back(write_cb);
     }
 
+    //! asynchronously write buffer and callback when delivered. The buffer is
+    //! MOVED into the connection's write queue.
+    void AsyncWrite(
+        net::Connection& c, uint32_t /* seq */, Buffer&& buffer,
+        const AsyncWriteCallback& done_cb = AsyncWriteCallback()) final {
+        assert(c.IsValid());
+
+        if (buffer.size() == 0) {
+            if (done_cb) done_cb(c);
+            return;
+        }
+
+        QueueWrite(c, QueuedWrite(std::move(buffer), done_cb));
+    }
+
+    //! asynchronously write block and callback when delivered. The block is
+    //! MOVED into the connection's write queue.
+    void AsyncWrite(
+        net::Connection& c, uint32_t /* seq */, data::PinnedBlock&& block,
+        const AsyncWriteCallback& done_cb = AsyncWriteCallback()) final {
+        assert(c.IsValid());
+
+        if (block.size() == 0) {
+            if (done_cb) done_cb(c);
+            return;
+        }
+
+        QueueWrite(c, QueuedWrite(std::move(block), done_cb));
+    }
+
+    //! Check whether there are still AsyncWrite()s in the queues, or data held
+    //! for unfinished zero-copy sends.
+    bool HasAsyncWrites() const final {
+        return net::Dispatcher::HasAsyncWrites() ||
+               num_queued_writes_ != 0 || num_zerocopy_pending_ != 0;
+    }
+
     //! Register a buffered write callback and a default exception callback.
     void SetExcept(net::Connection& c, const Callback& except_cb) {
         assert(dynamic_cast<Connection*>(&c));
@@ -165,6 +217,18 @@ public:
         w.write_cb.clear();
         w.except_cb = Callback();
         w.active = false;
+
+        if (w.write_queue) {
+            // keep the WriteQueue object, a callback may still reference it,
+            // but detach it from the Connection, which may be destroyed.
+            WriteQueue& q = *w.write_queue;
+            num_queued_writes_ -= q.queue.size();
+            q.queue.clear();
+            q.offset = 0;
+            q.active = false;
+            OrphanZeroCopy(q);
+            q.conn = nullptr;
+        }
     }
 
     //! Run one iteration of dispatching select().
@@ -183,6 +247,61 @@ private:
     //! buffer to receive one byte signals from self-pipe
     char self_pipe_buffer_[32];
 
+    //! a Buffer or Block in a write queue, with its completion callback
+    struct QueuedWrite {
+        //! send buffer, if not a block
+        Buffer                  buffer;
+        //! send block, holds a pin on the underlying ByteBlock
+        data::PinnedBlock       block;
+        //! functional object to call once data is sent
+        AsyncWriteCallback      callback;
+        //! whether parts were sent with MSG_ZEROCOPY
+        bool                    zerocopy = false;
+        //! id of the last zero-copy send call covering the data
+        uint32_t                zerocopy_id = 0;
+
+        QueuedWrite(Buffer&& _buffer, const AsyncWriteCallback& _callback)
+            : buffer(std::move(_buffer)), callback(_callback) { }
+
+        QueuedWrite(data::PinnedBlock&& _block,
+                    const AsyncWriteCallback& _callback)
+            : block(std::move(_block)), callback(_callback) { }
+
+        //! pointer to the data to send
+        const uint8_t * data() const {
+            return block.IsValid() ? block.data_begin() : buffer.data();
+        }
+
+        //! size of the data to send
+        size_t size() const {
+            return block.IsValid() ? block.size() : buffer.size();
+        }
+    };
+
+    //! deque of QueuedWrite items
+    using QueuedWriteDeque =
+        std::deque<QueuedWrite, mem::GPoolAllocator<QueuedWrite> >;
+
+    //! outgoing data of a connection, sent with vectored writes
+    struct WriteQueue {
+        //! connection of the queue, nullptr after Cancel()
+        Connection* conn;
+        //! items waiting to be sent
+        QueuedWriteDeque queue;
+        //! bytes of queue.front() already sent
+        size_t offset = 0;
+        //! whether the write callback of the queue is registered
+        bool active = false;
+        //! sent items which may still be referenced by zero-copy sends
+        QueuedWriteDeque zerocopy_pending;
+        //! number of zero-copy send calls issued, the kernel's counter
+        uint32_t zerocopy_calls = 0;
+        //! state of SO_ZEROCOPY: 0 = unknown, 1 = enabled, -1 = unsupported
+        int zerocopy_state = 0;
+
+        explicit WriteQueue(Connection* _conn) : conn(_conn) { }
+    };
+
     //! callback vectors per watched file descriptor
     struct Watch {
         //! boolean check whether any callbacks are registered
@@ -192,6 +311,10 @@ private:
                  read_cb, write_cb;
         //! only one exception callback for the fd.
         Callback except_cb;
+        //! queue of AsyncWrite()s on the fd, allocated on demand. It is not
+        //! moved when watch_ grows, hence the write callback can keep a
+        //! pointer to it.
+        std::unique_ptr<WriteQueue> write_queue;
     };
 
     //! handlers for all registered file descriptors. the fd integer range
@@ -199,6 +322,44 @@ private:
     //! needed.
     std::vector<Watch> watch_;
 
+    //! number of items in all write queues
+    size_t num_queued_writes_ = 0;
+
+    //! number of items held for unfinished zero-copy sends
+    size_t num_zerocopy_pending_ = 0;
+
+    //! items of unfinished zero-copy sends of a cancelled Connection, with a
+    //! duplicate of its socket, which keeps the socket and its error queue
+    //! alive until all completions were reaped.
+    struct ZeroCopyOrphan {
+        Socket           socket;
+        QueuedWriteDeque pending;
+    };
+
+    //! zero-copy sends of cancelled Connections
+    std::deque<ZeroCopyOrphan> zerocopy_orphans_;
+
+    //! Append an item to the connection's write queue and register the queue's
+    //! write callback, if it is not already active.
+    void QueueWrite(net::Connection& c, QueuedWrite&& item);
+
+    //! Write callback of a queue: send a batch of queued items with one
+    //! vectored send, returns true if more data is waiting.
+    bool WriteQueueCallback(WriteQueue* q);
+
+    //! Remove the front item from the write queue and run its callback.
+    void CompleteWrite(WriteQueue* q);
+
+    //! Release items of finished zero-copy sends of all write queues.
+    void ReapZeroCopy();
+
+    //! Release items of pending whose zero-copy sends on socket finished.
+    void ReapZeroCopy(Socket& socket, QueuedWriteDeque& pending);
+
+    //! Move the unfinished zero-copy sends of a queue whose Connection is
+    //! cancelled to zerocopy_orphans_, and reset its zero-copy state.
+    void OrphanZeroCopy(WriteQueue& q);
+
     //! Default exception handler
     static bool DefaultExceptionCallback() {
         throw Exception("SelectDispatcher() exception on socket!", errno);
@@ -12,10 +12,16 @@
 
 #include <thrill/net/tcp/socket.hpp>
 
+#include <tlx/unused.hpp>
+
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 
+#if THRILL_NET_TCP_HAVE_ZEROCOPY
+#include <linux/errqueue.h>
+#endif
+
 namespace thrill {
 namespace net {
 namespace tcp {
@@ -78,6 +84,70 @@ void Socket::SetNoDelay(bool activate) {
 #endif
 }
 
+bool Socket::SetZeroCopy(bool activate) {
+    assert(IsValid());
+
+#if THRILL_NET_TCP_HAVE_ZEROCOPY
+    int sockoptflag = (activate ? 1 : 0);
+
+    /* SO_ZEROCOPY enables the MSG_ZEROCOPY flag of send calls: the kernel
+       then pins the user pages and transmits from them, and it signals
+       completion of each send call via the socket's error queue. */
+    if (::setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY,
+                     &sockoptflag, sizeof(sockoptflag)) != 0)
+    {
+        LOG << "Cannot set SO_ZEROCOPY on socket fd " << fd_
+            << ": " << strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    tlx::unused(activate);
+    return false;
+#endif
+}
+
+bool Socket::RecvZeroCopyCompletion(uint32_t* lo, uint32_t* hi) {
+    assert(IsValid());
+
+#if THRILL_NET_TCP_HAVE_ZEROCOPY
+    while (true)
+    {
+        char control[128];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        if (::recvmsg(fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            return false;
+
+        for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+             cm = CMSG_NXTHDR(&msg, cm))
+        {
+            if (!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                  (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)))
+                continue;
+
+            struct sock_extended_err serr;
+            memcpy(&serr, CMSG_DATA(cm), sizeof(serr));
+
+            if (serr.ee_errno != 0 ||
+                serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+
+            *lo = serr.ee_info;
+            *hi = serr.ee_data;
+            return true;
+        }
+        // other error message: skip it
+    }
+#else
+    tlx::unused(lo, hi);
+    return false;
+#endif
+}
+
 void Socket::SetSndBuf(size_t size) {
     assert(IsValid());
 
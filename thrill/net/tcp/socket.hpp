@@ -24,6 +24,7 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <cassert>
@@ -32,6 +33,11 @@
 #include <string>
 #include <utility>
 
+// zero-copy sends with completion notifications on the error queue (Linux 4.14)
+#if defined(__linux__) && defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+#define THRILL_NET_TCP_HAVE_ZEROCOPY 1
+#endif
+
 namespace thrill {
 namespace net {
 namespace tcp {
@@ -412,6 +418,31 @@ public:
         return wb;
     }
 
+    //! Send the scatter/gather list iov[0,iovcnt) to socket in one sendmsg()
+    //! call, returns the number of bytes sent, which may be short.
+    ssize_t send_vector_one(const struct iovec* iov, size_t iovcnt,
+                            int flags = 0) {
+        assert(IsValid());
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = const_cast<struct iovec*>(iov);
+        msg.msg_iovlen = iovcnt;
+
+        LOG << "Socket::send_vector_one()"
+            << " fd_=" << fd_
+            << " iovcnt=" << iovcnt
+            << " flags=" << flags;
+
+        ssize_t r = ::sendmsg(fd_, &msg, flags);
+
+        LOG << "done Socket::send_vector_one()"
+            << " fd_=" << fd_
+            << " return=" << r;
+
+        return r;
+    }
+
     //! Send (data,size) to destination
     ssize_t sendto(const void* data, size_t size, int flags,
                    const SocketAddress& dest) {
@@ -590,6 +621,15 @@ public:
     //! sent as soon as possible, even if there is only a small amount of data.
     void SetNoDelay(bool activate = true);
 
+    //! Enable SO_ZEROCOPY, which allows sends with MSG_ZEROCOPY. Returns false
+    //! if not supported by the kernel.
+    bool SetZeroCopy(bool activate = true);
+
+    //! Receive one notification from the error queue about completed
+    //! MSG_ZEROCOPY sends, which covers the send calls in the range [lo,hi].
+    //! Returns false if no notification is available.
+    bool RecvZeroCopyCompletion(uint32_t* lo, uint32_t* hi);
+
     //! Set SO_SNDBUF socket option.
     void SetSndBuf(size_t size);
 
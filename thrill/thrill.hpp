@@ -56,8 +56,10 @@ print "#include <$_>\n" foreach sort glob("thrill/api/"."*.hpp");
 #include <thrill/api/union.hpp>
 #include <thrill/api/window.hpp>
 #include <thrill/api/write_binary.hpp>
+#include <thrill/api/write_binary_one.hpp>
 #include <thrill/api/write_lines.hpp>
 #include <thrill/api/write_lines_one.hpp>
+#include <thrill/api/write_shared_file.hpp>
 #include <thrill/api/zip.hpp>
 #include <thrill/api/zip_window.hpp>
 #include <thrill/api/zip_with_index.hpp>
@@ -233,6 +233,47 @@ WriteStreamPtr OpenWriteStream(const std::string& path) {
     return p;
 }
 
+WriteAtStream::~WriteAtStream() { }
+
+bool IsWriteAtSupported(const std::string& path) {
+    if (IsRemoteUri(path) || IsCompressed(path))
+        return false;
+
+    if (tlx::starts_with(path, "file://"))
+        return SysIsWriteAtSupported(path.substr(7));
+
+    return SysIsWriteAtSupported(path);
+}
+
+WriteAtStreamPtr OpenWriteAtStream(
+    const std::string& path, bool create, uint64_t size) {
+
+    if (tlx::starts_with(path, "file://"))
+        return SysOpenWriteAtStream(path.substr(7), create, size);
+
+    return SysOpenWriteAtStream(path, create, size);
+}
+
+ReadAtStream::~ReadAtStream() { }
+
+bool IsReadAtSupported(const std::string& path) {
+    if (IsRemoteUri(path) || IsCompressed(path))
+        return false;
+
+    if (tlx::starts_with(path, "file://"))
+        return SysIsReadAtSupported(path.substr(7));
+
+    return SysIsReadAtSupported(path);
+}
+
+ReadAtStreamPtr OpenReadAtStream(const std::string& path) {
+
+    if (tlx::starts_with(path, "file://"))
+        return SysOpenReadAtStream(path.substr(7));
+
+    return SysOpenReadAtStream(path);
+}
+
 } // namespace vfs
 } // namespace thrill
 
@@ -142,8 +142,42 @@ public:
     virtual void close() = 0;
 };
 
+/*!
+ * Writer object for writing data at given byte offsets into a file, which may
+ * be shared by multiple workers writing disjoint byte ranges.
+ */
+class WriteAtStream : public virtual tlx::ReferenceCounter
+{
+public:
+    virtual ~WriteAtStream();
+
+    //! write size bytes at the given byte offset in the file.
+    virtual void write_at(const void* data, size_t size, uint64_t offset) = 0;
+
+    virtual void close() = 0;
+};
+
+/*!
+ * Reader object for reading data at given byte offsets from a file, which
+ * allows workers to read disjoint byte ranges of the same file in large chunks
+ * without a shared stream position.
+ */
+class ReadAtStream : public virtual tlx::ReferenceCounter
+{
+public:
+    virtual ~ReadAtStream();
+
+    //! read size bytes at the given byte offset in the file. Returns fewer
+    //! bytes only if the end of the file is reached.
+    virtual size_t read_at(void* data, size_t size, uint64_t offset) = 0;
+
+    virtual void close() = 0;
+};
+
 using ReadStreamPtr = tlx::CountingPtr<ReadStream>;
 using WriteStreamPtr = tlx::CountingPtr<WriteStream>;
+using WriteAtStreamPtr = tlx::CountingPtr<WriteAtStream>;
+using ReadAtStreamPtr = tlx::CountingPtr<ReadAtStream>;
 
 /******************************************************************************/
 
@@ -152,7 +186,8 @@ using WriteStreamPtr = tlx::CountingPtr<WriteStream>;
  * file to read. If e = 0, the complete file is read.
  *
  * For the POSIX SysFile implementation the range is used only to seek to the
- * byte offset b. It allows additional bytes after e to be read.
+ * byte offset b. It allows additional bytes after e to be read. Regular files
+ * read via io_uring, however, stop at e, since they read ahead up to it.
  *
  * For the S3File implementations, however, the range[b,e) is used to determine
  * which data to fetch from S3. Hence, once e is reached, read() will return
@@ -163,6 +198,34 @@ ReadStreamPtr OpenReadStream(
 
 WriteStreamPtr OpenWriteStream(const std::string& path);
 
+/*!
+ * Returns true, if path can be written at offsets with OpenWriteAtStream().
+ * This is the case for uncompressed local files, which either do not exist yet
+ * or are regular files, but not for pipes, devices, or remote uris.
+ */
+bool IsWriteAtSupported(const std::string& path);
+
+/*!
+ * Construct writer for writing at offsets into the file at path, which must
+ * satisfy IsWriteAtSupported(). If create is true, the file is created or
+ * truncated, and then resized to size bytes. Otherwise, an existing file is
+ * opened and size is ignored.
+ */
+WriteAtStreamPtr OpenWriteAtStream(
+    const std::string& path, bool create, uint64_t size = 0);
+
+/*!
+ * Returns true, if path can be read at offsets with OpenReadAtStream(). This is
+ * the case for uncompressed local regular files.
+ */
+bool IsReadAtSupported(const std::string& path);
+
+/*!
+ * Construct reader for reading at offsets from the file at path, which must
+ * satisfy IsReadAtSupported().
+ */
+ReadAtStreamPtr OpenReadAtStream(const std::string& path);
+
 /******************************************************************************/
 
 } // namespace vfs
@@ -0,0 +1,201 @@
+/*******************************************************************************
+ * thrill/vfs/io_uring.cpp
+ *
+ * Minimal wrapper of a Linux io_uring submission and completion queue pair,
+ * using the raw system calls.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/vfs/io_uring.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <thrill/common/logger.hpp>
+#include <thrill/common/system_exception.hpp>
+
+#include <tlx/die.hpp>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace thrill {
+namespace vfs {
+
+IoUring::IoUring(unsigned entries) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+
+    fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+    if (fd_ < 0)
+        throw common::ErrnoException("io_uring_setup() failed", errno);
+
+    sq_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_size_ = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    sqes_size_ = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    sq_ptr_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    cq_ptr_ = ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+    void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+
+    if (sq_ptr_ == MAP_FAILED || cq_ptr_ == MAP_FAILED || sqes == MAP_FAILED) {
+        int err = errno;
+        if (sq_ptr_ != MAP_FAILED) ::munmap(sq_ptr_, sq_size_);
+        if (cq_ptr_ != MAP_FAILED) ::munmap(cq_ptr_, cq_size_);
+        if (sqes != MAP_FAILED) ::munmap(sqes, sqes_size_);
+        ::close(fd_);
+        throw common::ErrnoException("io_uring mmap() failed", err);
+    }
+
+    char* sq = reinterpret_cast<char*>(sq_ptr_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    sq_entries_ = p.sq_entries;
+
+    char* cq = reinterpret_cast<char*>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + p.cq_off.cqes);
+
+    sqes_ = reinterpret_cast<struct io_uring_sqe*>(sqes);
+}
+
+IoUring::~IoUring() {
+    // the kernel may still write into buffers of requests in flight
+    die_unless(in_flight_ == 0);
+
+    ::munmap(sqes_, sqes_size_);
+    ::munmap(cq_ptr_, cq_size_);
+    ::munmap(sq_ptr_, sq_size_);
+    ::close(fd_);
+}
+
+bool IoUring::IsSupported() {
+    static const bool supported = []() {
+        try {
+            IoUring ring(1);
+            return true;
+        }
+        catch (common::ErrnoException& e) {
+            LOG1 << "io_uring is not available: " << e.what();
+            return false;
+        }
+    } ();
+    return supported;
+}
+
+bool IoUring::RegisterBuffers(const struct iovec* iov, unsigned count) {
+    int r = static_cast<int>(
+        ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS,
+                  iov, count));
+    registered_ = (r == 0);
+    return registered_;
+}
+
+void IoUring::PrepareRead(int fd, const struct iovec* iov, uint64_t offset,
+                          unsigned buf_index, uint64_t user_data) {
+    Prepare(registered_ ? IORING_OP_READ_FIXED : IORING_OP_READV,
+            fd, iov, offset, buf_index, user_data);
+}
+
+void IoUring::PrepareWrite(int fd, const struct iovec* iov, uint64_t offset,
+                           unsigned buf_index, uint64_t user_data) {
+    Prepare(registered_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITEV,
+            fd, iov, offset, buf_index, user_data);
+}
+
+void IoUring::Prepare(int opcode, int fd, const struct iovec* iov,
+                      uint64_t offset, unsigned buf_index, uint64_t user_data) {
+    // we are the only producer, the kernel advances the head.
+    unsigned tail = *sq_tail_;
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+        Submit();
+        tail = *sq_tail_;
+    }
+
+    unsigned index = tail & *sq_mask_;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+
+    sqe->opcode = static_cast<uint8_t>(opcode);
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    if (registered_) {
+        sqe->addr = reinterpret_cast<uint64_t>(iov->iov_base);
+        sqe->len = static_cast<uint32_t>(iov->iov_len);
+        sqe->buf_index = static_cast<uint16_t>(buf_index);
+    }
+    else {
+        sqe->addr = reinterpret_cast<uint64_t>(iov);
+        sqe->len = 1;
+    }
+
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+    ++to_submit_;
+    ++in_flight_;
+}
+
+void IoUring::Submit() {
+    while (to_submit_ != 0) {
+        int r = Enter(to_submit_, 0, 0);
+        if (r < 0)
+            throw common::ErrnoException("io_uring_enter() failed", -r);
+        to_submit_ -= static_cast<unsigned>(r);
+    }
+}
+
+int32_t IoUring::WaitCompletion(uint64_t* user_data) {
+    assert(in_flight_ != 0);
+
+    while (true) {
+        unsigned head = *cq_head_;
+        if (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+            const struct io_uring_cqe* cqe = &cqes_[head & *cq_mask_];
+            *user_data = cqe->user_data;
+            int32_t res = cqe->res;
+            __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+            --in_flight_;
+            return res;
+        }
+
+        // submit queued requests and wait in the same system call
+        int r = Enter(to_submit_, 1, IORING_ENTER_GETEVENTS);
+        if (r < 0)
+            throw common::ErrnoException("io_uring_enter() failed", -r);
+        to_submit_ -= static_cast<unsigned>(r);
+    }
+}
+
+int IoUring::Enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    while (true) {
+        int r = static_cast<int>(
+            ::syscall(__NR_io_uring_enter, fd_, to_submit, min_complete,
+                      flags, nullptr, 0));
+        if (r >= 0) return r;
+        if (errno != EINTR) return -errno;
+    }
+}
+
+} // namespace vfs
+} // namespace thrill
+
+#endif // THRILL_HAVE_IO_URING
+
+/******************************************************************************/
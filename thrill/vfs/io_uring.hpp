@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * thrill/vfs/io_uring.hpp
+ *
+ * Minimal wrapper of a Linux io_uring submission and completion queue pair,
+ * using the raw system calls.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_VFS_IO_URING_HEADER
+#define THRILL_VFS_IO_URING_HEADER
+
+#include <thrill/common/config.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <cstddef>
+#include <cstdint>
+
+#include <sys/uio.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace thrill {
+namespace vfs {
+
+/*!
+ * An io_uring instance: a ring of submission queue entries, which are passed to
+ * the kernel in batches by Submit(), and a ring of completions. Reads and
+ * writes use registered buffers if RegisterBuffers() succeeded, which saves
+ * pinning the pages for each request, otherwise they fall back to vectored
+ * I/O. The iovec passed to PrepareRead() and PrepareWrite() must stay valid
+ * until the request completed.
+ *
+ * Not thread-safe, each stream owns its ring.
+ */
+class IoUring
+{
+public:
+    //! create ring with at least the given number of entries, throws an
+    //! ErrnoException if the kernel does not support io_uring.
+    explicit IoUring(unsigned entries);
+
+    //! non-copyable: delete copy-constructor
+    IoUring(const IoUring&) = delete;
+    //! non-copyable: delete assignment operator
+    IoUring& operator = (const IoUring&) = delete;
+
+    ~IoUring();
+
+    //! check once whether io_uring can be set up, e.g. it may be disabled by
+    //! seccomp filters in containers.
+    static bool IsSupported();
+
+    //! register the buffers with the kernel, returns false if this failed, for
+    //! example due to RLIMIT_MEMLOCK.
+    bool RegisterBuffers(const struct iovec* iov, unsigned count);
+
+    //! queue read of iov->iov_len bytes at offset into iov->iov_base, which
+    //! must lie in the registered buffer buf_index.
+    void PrepareRead(int fd, const struct iovec* iov, uint64_t offset,
+                     unsigned buf_index, uint64_t user_data);
+
+    //! queue write of iov->iov_len bytes at offset from iov->iov_base, which
+    //! must lie in the registered buffer buf_index.
+    void PrepareWrite(int fd, const struct iovec* iov, uint64_t offset,
+                      unsigned buf_index, uint64_t user_data);
+
+    //! submit all queued requests with one system call.
+    void Submit();
+
+    //! wait for the next completion, returns the result of the request, which
+    //! is the number of bytes transferred or a negative errno.
+    int32_t WaitCompletion(uint64_t* user_data);
+
+    //! number of submitted requests whose completion was not reaped yet.
+    size_t in_flight() const { return in_flight_; }
+
+private:
+    //! ring file descriptor
+    int fd_ = -1;
+
+    //! mapped submission queue ring and its size
+    void* sq_ptr_ = nullptr;
+    size_t sq_size_ = 0;
+
+    //! mapped completion queue ring and its size
+    void* cq_ptr_ = nullptr;
+    size_t cq_size_ = 0;
+
+    //! mapped submission queue entries and their size
+    struct io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    //! pointers into the submission queue ring
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_entries_ = 0;
+
+    //! pointers into the completion queue ring
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    struct io_uring_cqe* cqes_ = nullptr;
+
+    //! whether buffers are registered, use READ_FIXED/WRITE_FIXED
+    bool registered_ = false;
+
+    //! number of queued requests not yet passed to the kernel
+    unsigned to_submit_ = 0;
+
+    //! number of requests not completed
+    size_t in_flight_ = 0;
+
+    //! queue a request, submits the queue first if it is full.
+    void Prepare(int opcode, int fd, const struct iovec* iov, uint64_t offset,
+                 unsigned buf_index, uint64_t user_data);
+
+    //! io_uring_enter() retrying on EINTR
+    int Enter(unsigned to_submit, unsigned min_complete, unsigned flags);
+};
+
+} // namespace vfs
+} // namespace thrill
+
+#endif // THRILL_HAVE_IO_URING
+
+#endif // !THRILL_VFS_IO_URING_HEADER
+
+/******************************************************************************/
@@ -15,6 +15,7 @@
 #include <thrill/common/string.hpp>
 
 #include <tlx/die.hpp>
+#include <tlx/string/parse_si_iec_units.hpp>
 #include <tlx/string/split.hpp>
 #include <tlx/string/starts_with.hpp>
 
@@ -23,7 +24,12 @@
 #endif
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <limits>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -118,10 +124,16 @@ S3Status ResponsePropertiesCallback(
 static void FillS3BucketContext(S3BucketContext& bkt, const std::string& key) {
     memset(&bkt, 0, sizeof(bkt));
 
+    // plain HTTP and path-style URIs are needed for local S3 stand-ins
+    const char* protocol = getenv("THRILL_S3_PROTOCOL");
+    const char* uri_style = getenv("THRILL_S3_URI_STYLE");
+
     bkt.hostName = getenv("THRILL_S3_HOST");
     bkt.bucketName = key.c_str();
-    bkt.protocol = S3ProtocolHTTPS;
-    bkt.uriStyle = S3UriStyleVirtualHost;
+    bkt.protocol = protocol && strcmp(protocol, "http") == 0
+                   ? S3ProtocolHTTP : S3ProtocolHTTPS;
+    bkt.uriStyle = uri_style && strcmp(uri_style, "path") == 0
+                   ? S3UriStylePath : S3UriStyleVirtualHost;
     bkt.accessKeyId = getenv("THRILL_S3_KEY");
     bkt.secretAccessKey = getenv("THRILL_S3_SECRET");
     bkt.authRegion = getenv("THRILL_S3_REGION");
@@ -134,6 +146,62 @@ static void FillS3BucketContext(S3BucketContext& bkt, const std::string& key) {
     }
 }
 
+//! size of the parts of ranged GETs and multipart uploads, set via
+//! THRILL_S3_PART_SIZE. S3 requires at least 5 MiB for uploads.
+static size_t S3PartSize() {
+    uint64_t size = 16 * 1024 * 1024;
+
+    const char* env_size = getenv("THRILL_S3_PART_SIZE");
+    if (env_size && *env_size &&
+        (!tlx::parse_si_iec_units(env_size, &size) || size == 0)) {
+        die("S3-ERROR - THRILL_S3_PART_SIZE=" << env_size
+            << " is not a valid size.");
+    }
+    return size;
+}
+
+//! number of parts transferred concurrently by each stream, set via
+//! THRILL_S3_CONCURRENCY.
+static size_t S3Concurrency() {
+    const char* env_concurrency = getenv("THRILL_S3_CONCURRENCY");
+    if (env_concurrency == nullptr || *env_concurrency == 0) return 4;
+
+    char* endptr;
+    size_t concurrency = std::strtoul(env_concurrency, &endptr, 10);
+    if (!endptr || *endptr != 0 || concurrency == 0) {
+        die("S3-ERROR - THRILL_S3_CONCURRENCY=" << env_concurrency
+            << " is not a valid number of parts.");
+    }
+    return concurrency;
+}
+
+//! Wait for progress of the requests in a request context using select() and
+//! run their callbacks once. Returns the number of remaining requests.
+static int RunRequestContextOnce(S3RequestContext* req_ctx) {
+    fd_set read_fds, write_fds, except_fds;
+    FD_ZERO(&read_fds);
+    FD_ZERO(&write_fds);
+    FD_ZERO(&except_fds);
+    int max_fd;
+
+    S3Status status = S3_get_request_context_fdsets(
+        req_ctx, &read_fds, &write_fds, &except_fds, &max_fd);
+    die_unless(status == S3StatusOK);
+
+    if (max_fd != -1) {
+        int64_t timeout = S3_get_request_context_timeout(req_ctx);
+        struct timeval tv = { timeout / 1000, (timeout % 1000) * 1000 };
+        int r = select(max_fd + 1, &read_fds, &write_fds, &except_fds,
+                       /* timeout */ (timeout == -1) ? 0 : &tv);
+        die_unless(r >= 0);
+    }
+
+    // run callbacks
+    int remaining_requests = 0;
+    S3_runonce_request_context(req_ctx, &remaining_requests);
+    return remaining_requests;
+}
+
 /******************************************************************************/
 // List Bucket Contents on S3
 
@@ -289,45 +357,35 @@ void S3Glob(const std::string& _path, const GlobType& gtype,
 /******************************************************************************/
 // Stream Reading from S3
 
+/*!
+ * ReadStream which fetches a range of an S3 object with multiple ranged GET
+ * requests in parallel. The range is split into parts of THRILL_S3_PART_SIZE,
+ * of which up to THRILL_S3_CONCURRENCY are requested concurrently in one
+ * request context, while read() delivers the parts in order.
+ */
 class S3ReadStream : public ReadStream
 {
+    static constexpr bool debug = false;
+
 public:
     S3ReadStream(const std::string& bucket, const std::string& key,
-                 const S3GetConditions* get_conditions,
-                 uint64_t start_byte, uint64_t byte_count)
-        : bucket_(bucket), key_(key) {
-
-        // construct bucket
-        S3BucketContext bucket_context;
-        FillS3BucketContext(bucket_context, bucket_);
-
-        // construct handlers
-        S3GetObjectHandler handler;
-        memset(&handler, 0, sizeof(handler));
-
-        handler.responseHandler.propertiesCallback =
-            &ResponsePropertiesCallback;
-        handler.responseHandler.completeCallback =
-            &S3ReadStream::ResponseCompleteCallback;
-        handler.getObjectDataCallback = &S3ReadStream::GetObjectDataCallback;
+                 uint64_t start_byte = 0, uint64_t byte_count = 0)
+        : bucket_(bucket), key_(key),
+          part_size_(S3PartSize()), concurrency_(S3Concurrency()),
+          next_(start_byte), end_(start_byte + byte_count) {
 
         // create request context
         S3Status status = S3_create_request_context(&req_ctx_);
         if (status != S3StatusOK || req_ctx_ == nullptr)
             die("S3_create_request_context() failed.");
 
-        // issue request but do not wait for data
-        S3_get_object(
-            &bucket_context, key_.c_str(), get_conditions,
-            start_byte, byte_count, /* request_context */ req_ctx_,
-            /* timeoutMs */ 0, &handler, this);
-    }
+        // the parts of an open range can only be determined from its size
+        if (byte_count == 0)
+            end_ = std::max(start_byte, HeadObjectSize());
 
-    //! simpler constructor
-    S3ReadStream(const std::string& bucket, const std::string& key,
-                 uint64_t start_byte = 0, uint64_t byte_count = 0)
-        : S3ReadStream(bucket, key, /* get_conditions */ nullptr,
-                       start_byte, byte_count) { }
+        // issue requests but do not wait for data
+        IssueParts();
+    }
 
     //! non-copyable: delete copy-constructor
     S3ReadStream(const S3ReadStream&) = delete;
@@ -341,88 +399,168 @@ public:
     ssize_t read(void* data, size_t size) final {
         assert(req_ctx_);
 
-        if (status_ != S3StatusOK)
-            die("S3-ERROR during read: " << S3_get_status_name(status_));
-
-        status_ = S3StatusOK;
         uint8_t* output_begin = reinterpret_cast<uint8_t*>(data);
-        output_ = output_begin;
-        output_end_ = output_ + size;
-
-        // copy data from reception buffer
-        size_t wb = std::min(size, buffer_.size());
-        std::copy(buffer_.begin(), buffer_.begin() + wb, output_);
-        output_ += wb;
-        buffer_.erase(buffer_.begin(), buffer_.begin() + wb);
-
-        // wait for more callbacks to deliver data, use select() to wait
-        int remaining_requests = 1;
-        while (status_ == S3StatusOK &&
-               output_ < output_end_ && remaining_requests)
+        uint8_t* output = output_begin;
+        uint8_t* output_end = output + size;
+
+        while (output < output_end && !parts_.empty())
         {
-            // perform a select() waiting on new data
-            fd_set read_fds, write_fds, except_fds;
-            FD_ZERO(&read_fds);
-            FD_ZERO(&write_fds);
-            FD_ZERO(&except_fds);
-            int max_fd;
-
-            S3Status status = S3_get_request_context_fdsets(
-                req_ctx_, &read_fds, &write_fds, &except_fds, &max_fd);
-            die_unless(status == S3StatusOK);
-
-            if (max_fd != -1) {
-                int64_t timeout = S3_get_request_context_timeout(req_ctx_);
-                struct timeval tv = { timeout / 1000, (timeout % 1000) * 1000 };
-                int r = select(max_fd + 1, &read_fds, &write_fds, &except_fds,
-                               /* timeout */ (timeout == -1) ? 0 : &tv);
-                die_unless(r >= 0);
+            // wait for data of the first part, later parts arrive meanwhile
+            Part& p = *parts_.front();
+            while (p.pos == p.filled && !p.done)
+                RunRequestContextOnce(req_ctx_);
+
+            if (p.status != S3StatusOK)
+                die("S3-ERROR during read: " << S3_get_status_name(p.status));
+
+            // copy data from part
+            size_t wb = std::min<size_t>(output_end - output, p.filled - p.pos);
+            std::copy(p.data.begin() + p.pos, p.data.begin() + p.pos + wb,
+                      output);
+            output += wb;
+            p.pos += wb;
+
+            if (p.done && p.pos == p.filled) {
+                if (p.filled != p.data.size())
+                    die("S3-ERROR - short read of " << key_);
+
+                // keep the buffer for the next part
+                spare_ = std::move(p.data);
+                parts_.pop_front();
+                IssueParts();
             }
-
-            // run callbacks
-            S3_runonce_request_context(req_ctx_, &remaining_requests);
         }
 
-        return output_ - output_begin;
+        return output - output_begin;
     }
 
     void close() final {
         if (req_ctx_ == nullptr) return;
 
+        // aborts requests still in progress, which write into parts_
         S3_destroy_request_context(req_ctx_);
         req_ctx_ = nullptr;
+        parts_.clear();
     }
 
 private:
-    //! request context for waiting on more data
+    //! a ranged GET request and its reception buffer
+    struct Part {
+        //! received data, sized to the length of the range
+        std::vector<uint8_t> data;
+        //! number of bytes received
+        size_t filled = 0;
+        //! number of bytes delivered by read()
+        size_t pos = 0;
+        //! set by completion callback
+        bool done = false;
+        //! status of request
+        S3Status status = S3StatusOK;
+    };
+
+    //! request context of the concurrent GET requests
     S3RequestContext* req_ctx_ = nullptr;
 
-    //! status of request
+    //! status of HEAD request
     S3Status status_ = S3StatusOK;
 
-    //! bucket for upload
+    //! bucket for download
     std::string bucket_;
 
-    //! bucket key for upload
+    //! bucket key for download
     std::string key_;
 
-    //! reception buffer containing unneeded bytes from callback
-    std::vector<uint8_t> buffer_;
+    //! size of GET requests
+    size_t part_size_;
 
-    //! output buffer for read()
-    uint8_t* output_;
+    //! maximum number of parts in flight
+    size_t concurrency_;
 
-    //! end of output buffer for read()
-    uint8_t* output_end_;
+    //! object offset of next part to request
+    uint64_t next_;
+
+    //! object offset after the range
+    uint64_t end_;
+
+    //! object size delivered by HEAD request
+    uint64_t object_size_ = 0;
+
+    //! parts in flight, in order of the range
+    std::deque<std::unique_ptr<Part> > parts_;
+
+    //! buffer of a completely delivered part for reuse
+    std::vector<uint8_t> spare_;
 
     /**************************************************************************/
 
+    //! issue GET requests until concurrency_ parts are in flight
+    void IssueParts() {
+        if (parts_.size() >= concurrency_ || next_ >= end_) return;
+
+        // construct bucket
+        S3BucketContext bucket_context;
+        FillS3BucketContext(bucket_context, bucket_);
+
+        // construct handlers
+        S3GetObjectHandler handler;
+        memset(&handler, 0, sizeof(handler));
+
+        handler.responseHandler.propertiesCallback =
+            &ResponsePropertiesCallback;
+        handler.responseHandler.completeCallback =
+            &S3ReadStream::PartCompleteCallback;
+        handler.getObjectDataCallback = &S3ReadStream::GetObjectDataCallback;
+
+        while (parts_.size() < concurrency_ && next_ < end_)
+        {
+            uint64_t size = std::min<uint64_t>(part_size_, end_ - next_);
+
+            parts_.emplace_back(std::make_unique<Part>());
+            Part& p = *parts_.back();
+            p.data = std::move(spare_);
+            p.data.resize(size);
+
+            sLOG << "S3-INFO - GET" << key_ << "range" << next_ << size;
+
+            S3_get_object(
+                &bucket_context, key_.c_str(), /* get_conditions */ nullptr,
+                /* start_byte */ next_, /* byte_count */ size,
+                /* request_context */ req_ctx_,
+                /* timeoutMs */ 0, &handler, &p);
+
+            next_ += size;
+        }
+    }
+
+    //! fetch size of the object with a synchronous HEAD request
+    uint64_t HeadObjectSize() {
+        // construct bucket
+        S3BucketContext bucket_context;
+        FillS3BucketContext(bucket_context, bucket_);
+
+        // construct handlers
+        S3ResponseHandler handler;
+        memset(&handler, 0, sizeof(handler));
+
+        handler.propertiesCallback = &S3ReadStream::HeadPropertiesCallback;
+        handler.completeCallback = &S3ReadStream::ResponseCompleteCallback;
+
+        S3_head_object(
+            &bucket_context, key_.c_str(), /* request_context */ nullptr,
+            /* timeoutMs */ 0, &handler, this);
+
+        if (status_ != S3StatusOK)
+            die("S3-ERROR during head: " << S3_get_status_name(status_));
+
+        return object_size_;
+    }
+
     //! completion callback, check for errors
     void ResponseCompleteCallback(
         S3Status status, const S3ErrorDetails* error) {
         status_ = status;
 
-        if (status != S3StatusOK && status != S3StatusInterrupted)
+        if (status != S3StatusOK)
             LibS3LogError(status, error);
     }
 
@@ -433,32 +571,37 @@ private:
         return t->ResponseCompleteCallback(status, error);
     }
 
-    //! callback receiving data
-    S3Status GetObjectDataCallback(int bufferSize, const char* buffer) {
-
-        // copy as much data into output_ as fits
-        size_t wb = std::min(
-            output_end_ - output_, static_cast<intptr_t>(bufferSize));
-        std::copy(buffer, buffer + wb, output_);
-        output_ += wb;
+    //! callback delivering the object size
+    static S3Status HeadPropertiesCallback(
+        const S3ResponseProperties* properties, void* cookie) {
+        S3ReadStream* t = reinterpret_cast<S3ReadStream*>(cookie);
+        t->object_size_ = properties->contentLength;
+        return ResponsePropertiesCallback(properties, nullptr);
+    }
 
-        // store remaining unneeded bytes in buffer_
-        if (wb != static_cast<uintptr_t>(bufferSize))
-        {
-            die_unless(output_ == output_end_);
-            die_unless(buffer_.empty());
-            buffer_.resize(bufferSize - wb);
-            std::copy(buffer + wb, buffer + bufferSize, buffer_.data());
-        }
+    //! completion callback of a part, check for errors
+    static void PartCompleteCallback(
+        S3Status status, const S3ErrorDetails* error, void* cookie) {
+        Part* p = reinterpret_cast<Part*>(cookie);
+        p->status = status;
+        p->done = true;
 
-        return S3StatusOK;
+        if (status != S3StatusOK && status != S3StatusInterrupted)
+            LibS3LogError(status, error);
     }
 
-    //! static wrapper to call GetObjectDataCallback
+    //! callback receiving data of a part
     static S3Status GetObjectDataCallback(
         int bufferSize, const char* buffer, void* cookie) {
-        S3ReadStream* t = reinterpret_cast<S3ReadStream*>(cookie);
-        return t->GetObjectDataCallback(bufferSize, buffer);
+        Part* p = reinterpret_cast<Part*>(cookie);
+
+        // the server must not deliver more than the requested range
+        if (p->filled + bufferSize > p->data.size())
+            return S3StatusAbortedByCallback;
+
+        std::copy(buffer, buffer + bufferSize, p->data.data() + p->filled);
+        p->filled += bufferSize;
+        return S3StatusOK;
     }
 };
 
@@ -481,13 +624,22 @@ ReadStreamPtr S3OpenReadStream(
 
 /******************************************************************************/
 
+/*!
+ * WriteStream which uploads an S3 object with a multipart upload. The data is
+ * collected in parts of THRILL_S3_PART_SIZE, of which up to
+ * THRILL_S3_CONCURRENCY are uploaded concurrently in one request context while
+ * the next part is being filled.
+ */
 class S3WriteStream : public WriteStream
 {
+    static constexpr bool debug = false;
+
 public:
     S3WriteStream(const std::string& bucket, const std::string& key,
                   S3PutProperties* put_properties = nullptr)
         : bucket_(bucket), key_(key),
-          put_properties_(put_properties) {
+          put_properties_(put_properties),
+          part_size_(S3PartSize()), concurrency_(S3Concurrency()) {
 
         S3BucketContext bucket_context;
         FillS3BucketContext(bucket_context, bucket);
@@ -507,52 +659,81 @@ public:
         S3_initiate_multipart(
             &bucket_context, key_.c_str(), put_properties, &handler,
             /* request_context */ nullptr, /* timeoutMs */ 0, this);
+
+        if (status_ != S3StatusOK || upload_id_.empty()) {
+            die("S3-ERROR initiating multipart upload of " << key_ << ": "
+                << S3_get_status_name(status_));
+        }
+
+        // create request context for part uploads
+        S3Status status = S3_create_request_context(&req_ctx_);
+        if (status != S3StatusOK || req_ctx_ == nullptr)
+            die("S3_create_request_context() failed.");
     }
 
+    //! non-copyable: delete copy-constructor
+    S3WriteStream(const S3WriteStream&) = delete;
+    //! non-copyable: delete assignment operator
+    S3WriteStream& operator = (const S3WriteStream&) = delete;
+
     ~S3WriteStream() override {
         close();
     }
 
     ssize_t write(const void* _data, size_t size) final {
         const uint8_t* data = reinterpret_cast<const uint8_t*>(_data);
+        size_t total = size;
 
         while (size > 0)
         {
             // copy data to buffer
             size_t buffer_pos = buffer_.size();
-            size_t wb = std::min(size, buffer_max_ - buffer_pos);
+            size_t wb = std::min(size, part_size_ - buffer_pos);
             buffer_.resize(buffer_pos + wb);
             std::copy(data, data + wb, buffer_.data() + buffer_pos);
             data += wb;
             size -= wb;
 
-            if (buffer_.size() >= buffer_max_)
-                UploadMultipart();
+            if (buffer_.size() >= part_size_)
+                UploadPart();
         }
 
-        return size;
+        return total;
     }
 
     void close() final {
         if (upload_id_.empty()) return;
 
-        // upload last multipart piece
-        if (!buffer_.empty())
-            UploadMultipart();
+        // upload last multipart piece, an empty object has one empty part.
+        if (!buffer_.empty() || parts_.empty())
+            UploadPart();
+
+        // wait for all part uploads
+        while (active_ != 0)
+            RunRequestContextOnce(req_ctx_);
+
+        S3_destroy_request_context(req_ctx_);
+        req_ctx_ = nullptr;
 
-        LOG1 << "commit multipart";
+        sLOG << "S3-INFO - commit multipart upload of" << key_
+             << "with" << parts_.size() << "parts";
 
         // construct commit XML
 
         std::ostringstream xml;
         xml << "<CompleteMultipartUpload>";
-        for (size_t i = 0; i < part_etag_.size(); ++i) {
+        for (const std::unique_ptr<Part>& p : parts_) {
+            if (p->status != S3StatusOK || p->etag.empty()) {
+                die("S3-ERROR uploading part " << p->seq << " of " << key_
+                    << ": " << S3_get_status_name(p->status));
+            }
             xml << "<Part>"
-                << "<PartNumber>" << (i + 1) << "</PartNumber>"
-                << "<ETag>" << part_etag_[i] << "</ETag>"
+                << "<PartNumber>" << p->seq << "</PartNumber>"
+                << "<ETag>" << p->etag << "</ETag>"
                 << "</Part>";
         }
         xml << "</CompleteMultipartUpload>";
+        parts_.clear();
 
         // put commit message into buffer_
         std::string xml_str = xml.str();
@@ -582,9 +763,30 @@ public:
             /* request_context */ nullptr, /* timeoutMs */ 0, this);
 
         upload_id_.clear();
+
+        if (status_ != S3StatusOK) {
+            die("S3-ERROR completing multipart upload of " << key_ << ": "
+                << S3_get_status_name(status_));
+        }
     }
 
 private:
+    //! an uploading part and its data
+    struct Part {
+        //! stream to count active uploads
+        S3WriteStream* stream;
+        //! part number, starting at 1
+        int seq;
+        //! data of the part
+        std::vector<uint8_t> data;
+        //! current upload position in data
+        size_t pos = 0;
+        //! ETag returned by upload
+        std::string etag;
+        //! status of request
+        S3Status status = S3StatusOK;
+    };
+
     //! status of request
     S3Status status_ = S3StatusOK;
 
@@ -600,24 +802,33 @@ private:
     //! unique identifier for multi part upload
     std::string upload_id_;
 
-    //! sequence number of uploads
-    int upload_seq_ = 1;
+    //! size of parts to upload
+    size_t part_size_;
 
-    //! block size to upload as multi part
-    size_t buffer_max_ = 16 * 1024 * 1024;
+    //! maximum number of concurrent part uploads
+    size_t concurrency_;
 
-    //! output buffer, if this grows to 16 MiB a part upload is initiated.
+    //! request context of the concurrent part uploads
+    S3RequestContext* req_ctx_ = nullptr;
+
+    //! output buffer, if this grows to part_size_ a part upload is initiated.
     std::vector<uint8_t> buffer_;
 
-    //! current upload position in buffer_ or other memory areas
+    //! buffer of a completed part upload for reuse
+    std::vector<uint8_t> spare_;
+
+    //! uploaded and uploading parts
+    std::vector<std::unique_ptr<Part> > parts_;
+
+    //! number of parts currently uploading
+    size_t active_ = 0;
+
+    //! current upload position of commit message
     const uint8_t* upload_;
 
-    //! end position of upload area
+    //! end position of commit message
     const uint8_t* upload_end_;
 
-    //! list of ETags of uploaded multiparts
-    std::vector<std::string> part_etag_;
-
     /**************************************************************************/
 
     //! completion callback, check for errors
@@ -651,11 +862,35 @@ private:
         return S3StatusOK;
     }
 
+    int PutObjectDataCallback(int bufferSize, char* buffer) {
+        size_t wb = std::min(
+            static_cast<intptr_t>(bufferSize), upload_end_ - upload_);
+        std::copy(upload_, upload_ + wb, buffer);
+        upload_ += wb;
+        return wb;
+    }
+
+    static int PutObjectDataCallback(
+        int bufferSize, char* buffer, void* cookie) {
+        S3WriteStream* t = reinterpret_cast<S3WriteStream*>(cookie);
+        return t->PutObjectDataCallback(bufferSize, buffer);
+    }
+
     /**************************************************************************/
 
-    void UploadMultipart() {
-        LOG1 << "S3-INFO - Upload multipart[" << upload_seq_ << "]"
-             << " size " << buffer_.size();
+    //! start upload of buffer_ as next part, after waiting for a free slot.
+    void UploadPart() {
+        while (active_ >= concurrency_)
+            RunRequestContextOnce(req_ctx_);
+
+        parts_.emplace_back(std::make_unique<Part>());
+        Part& p = *parts_.back();
+        p.stream = this;
+        p.seq = static_cast<int>(parts_.size());
+        p.data = std::move(buffer_);
+
+        sLOG << "S3-INFO - upload multipart[" << p.seq << "]"
+             << "size" << p.data.size();
 
         S3BucketContext bucket_context;
         FillS3BucketContext(bucket_context, bucket_);
@@ -665,51 +900,57 @@ private:
         memset(&handler, 0, sizeof(handler));
 
         handler.responseHandler.propertiesCallback =
-            &S3WriteStream::MultipartPropertiesCallback;
+            &S3WriteStream::PartPropertiesCallback;
         handler.responseHandler.completeCallback =
-            &S3WriteStream::ResponseCompleteCallback;
+            &S3WriteStream::PartCompleteCallback;
         handler.putObjectDataCallback =
-            &S3WriteStream::PutObjectDataCallback;
+            &S3WriteStream::PartDataCallback;
 
-        // synchronous upload of multi part data
-        upload_ = buffer_.data();
-        upload_end_ = buffer_.data() + buffer_.size();
+        // asynchronous upload of multi part data
+        ++active_;
         S3_upload_part(&bucket_context, key_.c_str(), put_properties_,
-                       &handler, upload_seq_++, upload_id_.c_str(),
-                       /* partContentLength */ buffer_.size(),
-                       /* request_context */ nullptr,
-                       /* timeoutMs */ 0, this);
+                       &handler, p.seq, upload_id_.c_str(),
+                       /* partContentLength */ p.data.size(),
+                       /* request_context */ req_ctx_,
+                       /* timeoutMs */ 0, &p);
 
+        // fill the next part into the buffer of a completed one
+        buffer_ = std::move(spare_);
         buffer_.clear();
     }
 
-    S3Status MultipartPropertiesCallback(
-        const S3ResponseProperties* properties) {
-
-        part_etag_.emplace_back(properties->eTag);
+    static S3Status PartPropertiesCallback(
+        const S3ResponseProperties* properties, void* cookie) {
+        Part* p = reinterpret_cast<Part*>(cookie);
+        if (properties->eTag != nullptr)
+            p->etag = properties->eTag;
         // output properties
-        ResponsePropertiesCallback(properties, nullptr);
-        return S3StatusOK;
+        return ResponsePropertiesCallback(properties, nullptr);
     }
 
-    static S3Status MultipartPropertiesCallback(
-        const S3ResponseProperties* properties, void* cookie) {
-        S3WriteStream* t = reinterpret_cast<S3WriteStream*>(cookie);
-        return t->MultipartPropertiesCallback(properties);
-    }
+    static void PartCompleteCallback(
+        S3Status status, const S3ErrorDetails* error, void* cookie) {
+        Part* p = reinterpret_cast<Part*>(cookie);
+        p->status = status;
+        if (status != S3StatusOK)
+            LibS3LogError(status, error);
 
-    int PutObjectDataCallback(int bufferSize, char* buffer) {
-        size_t wb = std::min(
-            static_cast<intptr_t>(bufferSize), upload_end_ - upload_);
-        std::copy(upload_, upload_ + wb, buffer);
-        upload_ += wb;
-        return wb;
+        // release the data of the part
+        S3WriteStream* t = p->stream;
+        if (t->spare_.capacity() < p->data.capacity())
+            t->spare_ = std::move(p->data);
+        std::vector<uint8_t>().swap(p->data);
+        --t->active_;
     }
 
-    static int PutObjectDataCallback(
-        int bufferSize, char* buffer, void* cookie) {
-        S3WriteStream* t = reinterpret_cast<S3WriteStream*>(cookie);
-        return t->PutObjectDataCallback(bufferSize, buffer);
+    static int PartDataCallback(int bufferSize, char* buffer, void* cookie) {
+        Part* p = reinterpret_cast<Part*>(cookie);
+        size_t wb = std::min(
+            static_cast<size_t>(bufferSize), p->data.size() - p->pos);
+        std::copy(p->data.data() + p->pos, p->data.data() + p->pos + wb,
+                  buffer);
+        p->pos += wb;
+        return static_cast<int>(wb);
     }
 };
 
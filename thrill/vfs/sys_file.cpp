@@ -15,6 +15,7 @@
 #include <thrill/common/porting.hpp>
 #include <thrill/common/string.hpp>
 #include <thrill/common/system_exception.hpp>
+#include <thrill/vfs/io_uring.hpp>
 #include <thrill/vfs/simple_glob.hpp>
 
 #include <tlx/die.hpp>
@@ -50,6 +51,8 @@
 namespace thrill {
 namespace vfs {
 
+bool use_io_uring = false;
+
 /******************************************************************************/
 
 static void SysGlobWalkRecursive(const std::string& path, FileList& filelist) {
@@ -320,6 +323,300 @@ void SysFile::close() {
 
 /******************************************************************************/
 
+#if THRILL_HAVE_IO_URING
+
+/*!
+ * Base of local files read or written sequentially via io_uring. The file is
+ * transferred in chunks through a few buffers in one registered memory region,
+ * each of which carries at most one request in flight, such that reads ahead or
+ * writes behind of the stream position overlap with the computation.
+ */
+class SysUringFile
+{
+    static constexpr bool debug = false;
+
+protected:
+    //! number of buffers and thereby maximum number of requests in flight
+    static constexpr size_t num_buffers_ = 4;
+
+    //! size of each buffer and thereby of each request
+    static constexpr size_t buffer_size_ = 1024 * 1024;
+
+    //! a buffer and its request
+    struct Buffer {
+        //! begin of buffer in region_
+        uint8_t* data;
+        //! file offset of data[0]
+        uint64_t offset = 0;
+        //! length of the request
+        size_t size = 0;
+        //! bytes transferred by the request
+        size_t filled = 0;
+        //! remaining part of the request, must stay valid while in flight
+        struct iovec iov;
+        //! whether the request is in flight
+        bool busy = false;
+    };
+
+    explicit SysUringFile(int fd)
+        : ring_(num_buffers_), region_(num_buffers_ * buffer_size_),
+          buffers_(num_buffers_), fd_(fd) {
+        for (size_t i = 0; i < num_buffers_; ++i)
+            buffers_[i].data = region_.data() + i * buffer_size_;
+
+        struct iovec region;
+        region.iov_base = region_.data();
+        region.iov_len = region_.size();
+        if (!ring_.RegisterBuffers(&region, 1))
+            sLOG << "SysUringFile: could not register buffers";
+    }
+
+    //! non-copyable: delete copy-constructor
+    SysUringFile(const SysUringFile&) = delete;
+    //! non-copyable: delete assignment operator
+    SysUringFile& operator = (const SysUringFile&) = delete;
+
+    //! queue the remaining part of the request of buffer i.
+    void Issue(size_t i, bool write) {
+        Buffer& b = buffers_[i];
+        b.iov.iov_base = b.data + b.filled;
+        b.iov.iov_len = b.size - b.filled;
+        b.busy = true;
+        if (write)
+            ring_.PrepareWrite(fd_, &b.iov, b.offset + b.filled, 0, i);
+        else
+            ring_.PrepareRead(fd_, &b.iov, b.offset + b.filled, 0, i);
+    }
+
+    //! wait for one completion and reissue partial transfers.
+    void Reap(bool write) {
+        uint64_t i;
+        int32_t res = ring_.WaitCompletion(&i);
+        Buffer& b = buffers_[i];
+
+        if (res == -EINTR || res == -EAGAIN) {
+            Issue(i, write);
+            ring_.Submit();
+            return;
+        }
+        if (res < 0) {
+            if (error_ == 0) error_ = -res;
+            b.busy = false;
+            return;
+        }
+
+        b.filled += res;
+        if (res != 0 && b.filled < b.size) {
+            Issue(i, write);
+            ring_.Submit();
+            return;
+        }
+        // a read of zero bytes is end of file, a write of zero bytes fails.
+        if (res == 0 && write && b.filled < b.size && error_ == 0)
+            error_ = EIO;
+        b.busy = false;
+    }
+
+    //! wait for all requests in flight and close the file descriptor.
+    void CloseFile(bool write) {
+        if (fd_ < 0) return;
+        while (ring_.in_flight() != 0)
+            Reap(write);
+        sLOG << "SysUringFile::close(): fd" << fd_;
+        if (::close(fd_) != 0) {
+            LOG1 << "SysUringFile::close()"
+                 << " fd_=" << fd_
+                 << " errno=" << errno
+                 << " error=" << strerror(errno);
+        }
+        fd_ = -1;
+    }
+
+    //! throw the first error of a request
+    void CheckError(const char* what) {
+        if (error_ != 0)
+            throw common::ErrnoException(what, error_);
+    }
+
+    //! ring of this file
+    IoUring ring_;
+
+    //! memory of the buffers, registered with the ring
+    std::vector<uint8_t> region_;
+
+    //! the buffers
+    std::vector<Buffer> buffers_;
+
+    //! file descriptor
+    int fd_;
+
+    //! first errno of a failed request
+    int error_ = 0;
+};
+
+/*!
+ * Represents a regular file read from an offset to its end, or to the end of
+ * the requested range, via io_uring, with all buffers reading ahead of read().
+ */
+class SysUringReadFile final : public ReadStream, private SysUringFile
+{
+public:
+    //! read from offset up to end, or up to the end of the file if end = 0.
+    SysUringReadFile(int fd, uint64_t offset, uint64_t end)
+        : SysUringFile(fd), next_(offset) {
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+            throw common::ErrnoException("SysUringReadFile: fstat failed", errno);
+        end_ = st.st_size;
+        if (end != 0)
+            end_ = std::min(end_, end);
+
+        // submit the first reads in one batch
+        for (size_t i = 0; i < num_buffers_; ++i)
+            IssueNext(i);
+        ring_.Submit();
+    }
+
+    ~SysUringReadFile() {
+        close();
+    }
+
+    ssize_t read(void* data, size_t size) final {
+        assert(fd_ >= 0);
+        uint8_t* output_begin = reinterpret_cast<uint8_t*>(data);
+        uint8_t* output = output_begin;
+        uint8_t* output_end = output + size;
+
+        while (output < output_end)
+        {
+            Buffer& b = buffers_[head_];
+            while (b.busy)
+                Reap(/* write */ false);
+            CheckError("SysUringReadFile: read failed");
+
+            size_t rb = std::min<size_t>(output_end - output, b.filled - pos_);
+            std::copy(b.data + pos_, b.data + pos_ + rb, output);
+            output += rb;
+            pos_ += rb;
+
+            // stop at the end of the file, or if the buffer is not exhausted
+            if (pos_ != b.filled || b.filled != b.size || b.size == 0)
+                break;
+
+            // reuse the exhausted buffer for the next chunk
+            IssueNext(head_);
+            ring_.Submit();
+            head_ = (head_ + 1) % num_buffers_;
+            pos_ = 0;
+        }
+
+        return output - output_begin;
+    }
+
+    void close() final {
+        CloseFile(/* write */ false);
+    }
+
+private:
+    //! file offset of the next chunk to read
+    uint64_t next_;
+
+    //! file offset after the range to read
+    uint64_t end_;
+
+    //! buffer delivered by read()
+    size_t head_ = 0;
+
+    //! bytes of the head buffer delivered by read()
+    size_t pos_ = 0;
+
+    //! queue read of the next chunk into buffer i, if it is inside the file.
+    void IssueNext(size_t i) {
+        Buffer& b = buffers_[i];
+        b.offset = next_;
+        b.size = next_ < end_
+                 ? std::min(end_ - next_, static_cast<uint64_t>(buffer_size_)) : 0;
+        b.filled = 0;
+        if (b.size == 0) return;
+        next_ += b.size;
+        Issue(i, /* write */ false);
+    }
+};
+
+/*!
+ * Represents a regular file written sequentially via io_uring, with full
+ * buffers written behind write() and close() waiting for all of them.
+ */
+class SysUringWriteFile final : public WriteStream, private SysUringFile
+{
+public:
+    explicit SysUringWriteFile(int fd) : SysUringFile(fd) { }
+
+    ~SysUringWriteFile() {
+        close();
+    }
+
+    ssize_t write(const void* data, size_t size) final {
+        assert(fd_ >= 0);
+        const uint8_t* input = reinterpret_cast<const uint8_t*>(data);
+
+        for (size_t left = size; left != 0; )
+        {
+            Buffer& b = buffers_[head_];
+            if (fill_ == 0) {
+                // wait for the previous write from this buffer
+                while (b.busy)
+                    Reap(/* write */ true);
+                CheckError("SysUringWriteFile: write failed");
+            }
+
+            size_t wb = std::min(left, buffer_size_ - fill_);
+            std::copy(input, input + wb, b.data + fill_);
+            input += wb, left -= wb, fill_ += wb;
+
+            if (fill_ == buffer_size_)
+                Flush();
+        }
+
+        return size;
+    }
+
+    void close() final {
+        if (fd_ < 0) return;
+        if (fill_ != 0)
+            Flush();
+        CloseFile(/* write */ true);
+        CheckError("SysUringWriteFile: write failed");
+    }
+
+private:
+    //! file offset of the next buffer to write
+    uint64_t offset_ = 0;
+
+    //! buffer filled by write()
+    size_t head_ = 0;
+
+    //! bytes in the head buffer
+    size_t fill_ = 0;
+
+    //! submit write of the head buffer and continue with the next one.
+    void Flush() {
+        Buffer& b = buffers_[head_];
+        b.offset = offset_;
+        b.size = fill_;
+        b.filled = 0;
+        offset_ += fill_;
+        Issue(head_, /* write */ true);
+        ring_.Submit();
+        head_ = (head_ + 1) % num_buffers_;
+        fill_ = 0;
+    }
+};
+
+#endif // THRILL_HAVE_IO_URING
+
+/******************************************************************************/
+
 ReadStreamPtr SysOpenReadStream(
     const std::string& path, const common::Range& range) {
 
@@ -351,6 +648,20 @@ ReadStreamPtr SysOpenReadStream(
 
         sLOG << "SysFile::OpenForRead(): filefd" << fd;
 
+#if THRILL_HAVE_IO_URING
+        struct stat st;
+        if (use_io_uring && ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            IoUring::IsSupported()) {
+            try {
+                return tlx::make_counting<SysUringReadFile>(
+                    fd, range.begin, range.end);
+            }
+            catch (common::ErrnoException& e) {
+                LOG1 << "SysFile::OpenForRead(): " << e.what();
+            }
+        }
+#endif
+
         if (range.begin) {
             //! POSIX lseek function from current position.
             ::lseek(fd, range.begin, SEEK_CUR);
@@ -441,6 +752,19 @@ WriteStreamPtr SysOpenWriteStream(const std::string& path) {
 
         sLOG << "SysFile::OpenForWrite(): filefd" << fd;
 
+#if THRILL_HAVE_IO_URING
+        struct stat st;
+        if (use_io_uring && ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            IoUring::IsSupported()) {
+            try {
+                return tlx::make_counting<SysUringWriteFile>(fd);
+            }
+            catch (common::ErrnoException& e) {
+                LOG1 << "SysFile::OpenForWrite(): " << e.what();
+            }
+        }
+#endif
+
         return tlx::make_counting<SysFile>(fd);
     }
 
@@ -491,6 +815,199 @@ WriteStreamPtr SysOpenWriteStream(const std::string& path) {
 #endif
 }
 
+/******************************************************************************/
+
+/*!
+ * Represents a POSIX system file opened for writing at offsets with pwrite(),
+ * which allows multiple workers to write disjoint ranges of the same file.
+ */
+class SysWriteAtFile final : public WriteAtStream
+{
+    static constexpr bool debug = false;
+
+public:
+    explicit SysWriteAtFile(int fd) noexcept : fd_(fd) { }
+
+    //! non-copyable: delete copy-constructor
+    SysWriteAtFile(const SysWriteAtFile&) = delete;
+    //! non-copyable: delete assignment operator
+    SysWriteAtFile& operator = (const SysWriteAtFile&) = delete;
+
+    ~SysWriteAtFile() {
+        close();
+    }
+
+    //! write all bytes at the offset, repeating partial writes.
+    void write_at(const void* data, size_t size, uint64_t offset) final {
+        assert(fd_ >= 0);
+        const char* cdata = reinterpret_cast<const char*>(data);
+
+        while (size != 0) {
+#if defined(_MSC_VER)
+            if (::_lseeki64(fd_, offset, SEEK_SET) < 0)
+                throw common::ErrnoException("SysWriteAtFile: seek failed");
+            int wb = ::_write(fd_, cdata, static_cast<unsigned>(
+                                  std::min<size_t>(size, 1u << 30)));
+#else
+            ssize_t wb = ::pwrite(fd_, cdata, size, offset);
+#endif
+            if (wb < 0) {
+                if (errno == EINTR) continue;
+                throw common::ErrnoException("SysWriteAtFile: pwrite failed");
+            }
+            cdata += wb, size -= wb, offset += wb;
+        }
+    }
+
+    //! close the file descriptor
+    void close() final {
+        if (fd_ < 0) return;
+        sLOG << "SysWriteAtFile::close(): fd" << fd_;
+        if (::close(fd_) != 0) {
+            LOG1 << "SysWriteAtFile::close()"
+                 << " fd_=" << fd_
+                 << " errno=" << errno
+                 << " error=" << strerror(errno);
+        }
+        fd_ = -1;
+    }
+
+private:
+    //! file descriptor
+    int fd_ = -1;
+};
+
+bool SysIsWriteAtSupported(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0)
+        return errno == ENOENT;
+    return S_ISREG(st.st_mode);
+}
+
+WriteAtStreamPtr SysOpenWriteAtStream(
+    const std::string& path, bool create, uint64_t size) {
+
+    static constexpr bool debug = false;
+
+    int flags = O_WRONLY | O_BINARY;
+    if (create) flags |= O_CREAT | O_TRUNC;
+
+    int fd = ::open(path.c_str(), flags, 0666);
+    if (fd < 0) {
+        throw common::ErrnoException("Cannot open file " + path);
+    }
+    common::PortSetCloseOnExec(fd);
+
+    if (create) {
+        // pre-size the file, such that all workers can write their ranges.
+#if defined(_MSC_VER)
+        if (::_chsize_s(fd, size) != 0) {
+#else
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+#endif
+            ::close(fd);
+            throw common::ErrnoException("Cannot resize file " + path);
+        }
+    }
+
+    sLOG << "SysOpenWriteAtStream(): fd" << fd << "create" << create
+         << "size" << size;
+
+    return tlx::make_counting<SysWriteAtFile>(fd);
+}
+
+/******************************************************************************/
+
+/*!
+ * Represents a POSIX system file opened for reading at offsets with pread(),
+ * which allows multiple workers to read disjoint ranges of the same file.
+ */
+class SysReadAtFile final : public ReadAtStream
+{
+    static constexpr bool debug = false;
+
+public:
+    explicit SysReadAtFile(int fd) noexcept : fd_(fd) { }
+
+    //! non-copyable: delete copy-constructor
+    SysReadAtFile(const SysReadAtFile&) = delete;
+    //! non-copyable: delete assignment operator
+    SysReadAtFile& operator = (const SysReadAtFile&) = delete;
+
+    ~SysReadAtFile() {
+        close();
+    }
+
+    //! read bytes at the offset, repeating partial reads until EOF.
+    size_t read_at(void* data, size_t size, uint64_t offset) final {
+        assert(fd_ >= 0);
+        char* cdata = reinterpret_cast<char*>(data);
+        size_t total = 0;
+
+        while (size != 0) {
+#if defined(_MSC_VER)
+            if (::_lseeki64(fd_, offset, SEEK_SET) < 0)
+                throw common::ErrnoException("SysReadAtFile: seek failed");
+            int rb = ::_read(fd_, cdata, static_cast<unsigned>(
+                                 std::min<size_t>(size, 1u << 30)));
+#else
+            ssize_t rb = ::pread(fd_, cdata, size, offset);
+#endif
+            if (rb < 0) {
+                if (errno == EINTR) continue;
+                throw common::ErrnoException("SysReadAtFile: pread failed");
+            }
+            if (rb == 0) break;
+            cdata += rb, size -= rb, offset += rb, total += rb;
+        }
+        return total;
+    }
+
+    //! close the file descriptor
+    void close() final {
+        if (fd_ < 0) return;
+        sLOG << "SysReadAtFile::close(): fd" << fd_;
+        if (::close(fd_) != 0) {
+            LOG1 << "SysReadAtFile::close()"
+                 << " fd_=" << fd_
+                 << " errno=" << errno
+                 << " error=" << strerror(errno);
+        }
+        fd_ = -1;
+    }
+
+private:
+    //! file descriptor
+    int fd_ = -1;
+};
+
+bool SysIsReadAtSupported(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0)
+        return false;
+    return S_ISREG(st.st_mode);
+}
+
+ReadAtStreamPtr SysOpenReadAtStream(const std::string& path) {
+
+    static constexpr bool debug = false;
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_BINARY, 0);
+    if (fd < 0) {
+        throw common::ErrnoException("Cannot open file " + path);
+    }
+    common::PortSetCloseOnExec(fd);
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    // the ranges are read front to back in large chunks
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    sLOG << "SysOpenReadAtStream(): fd" << fd;
+
+    return tlx::make_counting<SysReadAtFile>(fd);
+}
+
 } // namespace vfs
 } // namespace thrill
 
@@ -20,6 +20,10 @@
 namespace thrill {
 namespace vfs {
 
+//! read and write uncompressed regular files via io_uring if the kernel
+//! supports it, set via THRILL_IO_URING.
+extern bool use_io_uring;
+
 /*!
  * Glob a path and augment the FileList with matching file names.
  */
@@ -47,6 +51,29 @@ ReadStreamPtr SysOpenReadStream(
  */
 WriteStreamPtr SysOpenWriteStream(const std::string& path);
 
+/*!
+ * Returns true if path does not exist or is a regular file, hence it can be
+ * written at offsets.
+ */
+bool SysIsWriteAtSupported(const std::string& path);
+
+/*!
+ * Open file for writing at offsets with pwrite(). If create is true, the file
+ * is created or truncated and resized to size bytes.
+ *
+ * \param path Path to open
+ *
+ * \param create Whether to create and resize the file
+ *
+ * \param size Size of the file to create
+ */
+WriteAtStreamPtr SysOpenWriteAtStream(
+    const std::string& path, bool create, uint64_t size);
+
+bool SysIsReadAtSupported(const std::string& path);
+
+ReadAtStreamPtr SysOpenReadAtStream(const std::string& path);
+
 } // namespace vfs
 } // namespace thrill
 